@@ -0,0 +1,5 @@
+#include "CacheTrace.h"
+
+#define NATIVE_TRACE_CATEGORY "framedatacache"
+
+#include "NativeTraceImpl.h"
@@ -1,25 +1,43 @@
 ﻿#include "FrameDataCache.h"
+#include "CacheTrace.h"
 
 #include <map>
+#include <deque>
 #include <vector>
+#include <memory>
+#include <utility>
 #include <algorithm>
+#include <cstring>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 
 typedef struct FrameIndex {
-    FrameIndex(unsigned char *pBuf, int nLen, bool isKeyFrame, bool bRFlag = false)
-            : _pBuf(pBuf), _nLen(nLen), _isKeyFrame(isKeyFrame), _isReadFlag(bRFlag) {
+    FrameIndex(int64 timestamp, int trackId, unsigned char *pBuf, int nLen, bool isKeyFrame,
+               bool bRFlag = false)
+            : _timestamp(timestamp), _trackId(trackId), _pBuf(pBuf), _nLen(nLen),
+              _isKeyFrame(isKeyFrame), _isReadFlag(bRFlag) {
     }
 
     FrameIndex(const FrameIndex &item) {
+        this->_timestamp = item._timestamp;
+        this->_trackId = item._trackId;
         this->_pBuf = item._pBuf;
         this->_nLen = item._nLen;
         this->_isKeyFrame = item._isKeyFrame;
-        this->_isReadFlag = item._isReadFlag;
+        this->_isReadFlag = item._isReadFlag.load();
     }
 
     /**
-     * 数据存储在buffer中的地址
+     * 帧的时间戳
+     */
+    int64 _timestamp;
+    /**
+     * 帧所属的轨道ID
+     */
+    int _trackId;
+    /**
+     * 数据存储在buffer中的地址，超出buffer尾部的部分存储在buffer头部
      */
     unsigned char *_pBuf;
     /**
@@ -31,9 +49,9 @@ typedef struct FrameIndex {
      */
     bool _isKeyFrame;
     /**
-     * 是否正在读取
+     * 是否被读取过，持有读锁的多个线程可能同时设置
      */
-    bool _isReadFlag;
+    std::atomic<bool> _isReadFlag;
 } FrameIndex, *PFrameIndex;
 
 typedef std::map <int64, std::shared_ptr<FrameIndex>> FRAME_INDEX_MAP;
@@ -42,11 +60,19 @@ typedef FRAME_INDEX_MAP::const_iterator FRAME_INDEX_MAP_CONST_ITERATOR;
 // iterator可改自身和所指的元素值
 typedef FRAME_INDEX_MAP::iterator FRAME_INDEX_MAP_ITERATOR;
 
+// 交织索引的key：(时间戳, 轨道ID)，相同时间戳时按轨道ID排序
+typedef std::pair <int64, int> SAMPLE_KEY;
+// 所有轨道按时间戳交织的帧索引容器
+typedef std::map <SAMPLE_KEY, std::shared_ptr<FrameIndex>> SAMPLE_INDEX_MAP;
+typedef SAMPLE_INDEX_MAP::const_iterator SAMPLE_INDEX_MAP_CONST_ITERATOR;
+
+// 帧数据在buffer中的写入顺序，队首为最早写入的帧，淘汰时从队首开始
+typedef std::deque <std::shared_ptr<FrameIndex>> FRAME_WRITE_QUEUE;
+
 /**
  * 内存buffer指针
  */
 static unsigned char *s_pMemBuf = nullptr;
-static FRAME_INDEX_MAP sFrameIndexMap;
 
 // 关键帧时间戳容器类型定义
 typedef std::vector <int64> KEY_FRAME_TS_VECTOR;
@@ -54,14 +80,38 @@ typedef std::vector <int64> KEY_FRAME_TS_VECTOR;
 typedef KEY_FRAME_TS_VECTOR::const_iterator KEY_FRAME_TS_VECTOR_CONST_ITERATOR;
 // 可改关键帧时间戳迭代器
 typedef KEY_FRAME_TS_VECTOR::iterator KEY_FRAME_TS_VECTOR_ITERATOR;
-// 关键帧时间戳容器
-static KEY_FRAME_TS_VECTOR sKeyFrameTSVec;
+
+/**
+ * 单个轨道的帧索引
+ */
+typedef struct TrackIndex {
+    /**
+     * 该轨道按时间戳排序的帧索引
+     */
+    FRAME_INDEX_MAP frameIndexMap;
+    /**
+     * 该轨道关键帧（同步帧）的时间戳
+     */
+    KEY_FRAME_TS_VECTOR keyFrameTSVec;
+} TrackIndex;
+
+static TrackIndex sTrackIndex[MAX_TRACK_COUNT];
+// 视频轨道的帧索引及关键帧时间戳容器
+static FRAME_INDEX_MAP &sFrameIndexMap = sTrackIndex[TRACK_VIDEO].frameIndexMap;
+static KEY_FRAME_TS_VECTOR &sKeyFrameTSVec = sTrackIndex[TRACK_VIDEO].keyFrameTSVec;
+
+static SAMPLE_INDEX_MAP sSampleIndexMap;
+static FRAME_WRITE_QUEUE sFrameWriteQueue;
 
 static unsigned char *s_pCurPos = nullptr;
-static unsigned char *s_pFreePos = nullptr; //当前释放的位置
+// 已被帧数据占用的空间大小
+static long s_nUsedSize = 0;
 
 static bool printDebugLog = false;
 
+// 从未被读取过就被淘汰的帧数，即读取方跟不上写入时丢失的帧
+static std::atomic<long> sEvictedUnreadCount(0);
+
 // 默认分配大小
 static long sMaxDataBuf = 1; // 30M
 
@@ -73,12 +123,14 @@ public:
 
 public:
     void lock_read() {
+        TRACE_SCOPE("lockWait(read)");
         std::unique_lock <std::mutex> ulk(counter_mutex);
         cond_r.wait(ulk, [=]() -> bool { return write_cnt == 0; });
         ++read_cnt;
     }
 
     void lock_write() {
+        TRACE_SCOPE("lockWait(write)");
         std::unique_lock <std::mutex> ulk(counter_mutex);
         ++write_cnt;
         cond_w.wait(ulk, [=]() -> bool { return read_cnt == 0 && !inWriteFlag; });
@@ -159,6 +211,71 @@ private:
 
 static WFirstRWLock s_Lock;
 
+/**
+ * 清空所有轨道的帧索引
+ */
+static void clearIndex() {
+    for (int i = 0; i < MAX_TRACK_COUNT; i++) {
+        sTrackIndex[i].frameIndexMap.clear();
+        sTrackIndex[i].keyFrameTSVec.clear();
+    }
+    sSampleIndexMap.clear();
+    sFrameWriteQueue.clear();
+    s_nUsedSize = 0;
+}
+
+/**
+ * 获取帧数据在buffer中的分段，跨越buffer尾部的帧分为尾部和头部两段
+ */
+static void getFrameIovec(FrameIndex &item, struct iovec *data) {
+    item._isReadFlag.store(true, std::memory_order_relaxed);
+    long tailLen = (s_pMemBuf + sMaxDataBuf) - item._pBuf;
+    data[0].iov_base = item._pBuf;
+    if (item._nLen <= tailLen) {
+        data[0].iov_len = (size_t) item._nLen;
+        data[1].iov_base = nullptr;
+        data[1].iov_len = 0;
+    } else {
+        data[0].iov_len = (size_t) tailLen;
+        data[1].iov_base = s_pMemBuf;
+        data[1].iov_len = (size_t) (item._nLen - tailLen);
+    }
+}
+
+/**
+ * 清空帧数据分段
+ */
+static void clearFrameIovec(struct iovec *data) {
+    for (int i = 0; i < FRAME_IOV_COUNT; i++) {
+        data[i].iov_base = nullptr;
+        data[i].iov_len = 0;
+    }
+}
+
+/**
+ * 淘汰最早写入的一帧数据，需在写锁内调用
+ */
+static void eraseOldestFrame() {
+    TRACE_SCOPE("evict");
+    std::shared_ptr <FrameIndex> item = sFrameWriteQueue.front();
+    sFrameWriteQueue.pop_front();
+    s_nUsedSize -= item->_nLen;
+    if (!item->_isReadFlag.load(std::memory_order_relaxed)) {
+        sEvictedUnreadCount++;
+    }
+    TrackIndex &track = sTrackIndex[item->_trackId];
+    FRAME_INDEX_MAP_ITERATOR iterFrame = track.frameIndexMap.find(item->_timestamp);
+    if (iterFrame != track.frameIndexMap.end() && iterFrame->second == item) {
+        track.frameIndexMap.erase(iterFrame);
+        sSampleIndexMap.erase(SAMPLE_KEY(item->_timestamp, item->_trackId));
+    }
+    if (item->_isKeyFrame) {
+        track.keyFrameTSVec.erase(std::remove(track.keyFrameTSVec.begin(),
+                                              track.keyFrameTSVec.end(), item->_timestamp),
+                                  track.keyFrameTSVec.end());
+    }
+}
+
 void init(int cacheSize, bool isDebug) {
     int finalSize = 30;
     if (cacheSize > 0 && cacheSize < 100) {
@@ -170,17 +287,15 @@ void init(int cacheSize, bool isDebug) {
         s_pMemBuf = new unsigned char[sMaxDataBuf];
     }
     printDebugLog = isDebug;
+    sEvictedUnreadCount = 0;
     s_pCurPos = s_pMemBuf;
-    s_pFreePos = s_pMemBuf + sMaxDataBuf - 1;
-    sFrameIndexMap.clear();
-    sKeyFrameTSVec.clear();
+    clearIndex();
     //s_mapBufTm.clear();
     LOGI("data cache size: %dM", cacheSize);
 }
 
 void UnInit() {
-    sKeyFrameTSVec.clear();
-    sFrameIndexMap.clear();
+    clearIndex();
 
     s_pCurPos = nullptr;
 
@@ -191,77 +306,69 @@ void UnInit() {
 }
 
 void addFrame(int64 timestamp, bool isKeyFrame, unsigned char *puf, int nLen) {
+    addTrackFrame(TRACK_VIDEO, timestamp, isKeyFrame, puf, nLen);
+}
+
+void addTrackFrame(int trackId, int64 timestamp, bool isKeyFrame, unsigned char *puf, int nLen) {
     if (printDebugLog) {
-        LOGI("data cache add frame start: timestamp -> %lld isKeyFrame -> %d  length -> %d", timestamp,
-             isKeyFrame, nLen);
+        LOGI("data cache add frame start: trackId -> %d timestamp -> %lld isKeyFrame -> %d  length -> %d",
+             trackId, timestamp, isKeyFrame, nLen);
     }
-    if (sFrameIndexMap.size() > 0 && sKeyFrameTSVec.size() > 0
-        && sFrameIndexMap.begin()->first > *sKeyFrameTSVec.begin()) {
-        LOGI("*****************************begin sFrameIndexMap.begin()->first > *sKeyFrameTSVec.begin()");
+    if (trackId < 0 || trackId >= MAX_TRACK_COUNT || nLen <= 0 || nLen > sMaxDataBuf) {
+        LOGE("invalid frame: trackId -> %d length -> %d", trackId, nLen);
+        return;
     }
     unique_writeguard<WFirstRWLock> writeLock(s_Lock);
-    if ((s_pCurPos + nLen) > (s_pMemBuf + sMaxDataBuf)) {
-        LOGI("buffer have full, start erase data ");
-        //当前要存储的空间不足,从头开始
-        FRAME_INDEX_MAP_ITERATOR iterFrame = sFrameIndexMap.begin(), _endFrame = sFrameIndexMap.end();
-        for (; iterFrame != _endFrame;) {
-            if (iterFrame->second->_pBuf >= s_pCurPos &&
-                iterFrame->second->_pBuf < (s_pCurPos + nLen)) {
-                if (iterFrame->second->_isKeyFrame) {
-                    sKeyFrameTSVec.erase(std::remove(
-                            sKeyFrameTSVec.begin(), sKeyFrameTSVec.end(), iterFrame->first),
-                                         sKeyFrameTSVec.end());
-                }
-                iterFrame = sFrameIndexMap.erase(iterFrame);
-            } else {
-                break;
-            }
-        }
-        s_pCurPos = s_pMemBuf;
-        s_pFreePos = s_pCurPos;
+    // 环形缓存中空闲区域从s_pCurPos开始，按写入顺序淘汰最早的帧直到空闲空间足够
+    while (!sFrameWriteQueue.empty() && (sMaxDataBuf - s_nUsedSize) < nLen) {
+        eraseOldestFrame();
     }
-    if ((s_pCurPos + nLen) > s_pFreePos) {
-        unsigned char *nFreePos = s_pFreePos;
-        FRAME_INDEX_MAP_ITERATOR iterFrame = sFrameIndexMap.begin(), _endFrame = sFrameIndexMap.end();
-        for (; iterFrame != _endFrame;) {
-            if (iterFrame->second->_pBuf >= s_pCurPos &&
-                iterFrame->second->_pBuf < (s_pCurPos + nLen)) {
-                nFreePos += iterFrame->second->_nLen;
-                if (iterFrame->second->_isKeyFrame) {
-                    sKeyFrameTSVec.erase(
-                            std::remove(sKeyFrameTSVec.begin(), sKeyFrameTSVec.end(),
-                                        iterFrame->first), sKeyFrameTSVec.end());
-                }
-                iterFrame = sFrameIndexMap.erase(iterFrame);
-            } else {
-                break;
-            }
-        }
-        s_pFreePos = nFreePos;
+    std::shared_ptr <FrameIndex> item(
+            new FrameIndex(timestamp, trackId, s_pCurPos, nLen, isKeyFrame, false));
+    TrackIndex &track = sTrackIndex[trackId];
+    if (!track.frameIndexMap.insert(std::make_pair(timestamp, item)).second) {
+        LOGE("frame already exists: trackId -> %d timestamp -> %lld", trackId, timestamp);
+        return;
     }
-    std::shared_ptr <FrameIndex> item(new FrameIndex(s_pCurPos, nLen, isKeyFrame, false));
     if (isKeyFrame) {
-        sKeyFrameTSVec.push_back(timestamp);
+        track.keyFrameTSVec.push_back(timestamp);
+    }
+    long tailLen = (s_pMemBuf + sMaxDataBuf) - s_pCurPos;
+    {
+        TRACE_SCOPE("memcpy");
+        if (nLen < tailLen) {
+            memcpy(s_pCurPos, puf, nLen);
+            s_pCurPos += nLen;
+        } else {
+            // 尾部剩余空间不足，超出部分从buffer头部继续存储
+            memcpy(s_pCurPos, puf, tailLen);
+            memcpy(s_pMemBuf, puf + tailLen, nLen - tailLen);
+            s_pCurPos = s_pMemBuf + (nLen - tailLen);
+        }
     }
-    memcpy(s_pCurPos, puf, nLen);
-    sFrameIndexMap.insert(std::make_pair(timestamp, item));
-    s_pCurPos += nLen;
+    s_nUsedSize += nLen;
+    sSampleIndexMap.insert(std::make_pair(SAMPLE_KEY(timestamp, trackId), item));
+    sFrameWriteQueue.push_back(item);
 }
 
-int getFirstFrame(int64 timestamp, int64 &curTimestamp, unsigned char *&data, int &nLen) {
+int getFirstFrame(int64 timestamp, int64 &curTimestamp, struct iovec *data, int &nLen) {
     unique_readguard<WFirstRWLock> readLock(s_Lock);
 
     KEY_FRAME_TS_VECTOR_CONST_ITERATOR iterKeyFrame = std::lower_bound(sKeyFrameTSVec.begin(),
                                                                        sKeyFrameTSVec.end(),
                                                                        timestamp);
     if (iterKeyFrame != sKeyFrameTSVec.end()) {
-        LOGI("get First frame iterKeyFrame 1:%lld", *iterKeyFrame);
+        if (printDebugLog) {
+            LOGI("get First frame iterKeyFrame 1:%lld", *iterKeyFrame);
+        }
 
         FRAME_INDEX_MAP_CONST_ITERATOR iterFrame = sFrameIndexMap.find(*iterKeyFrame);
         if (iterFrame != sFrameIndexMap.end()) {
-            LOGI("get First frame iterKeyFrame 2:%lld", iterFrame->first);
+            if (printDebugLog) {
+                LOGI("get First frame iterKeyFrame 2:%lld", iterFrame->first);
+            }
             nLen = iterFrame->second->_nLen;
-            data = iterFrame->second->_pBuf;
+            getFrameIovec(*iterFrame->second, data);
             curTimestamp = *iterKeyFrame;
             return 0;
         }
@@ -271,25 +378,27 @@ int getFirstFrame(int64 timestamp, int64 &curTimestamp, unsigned char *&data, in
                     *sKeyFrameTSVec.begin());
             if (iterFrame != sFrameIndexMap.end()) {
                 nLen = iterFrame->second->_nLen;
-                data = iterFrame->second->_pBuf;
+                getFrameIovec(*iterFrame->second, data);
                 curTimestamp = *iterKeyFrame;
                 return 0;
             }
         }
     }
     nLen = 0;
-    data = nullptr;
-    LOGI("get First frame time :%lld minTime:%lld maxTime:%lld", timestamp,
-         sKeyFrameTSVec.begin() != sKeyFrameTSVec.end() ? *sKeyFrameTSVec.begin() : 0,
-         sKeyFrameTSVec.rbegin() != sKeyFrameTSVec.rend() ? *sKeyFrameTSVec.rbegin() : 0);
-    FRAME_INDEX_MAP_ITERATOR iterFrame = sFrameIndexMap.begin(), _endFrame = sFrameIndexMap.end();
-    for (; iterFrame != _endFrame; ++iterFrame) {
-        LOGI("get First frame iterKeyFrame :%lld", iterFrame->first);
+    clearFrameIovec(data);
+    if (printDebugLog) {
+        LOGI("get First frame time :%lld minTime:%lld maxTime:%lld", timestamp,
+             sKeyFrameTSVec.begin() != sKeyFrameTSVec.end() ? *sKeyFrameTSVec.begin() : 0,
+             sKeyFrameTSVec.rbegin() != sKeyFrameTSVec.rend() ? *sKeyFrameTSVec.rbegin() : 0);
+        FRAME_INDEX_MAP_ITERATOR iterFrame = sFrameIndexMap.begin(), _endFrame = sFrameIndexMap.end();
+        for (; iterFrame != _endFrame; ++iterFrame) {
+            LOGI("get First frame iterKeyFrame :%lld", iterFrame->first);
+        }
     }
     return 1;
 }
 
-int getNextFrame(int64 preTimestamp, int64 &curTimestamp, unsigned char *&data,
+int getNextFrame(int64 preTimestamp, int64 &curTimestamp, struct iovec *data,
                  int &len, bool &isKeyFrame) {
     unique_readguard<WFirstRWLock> readLock(s_Lock);
     FRAME_INDEX_MAP_CONST_ITERATOR iterFrame = sFrameIndexMap.find(preTimestamp);
@@ -299,17 +408,93 @@ int getNextFrame(int64 preTimestamp, int64 &curTimestamp, unsigned char *&data,
             len = iterFrame->second->_nLen;
             isKeyFrame = iterFrame->second->_isKeyFrame;
             curTimestamp = iterFrame->first;
-            data = iterFrame->second->_pBuf;
-            if (data + len > s_pMemBuf + sMaxDataBuf) {
-                LOGE("data + nLen > s_pMemBuf + sMaxDataBuf ");
-            }
+            getFrameIovec(*iterFrame->second, data);
+            return 0;
+        }
+        len = 0;
+        clearFrameIovec(data);
+        return 2;
+    }
+    len = 0;
+    clearFrameIovec(data);
+    return 1;
+}
+
+int getNextKeyFrame(int64 preTimestamp, int64 &curTimestamp, struct iovec *data, int &len) {
+    unique_readguard<WFirstRWLock> readLock(s_Lock);
+    KEY_FRAME_TS_VECTOR_CONST_ITERATOR iterKeyFrame = std::upper_bound(sKeyFrameTSVec.begin(),
+                                                                       sKeyFrameTSVec.end(),
+                                                                       preTimestamp);
+    if (iterKeyFrame != sKeyFrameTSVec.end()) {
+        FRAME_INDEX_MAP_CONST_ITERATOR iterFrame = sFrameIndexMap.find(*iterKeyFrame);
+        if (iterFrame != sFrameIndexMap.end()) {
+            len = iterFrame->second->_nLen;
+            curTimestamp = iterFrame->first;
+            getFrameIovec(*iterFrame->second, data);
             return 0;
         }
         len = 0;
-        data = nullptr;
+        clearFrameIovec(data);
+        return 1;
+    }
+    len = 0;
+    clearFrameIovec(data);
+    return 2;
+}
+
+int getFirstSample(int64 timestamp, int64 &curTimestamp, int &trackId, struct iovec *data,
+                   int &nLen) {
+    // 交织读取从视频关键帧开始，保证导出的文件可以直接解码
+    int res = getFirstFrame(timestamp, curTimestamp, data, nLen);
+    trackId = TRACK_VIDEO;
+    return res;
+}
+
+int getNextSample(int64 preTimestamp, int preTrackId, int64 &curTimestamp, int &trackId,
+                  struct iovec *data, int &len, bool &isKeyFrame) {
+    unique_readguard<WFirstRWLock> readLock(s_Lock);
+    SAMPLE_INDEX_MAP_CONST_ITERATOR iterSample = sSampleIndexMap.find(
+            SAMPLE_KEY(preTimestamp, preTrackId));
+    if (iterSample != sSampleIndexMap.end()) {
+        ++iterSample;
+        if (iterSample != sSampleIndexMap.end()) {
+            len = iterSample->second->_nLen;
+            isKeyFrame = iterSample->second->_isKeyFrame;
+            curTimestamp = iterSample->first.first;
+            trackId = iterSample->first.second;
+            getFrameIovec(*iterSample->second, data);
+            return 0;
+        }
+        len = 0;
+        clearFrameIovec(data);
         return 2;
     }
     len = 0;
-    data = nullptr;
+    clearFrameIovec(data);
     return 1;
 }
+
+void copyFrameData(const struct iovec *data, unsigned char *dst) {
+    TRACE_SCOPE("memcpy");
+    for (int i = 0; i < FRAME_IOV_COUNT; i++) {
+        if (data[i].iov_len > 0) {
+            memcpy(dst, data[i].iov_base, data[i].iov_len);
+            dst += data[i].iov_len;
+        }
+    }
+}
+
+bool isFrameValid(int trackId, int64 timestamp, const struct iovec *data) {
+    if (trackId < 0 || trackId >= MAX_TRACK_COUNT) {
+        return false;
+    }
+    // 写入线程只覆盖已淘汰的帧，且淘汰在写锁内完成，帧仍在索引中说明读取期间没有被覆盖
+    unique_readguard<WFirstRWLock> readLock(s_Lock);
+    const FRAME_INDEX_MAP &frameIndexMap = sTrackIndex[trackId].frameIndexMap;
+    FRAME_INDEX_MAP_CONST_ITERATOR iterFrame = frameIndexMap.find(timestamp);
+    return iterFrame != frameIndexMap.end() && iterFrame->second->_pBuf == data[0].iov_base;
+}
+
+long getEvictedUnreadCount() {
+    return sEvictedUnreadCount.load();
+}
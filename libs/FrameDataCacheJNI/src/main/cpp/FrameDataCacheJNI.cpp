@@ -1,14 +1,37 @@
 #include <cstring>
 #include "FrameDataCacheJNI.h"
+#include "CacheTrace.h"
+
+/**
+ * JNI_OnLoad 中缓存的 java/lang/Exception 全局引用，避免每次抛异常都 FindClass
+ */
+static jclass sExceptionClass = nullptr;
+
+/**
+ * initCache 传入的debug标志，非debug时不输出每次读取的日志
+ */
+static bool sDebugLog = false;
 
 /**
  * 动态注册
  */
 JNINativeMethod methods[] = {
-        {"initCache",         "(IZ)V",        (void *) initCache},
-        {"addFrameData",      "(JZ[BI)V",     (void *) addFrameData},
-        {"getFirstFrameData", "(J[J[B[I)I",   (jint *) getFirstFrameData},
-        {"getNextFrameData",  "(J[J[B[I[Z)I", (jint *) getNextFrameData}
+        {"initCache",           "(IZ)V",           (void *) initCache},
+        {"addFrameData",        "(JZ[BI)V",        (void *) addFrameData},
+        {"addFrameData",        "(JZLjava/nio/ByteBuffer;II)V", (void *) addFrameDataDirect},
+        {"getFirstFrameData",   "(J[J[B[I)I",      (jint *) getFirstFrameData},
+        {"getNextFrameData",    "(J[J[B[I[Z)I",    (jint *) getNextFrameData},
+        {"getNextKeyFrameData", "(J[J[B[I)I",      (jint *) getNextKeyFrameData},
+        {"addTrackFrameData",   "(IJZ[BI)V",       (void *) addTrackFrameData},
+        {"getFirstSampleData",  "(J[J[I[B[I)I",    (jint *) getFirstSampleData},
+        {"getNextSampleData",   "(JI[J[I[B[I[Z)I", (jint *) getNextSampleData},
+        {"setTraceEnabled",     "(Z)V",            (void *) setTraceEnabled},
+        {"dumpTrace",           "(Ljava/lang/String;)I", (jint *) dumpTrace}
+};
+
+JNINativeMethod seiMethods[] = {
+        {"injectTimestampSei", "(ZJ[BI[B)I", (jint *) injectTimestampSeiData},
+        {"parseTimestampSei",  "(Z[BI)J",    (jlong *) parseTimestampSeiData}
 };
 
 /**
@@ -21,6 +44,10 @@ jint registerNativeMethod(JNIEnv *env) {
     if ((env->RegisterNatives(cl, methods, sizeof(methods) / sizeof(methods[0]))) < 0) {
         return JNI_ERR;
     }
+    jclass seiCl = env->FindClass(TIMESTAMP_SEI_UTILS_JAVA);
+    if ((env->RegisterNatives(seiCl, seiMethods, sizeof(seiMethods) / sizeof(seiMethods[0]))) < 0) {
+        return JNI_ERR;
+    }
     return JNI_OK;
 }
 
@@ -35,6 +62,9 @@ jint JNI_OnLoad(JavaVM *vm, void *reserved) {
     if (vm->GetEnv((void **) &env, JNI_VERSION_1_6) != JNI_OK) {
         return JNI_ERR;
     }
+    jclass exceptionClass = env->FindClass("java/lang/Exception");
+    sExceptionClass = (jclass) env->NewGlobalRef(exceptionClass);
+    env->DeleteLocalRef(exceptionClass);
     //注册方法
     if (registerNativeMethod(env) != JNI_OK) {
         return JNI_ERR;
@@ -50,45 +80,102 @@ void JNI_OnUnload(JavaVM *jvm, void *reserved) {
     }
     jclass clazz = env->FindClass(DATA_CACHE_UTILS_JAVA);
     env->UnregisterNatives(clazz);
+    jclass seiClazz = env->FindClass(TIMESTAMP_SEI_UTILS_JAVA);
+    env->UnregisterNatives(seiClazz);
+    env->DeleteGlobalRef(sExceptionClass);
+    sExceptionClass = nullptr;
+}
+
+/**
+ * 将分段存储的帧数据拷贝到java数组中
+ *
+ * 读锁已释放，拷贝期间写入线程可能淘汰并覆盖该帧，拷贝后重新检查，被覆盖时按无效处理
+ *
+ * @return 0成功 1帧已被覆盖 RES_BUFFER_TOO_SMALL java数组小于帧长度（不写入数据）
+ */
+static jint setFrameDataRegion(JNIEnv *env, jbyteArray buf, int trackId, int64 timestamp,
+                               const struct iovec *frameData, int len) {
+    TRACE_SCOPE("memcpy");
+    if (buf == nullptr || env->GetArrayLength(buf) < len) {
+        LOGE("frame data buffer too small, need %d", len);
+        return RES_BUFFER_TOO_SMALL;
+    }
+    jsize offset = 0;
+    for (int i = 0; i < FRAME_IOV_COUNT; i++) {
+        if (frameData[i].iov_len > 0) {
+            env->SetByteArrayRegion(buf, offset, (jsize) frameData[i].iov_len,
+                                    (const jbyte *) frameData[i].iov_base);
+            offset += (jsize) frameData[i].iov_len;
+        }
+    }
+    if (!isFrameValid(trackId, timestamp, frameData)) {
+        LOGE("frame %lld overwritten while copying", timestamp);
+        return 1;
+    }
+    return 0;
 }
 
 void initCache(JNIEnv *env, jobject obj, jint cacheSize, jboolean isDebug) {
+    TRACE_SCOPE(__func__);
+    sDebugLog = isDebug;
     init(cacheSize, isDebug);
 }
 
 void addFrameData(JNIEnv *env, jobject obj, jlong timeSptamp, jboolean bKeyFrame, jbyteArray buf,
                   jint len) {
-    jbyte *frameBuffer = env->GetByteArrayElements(buf, 0);
+    TRACE_SCOPE(__func__);
+    if (buf == nullptr || len < 0 || len > env->GetArrayLength(buf)) {
+        env->ThrowNew(sExceptionClass, "need valid frame data length");
+        return;
+    }
+    // addFrame 可能等待写锁，不能在 critical 区内等待，否则会阻塞GC
+    jbyte *frameBuffer = env->GetByteArrayElements(buf, nullptr);
+    if (frameBuffer == nullptr) {
+        return;
+    }
 
     addFrame(timeSptamp, bKeyFrame, (unsigned char *) frameBuffer, len);
 
-    env->ReleaseByteArrayElements(buf, frameBuffer, 0);
+    env->ReleaseByteArrayElements(buf, frameBuffer, JNI_ABORT);
 
     throw_java_exception(env, "Add frame Exception");
 }
 
+void addFrameDataDirect(JNIEnv *env, jobject obj, jlong timeSptamp, jboolean bKeyFrame,
+                        jobject buf, jint offset, jint len) {
+    TRACE_SCOPE(__func__);
+    unsigned char *frameBuffer = (unsigned char *) env->GetDirectBufferAddress(buf);
+    if (frameBuffer == nullptr || offset < 0 || len < 0 ||
+        (jlong) offset + len > env->GetDirectBufferCapacity(buf)) {
+        env->ThrowNew(sExceptionClass, "need direct ByteBuffer and valid offset, length");
+        return;
+    }
+
+    // 直接从 MediaCodec OutputBuffer 等 native 内存拷入缓存，不经过 java 数组
+    addFrame(timeSptamp, bKeyFrame, frameBuffer + offset, len);
+}
+
 jint getFirstFrameData(JNIEnv *env, jobject obj, jlong timeSptamp_, jlongArray curTimestamp_,
                        jbyteArray buf_, jintArray len_) {
-    jlong *curTimestamp = env->GetLongArrayElements(curTimestamp_, 0);
-    jbyte *frameBuffer = env->GetByteArrayElements(buf_, 0);
-    jint *len = env->GetIntArrayElements(len_, 0);
-
+    TRACE_SCOPE(__func__);
     int64 cCurTimestamp;
-    unsigned char *frameData;
+    struct iovec frameData[FRAME_IOV_COUNT];
     int cLen;
     jint res = getFirstFrame(timeSptamp_, cCurTimestamp, frameData, cLen);
     if (res != 0) {
         LOGE("getFirstFrame res failed %d", res);
         return res;
     }
-    LOGI("getFirstFrame find success: cCurTimestamp -> %lld , size -> %d", cCurTimestamp, cLen);
-    memcpy(frameBuffer, frameData, cLen);
-    curTimestamp[0] = cCurTimestamp;
-    len[0] = cLen;
-
-    env->ReleaseLongArrayElements(curTimestamp_, curTimestamp, 0);
-    env->ReleaseByteArrayElements(buf_, frameBuffer, 0);
-    env->ReleaseIntArrayElements(len_, len, 0);
+    if (sDebugLog) {
+        LOGI("getFirstFrame find success: cCurTimestamp -> %lld , size -> %d", cCurTimestamp, cLen);
+    }
+    res = setFrameDataRegion(env, buf_, TRACK_VIDEO, cCurTimestamp, frameData, cLen);
+    if (res != 0) {
+        return res;
+    }
+    jlong jCurTimestamp = cCurTimestamp;
+    env->SetLongArrayRegion(curTimestamp_, 0, 1, &jCurTimestamp);
+    env->SetIntArrayRegion(len_, 0, 1, &cLen);
 
     throw_java_exception(env, "get first frame Exception");
     return res;
@@ -96,35 +183,190 @@ jint getFirstFrameData(JNIEnv *env, jobject obj, jlong timeSptamp_, jlongArray c
 
 jint getNextFrameData(JNIEnv *env, jobject obj, jlong preTimestamp_, jlongArray curTimestamp_,
                       jbyteArray buf_, jintArray len_, jbooleanArray isKeyFrame_) {
-    jlong *curTimestamp = env->GetLongArrayElements(curTimestamp_, 0);
-    jbyte *frameBuffer = env->GetByteArrayElements(buf_, 0);
-    jint *len = env->GetIntArrayElements(len_, 0);
-    jboolean *isKeyFrame = env->GetBooleanArrayElements(isKeyFrame_, 0);
-
+    TRACE_SCOPE(__func__);
     int64 cCurTimestamp;
-    unsigned char *frameData;
+    struct iovec frameData[FRAME_IOV_COUNT];
     int cLen;
     bool cIsKeyFrame;
     jint res = getNextFrame(preTimestamp_, cCurTimestamp, frameData, cLen, cIsKeyFrame);
+    if (res != 0) {
+        return res;
+    }
+    res = setFrameDataRegion(env, buf_, TRACK_VIDEO, cCurTimestamp, frameData, cLen);
+    if (res != 0) {
+        return res;
+    }
+    jlong jCurTimestamp = cCurTimestamp;
+    jboolean jIsKeyFrame = (jboolean) cIsKeyFrame;
+    env->SetLongArrayRegion(curTimestamp_, 0, 1, &jCurTimestamp);
+    env->SetIntArrayRegion(len_, 0, 1, &cLen);
+    env->SetBooleanArrayRegion(isKeyFrame_, 0, 1, &jIsKeyFrame);
 
-    memcpy(frameBuffer, frameData, cLen);
-    curTimestamp[0] = cCurTimestamp;
-    len[0] = cLen;
-    isKeyFrame[0] = cIsKeyFrame;
+    throw_java_exception(env, "get next frame Exception");
+    return res;
+}
 
-    env->ReleaseLongArrayElements(curTimestamp_, curTimestamp, 0);
-    env->ReleaseByteArrayElements(buf_, frameBuffer, 0);
-    env->ReleaseIntArrayElements(len_, len, 0);
-    env->ReleaseBooleanArrayElements(isKeyFrame_, isKeyFrame, 0);
+jint getNextKeyFrameData(JNIEnv *env, jobject obj, jlong preTimestamp_, jlongArray curTimestamp_,
+                         jbyteArray buf_, jintArray len_) {
+    TRACE_SCOPE(__func__);
+    int64 cCurTimestamp;
+    struct iovec frameData[FRAME_IOV_COUNT];
+    int cLen;
+    jint res = getNextKeyFrame(preTimestamp_, cCurTimestamp, frameData, cLen);
+    if (res != 0) {
+        return res;
+    }
+    res = setFrameDataRegion(env, buf_, TRACK_VIDEO, cCurTimestamp, frameData, cLen);
+    if (res != 0) {
+        return res;
+    }
+    jlong jCurTimestamp = cCurTimestamp;
+    env->SetLongArrayRegion(curTimestamp_, 0, 1, &jCurTimestamp);
+    env->SetIntArrayRegion(len_, 0, 1, &cLen);
 
-    throw_java_exception(env, "get next frame Exception");
+    throw_java_exception(env, "get next key frame Exception");
+    return res;
+}
+
+void addTrackFrameData(JNIEnv *env, jobject obj, jint trackId, jlong timestamp, jboolean bKeyFrame,
+                       jbyteArray buf, jint len) {
+    TRACE_SCOPE(__func__);
+    if (buf == nullptr || len < 0 || len > env->GetArrayLength(buf)) {
+        env->ThrowNew(sExceptionClass, "need valid frame data length");
+        return;
+    }
+    // 与 addFrameData 相同，等待写锁期间不能持有 critical 区
+    jbyte *frameBuffer = env->GetByteArrayElements(buf, nullptr);
+    if (frameBuffer == nullptr) {
+        return;
+    }
+
+    addTrackFrame(trackId, timestamp, bKeyFrame, (unsigned char *) frameBuffer, len);
+
+    env->ReleaseByteArrayElements(buf, frameBuffer, JNI_ABORT);
+
+    throw_java_exception(env, "Add track frame Exception");
+}
+
+jint getFirstSampleData(JNIEnv *env, jobject obj, jlong timestamp_, jlongArray curTimestamp_,
+                        jintArray trackId_, jbyteArray buf_, jintArray len_) {
+    TRACE_SCOPE(__func__);
+    int64 cCurTimestamp;
+    int cTrackId;
+    struct iovec frameData[FRAME_IOV_COUNT];
+    int cLen;
+    jint res = getFirstSample(timestamp_, cCurTimestamp, cTrackId, frameData, cLen);
+    if (res != 0) {
+        LOGE("getFirstSample res failed %d", res);
+        return res;
+    }
+    res = setFrameDataRegion(env, buf_, cTrackId, cCurTimestamp, frameData, cLen);
+    if (res != 0) {
+        return res;
+    }
+    jlong jCurTimestamp = cCurTimestamp;
+    env->SetLongArrayRegion(curTimestamp_, 0, 1, &jCurTimestamp);
+    env->SetIntArrayRegion(trackId_, 0, 1, &cTrackId);
+    env->SetIntArrayRegion(len_, 0, 1, &cLen);
+
+    throw_java_exception(env, "get first sample Exception");
     return res;
 }
 
+jint getNextSampleData(JNIEnv *env, jobject obj, jlong preTimestamp_, jint preTrackId_,
+                       jlongArray curTimestamp_, jintArray trackId_, jbyteArray buf_,
+                       jintArray len_, jbooleanArray isKeyFrame_) {
+    TRACE_SCOPE(__func__);
+    int64 cCurTimestamp;
+    int cTrackId;
+    struct iovec frameData[FRAME_IOV_COUNT];
+    int cLen;
+    bool cIsKeyFrame;
+    jint res = getNextSample(preTimestamp_, preTrackId_, cCurTimestamp, cTrackId, frameData, cLen,
+                             cIsKeyFrame);
+    if (res != 0) {
+        return res;
+    }
+    res = setFrameDataRegion(env, buf_, cTrackId, cCurTimestamp, frameData, cLen);
+    if (res != 0) {
+        return res;
+    }
+    jlong jCurTimestamp = cCurTimestamp;
+    jboolean jIsKeyFrame = (jboolean) cIsKeyFrame;
+    env->SetLongArrayRegion(curTimestamp_, 0, 1, &jCurTimestamp);
+    env->SetIntArrayRegion(trackId_, 0, 1, &cTrackId);
+    env->SetIntArrayRegion(len_, 0, 1, &cLen);
+    env->SetBooleanArrayRegion(isKeyFrame_, 0, 1, &jIsKeyFrame);
+
+    throw_java_exception(env, "get next sample Exception");
+    return res;
+}
+
+jint injectTimestampSeiData(JNIEnv *env, jobject obj, jboolean isHevc, jlong timestamp,
+                            jbyteArray src_, jint srcLen, jbyteArray dst_) {
+    TRACE_SCOPE(__func__);
+    if (src_ == nullptr || dst_ == nullptr || srcLen < 0 || srcLen > env->GetArrayLength(src_)) {
+        LOGE("injectTimestampSei invalid src length %d", srcLen);
+        return -1;
+    }
+    if (env->GetArrayLength(dst_) < (jlong) srcLen + TIMESTAMP_SEI_MAX_SIZE) {
+        LOGE("injectTimestampSei dst buffer too small");
+        return -1;
+    }
+    jbyte *src = (jbyte *) env->GetPrimitiveArrayCritical(src_, nullptr);
+    jbyte *dst = (jbyte *) env->GetPrimitiveArrayCritical(dst_, nullptr);
+
+    jint res = injectTimestampSei(isHevc, timestamp, (const unsigned char *) src, srcLen,
+                                  (unsigned char *) dst);
+
+    env->ReleasePrimitiveArrayCritical(src_, src, JNI_ABORT);
+    env->ReleasePrimitiveArrayCritical(dst_, dst, 0);
+
+    throw_java_exception(env, "inject timestamp sei Exception");
+    return res;
+}
+
+jlong parseTimestampSeiData(JNIEnv *env, jobject obj, jboolean isHevc, jbyteArray data_,
+                            jint len) {
+    TRACE_SCOPE(__func__);
+    if (data_ == nullptr || len < 0 || len > env->GetArrayLength(data_)) {
+        LOGE("parseTimestampSei invalid length %d", len);
+        return -1;
+    }
+    jbyte *data = (jbyte *) env->GetPrimitiveArrayCritical(data_, nullptr);
+
+    int64 timestamp = -1;
+    if (parseTimestampSei(isHevc, (const unsigned char *) data, len, timestamp) != 0) {
+        timestamp = -1;
+    }
+
+    env->ReleasePrimitiveArrayCritical(data_, data, JNI_ABORT);
+
+    throw_java_exception(env, "parse timestamp sei Exception");
+    return timestamp;
+}
+
+void setTraceEnabled(JNIEnv *env, jobject obj, jboolean enabled) {
+    cachetrace::setTraceEnabled(enabled);
+}
+
+jint dumpTrace(JNIEnv *env, jobject obj, jstring path_) {
+    if (path_ == nullptr) {
+        env->ThrowNew(sExceptionClass, "invalid trace path");
+        return -1;
+    }
+    const char *path = env->GetStringUTFChars(path_, nullptr);
+    if (path == nullptr) {
+        return -1;
+    }
+    int count = cachetrace::dumpTrace(path);
+    env->ReleaseStringUTFChars(path_, path);
+    return count;
+}
+
 void throw_java_exception(JNIEnv *env, const char *msg) {
     if (env->ExceptionCheck()) {
         env->ExceptionClear();
-        jclass cException = env->FindClass("java/lang/Exception");
-        env->ThrowNew(cException, msg);
+        env->ThrowNew(sExceptionClass, msg);
     }
 }
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "TimestampSei.h"
+
+#include <cstring>
+
+// H.264 SEI NAL类型
+#define AVC_NAL_SEI 6
+// H.265 前缀SEI NAL类型
+#define HEVC_NAL_PREFIX_SEI 39
+// SEI payload类型：user_data_unregistered
+#define SEI_USER_DATA_UNREGISTERED 5
+// 时间戳占用的字节数（大端序）
+#define TIMESTAMP_BYTES 8
+
+/**
+ * 时间戳SEI的UUID，用于和编码器或其他工具写入的user data区分
+ */
+static const unsigned char TIMESTAMP_SEI_UUID[16] = {
+        0x6c, 0x6b, 0x6c, 0x2d, 0x61, 0x74, 0x61, 0x74,
+        0x9e, 0x3a, 0x4d, 0x1c, 0xb2, 0x57, 0x0f, 0xd4
+};
+
+/**
+ * 查找下一个起始码（00 00 01 或 00 00 00 01）
+ *
+ * @param data 数据
+ * @param pos 开始查找的位置
+ * @param len 数据长度
+ * @param codeLen 找到的起始码长度
+ * @return 起始码的位置，没找到返回len
+ */
+static int findStartCode(const unsigned char *data, int pos, int len, int &codeLen) {
+    for (int i = pos; i + 2 < len; i++) {
+        if (data[i] == 0 && data[i + 1] == 0) {
+            if (data[i + 2] == 1) {
+                codeLen = (i > pos && data[i - 1] == 0) ? 4 : 3;
+                return codeLen == 4 ? i - 1 : i;
+            }
+            if (data[i + 2] != 0) {
+                i += 2;
+            }
+        }
+    }
+    codeLen = 0;
+    return len;
+}
+
+static int nalType(bool isHevc, unsigned char header) {
+    return isHevc ? (header >> 1) & 0x3f : header & 0x1f;
+}
+
+static bool isVclNal(bool isHevc, int type) {
+    return isHevc ? type < 32 : (type >= 1 && type <= 5);
+}
+
+/**
+ * 写入RBSP数据并插入防竞争字节（00 00 0x -> 00 00 03 0x）
+ */
+static int writeEscaped(unsigned char *dst, const unsigned char *rbsp, int len, int &zeroCount) {
+    int pos = 0;
+    for (int i = 0; i < len; i++) {
+        if (zeroCount == 2 && rbsp[i] <= 3) {
+            dst[pos++] = 0x03;
+            zeroCount = 0;
+        }
+        dst[pos++] = rbsp[i];
+        zeroCount = rbsp[i] == 0 ? zeroCount + 1 : 0;
+    }
+    return pos;
+}
+
+/**
+ * 生成带起始码的时间戳SEI NAL
+ *
+ * @return SEI NAL的长度
+ */
+static int writeTimestampSei(bool isHevc, int64 timestamp, unsigned char *dst) {
+    int pos = 0;
+    dst[pos++] = 0;
+    dst[pos++] = 0;
+    dst[pos++] = 0;
+    dst[pos++] = 1;
+    if (isHevc) {
+        // forbidden_zero_bit | nal_unit_type | nuh_layer_id = 0 | nuh_temporal_id_plus1 = 1
+        dst[pos++] = HEVC_NAL_PREFIX_SEI << 1;
+        dst[pos++] = 1;
+    } else {
+        // nal_ref_idc = 0
+        dst[pos++] = AVC_NAL_SEI;
+    }
+    unsigned char rbsp[2 + sizeof(TIMESTAMP_SEI_UUID) + TIMESTAMP_BYTES + 1];
+    int rbspLen = 0;
+    rbsp[rbspLen++] = SEI_USER_DATA_UNREGISTERED;
+    rbsp[rbspLen++] = sizeof(TIMESTAMP_SEI_UUID) + TIMESTAMP_BYTES;
+    memcpy(rbsp + rbspLen, TIMESTAMP_SEI_UUID, sizeof(TIMESTAMP_SEI_UUID));
+    rbspLen += sizeof(TIMESTAMP_SEI_UUID);
+    for (int i = TIMESTAMP_BYTES - 1; i >= 0; i--) {
+        rbsp[rbspLen++] = (unsigned char) ((unsigned long long) timestamp >> (i * 8));
+    }
+    // rbsp_trailing_bits
+    rbsp[rbspLen++] = 0x80;
+    int zeroCount = 0;
+    pos += writeEscaped(dst + pos, rbsp, rbspLen, zeroCount);
+    return pos;
+}
+
+int injectTimestampSei(bool isHevc, int64 timestamp, const unsigned char *src, int srcLen,
+                       unsigned char *dst) {
+    int codeLen;
+    int nalPos = findStartCode(src, 0, srcLen, codeLen);
+    if (nalPos != 0) {
+        return -1;
+    }
+    // SEI需要放在AUD、参数集之后，第一个VCL NAL之前
+    int insertPos = srcLen;
+    while (nalPos < srcLen) {
+        int headerPos = nalPos + codeLen;
+        if (headerPos >= srcLen) {
+            break;
+        }
+        if (isVclNal(isHevc, nalType(isHevc, src[headerPos]))) {
+            insertPos = nalPos;
+            break;
+        }
+        nalPos = findStartCode(src, headerPos, srcLen, codeLen);
+    }
+    memcpy(dst, src, (size_t) insertPos);
+    int seiLen = writeTimestampSei(isHevc, timestamp, dst + insertPos);
+    memcpy(dst + insertPos + seiLen, src + insertPos, (size_t) (srcLen - insertPos));
+    return srcLen + seiLen;
+}
+
+int parseTimestampSei(bool isHevc, const unsigned char *data, int len, int64 &timestamp) {
+    int codeLen;
+    int nalPos = findStartCode(data, 0, len, codeLen);
+    while (nalPos < len) {
+        int headerPos = nalPos + codeLen;
+        int nextPos = findStartCode(data, headerPos, len, codeLen);
+        int headerLen = isHevc ? 2 : 1;
+        int type = headerPos < len ? nalType(isHevc, data[headerPos]) : -1;
+        if (type == (isHevc ? HEVC_NAL_PREFIX_SEI : AVC_NAL_SEI)) {
+            // 去除防竞争字节后解析 sei_message
+            unsigned char rbsp[TIMESTAMP_SEI_MAX_SIZE];
+            int rbspLen = 0;
+            int zeroCount = 0;
+            for (int i = headerPos + headerLen; i < nextPos && rbspLen < TIMESTAMP_SEI_MAX_SIZE; i++) {
+                if (zeroCount == 2 && data[i] == 0x03) {
+                    zeroCount = 0;
+                    continue;
+                }
+                rbsp[rbspLen++] = data[i];
+                zeroCount = data[i] == 0 ? zeroCount + 1 : 0;
+            }
+            int expectSize = sizeof(TIMESTAMP_SEI_UUID) + TIMESTAMP_BYTES;
+            if (rbspLen >= 2 + expectSize && rbsp[0] == SEI_USER_DATA_UNREGISTERED &&
+                rbsp[1] == expectSize &&
+                memcmp(rbsp + 2, TIMESTAMP_SEI_UUID, sizeof(TIMESTAMP_SEI_UUID)) == 0) {
+                unsigned long long value = 0;
+                for (int i = 0; i < TIMESTAMP_BYTES; i++) {
+                    value = (value << 8) | rbsp[2 + sizeof(TIMESTAMP_SEI_UUID) + i];
+                }
+                timestamp = (int64) value;
+                return 0;
+            }
+        }
+        nalPos = nextPos;
+    }
+    return 1;
+}
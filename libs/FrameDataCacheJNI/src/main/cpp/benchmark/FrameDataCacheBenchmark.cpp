@@ -0,0 +1,302 @@
+/**
+ * FrameDataCache 端到端回放benchmark（add -> cache -> range read -> file write）
+ *
+ * 按真实（或加速）码率回放录制的H.264码流，同时运行多个导出线程，输出：
+ * 持续写入帧率、导出吞吐、读取被覆盖次数（包括写出期间被覆盖的帧，不计入导出吞吐）、写入阻塞时长 p50/p99。
+ *
+ * 输入：
+ *   --stream <file>    H.264码流文件，所有帧按顺序拼接
+ *   --index <file>     帧索引文件，每行 "timestamp_ms size is_key"，与码流文件中的帧一一对应
+ *   --synthetic <n>    不使用文件，生成n帧模拟数据（I帧为P帧的10倍大小）
+ * 参数：
+ *   --fps <n>          模拟数据的帧率，默认30
+ *   --bitrate <bps>    模拟数据的码率，默认6000000
+ *   --speed <x>        回放倍速，0表示不限速，默认1
+ *   --cache <MB>       缓存大小，默认30
+ *   --exporters <n>    并发导出线程数，默认1
+ *   --export-ms <ms>   每次导出最近多长时间的数据，默认10000
+ *   --out <dir>        导出文件目录，默认写入 /dev/null
+ *   --trace <file>     记录加锁等待、拷贝、淘汰等阶段的trace事件，结束后以 Chrome trace JSON 写入文件
+ */
+#include "FrameDataCache.h"
+#include "CacheTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * 回放的一帧数据
+ */
+typedef struct ReplayFrame {
+    int64 timestamp;
+    long offset;
+    int len;
+    bool isKeyFrame;
+} ReplayFrame;
+
+/**
+ * 单个导出线程的统计数据
+ */
+typedef struct ExportStats {
+    long exportCount = 0;
+    long frameCount = 0;
+    long long bytes = 0;
+    long overrunCount = 0;
+    double seconds = 0;
+} ExportStats;
+
+static std::vector<unsigned char> sStream;
+static std::vector<ReplayFrame> sFrames;
+static std::atomic<int64> sLatestTimestamp(-1);
+static std::atomic<bool> sIngestFinished(false);
+
+static double elapsedUs(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+static bool loadStream(const char *streamPath, const char *indexPath) {
+    FILE *fp = fopen(streamPath, "rb");
+    if (fp == nullptr) {
+        fprintf(stderr, "open stream file failed: %s\n", streamPath);
+        return false;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    sStream.resize((size_t) size);
+    size_t readLen = fread(sStream.data(), 1, (size_t) size, fp);
+    fclose(fp);
+    if ((long) readLen != size) {
+        fprintf(stderr, "read stream file failed: %s\n", streamPath);
+        return false;
+    }
+
+    fp = fopen(indexPath, "r");
+    if (fp == nullptr) {
+        fprintf(stderr, "open index file failed: %s\n", indexPath);
+        return false;
+    }
+    long offset = 0;
+    long long timestamp;
+    int len;
+    int isKey;
+    while (fscanf(fp, "%lld %d %d", &timestamp, &len, &isKey) == 3) {
+        if (offset + len > size) {
+            fprintf(stderr, "index exceeds stream size at frame %zu\n", sFrames.size());
+            break;
+        }
+        sFrames.push_back({timestamp, offset, len, isKey != 0});
+        offset += len;
+    }
+    fclose(fp);
+    return !sFrames.empty();
+}
+
+static void generateStream(int frameCount, int fps, long bitrate) {
+    // GOP为1s，I帧大小为P帧的10倍
+    long gopBytes = bitrate / 8;
+    int pLen = (int) (gopBytes / (fps + 9));
+    int iLen = pLen * 10;
+    long size = 0;
+    for (int i = 0; i < frameCount; i++) {
+        bool isKeyFrame = i % fps == 0;
+        int len = isKeyFrame ? iLen : pLen;
+        sFrames.push_back({(int64) i * 1000 / fps, size, len, isKeyFrame});
+        size += len;
+    }
+    sStream.resize((size_t) size);
+    for (long i = 0; i < size; i++) {
+        sStream[i] = (unsigned char) (i * 31);
+    }
+}
+
+static void ingest(double speed, std::vector<double> &stallUs, double &seconds) {
+    stallUs.reserve(sFrames.size());
+    Clock::time_point start = Clock::now();
+    int64 firstTimestamp = sFrames.front().timestamp;
+    for (size_t i = 0; i < sFrames.size(); i++) {
+        const ReplayFrame &frame = sFrames[i];
+        if (speed > 0) {
+            Clock::time_point due = start + std::chrono::microseconds(
+                    (long long) ((frame.timestamp - firstTimestamp) * 1000 / speed));
+            std::this_thread::sleep_until(due);
+        }
+        Clock::time_point addStart = Clock::now();
+        addFrame(frame.timestamp, frame.isKeyFrame, sStream.data() + frame.offset, frame.len);
+        stallUs.push_back(elapsedUs(addStart, Clock::now()));
+        sLatestTimestamp.store(frame.timestamp);
+    }
+    seconds = elapsedUs(start, Clock::now()) / 1e6;
+    sIngestFinished.store(true);
+}
+
+static void exportLoop(int id, int64 exportMs, const std::string &outDir, ExportStats &stats) {
+    Clock::time_point start = Clock::now();
+    struct iovec data[FRAME_IOV_COUNT];
+    while (!sIngestFinished.load()) {
+        int64 endTimestamp = sLatestTimestamp.load();
+        if (endTimestamp < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        std::string path = outDir.empty() ? "/dev/null" :
+                           outDir + "/export_" + std::to_string(id) + ".h264";
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "open export file failed: %s\n", path.c_str());
+            return;
+        }
+        int64 timestamp;
+        int len;
+        bool isKeyFrame;
+        int res = getFirstFrame(endTimestamp - exportMs, timestamp, data, len);
+        while (res == 0) {
+            if (writev(fd, data, FRAME_IOV_COUNT) != len) {
+                fprintf(stderr, "write export file failed: %s\n", path.c_str());
+            }
+            if (!isFrameValid(TRACK_VIDEO, timestamp, data)) {
+                // 写出期间该帧已被写入线程淘汰覆盖，写出的数据可能不完整
+                stats.overrunCount++;
+                break;
+            }
+            stats.frameCount++;
+            stats.bytes += len;
+            if (timestamp >= endTimestamp) {
+                break;
+            }
+            int64 preTimestamp = timestamp;
+            res = getNextFrame(preTimestamp, timestamp, data, len, isKeyFrame);
+            while (res == 2 && !sIngestFinished.load()) {
+                // 导出范围内的数据还没写入，等待新数据
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                res = getNextFrame(preTimestamp, timestamp, data, len, isKeyFrame);
+            }
+            if (res == 1) {
+                // 正在读取的帧已被写入线程覆盖
+                stats.overrunCount++;
+            }
+        }
+        close(fd);
+        stats.exportCount++;
+    }
+    stats.seconds = elapsedUs(start, Clock::now()) / 1e6;
+}
+
+static double percentile(std::vector<double> &values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = (size_t) (p * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int main(int argc, char **argv) {
+    const char *streamPath = nullptr;
+    const char *indexPath = nullptr;
+    int synthetic = 0;
+    int fps = 30;
+    long bitrate = 6000000;
+    double speed = 1;
+    int cacheSize = 30;
+    int exporters = 1;
+    int64 exportMs = 10000;
+    std::string outDir;
+    const char *tracePath = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--stream")) {
+            streamPath = argv[i + 1];
+        } else if (!strcmp(argv[i], "--index")) {
+            indexPath = argv[i + 1];
+        } else if (!strcmp(argv[i], "--synthetic")) {
+            synthetic = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--fps")) {
+            fps = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--bitrate")) {
+            bitrate = atol(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--speed")) {
+            speed = atof(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--cache")) {
+            cacheSize = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--exporters")) {
+            exporters = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--export-ms")) {
+            exportMs = atoll(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--out")) {
+            outDir = argv[i + 1];
+        } else if (!strcmp(argv[i], "--trace")) {
+            tracePath = argv[i + 1];
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (streamPath != nullptr && indexPath != nullptr) {
+        if (!loadStream(streamPath, indexPath)) {
+            return 1;
+        }
+    } else if (synthetic > 0 && fps > 0) {
+        generateStream(synthetic, fps, bitrate);
+    } else {
+        fprintf(stderr, "usage: %s (--stream <file> --index <file> | --synthetic <n>) "
+                        "[--fps n] [--bitrate bps] [--speed x] [--cache MB] [--exporters n] "
+                        "[--export-ms ms] [--out dir] [--trace file]\n", argv[0]);
+        return 1;
+    }
+
+    if (tracePath != nullptr) {
+        cachetrace::setTraceEnabled(true);
+    }
+    init(cacheSize, false);
+    std::vector<ExportStats> exportStats((size_t) exporters);
+    std::vector<std::thread> exportThreads;
+    for (int i = 0; i < exporters; i++) {
+        exportThreads.emplace_back(exportLoop, i, exportMs, outDir, std::ref(exportStats[i]));
+    }
+    std::vector<double> stallUs;
+    double ingestSeconds = 0;
+    ingest(speed, stallUs, ingestSeconds);
+    for (size_t i = 0; i < exportThreads.size(); i++) {
+        exportThreads[i].join();
+    }
+    UnInit();
+    if (tracePath != nullptr) {
+        cachetrace::setTraceEnabled(false);
+        if (cachetrace::dumpTrace(tracePath) < 0) {
+            fprintf(stderr, "open trace file failed: %s\n", tracePath);
+        }
+    }
+
+    long exportCount = 0;
+    long exportFrames = 0;
+    long long exportBytes = 0;
+    long overrunCount = 0;
+    double exportSeconds = 0;
+    for (size_t i = 0; i < exportStats.size(); i++) {
+        exportCount += exportStats[i].exportCount;
+        exportFrames += exportStats[i].frameCount;
+        exportBytes += exportStats[i].bytes;
+        overrunCount += exportStats[i].overrunCount;
+        exportSeconds = std::max(exportSeconds, exportStats[i].seconds);
+    }
+    printf("{\"frames\": %zu, \"ingest_seconds\": %.3f, \"ingest_fps\": %.1f, "
+           "\"ingest_mb_per_s\": %.2f, \"exporters\": %d, \"exports\": %ld, "
+           "\"export_frames\": %ld, \"export_mb_per_s\": %.2f, \"reader_overruns\": %ld, "
+           "\"evicted_unread\": %ld, \"writer_stall_p50_us\": %.2f, \"writer_stall_p99_us\": %.2f}\n",
+           sFrames.size(), ingestSeconds, sFrames.size() / ingestSeconds,
+           sStream.size() / 1048576.0 / ingestSeconds, exporters, exportCount, exportFrames,
+           exportSeconds > 0 ? exportBytes / 1048576.0 / exportSeconds : 0, overrunCount,
+           getEvictedUnreadCount(), percentile(stallUs, 0.5), percentile(stallUs, 0.99));
+    return 0;
+}
@@ -0,0 +1,9 @@
+#ifndef CACHE_TRACE_H
+#define CACHE_TRACE_H
+
+// framedatacachejni 的 trace 实例，实现见 libs/NativeTrace，与 yuv-jni 分开开关、分开导出
+#define NATIVE_TRACE_NAMESPACE cachetrace
+
+#include "NativeTrace.h"
+
+#endif //CACHE_TRACE_H
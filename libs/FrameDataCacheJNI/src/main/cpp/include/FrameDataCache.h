@@ -3,8 +3,26 @@
 
 typedef long long int64;
 
+#include <sys/uio.h>
 #include "logger.h"
 
+/**
+ * 视频轨道ID
+ */
+#define TRACK_VIDEO 0
+/**
+ * 音频轨道ID
+ */
+#define TRACK_AUDIO 1
+/**
+ * 支持的最大轨道数
+ */
+#define MAX_TRACK_COUNT 4
+/**
+ * 一帧数据最多分成的段数，跨越缓存尾部的帧分为尾部和头部两段存储
+ */
+#define FRAME_IOV_COUNT 2
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -32,29 +50,104 @@ void UnInit();
  */
 void addFrame(int64 timestamp, bool isKeyFrame, unsigned char *puf, int nLen);
 
+/**
+ * 添加指定轨道的帧数据，所有轨道共用同一块环形缓存
+ *
+ * @param trackId 轨道ID
+ * @param timestamp 时间戳
+ * @param isKeyFrame 是否关键帧（视频为I帧，音频每帧都是同步帧）
+ * @param puf
+ * @param nLen 长度
+ */
+void addTrackFrame(int trackId, int64 timestamp, bool isKeyFrame, unsigned char *puf, int nLen);
+
 //遍历帧数据
 /**
  * 获取第一帧数据
  *
  * @param timestamp 时间戳
  * @param curTimestamp 当前帧时间戳
- * @param data 帧数据
+ * @param data 帧数据，FRAME_IOV_COUNT 个分段，不跨越缓存尾部时第二段长度为0
  * @param nLen 数据长度
  * @return 查找状态0:找到 1:无效 2:等待
  */
-int getFirstFrame(int64 timestamp, int64 &curTimestamp, unsigned char *&data, int &nLen);
+int getFirstFrame(int64 timestamp, int64 &curTimestamp, struct iovec *data, int &nLen);
 
 /**
  * 返回当前curTimestamp的下一帧数据和index
  *
  * @param preTimestamp 前一帧时间戳
  * @param curTimestamp 当前帧时间戳
- * @param data 帧数据
+ * @param data 帧数据，FRAME_IOV_COUNT 个分段，不跨越缓存尾部时第二段长度为0
  * @param len 数据长度
  * @param isKeyFrame 是否关键帧（I帧）
  * @return 返回查找状态0:找到 1:无效 2:等待
  */
-int getNextFrame(int64 preTimestamp, int64 &curTimestamp, unsigned char *&data, int &len, bool &isKeyFrame);
+int getNextFrame(int64 preTimestamp, int64 &curTimestamp, struct iovec *data, int &len, bool &isKeyFrame);
+
+/**
+ * 返回视频轨道中preTimestamp之后的下一个关键帧数据，只遍历关键帧索引
+ *
+ * @param preTimestamp 前一帧时间戳
+ * @param curTimestamp 当前关键帧时间戳
+ * @param data 帧数据，FRAME_IOV_COUNT 个分段，不跨越缓存尾部时第二段长度为0
+ * @param len 数据长度
+ * @return 返回查找状态0:找到 1:无效 2:等待
+ */
+int getNextKeyFrame(int64 preTimestamp, int64 &curTimestamp, struct iovec *data, int &len);
+
+//按时间戳交织遍历所有轨道的帧数据
+/**
+ * 获取交织读取的第一帧数据（视频轨道中不早于timestamp的第一个关键帧）
+ *
+ * @param timestamp 时间戳
+ * @param curTimestamp 当前帧时间戳
+ * @param trackId 当前帧所属轨道ID
+ * @param data 帧数据，FRAME_IOV_COUNT 个分段，不跨越缓存尾部时第二段长度为0
+ * @param nLen 数据长度
+ * @return 查找状态0:找到 1:无效 2:等待
+ */
+int getFirstSample(int64 timestamp, int64 &curTimestamp, int &trackId, struct iovec *data, int &nLen);
+
+/**
+ * 按时间戳顺序返回所有轨道中(preTimestamp, preTrackId)之后的下一帧数据
+ *
+ * @param preTimestamp 前一帧时间戳
+ * @param preTrackId 前一帧所属轨道ID
+ * @param curTimestamp 当前帧时间戳
+ * @param trackId 当前帧所属轨道ID
+ * @param data 帧数据，FRAME_IOV_COUNT 个分段，不跨越缓存尾部时第二段长度为0
+ * @param len 数据长度
+ * @param isKeyFrame 是否关键帧（同步帧）
+ * @return 返回查找状态0:找到 1:无效 2:等待
+ */
+int getNextSample(int64 preTimestamp, int preTrackId, int64 &curTimestamp, int &trackId,
+                  struct iovec *data, int &len, bool &isKeyFrame);
+
+/**
+ * 将分段存储的帧数据拷贝到连续的内存中
+ *
+ * @param data 帧数据分段
+ * @param dst 目标内存，大小不小于帧数据长度
+ */
+void copyFrameData(const struct iovec *data, unsigned char *dst);
+
+/**
+ * 检查 get* 返回的帧是否仍在缓存中
+ *
+ * 分段直接指向缓存内部，读锁释放后写入线程可能淘汰该帧并覆盖其数据，拷贝或写出分段之后调用，
+ * 返回false时已读取的数据可能不完整，应丢弃
+ *
+ * @param trackId 帧所属轨道ID
+ * @param timestamp 帧时间戳
+ * @param data get* 返回的帧数据分段
+ */
+bool isFrameValid(int trackId, int64 timestamp, const struct iovec *data);
+
+/**
+ * 从未被读取过就被淘汰的帧数（init 时清零），读取方跟不上写入、帧在被读取前就被覆盖时增加
+ */
+long getEvictedUnreadCount();
 
 #ifdef __cplusplus
 }
@@ -8,8 +8,15 @@ extern "C" {
 
 #include "logger.h"
 #include "FrameDataCache.h"
+#include "TimestampSei.h"
 
 #define DATA_CACHE_UTILS_JAVA "com/lkl/framedatacachejni/FrameDataCacheUtils"
+#define TIMESTAMP_SEI_UTILS_JAVA "com/lkl/framedatacachejni/TimestampSeiUtils"
+
+/**
+ * get*Data 的返回值，传入的帧数据数组小于帧长度，没有写入任何输出参数
+ */
+#define RES_BUFFER_TOO_SMALL 3
 
 JNIEXPORT void JNICALL
 initCache(JNIEnv *, jobject, jint, jboolean);
@@ -17,12 +24,40 @@ initCache(JNIEnv *, jobject, jint, jboolean);
 JNIEXPORT void JNICALL
 addFrameData(JNIEnv *, jobject, jlong, jboolean, jbyteArray, jint);
 
+JNIEXPORT void JNICALL
+addFrameDataDirect(JNIEnv *, jobject, jlong, jboolean, jobject, jint, jint);
+
 JNIEXPORT jint
 JNICALL getFirstFrameData(JNIEnv *, jobject, jlong, jlongArray, jbyteArray, jintArray);
 
 JNIEXPORT jint
 JNICALL getNextFrameData(JNIEnv *, jobject, jlong, jlongArray, jbyteArray, jintArray, jbooleanArray);
 
+JNIEXPORT jint
+JNICALL getNextKeyFrameData(JNIEnv *, jobject, jlong, jlongArray, jbyteArray, jintArray);
+
+JNIEXPORT void JNICALL
+addTrackFrameData(JNIEnv *, jobject, jint, jlong, jboolean, jbyteArray, jint);
+
+JNIEXPORT jint
+JNICALL getFirstSampleData(JNIEnv *, jobject, jlong, jlongArray, jintArray, jbyteArray, jintArray);
+
+JNIEXPORT jint
+JNICALL getNextSampleData(JNIEnv *, jobject, jlong, jint, jlongArray, jintArray, jbyteArray, jintArray,
+                          jbooleanArray);
+
+JNIEXPORT jint
+JNICALL injectTimestampSeiData(JNIEnv *, jobject, jboolean, jlong, jbyteArray, jint, jbyteArray);
+
+JNIEXPORT jlong
+JNICALL parseTimestampSeiData(JNIEnv *, jobject, jboolean, jbyteArray, jint);
+
+JNIEXPORT void JNICALL
+setTraceEnabled(JNIEnv *, jobject, jboolean);
+
+JNIEXPORT jint
+JNICALL dumpTrace(JNIEnv *, jobject, jstring);
+
 #ifdef __cplusplus
 }
 #endif
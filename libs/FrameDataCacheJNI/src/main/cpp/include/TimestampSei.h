@@ -0,0 +1,43 @@
+#ifndef TIMESTAMP_SEI_H
+#define TIMESTAMP_SEI_H
+
+#include "FrameDataCache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 时间戳SEI的最大长度（含起始码），插入SEI后的数据长度不会超过 srcLen + TIMESTAMP_SEI_MAX_SIZE
+ */
+#define TIMESTAMP_SEI_MAX_SIZE 64
+
+/**
+ * 在一帧Annex-B格式（起始码分隔）的H.264/H.265数据中插入携带时间戳的 user_data_unregistered SEI，
+ * SEI位于第一个VCL NAL之前，原有的NAL数据不做任何修改，无需解码和重新编码
+ *
+ * @param isHevc true H.265，false H.264
+ * @param timestamp 要写入的时间戳 ms
+ * @param src 原始帧数据
+ * @param srcLen 原始帧数据长度
+ * @param dst 插入SEI后的帧数据，空间不小于 srcLen + TIMESTAMP_SEI_MAX_SIZE
+ * @return 插入SEI后的数据长度，-1表示数据不是Annex-B格式
+ */
+int injectTimestampSei(bool isHevc, int64 timestamp, const unsigned char *src, int srcLen,
+                       unsigned char *dst);
+
+/**
+ * 从一帧Annex-B格式的H.264/H.265数据中读取 injectTimestampSei 写入的时间戳
+ *
+ * @param isHevc true H.265，false H.264
+ * @param data 帧数据
+ * @param len 帧数据长度
+ * @param timestamp 读取到的时间戳 ms
+ * @return 0:找到 1:没有时间戳SEI
+ */
+int parseTimestampSei(bool isHevc, const unsigned char *data, int len, int64 &timestamp);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //TIMESTAMP_SEI_H
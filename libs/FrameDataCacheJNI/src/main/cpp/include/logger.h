@@ -1,17 +1,23 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#define LOG_TAG    "FrameDataCache"
+
 #ifdef ANDROID
 
 #include <android/log.h>
 
-#define LOG_TAG    "FrameDataCache"
 #define LOGD(format, ...)  __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, format, ##__VA_ARGS__)
 #define LOGE(format, ...)  __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, format, ##__VA_ARGS__)
 #define LOGI(format, ...)  __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, format, ##__VA_ARGS__)
 #else
-#define LOGE(format, ...)  printf(LOG_TAG format "\n", ##__VA_ARGS__)
-#define LOGI(format, ...)  printf(LOG_TAG format "\n", ##__VA_ARGS__)
+
+#include <cstdio>
+
+// 非Android环境（如host benchmark）输出到stderr，不干扰stdout上的结果输出
+#define LOGD(format, ...)  fprintf(stderr, LOG_TAG " D " format "\n", ##__VA_ARGS__)
+#define LOGE(format, ...)  fprintf(stderr, LOG_TAG " E " format "\n", ##__VA_ARGS__)
+#define LOGI(format, ...)  fprintf(stderr, LOG_TAG " I " format "\n", ##__VA_ARGS__)
 #endif
 
 #endif //LOGGER_H
@@ -1,5 +1,8 @@
 package com.lkl.framedatacachejni
 
+import dalvik.annotation.optimization.FastNative
+import java.nio.ByteBuffer
+
 /**
  * 视频帧数据缓存工具类
  *
@@ -30,6 +33,23 @@ object FrameDataCacheUtils {
         length: Int
     )
 
+    /**
+     * 添加新的一帧数据到缓存，数据直接从 direct ByteBuffer（如 MediaCodec OutputBuffer）拷入，不需要先取到 java 数组
+     *
+     * @param timestamp 时间戳 ms
+     * @param isKeyFrame 是否关键帧
+     * @param frameData 帧数据，必须是 direct ByteBuffer
+     * @param offset 数据在 frameData 中的起始位置
+     * @param length 数据长度
+     */
+    external fun addFrameData(
+        timestamp: Long,
+        isKeyFrame: Boolean,
+        frameData: ByteBuffer,
+        offset: Int,
+        length: Int
+    )
+
     /**
      * 通过时间戳从缓存区中获取最近的一个关键帧数据
      *
@@ -64,6 +84,96 @@ object FrameDataCacheUtils {
         isKeyFrame: BooleanArray
     ): Int
 
+    /**
+     * 通过时间戳从缓存区中获取下一个关键帧数据，只遍历关键帧索引
+     *
+     * @param preTimestamp 前一个关键帧的时间戳 ms
+     * @param curTimestamp 当前关键帧的时间戳 ms
+     * @param frameData 帧数据
+     * @param length 数据长度
+     * @return 0成功，非0失败
+     */
+    external fun getNextKeyFrameData(
+        preTimestamp: Long,
+        curTimestamp: LongArray,
+        frameData: ByteArray,
+        length: IntArray
+    ): Int
+
+    /**
+     * 添加指定轨道的一帧数据到缓存，所有轨道共用同一块缓存空间
+     *
+     * @param trackId 轨道ID [com.lkl.framedatacachejni.constant.DataCacheTrack]
+     * @param timestamp 时间戳 ms
+     * @param isKeyFrame 是否关键帧（音频帧都为同步帧，传true）
+     * @param frameData 帧数据
+     * @param length 数据长度
+     */
+    external fun addTrackFrameData(
+        trackId: Int,
+        timestamp: Long,
+        isKeyFrame: Boolean,
+        frameData: ByteArray,
+        length: Int
+    )
+
+    /**
+     * 通过时间戳获取交织读取的第一帧数据（视频轨道中最近的一个关键帧）
+     *
+     * @param timestamp 传入的时间戳 ms
+     * @param curTimestamp 查找到的帧的时间戳 ms
+     * @param trackId 查找到的帧所属的轨道ID
+     * @param frameData 帧数据
+     * @param length 数据长度
+     * @return 0成功，非0失败
+     */
+    external fun getFirstSampleData(
+        timestamp: Long,
+        curTimestamp: LongArray,
+        trackId: IntArray,
+        frameData: ByteArray,
+        length: IntArray
+    ): Int
+
+    /**
+     * 按时间戳顺序获取所有轨道中的下一帧数据
+     *
+     * @param preTimestamp 前一帧的时间戳 ms
+     * @param preTrackId 前一帧所属的轨道ID
+     * @param curTimestamp 当前帧的时间戳 ms
+     * @param trackId 当前帧所属的轨道ID
+     * @param frameData 帧数据
+     * @param length 数据长度
+     * @param isKeyFrame 是否关键帧（同步帧）true 关键帧
+     * @return 0成功，非0失败
+     */
+    external fun getNextSampleData(
+        preTimestamp: Long,
+        preTrackId: Int,
+        curTimestamp: LongArray,
+        trackId: IntArray,
+        frameData: ByteArray,
+        length: IntArray,
+        isKeyFrame: BooleanArray
+    ): Int
+
+    /**
+     * 开始或停止记录 trace 事件（各接口调用及内部的加锁等待、拷贝、淘汰），开始时清空之前记录的事件；
+     * 开启期间同时输出为 ATrace section（Android 6.0 及以上），抓取 systrace / Perfetto 时与 MediaCodec 显示在同一时间轴上
+     *
+     * @param enabled 是否记录
+     */
+    @FastNative
+    external fun setTraceEnabled(enabled: Boolean)
+
+    /**
+     * 将记录的事件按 Chrome trace JSON 格式写入文件，可用 Perfetto UI 打开，与 YuvUtils.dumpTrace 导出的文件时间戳一致
+     *
+     * @param path 文件路径
+     * @return 写入的事件数，-1打开文件失败
+     */
+    external fun dumpTrace(path: String): Int
+
     init {
         System.loadLibrary("framedatacachejni")
     }
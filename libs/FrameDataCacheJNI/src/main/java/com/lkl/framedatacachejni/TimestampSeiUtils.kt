@@ -0,0 +1,46 @@
+package com.lkl.framedatacachejni
+
+/**
+ * 时间戳SEI工具类，直接在H.264/H.265码流中写入/读取时间戳，无需解码和重新编码
+ *
+ * @author likunlun
+ * @since 2026/10/19
+ */
+object TimestampSeiUtils {
+    /**
+     * 插入SEI后数据最多增加的长度
+     */
+    const val SEI_MAX_SIZE = 64
+
+    /**
+     * 在一帧Annex-B格式的数据中第一个VCL NAL之前插入携带时间戳的 user_data_unregistered SEI
+     *
+     * @param isHevc true H.265，false H.264
+     * @param timestamp 要写入的时间戳 ms
+     * @param src 原始帧数据
+     * @param srcLength 原始帧数据长度
+     * @param dst 插入SEI后的帧数据，长度不小于 srcLength + [SEI_MAX_SIZE]
+     * @return 插入SEI后的数据长度，-1失败
+     */
+    external fun injectTimestampSei(
+        isHevc: Boolean,
+        timestamp: Long,
+        src: ByteArray,
+        srcLength: Int,
+        dst: ByteArray
+    ): Int
+
+    /**
+     * 读取帧数据中 [injectTimestampSei] 写入的时间戳
+     *
+     * @param isHevc true H.265，false H.264
+     * @param data 帧数据
+     * @param length 数据长度
+     * @return 时间戳 ms，-1没有时间戳SEI
+     */
+    external fun parseTimestampSei(isHevc: Boolean, data: ByteArray, length: Int): Long
+
+    init {
+        System.loadLibrary("framedatacachejni")
+    }
+}
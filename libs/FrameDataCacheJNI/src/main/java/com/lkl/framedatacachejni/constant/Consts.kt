@@ -13,4 +13,19 @@ object DataCacheCode {
      * jni接口请求结果 - 等待，没有更多缓存数据了，需等待新数据
      */
     const val RES_WAITING = 2
+    /**
+     * jni接口请求结果 - 传入的帧数据数组小于帧长度，没有写入任何数据，需使用更大的数组重新获取
+     */
+    const val RES_BUFFER_TOO_SMALL = 3
+}
+
+object DataCacheTrack {
+    /**
+     * 视频轨道
+     */
+    const val TRACK_VIDEO = 0
+    /**
+     * 音频轨道
+     */
+    const val TRACK_AUDIO = 1
 }
\ No newline at end of file
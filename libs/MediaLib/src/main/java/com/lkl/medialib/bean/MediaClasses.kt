@@ -3,6 +3,7 @@ package com.lkl.medialib.bean
 import android.media.MediaCodecInfo
 import android.media.MediaFormat
 import com.lkl.medialib.constant.VideoProperty
+import com.lkl.yuvjni.YuvBuffer
 
 /**
  * 媒体操作相关的实体类
@@ -14,13 +15,29 @@ import com.lkl.medialib.constant.VideoProperty
  * @param length 帧数据长度
  * @param timestamp 时间戳 ms
  * @param isKeyFrame 是否关键帧（I帧）true I帧
+ * @param trackId 帧所属的轨道ID [com.lkl.framedatacachejni.constant.DataCacheTrack]
+ * @param buffer 帧数据位于native帧缓冲池中时不为空，此时 data 为 [EMPTY_DATA]，最后一个使用者调用 [recycle] 归还
  */
 data class FrameData(
     var data: ByteArray,
     var length: Int = -1,
     var timestamp: Long,
-    var isKeyFrame: Boolean = false
+    var isKeyFrame: Boolean = false,
+    var trackId: Int = 0,
+    var buffer: YuvBuffer? = null
 ) {
+    companion object {
+        val EMPTY_DATA = ByteArray(0)
+    }
+
+    /**
+     * 归还native帧缓冲
+     */
+    fun recycle() {
+        buffer?.close()
+        buffer = null
+    }
+
     override fun equals(other: Any?): Boolean {
         if (this === other) return true
         if (javaClass != other?.javaClass) return false
@@ -31,6 +48,7 @@ data class FrameData(
         if (length != other.length) return false
         if (timestamp != other.timestamp) return false
         if (isKeyFrame != other.isKeyFrame) return false
+        if (trackId != other.trackId) return false
 
         return true
     }
@@ -40,11 +58,12 @@ data class FrameData(
         result = 31 * result + length
         result = 31 * result + timestamp.hashCode()
         result = 31 * result + isKeyFrame.hashCode()
+        result = 31 * result + trackId
         return result
     }
 
     override fun toString(): String {
-        return "FrameData(length=$length, timestamp=$timestamp, isKeyFrame=$isKeyFrame)"
+        return "FrameData(length=$length, timestamp=$timestamp, isKeyFrame=$isKeyFrame, trackId=$trackId)"
     }
 }
 
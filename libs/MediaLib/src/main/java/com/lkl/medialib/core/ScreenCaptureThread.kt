@@ -37,6 +37,11 @@ class ScreenCaptureThread(
     private val mBufferInfo = MediaCodec.BufferInfo()
     private var mVirtualDisplay: VirtualDisplay? = null
 
+    /**
+     * 复用的帧数据，只在 putFrameData 回调期间有效，回调方需要同步拷贝（如存入FrameDataCache），不再每帧创建数组
+     */
+    private val mFrameData = FrameData(ByteArray(512 * 1024), 0, 0)
+
     @Throws(IOException::class)
     override fun prepare() {
         val format = MediaUtils.createVideoFormat(mediaFormatParams)
@@ -99,14 +104,15 @@ class ScreenCaptureThread(
             encodedData.position(mBufferInfo.offset)
             encodedData.limit(mBufferInfo.offset + mBufferInfo.size)
 
-            // 取出编码好的H264数据
-            val data = ByteArray(mBufferInfo.size)
-            encodedData[data]
-
-            val frameData = FrameData(
-                data, mBufferInfo.size, System.currentTimeMillis(),
-                mBufferInfo.flags == MediaCodec.BUFFER_FLAG_KEY_FRAME
-            )
+            // 取出编码好的H264数据，容量不足时才扩容
+            val frameData = mFrameData
+            if (frameData.data.size < mBufferInfo.size) {
+                frameData.data = ByteArray(mBufferInfo.size + (mBufferInfo.size shr 1))
+            }
+            encodedData[frameData.data, 0, mBufferInfo.size]
+            frameData.length = mBufferInfo.size
+            frameData.timestamp = System.currentTimeMillis()
+            frameData.isKeyFrame = mBufferInfo.flags == MediaCodec.BUFFER_FLAG_KEY_FRAME
             callback.putFrameData(frameData)
 
             if (MediaConst.PRINT_DEBUG_LOG) {
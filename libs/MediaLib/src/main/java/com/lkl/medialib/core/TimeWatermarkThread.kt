@@ -1,14 +1,11 @@
 package com.lkl.medialib.core
 
 import android.util.Size
-import com.lkl.commonlib.util.BitmapUtils
-import com.lkl.commonlib.util.DateUtils
 import com.lkl.commonlib.util.LogUtils
 import com.lkl.medialib.bean.FrameData
 import com.lkl.medialib.bean.Position
-import com.lkl.yuvjni.YuvUtils
-import java.nio.ByteBuffer
-import java.util.*
+import com.lkl.medialib.util.TimeGlyphAtlas
+import com.lkl.yuvjni.Key
 
 /**
  * 时间水印工作线程
@@ -38,84 +35,94 @@ class TimeWatermarkThread(
 ) : BaseMediaThread(threadName) {
     companion object {
         private const val TAG = "TimeWatermarkThread"
+
+        /**
+         * 一次最多叠加时间水印的帧数
+         */
+        private const val BATCH_SIZE = 8
     }
 
-    private var lastTimeWaterMark = ""
-    private var lastTimeWaterMarkWidth = 0
-    private var lastTimeWaterMarkHeight = 0
-    private lateinit var lastTimeWaterMarkYuv: ByteArray
+    /**
+     * 时间水印字形表，数字及分隔符只转换一次
+     */
+    private var timeGlyphAtlas: TimeGlyphAtlas? = null
+
+    /**
+     * 本次取出的帧及native帧缓冲的地址、时间戳，复用避免每帧分配
+     */
+    private val batchFrames = ArrayList<FrameData>(BATCH_SIZE)
+    private val batchAddresses = LongArray(BATCH_SIZE)
+    private val batchTimestamps = LongArray(BATCH_SIZE)
 
     override fun prepare() {
         LogUtils.e(TAG, "startPos $startPos size: $size colorFormat: $colorFormat")
+        timeGlyphAtlas = TimeGlyphAtlas()
         callback.prepare()
     }
 
     override fun drain() {
-        val frameData = callback.getFrameData()
-        if (frameData == null) {
+        // 离线处理时解码往往快于叠加水印，一次取出已解码的多帧批量处理
+        while (batchFrames.size < BATCH_SIZE) {
+            val frameData = callback.getFrameData() ?: break
+            batchFrames.add(frameData)
+        }
+        if (batchFrames.isEmpty()) {
             waitTime(10)
         } else {
-            nv21ToYuv420p(frameData)
+            nv21ToYuv420p(batchFrames)
+            batchFrames.clear()
         }
     }
 
     /**
      * nv21数据添加时间水印并转为YUV420P
      *
-     * @param frameData 视频帧数据
+     * @param frames 视频帧数据
      */
-    private fun nv21ToYuv420p(frameData: FrameData) {
-        generateTimeWaterMarkBitmap(frameData.timestamp)
-
-        // NV21数据添加时间水印
-        YuvUtils.NV21AddWaterMark(
-            startPos.x,
-            startPos.y,
-            lastTimeWaterMarkYuv,
-            lastTimeWaterMarkWidth,
-            lastTimeWaterMarkHeight,
-            frameData.data,
-            size.width,
-            size.height
-        )
+    private fun nv21ToYuv420p(frames: List<FrameData>) {
+        // NV21数据逐字叠加时间水印，帧数据在native帧缓冲池中时按地址一次批量叠加
+        var count = 0
+        for (frameData in frames) {
+            val buffer = frameData.buffer
+            if (buffer != null) {
+                batchAddresses[count] = buffer.address()
+                batchTimestamps[count] = startTimestamp + frameData.timestamp
+                count++
+            } else {
+                timeGlyphAtlas?.draw(
+                    frameData.data,
+                    size.width,
+                    size.height,
+                    startTimestamp + frameData.timestamp,
+                    Key.TIME_FORMAT_DATE_TIME_MS,
+                    startPos.x,
+                    startPos.y
+                )
+            }
+        }
+        if (count > 0) {
+            timeGlyphAtlas?.drawBatch(
+                batchAddresses,
+                count,
+                size.width,
+                size.height,
+                batchTimestamps,
+                Key.TIME_FORMAT_DATE_TIME_MS,
+                startPos.x,
+                startPos.y
+            )
+        }
 
         // 将NV21数据转为YUV420P（I420）
 //        YuvUtils.NV21ToI420(frameData.data, yuv, width, height, false)
-        callback.putFrameData(frameData)
-    }
-
-    private fun generateTimeWaterMarkBitmap(timestamp: Long) {
-        val time = DateUtils.convertDateToString(
-            DateUtils.DATE_TIME_MS,
-            Date(startTimestamp + timestamp)
-        )
-        if (lastTimeWaterMark != time) {
-            lastTimeWaterMark = time
-            // 时间戳变动了，才需要重新生成新的水印数据
-            // 生成时间水印图片
-            val bitmap = BitmapUtils.textAsBitmap(time)
-            lastTimeWaterMarkWidth = bitmap.width
-            lastTimeWaterMarkHeight = bitmap.height
-            // 获取argb byte 数组
-            val timeBuffer =
-                ByteBuffer.allocate(lastTimeWaterMarkWidth * lastTimeWaterMarkHeight * 4)
-            bitmap.copyPixelsToBuffer(timeBuffer)
-            // 图片数据释放
-            bitmap.recycle()
-            lastTimeWaterMarkYuv =
-                ByteArray(lastTimeWaterMarkWidth * lastTimeWaterMarkHeight * 3 / 2)
-            // 将argb数据转为 NV21
-//            YuvUtils.RgbaToI420(Key.ARGB_TO_I420, timeBuffer.array(), lastTimeWaterMarkYuv, lastTimeWaterMarkWidth, lastTimeWaterMarkHeight);
-            YuvUtils.ArgbToNV21(
-                timeBuffer.array(),
-                lastTimeWaterMarkYuv,
-                lastTimeWaterMarkWidth,
-                lastTimeWaterMarkHeight
-            )
+        for (frameData in frames) {
+            callback.putFrameData(frameData)
         }
     }
 
     override fun release() {
+        timeGlyphAtlas?.release()
+        timeGlyphAtlas = null
         callback.finished()
     }
 }
\ No newline at end of file
@@ -8,6 +8,7 @@ import com.lkl.commonlib.util.LogUtils
 import com.lkl.medialib.bean.FrameData
 import com.lkl.medialib.constant.MediaConst
 import com.lkl.medialib.constant.VideoProperty
+import com.lkl.yuvjni.YuvBuffer
 import java.nio.ByteBuffer
 
 /**
@@ -138,19 +139,24 @@ class VideoDecoderThread(
             // adjust the ByteBuffer values to match BufferInfo (not needed?)
             decodedOutputBuffer.position(mBufferInfo.offset)
             decodedOutputBuffer.limit(mBufferInfo.offset + mBufferInfo.size)
-            // 取出编码好的H264/H265数据
-            val data = ByteArray(mBufferInfo.size)
-            decodedOutputBuffer[data]
+            // 取出解码后的YUV数据，放入native帧缓冲池，由编码线程写入InputBuffer后归还
+            val buffer = YuvBuffer.obtain(mBufferInfo.size)
+            buffer.buffer().clear()
+            buffer.buffer().put(decodedOutputBuffer)
             if (!hasSavaBitmap) {
                 hasSavaBitmap = true
+                val data = ByteArray(mBufferInfo.size)
+                buffer.buffer().rewind()
+                buffer.buffer()[data]
                 FileUtils.writeToFile(FileUtils.videoDir + "ipc.yuv", data)
             }
 
             val frameData = FrameData(
-                data,
+                FrameData.EMPTY_DATA,
                 mBufferInfo.size,
                 mBufferInfo.presentationTimeUs / 1000,
-                mBufferInfo.flags == MediaCodec.BUFFER_FLAG_KEY_FRAME
+                mBufferInfo.flags == MediaCodec.BUFFER_FLAG_KEY_FRAME,
+                buffer = buffer
             )
             callback.putFrameData(frameData)
             if (MediaConst.PRINT_DEBUG_LOG) {
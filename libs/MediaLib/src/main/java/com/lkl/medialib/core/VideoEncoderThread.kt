@@ -54,7 +54,12 @@ class VideoEncoderThread(
     override fun drain() {
         val frameData = callback.getFrameData()
         frameData?.apply {
-            putDataToInputBuffer(data, timestamp * 1000)
+            try {
+                putDataToInputBuffer(this, timestamp * 1000)
+            } finally {
+                // 已拷入InputBuffer，归还native帧缓冲
+                recycle()
+            }
         }
         waitTime(10)
     }
@@ -62,12 +67,12 @@ class VideoEncoderThread(
     /**
      * 向编码器InputBuffer中填入数据
      *
-     * @param data NV21数据
+     * @param frameData NV21数据
      * @param timestamp 时间戳 us
      * @throws IOException
      */
     @Throws(IOException::class)
-    private fun putDataToInputBuffer(data: ByteArray, timestamp: Long) {
+    private fun putDataToInputBuffer(frameData: FrameData, timestamp: Long) {
         mEncoder?.apply {
             val index = dequeueInputBuffer(-1)
             if (index >= 0) {
@@ -77,8 +82,18 @@ class VideoEncoderThread(
                     return
                 }
                 buffer.clear()
-                buffer.put(data)
-                queueInputBuffer(index, 0, data.size, timestamp, 0)
+                val pooled = frameData.buffer
+                val size = if (pooled != null) {
+                    val src = pooled.buffer()
+                    src.clear()
+                    src.limit(frameData.length)
+                    buffer.put(src)
+                    frameData.length
+                } else {
+                    buffer.put(frameData.data)
+                    frameData.data.size
+                }
+                queueInputBuffer(index, 0, size, timestamp, 0)
             }
             drainEncoder(this)
         }
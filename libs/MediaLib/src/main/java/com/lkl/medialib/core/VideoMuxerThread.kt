@@ -8,6 +8,7 @@ import com.lkl.commonlib.util.BitmapUtils
 import com.lkl.commonlib.util.DateUtils
 import com.lkl.commonlib.util.FileUtils
 import com.lkl.commonlib.util.LogUtils
+import com.lkl.framedatacachejni.constant.DataCacheTrack
 import com.lkl.medialib.bean.FrameData
 import com.lkl.medialib.constant.MediaConst
 import java.nio.ByteBuffer
@@ -23,6 +24,10 @@ class VideoMuxerThread(
     private val mediaFormat: MediaFormat,
     private val saveFilePath: String? = null,
     private val callback: Callback,
+    /**
+     * 音频轨道的MediaFormat，为null时只合成视频轨道
+     */
+    private val audioFormat: MediaFormat? = null,
     threadName: String = TAG
 ) : BaseMediaThread(threadName) {
     companion object {
@@ -33,6 +38,7 @@ class VideoMuxerThread(
     private val mBufferInfo = MediaCodec.BufferInfo()
     private var mOutputFileName = ""
     private var mTrackIndex = -1
+    private var mAudioTrackIndex = -1
 
     /**
      * 第一帧数据的时间戳 ms
@@ -44,8 +50,8 @@ class VideoMuxerThread(
         // because our MediaFormat doesn't have the Magic Goodies.  These can only be
         // obtained from the encoder after it has started processing data.
         //
-        // We're not actually interested in multiplexing audio.  We just want to convert
-        // the raw H.264 elementary stream we get from MediaCodec into a .mp4 file.
+        // The audio track is optional. Samples of all tracks are read from the cache
+        // interleaved by timestamp, so they can be written in one sequential pass.
         mOutputFileName = if (TextUtils.isEmpty(saveFilePath)) {
             FileUtils.videoDir + DateUtils.nowTime.replace(" ", "_") + BitmapUtils.VIDEO_FILE_EXT
         } else {
@@ -57,6 +63,10 @@ class VideoMuxerThread(
         LogUtils.d(TAG, "Muxer init mediaFormat -> $mediaFormat")
         mMuxer?.apply {
             mTrackIndex = addTrack(mediaFormat)
+            audioFormat?.let {
+                LogUtils.d(TAG, "Muxer init audioFormat -> $it")
+                mAudioTrackIndex = addTrack(it)
+            }
             start()
             firstFrameHandler()
         }
@@ -83,6 +93,12 @@ class VideoMuxerThread(
     }
 
     private fun writeSampleData(frameData: FrameData) {
+        val trackIndex =
+            if (frameData.trackId == DataCacheTrack.TRACK_AUDIO) mAudioTrackIndex else mTrackIndex
+        if (trackIndex < 0) {
+            // 没有对应的轨道，丢弃该帧
+            return
+        }
         mMuxer?.apply {
             val sampleData = ByteBuffer.wrap(frameData.data, 0, frameData.length)
             setBufferInfo(
@@ -90,7 +106,7 @@ class VideoMuxerThread(
                 frameData.timestamp,
                 frameData.length
             )
-            writeSampleData(mTrackIndex, sampleData, mBufferInfo)
+            writeSampleData(trackIndex, sampleData, mBufferInfo)
             if (MediaConst.PRINT_DEBUG_LOG) {
                 LogUtils.d(TAG, "writeSampleData frame data -> $frameData")
             }
@@ -9,6 +9,7 @@ import com.lkl.commonlib.BaseApplication
 import com.lkl.commonlib.util.*
 import com.lkl.framedatacachejni.FrameDataCacheUtils
 import com.lkl.framedatacachejni.constant.DataCacheCode
+import com.lkl.framedatacachejni.constant.DataCacheTrack
 import com.lkl.medialib.BuildConfig
 import com.lkl.medialib.bean.FrameData
 import com.lkl.medialib.bean.MediaFormatParams
@@ -41,6 +42,12 @@ class ScreenCaptureManager {
 
     private var mMediaFormat: MediaFormat? = null
 
+    /**
+     * 音频编码器输出的MediaFormat，未设置时只合成视频轨道
+     */
+    @Volatile
+    private var mAudioFormat: MediaFormat? = null
+
     /**
      * 录屏环境是否已就绪
      */
@@ -58,6 +65,7 @@ class ScreenCaptureManager {
 
     private var mFrameBuffer: ByteArray = ByteArray(2 * 1024 * 1024)
     private val mCurTimeStamp = LongArray(1)
+    private val mCurTrackId = IntArray(1)
     private val mLength = IntArray(1)
     private val mIsKeyFrame = BooleanArray(1)
 
@@ -103,6 +111,35 @@ class ScreenCaptureManager {
         mScreenCaptureThread?.start()
     }
 
+    /**
+     * 设置音频轨道的格式，之后 [startMuxer] 合成的视频包含音频轨道
+     *
+     * 录屏本身不采集音频，由调用方的音频编码器（如 AudioRecord + AAC MediaCodec）在输出格式确定后调用
+     *
+     * @param audioFormat 音频编码器输出的MediaFormat，null 只合成视频轨道
+     */
+    fun setAudioFormat(audioFormat: MediaFormat?) {
+        mAudioFormat = audioFormat
+    }
+
+    /**
+     * 将编码好的一帧音频数据存入缓存，与视频帧共用同一块缓存，合成时按时间戳交织写入
+     *
+     * @param frameData 音频帧数据，timestamp 与视频帧使用同一时间基准 ms
+     */
+    fun putAudioFrameData(frameData: FrameData) {
+        // 与视频帧一样，正在制作视频时暂停缓存
+        if (isEnvReady.get() && !isMuxer.get()) {
+            FrameDataCacheUtils.addTrackFrameData(
+                DataCacheTrack.TRACK_AUDIO,
+                frameData.timestamp,
+                true,
+                frameData.data,
+                frameData.length
+            )
+        }
+    }
+
     /**
      * 录屏环境是否已就绪
      *
@@ -127,24 +164,30 @@ class ScreenCaptureManager {
         // 删除旧的Cache文件，只保留8个
         FileUtils.deleteOldFiles(FileUtils.videoDir, 8)
         mVideoMuxerThread =
-            VideoMuxerThread(mMediaFormat!!, callback = object : VideoMuxerThread.Callback {
+            VideoMuxerThread(mMediaFormat!!, audioFormat = mAudioFormat,
+                callback = object : VideoMuxerThread.Callback {
                 override fun getFirstIFrameData(): FrameData? {
-                    val res = FrameDataCacheUtils.getFirstFrameData(
+                    val res = FrameDataCacheUtils.getFirstSampleData(
                         startTime,
                         mCurTimeStamp,
+                        mCurTrackId,
                         mFrameBuffer,
                         mLength
                     )
                     if (res == DataCacheCode.RES_SUCCESS) {
-                        return FrameData(mFrameBuffer, mLength[0], mCurTimeStamp[0], true)
+                        return FrameData(
+                            mFrameBuffer, mLength[0], mCurTimeStamp[0], true, mCurTrackId[0]
+                        )
                     }
                     return null
                 }
 
                 override fun getNextFrameData(): FrameData? {
-                    val res = FrameDataCacheUtils.getNextFrameData(
+                    val res = FrameDataCacheUtils.getNextSampleData(
                         mCurTimeStamp[0],
+                        mCurTrackId[0],
                         mCurTimeStamp,
+                        mCurTrackId,
                         mFrameBuffer,
                         mLength,
                         mIsKeyFrame
@@ -153,8 +196,12 @@ class ScreenCaptureManager {
                         if (mCurTimeStamp[0] > endTime) {
                             mVideoMuxerThread?.quit()
                         }
-                        return FrameData(mFrameBuffer, mLength[0], mCurTimeStamp[0], mIsKeyFrame[0])
-                    } else if (res == DataCacheCode.RES_FAILED) {
+                        return FrameData(
+                            mFrameBuffer, mLength[0], mCurTimeStamp[0], mIsKeyFrame[0],
+                            mCurTrackId[0]
+                        )
+                    } else if (res != DataCacheCode.RES_WAITING) {
+                        // 帧已被覆盖或帧数据数组不够大，都无法继续读取
                         mVideoMuxerThread?.quit()
                     }
                     return null
@@ -173,6 +220,95 @@ class ScreenCaptureManager {
         mVideoMuxerThread?.start()
     }
 
+    /**
+     * 只从缓存中提取关键帧快速合成缩时视频，无需解码和重新编码
+     *
+     * @param startTime 开始时间戳 ms
+     * @param endTime 结束时间戳 ms
+     * @param fps 合成视频的帧率（1~1000），每个关键帧播放 1000 / fps ms
+     * @param callback 合成完成回调
+     */
+    fun startTimelapseMuxer(startTime: Long, endTime: Long, fps: Int, callback: Callback) {
+        if (mMediaFormat == null || fps !in 1..1000) {
+            LogUtils.e(TAG, "startTimelapseMuxer invalid params fps $fps")
+            return
+        }
+        if (!isMuxer.compareAndSet(false, true)) {
+            LogUtils.e(TAG, "正在制作视频。。。")
+            return
+        }
+        var started = false
+        try {
+            startTimelapseMuxerThread(startTime, endTime, 1000L / fps, callback)
+            started = true
+        } finally {
+            // 合成线程没有启动就不会回调 finished，需在这里恢复缓存
+            if (!started) {
+                isMuxer.set(false)
+            }
+        }
+    }
+
+    private fun startTimelapseMuxerThread(
+        startTime: Long, endTime: Long, frameInterval: Long, callback: Callback
+    ) {
+        // 删除旧的Cache文件，只保留8个
+        FileUtils.deleteOldFiles(FileUtils.videoDir, 8)
+        var firstTimestamp = 0L
+        var frameCount = 0L
+        mVideoMuxerThread =
+            VideoMuxerThread(mMediaFormat!!, callback = object : VideoMuxerThread.Callback {
+                override fun getFirstIFrameData(): FrameData? {
+                    val res = FrameDataCacheUtils.getFirstFrameData(
+                        startTime,
+                        mCurTimeStamp,
+                        mFrameBuffer,
+                        mLength
+                    )
+                    if (res == DataCacheCode.RES_SUCCESS) {
+                        firstTimestamp = mCurTimeStamp[0]
+                        frameCount = 1
+                        return FrameData(mFrameBuffer, mLength[0], firstTimestamp, true)
+                    }
+                    return null
+                }
+
+                override fun getNextFrameData(): FrameData? {
+                    val res = FrameDataCacheUtils.getNextKeyFrameData(
+                        mCurTimeStamp[0],
+                        mCurTimeStamp,
+                        mFrameBuffer,
+                        mLength
+                    )
+                    if (res == DataCacheCode.RES_SUCCESS) {
+                        if (mCurTimeStamp[0] > endTime) {
+                            mVideoMuxerThread?.quit()
+                            return null
+                        }
+                        // 关键帧按目标帧率重新计算时间戳
+                        return FrameData(
+                            mFrameBuffer, mLength[0], firstTimestamp + frameInterval * frameCount++,
+                            true
+                        )
+                    }
+                    // 合成期间暂停了缓存，RES_WAITING 说明已经读到最后一个缓存的关键帧，不会再有新数据
+                    mVideoMuxerThread?.quit()
+                    return null
+                }
+
+                override fun finished(filePath: String) {
+                    try {
+                        finishedMuxerTask[endTime] = filePath
+                    } finally {
+                        isMuxer.set(false)
+                    }
+                    callback.muxerFinished(filePath)
+                }
+            })
+
+        mVideoMuxerThread?.start()
+    }
+
     /**
      * Muxer视频任务是否结束
      *
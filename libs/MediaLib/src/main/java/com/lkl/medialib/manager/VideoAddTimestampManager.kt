@@ -4,6 +4,7 @@ import android.media.MediaFormat
 import android.util.Size
 import com.lkl.commonlib.util.DisplayUtils
 import com.lkl.commonlib.util.LogUtils
+import com.lkl.framedatacachejni.TimestampSeiUtils
 import com.lkl.medialib.bean.FrameData
 import com.lkl.medialib.bean.Position
 import com.lkl.medialib.constant.VideoProperty
@@ -54,6 +55,46 @@ class VideoAddTimestampManager {
         startExtractVideo(videoFilePath)
     }
 
+    /**
+     * 不解码、不重新编码，直接在每帧码流中插入携带时间戳的SEI后重新封装
+     *
+     * @param videoFilePath 视频文件路径
+     */
+    fun startInjectTimestamp(videoFilePath: String) {
+        val startTimestamp = System.currentTimeMillis()
+        var isHevc = false
+        VideoExtractorThread(videoFilePath, object : VideoExtractorThread.Callback {
+            override fun preExtract(mimeType: String, mediaFormat: MediaFormat) {
+                mMineType = mimeType
+                isHevc = mimeType == MediaFormat.MIMETYPE_VIDEO_HEVC
+                LogUtils.d(TAG, "startInjectTimestamp preExtract mMineType $mMineType")
+                startMuxerVideo(mediaFormat)
+            }
+
+            override fun putExtractData(frameData: FrameData) {
+                val seiData = ByteArray(frameData.length + TimestampSeiUtils.SEI_MAX_SIZE)
+                val length = TimestampSeiUtils.injectTimestampSei(
+                    isHevc,
+                    startTimestamp + frameData.timestamp,
+                    frameData.data,
+                    frameData.length,
+                    seiData
+                )
+                if (length > 0) {
+                    frameData.data = seiData
+                    frameData.length = length
+                } else {
+                    LogUtils.e(TAG, "startInjectTimestamp inject sei failed $frameData")
+                }
+                addCacheFrameData(mEncodedDataQueue, frameData)
+            }
+
+            override fun finished() {
+                isEncodedFinished.set(true)
+            }
+        }).start()
+    }
+
     private fun startExtractVideo(videoFilePath: String) {
         val file = File(videoFilePath).name
         LogUtils.e(TAG, "file $file")
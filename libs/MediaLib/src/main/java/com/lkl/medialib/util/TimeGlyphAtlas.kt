@@ -0,0 +1,95 @@
+package com.lkl.medialib.util
+
+import android.graphics.Color
+import com.lkl.commonlib.util.BitmapUtils
+import com.lkl.yuvjni.YuvUtils
+import java.nio.ByteBuffer
+
+/**
+ * 时间水印字形表，数字及分隔符只渲染、转换一次，之后每帧在native逐字叠加，不再生成Bitmap
+ *
+ * @param textSize 字体大小
+ * @param textColor 字体颜色
+ */
+class TimeGlyphAtlas(textSize: Float = 30f, textColor: Int = Color.RED) {
+    companion object {
+        /**
+         * DateUtils.DATE_TIME_MS 格式用到的所有字符
+         */
+        private const val GLYPHS = "0123456789-: ."
+    }
+
+    private var atlas = YuvUtils.createGlyphAtlas()
+
+    /**
+     * 字形的高度
+     */
+    val height: Int
+
+    init {
+        for (glyph in GLYPHS) {
+            val bitmap = BitmapUtils.textAsBitmap(glyph.toString(), textSize, textColor)
+            // 获取预乘alpha的rgba byte 数组
+            val buffer = ByteBuffer.allocate(bitmap.rowBytes * bitmap.height)
+            bitmap.copyPixelsToBuffer(buffer)
+            YuvUtils.addGlyph(
+                atlas, glyph, buffer.array(), bitmap.rowBytes, bitmap.width, bitmap.height
+            )
+            bitmap.recycle()
+        }
+        height = YuvUtils.getGlyphAtlasHeight(atlas)
+    }
+
+    /**
+     * 时间水印的宽度
+     *
+     * @param timestamp 时间戳 ms
+     * @param format Key.TIME_FORMAT_XXX
+     */
+    fun measure(timestamp: Long, format: Int): Int {
+        return YuvUtils.measureTimestamp(atlas, timestamp, format)
+    }
+
+    /**
+     * NV21数据上叠加时间水印
+     *
+     * @param data NV21数据
+     * @param width 宽度
+     * @param height 高度
+     * @param timestamp 时间戳 ms
+     * @param format Key.TIME_FORMAT_XXX
+     * @param x 左上角X坐标
+     * @param y 左上角Y坐标
+     */
+    fun draw(data: ByteArray, width: Int, height: Int, timestamp: Long, format: Int, x: Int, y: Int) {
+        YuvUtils.NV21DrawTimestamp(data, width, height, atlas, timestamp, format, x, y)
+    }
+
+    /**
+     * NV21数据上叠加时间水印，数据位于native内存，如 YuvBuffer.address()
+     *
+     * @param address NV21数据的native地址
+     */
+    fun draw(address: Long, width: Int, height: Int, timestamp: Long, format: Int, x: Int, y: Int) {
+        YuvUtils.NV21DrawTimestamp(address, width, height, atlas, timestamp, format, x, y)
+    }
+
+    /**
+     * 多帧NV21数据上批量叠加时间水印，一次JNI调用，帧之间在native线程池上并行
+     *
+     * @param addresses 每帧NV21数据的native地址
+     * @param count 帧数，不超过 Key.BATCH_MAX_FRAMES
+     * @param timestamps 每帧的时间戳 ms
+     */
+    fun drawBatch(
+        addresses: LongArray, count: Int, width: Int, height: Int, timestamps: LongArray, format: Int,
+        x: Int, y: Int
+    ) {
+        YuvUtils.NV21DrawTimestampBatch(addresses, count, width, height, atlas, timestamps, format, x, y)
+    }
+
+    fun release() {
+        YuvUtils.releaseGlyphAtlas(atlas)
+        atlas = 0
+    }
+}
@@ -17,21 +17,17 @@ package com.lkl.medialib.util
 
 import com.lkl.commonlib.util.LogUtils.d
 import com.lkl.commonlib.util.LogUtils.w
-import com.lkl.commonlib.util.DateUtils.convertDateToString
-import com.lkl.commonlib.util.BitmapUtils.textAsBitmap
 import android.media.MediaCodec
 import kotlin.Throws
 import android.media.MediaFormat
 import android.media.MediaCodecInfo
 import com.lkl.medialib.constant.VideoProperty
 import com.lkl.framedatacachejni.FrameDataCacheUtils
-import com.lkl.commonlib.util.DateUtils
 import com.lkl.medialib.BuildConfig
+import com.lkl.yuvjni.Key
 import com.lkl.yuvjni.YuvUtils
 import java.io.IOException
 import java.lang.Exception
-import java.nio.ByteBuffer
-import java.util.*
 
 /**
  * This class wraps up the core components used for surface-input video encoding.
@@ -58,6 +54,12 @@ class VideoEncoderCore(private val mFrameRate: Int) : Runnable {
     private var mWidth = 0
     private var mHeight = 0
 
+    /**
+     * 编码器InputBuffer中Y分量每行的字节数及行数
+     */
+    private var mInputStride = 0
+    private var mInputSliceHeight = 0
+
     /**
      * 每帧数据时间间隔
      */
@@ -107,6 +109,13 @@ class VideoEncoderCore(private val mFrameRate: Int) : Runnable {
         // we can use for input and wrap it with a class that handles the EGL work.
         mEncoder = MediaCodec.createEncoderByType(MIME_TYPE)
         mEncoder!!.configure(format, null, null, MediaCodec.CONFIGURE_FLAG_ENCODE)
+        val inputFormat = mEncoder!!.inputFormat
+        mInputStride = if (inputFormat.containsKey(MediaFormat.KEY_STRIDE)) {
+            inputFormat.getInteger(MediaFormat.KEY_STRIDE).coerceAtLeast(width)
+        } else width
+        mInputSliceHeight = if (inputFormat.containsKey(MediaFormat.KEY_SLICE_HEIGHT)) {
+            inputFormat.getInteger(MediaFormat.KEY_SLICE_HEIGHT).coerceAtLeast(height)
+        } else height
 
         // 初始化H264数据缓冲区
         FrameDataCacheUtils.initCache(30, BuildConfig.DEBUG)
@@ -154,6 +163,8 @@ class VideoEncoderCore(private val mFrameRate: Int) : Runnable {
             mEncoder!!.release()
             mEncoder = null
         }
+        timeGlyphAtlas?.release()
+        timeGlyphAtlas = null
     }
 
     /**
@@ -169,61 +180,33 @@ class VideoEncoderCore(private val mFrameRate: Int) : Runnable {
         synchronized(mFrameDataSemaphore) { mFrameDataSemaphore.notifyAll() }
     }
 
-    private var yuv: ByteArray? = null
-
     //    private byte[] rgbData;
-    private var lastTimeWaterMark = ""
-    private var lastTimeWaterMarkWidth = 0
-    private var lastTimeWaterMarkHeight = 0
-    private lateinit var lastTimeWaterMarkYuv: ByteArray
+    /**
+     * 时间水印字形表，首次使用时创建
+     */
+    private var timeGlyphAtlas: TimeGlyphAtlas? = null
+    private var timeWaterMarkX = 0
+    private var timeWaterMarkY = 0
 
     /**
-     * nv21数据添加时间水印并转为YUV420P
+     * NV21数据上叠加时间水印，逐字叠加预先转换好的字形，不再每秒生成水印图片
      *
-     * @param data 摄像机原始数据 NV21
+     * @param data NV21数据
      * @param timeSpam 数据的时间戳
      */
-    private fun nv21ToYuv420p(data: ByteArray, timeSpam: Long) {
-        val time = convertDateToString(DateUtils.DATE_TIME, Date(timeSpam))
-        if (lastTimeWaterMark != time) {
-            lastTimeWaterMark = time
-            // 时间戳变动了，才需要重新生成新的水印数据
-            // 生成时间水印图片
-            val bitmap = textAsBitmap(time, 30f)
-            lastTimeWaterMarkWidth = bitmap.width
-            lastTimeWaterMarkHeight = bitmap.height
-            // 获取argb byte 数组
-            val timeBuffer =
-                ByteBuffer.allocate(lastTimeWaterMarkWidth * lastTimeWaterMarkHeight * 4)
-            bitmap.copyPixelsToBuffer(timeBuffer)
-            // 图片数据释放
-            bitmap.recycle()
-            lastTimeWaterMarkYuv =
-                ByteArray(lastTimeWaterMarkWidth * lastTimeWaterMarkHeight * 3 / 2)
-            // 将argb数据转为 NV21
-//            YuvUtils.RgbaToI420(Key.ARGB_TO_I420, timeBuffer.array(), lastTimeWaterMarkYuv, lastTimeWaterMarkWidth, lastTimeWaterMarkHeight);
-            YuvUtils.ArgbToNV21(
-                timeBuffer.array(),
-                lastTimeWaterMarkYuv,
-                lastTimeWaterMarkWidth,
-                lastTimeWaterMarkHeight
-            )
+    private fun drawTimeWaterMark(data: ByteArray, timeSpam: Long) {
+        var atlas = timeGlyphAtlas
+        if (atlas == null) {
+            atlas = TimeGlyphAtlas(30f)
+            timeGlyphAtlas = atlas
+            // 数字等宽，水印宽度固定，位置只需计算一次
+            val width = atlas.measure(timeSpam, Key.TIME_FORMAT_DATE_TIME)
+            timeWaterMarkX = mWidth - width - atlas.height
+            timeWaterMarkY = mHeight - 2 * atlas.height
         }
-
-        // NV21数据添加时间水印
-        YuvUtils.NV21AddWaterMark(
-            mWidth - lastTimeWaterMarkWidth - lastTimeWaterMarkHeight,
-            mHeight - 2 * lastTimeWaterMarkHeight,
-            lastTimeWaterMarkYuv,
-            lastTimeWaterMarkWidth,
-            lastTimeWaterMarkHeight,
-            data,
-            mWidth,
-            mHeight
+        atlas.draw(
+            data, mWidth, mHeight, timeSpam, Key.TIME_FORMAT_DATE_TIME, timeWaterMarkX, timeWaterMarkY
         )
-
-        // 将NV21数据转为YUV420P（I420）
-        YuvUtils.NV21ToI420(data, yuv, mWidth, mHeight, false)
     }
 
     /**
@@ -242,12 +225,8 @@ class VideoEncoderCore(private val mFrameRate: Int) : Runnable {
                 d(TAG, "InputBuffer is null point")
                 return
             }
-            if (yuv == null) {
-                yuv = ByteArray(mWidth * mHeight * 3 / 2)
-                //                rgbData = new byte[mWidth * mHeight * 3];
-            }
-            // YUV图片叠加的方式，会导致时间戳部分文字显示不自然
-            nv21ToYuv420p(data, timestamp)
+            // 按alpha混合叠加时间水印，只处理水印所在区域
+            drawTimeWaterMark(data, timestamp)
 
 //            YuvUtils.NV21ToI420(data, yuv, mWidth, mHeight, false);
 //            LogUtils.i(TAG, "start nv21 to rgb24");
@@ -259,8 +238,16 @@ class VideoEncoderCore(private val mFrameRate: Int) : Runnable {
 //                    DateUtils.convertDateToString(DateUtils.DATE_TIME, new Date(timeSptamp)));
 //            LogUtils.i(TAG,"end add text");
             buffer.clear()
-            buffer.put(yuv)
-            mEncoder!!.queueInputBuffer(index, 0, data.size, timestamp * 1000, 0)
+            // 转为YUV420P（I420），直接写入InputBuffer
+            val size = YuvUtils.NV21ToYuv420WithWaterMark(
+                data, mWidth, mHeight, null, 0, 0, 0, 0,
+                buffer, buffer.position(), mInputStride, mInputSliceHeight, Key.YUV_I420
+            )
+            if (size < 0) {
+                w(TAG, "NV21ToYuv420WithWaterMark failed")
+                return
+            }
+            mEncoder!!.queueInputBuffer(index, 0, size, timestamp * 1000, 0)
         }
         drainEncoder(false)
     }
@@ -311,19 +298,11 @@ class VideoEncoderCore(private val mFrameRate: Int) : Runnable {
                     mBufferInfo.size = 0
                 }
                 if (mBufferInfo.size != 0) {
-                    // adjust the ByteBuffer values to match BufferInfo (not needed?)
-                    encodedData.position(mBufferInfo.offset)
-                    encodedData.limit(mBufferInfo.offset + mBufferInfo.size)
-
-                    // 取出编码好的H264数据
-                    val data = ByteArray(mBufferInfo.size)
-                    encodedData[data]
-
-                    // 将编码好的H264数据存储到缓冲中
+                    // 将编码好的H264数据直接从OutputBuffer存储到缓冲中，不再每帧创建数组
                     FrameDataCacheUtils.addFrameData(
                         mBufferInfo.presentationTimeUs / 1000,
                         mBufferInfo.flags == MediaCodec.BUFFER_FLAG_KEY_FRAME,
-                        data, mBufferInfo.size
+                        encodedData, mBufferInfo.offset, mBufferInfo.size
                     )
 
 //                    LogUtils.d(TAG, "sent " + mBufferInfo.size + " bytes to muxer, ts=" +
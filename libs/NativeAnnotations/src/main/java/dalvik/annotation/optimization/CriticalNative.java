@@ -0,0 +1,17 @@
+package dalvik.annotation.optimization;
+
+import java.lang.annotation.ElementType;
+import java.lang.annotation.Retention;
+import java.lang.annotation.RetentionPolicy;
+import java.lang.annotation.Target;
+
+/**
+ * 与系统 dalvik.annotation.optimization.CriticalNative 同名的编译期注解（SDK 中为隐藏 API）
+ * <p>
+ * 只能用于参数和返回值都是基本类型的 static native 方法，native 函数没有 JNIEnv 和 jclass 参数；
+ * Android 8.0 以下系统忽略该注解，仍按普通 JNI 调用，注册时需要根据系统版本选择对应的函数
+ */
+@Retention(RetentionPolicy.CLASS)
+@Target(ElementType.METHOD)
+public @interface CriticalNative {
+}
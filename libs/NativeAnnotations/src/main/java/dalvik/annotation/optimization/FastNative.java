@@ -0,0 +1,16 @@
+package dalvik.annotation.optimization;
+
+import java.lang.annotation.ElementType;
+import java.lang.annotation.Retention;
+import java.lang.annotation.RetentionPolicy;
+import java.lang.annotation.Target;
+
+/**
+ * 与系统 dalvik.annotation.optimization.FastNative 同名的编译期注解（SDK 中为隐藏 API）
+ * <p>
+ * 标注的 native 方法调用时不切换线程状态，适用于耗时短、不阻塞的 JNI 方法；Android 8.0 以下系统忽略该注解
+ */
+@Retention(RetentionPolicy.CLASS)
+@Target(ElementType.METHOD)
+public @interface FastNative {
+}
@@ -0,0 +1,98 @@
+#ifndef NATIVE_TRACE_H
+#define NATIVE_TRACE_H
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * yuv-jni、framedatacachejni 共用的 trace 记录，每个库在自己的头文件中先定义 NATIVE_TRACE_NAMESPACE 再包含本文件，
+ * 并在一个源文件中包含 NativeTraceImpl.h 编译一份实现
+ *
+ * 两个so都导出默认可见的符号，各库使用不同的命名空间，符号不会重名，开关和导出互不影响
+ */
+#ifndef NATIVE_TRACE_NAMESPACE
+#error "define NATIVE_TRACE_NAMESPACE before including NativeTrace.h"
+#endif
+
+// 每个线程的环形缓冲保留的事件数（2的幂），写满后覆盖最早的事件
+#define TRACE_RING_SIZE 4096
+
+namespace NATIVE_TRACE_NAMESPACE {
+
+/**
+ * 是否正在记录trace事件，关闭时 TRACE_SCOPE 只有这一次读取
+ */
+extern std::atomic<bool> gTraceEnabled;
+
+static inline bool traceEnabled() {
+    return gTraceEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * 开始或停止记录trace事件，开始时清空之前记录的事件
+ *
+ * 开启期间每个事件同时输出为 ATrace section（Android 6.0 及以上），与 MediaCodec 等系统事件显示在
+ * systrace / Perfetto 的同一时间轴上，并记录到当前线程的环形缓冲中，可用 dumpTrace 导出
+ */
+void setTraceEnabled(bool enabled);
+
+/**
+ * 将各线程环形缓冲中的事件按 Chrome trace JSON 格式写入文件，可直接用 Perfetto UI 或 chrome://tracing 打开
+ *
+ * 时间戳为 CLOCK_MONOTONIC 微秒，与同一进程中其他库导出的文件可以合并显示
+ *
+ * @return 写入的事件数，-1打开文件失败
+ */
+int dumpTrace(const char *path);
+
+/**
+ * 事件开始，返回开始时间，供 TraceScope 使用
+ */
+uint64_t traceBegin(const char *name);
+
+/**
+ * 事件结束，记录到当前线程的环形缓冲中
+ */
+void traceEnd(const char *name, uint64_t start);
+
+/**
+ * 作用域内的trace事件，构造时开始，析构时结束
+ *
+ * 开始时未开启记录则整个作用域都不记录；中途关闭仍会结束已开始的事件，保证 ATrace section 成对
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char *name) : name(nullptr), start(0) {
+        if (traceEnabled()) {
+            this->name = name;
+            start = traceBegin(name);
+        }
+    }
+
+    ~TraceScope() {
+        if (name != nullptr) {
+            traceEnd(name, start);
+        }
+    }
+
+private:
+    TraceScope(const TraceScope &) = delete;
+
+    TraceScope &operator=(const TraceScope &) = delete;
+
+    // 须为字符串常量，导出时才读取
+    const char *name;
+    uint64_t start;
+};
+
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+/**
+ * 记录当前作用域，name 须为字符串常量（或 __func__）
+ */
+#define TRACE_SCOPE(name) \
+    NATIVE_TRACE_NAMESPACE::TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+#endif //NATIVE_TRACE_H
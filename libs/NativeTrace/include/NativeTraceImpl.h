@@ -0,0 +1,223 @@
+#ifndef NATIVE_TRACE_IMPL_H
+#define NATIVE_TRACE_IMPL_H
+
+/**
+ * NativeTrace.h 的实现，每个库只在一个源文件中包含一次，包含前须先包含该库的 trace 头文件（定义了
+ * NATIVE_TRACE_NAMESPACE），并定义导出事件的分类名 NATIVE_TRACE_CATEGORY
+ */
+#ifndef NATIVE_TRACE_CATEGORY
+#error "define NATIVE_TRACE_CATEGORY before including NativeTraceImpl.h"
+#endif
+
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+#include "NativeTrace.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef ANDROID
+#include <dlfcn.h>
+#endif
+
+namespace NATIVE_TRACE_NAMESPACE {
+
+std::atomic<bool> gTraceEnabled(false);
+
+/**
+ * 一个结束的事件，字段都为原子变量，导出时读到正在覆盖的事件也不会出现数据竞争
+ */
+struct TraceEvent {
+    std::atomic<const char *> name;
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> duration;
+    std::atomic<int> tid;
+};
+
+/**
+ * 单个线程写入的环形缓冲，只有所属线程写入，导出时按 head 丢弃可能已被覆盖的事件
+ */
+struct TraceRing {
+    // 写入的事件总数
+    std::atomic<uint64_t> head;
+    // 开始记录时的 head，之前的事件不再导出
+    std::atomic<uint64_t> base;
+    // 是否被某个线程占用，线程退出后可被新线程复用
+    bool inUse;
+    TraceEvent events[TRACE_RING_SIZE];
+};
+
+// 所有分配过的环形缓冲，只在线程第一次记录、导出及清空时加锁，进程退出前不释放
+static std::mutex sRingMutex;
+static std::vector<TraceRing *> sRings;
+
+/**
+ * 线程退出时归还环形缓冲，已记录的事件保留到被复用的线程覆盖
+ */
+struct TraceThread {
+    TraceRing *ring = nullptr;
+
+    ~TraceThread() {
+        if (ring != nullptr) {
+            std::lock_guard<std::mutex> lock(sRingMutex);
+            ring->inUse = false;
+        }
+    }
+};
+
+static thread_local TraceThread sTraceThread;
+static thread_local int sTid = 0;
+
+#ifdef ANDROID
+// ATrace_beginSection / ATrace_endSection 为 API 23 新增，minSdk 21 时运行时加载
+static std::atomic<void (*)(const char *)> sATraceBegin(nullptr);
+static std::atomic<void (*)()> sATraceEnd(nullptr);
+static std::once_flag sATraceOnce;
+
+static void loadATrace() {
+    void *lib = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+    if (lib == nullptr) {
+        return;
+    }
+    void *begin = dlsym(lib, "ATrace_beginSection");
+    void *end = dlsym(lib, "ATrace_endSection");
+    if (begin != nullptr && end != nullptr) {
+        // 先设置 end，开始的 section 都能结束
+        sATraceEnd = (void (*)()) end;
+        sATraceBegin = (void (*)(const char *)) begin;
+    }
+}
+#endif
+
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int currentTid() {
+    if (sTid == 0) {
+#ifdef __linux__
+        sTid = (int) syscall(SYS_gettid);
+#else
+        sTid = (int) (uintptr_t) pthread_self();
+#endif
+    }
+    return sTid;
+}
+
+static TraceRing *threadRing() {
+    if (sTraceThread.ring != nullptr) {
+        return sTraceThread.ring;
+    }
+    std::lock_guard<std::mutex> lock(sRingMutex);
+    TraceRing *ring = nullptr;
+    for (size_t i = 0; i < sRings.size(); i++) {
+        if (!sRings[i]->inUse) {
+            ring = sRings[i];
+            break;
+        }
+    }
+    if (ring == nullptr) {
+        ring = new TraceRing();
+        sRings.push_back(ring);
+    }
+    ring->inUse = true;
+    sTraceThread.ring = ring;
+    return ring;
+}
+
+void setTraceEnabled(bool enabled) {
+#ifdef ANDROID
+    if (enabled) {
+        std::call_once(sATraceOnce, loadATrace);
+    }
+#endif
+    if (enabled && !gTraceEnabled) {
+        std::lock_guard<std::mutex> lock(sRingMutex);
+        for (size_t i = 0; i < sRings.size(); i++) {
+            sRings[i]->base = sRings[i]->head.load();
+        }
+    }
+    gTraceEnabled = enabled;
+}
+
+uint64_t traceBegin(const char *name) {
+#ifdef ANDROID
+    void (*begin)(const char *) = sATraceBegin.load(std::memory_order_relaxed);
+    if (begin != nullptr) {
+        begin(name);
+    }
+#else
+    (void) name;
+#endif
+    return nowNs();
+}
+
+void traceEnd(const char *name, uint64_t start) {
+    uint64_t end = nowNs();
+#ifdef ANDROID
+    void (*endSection)() = sATraceEnd.load(std::memory_order_relaxed);
+    if (endSection != nullptr) {
+        endSection();
+    }
+#endif
+    TraceRing *ring = threadRing();
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    TraceEvent &event = ring->events[head & (TRACE_RING_SIZE - 1)];
+    // 导出线程读到新写入的字段时，也能读到覆盖前的 head，从而丢弃该位置
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.duration.store(end - start, std::memory_order_relaxed);
+    event.tid.store(currentTid(), std::memory_order_relaxed);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+int dumpTrace(const char *path) {
+    FILE *fp = fopen(path, "w");
+    if (fp == nullptr) {
+        return -1;
+    }
+    int pid = (int) getpid();
+    int count = 0;
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    std::lock_guard<std::mutex> lock(sRingMutex);
+    for (size_t i = 0; i < sRings.size(); i++) {
+        TraceRing *ring = sRings[i];
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t base = ring->base.load(std::memory_order_relaxed);
+        // 所属线程下一个写入的位置可能正在被覆盖，最多导出 TRACE_RING_SIZE - 1 个
+        uint64_t first = head >= TRACE_RING_SIZE ? head - TRACE_RING_SIZE + 1 : 0;
+        for (uint64_t index = first > base ? first : base; index < head; index++) {
+            const TraceEvent &event = ring->events[index & (TRACE_RING_SIZE - 1)];
+            const char *name = event.name.load(std::memory_order_relaxed);
+            uint64_t start = event.start.load(std::memory_order_relaxed);
+            uint64_t duration = event.duration.load(std::memory_order_relaxed);
+            int tid = event.tid.load(std::memory_order_relaxed);
+            // 读取期间所属线程可能继续写入，已被覆盖的位置丢弃
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t current = ring->head.load(std::memory_order_relaxed);
+            if (index + TRACE_RING_SIZE <= current) {
+                continue;
+            }
+            fprintf(fp, "%s\n{\"name\":\"%s\",\"cat\":\"" NATIVE_TRACE_CATEGORY "\",\"ph\":\"X\",\"ts\":%.3f,"
+                        "\"dur\":%.3f,\"pid\":%d,\"tid\":%d}", count > 0 ? "," : "", name,
+                    start / 1000.0, duration / 1000.0, pid, tid);
+            count++;
+        }
+    }
+    fprintf(fp, "\n]}\n");
+    fclose(fp);
+    return count;
+}
+
+}
+
+#endif //NATIVE_TRACE_IMPL_H
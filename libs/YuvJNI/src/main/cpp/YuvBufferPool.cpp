@@ -0,0 +1,236 @@
+#include <stdlib.h>
+#include <atomic>
+#include <mutex>
+#include "libyuv/scratch.h"
+#include "YuvBufferPool.h"
+
+// header 占用的字节数，保证 data 同样按 BUFFER_POOL_ALIGN 对齐
+#define BUFFER_HEADER_SIZE BUFFER_POOL_ALIGN
+
+static_assert(sizeof(PoolBuffer) <= BUFFER_HEADER_SIZE, "PoolBuffer header too large");
+
+/**
+ * 各规格的空闲链表，取出、归还都只在链表头操作
+ */
+struct BufferPool {
+    std::mutex mutex;
+    PoolBuffer *freeList[BUFFER_POOL_CLASS_COUNT] = {};
+    int64_t cachedBytes = 0;
+    int64_t limit = BUFFER_POOL_DEFAULT_LIMIT;
+};
+
+static BufferPool *sBufferPool = new BufferPool();
+static std::atomic<int64_t> sAllocCount(0);
+
+/**
+ * 计算 size 所属的规格及其容量
+ *
+ * @return 规格序号，超出最大规格时返回-1
+ */
+static int sizeClassOf(size_t size, size_t *capacity) {
+    size_t base = BUFFER_POOL_MIN_SIZE;
+    for (int index = 0; index < BUFFER_POOL_CLASS_COUNT; index += 4, base <<= 1) {
+        for (int step = 0; step < 4; step++) {
+            size_t classSize = base + (base >> 2) * step;
+            if (size <= classSize) {
+                *capacity = classSize;
+                return index + step;
+            }
+        }
+    }
+    return -1;
+}
+
+static void freePoolBuffer(PoolBuffer *buffer) {
+    free(buffer);
+}
+
+PoolBuffer *acquirePoolBuffer(size_t size) {
+    size_t capacity = 0;
+    int sizeClass = sizeClassOf(size, &capacity);
+    if (sizeClass < 0) {
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sBufferPool->mutex);
+        PoolBuffer *buffer = sBufferPool->freeList[sizeClass];
+        if (buffer != nullptr) {
+            sBufferPool->freeList[sizeClass] = buffer->next;
+            sBufferPool->cachedBytes -= buffer->capacity;
+            buffer->next = nullptr;
+            buffer->size = size;
+            return buffer;
+        }
+    }
+
+    void *memory = nullptr;
+    if (posix_memalign(&memory, BUFFER_POOL_ALIGN, BUFFER_HEADER_SIZE + capacity) != 0) {
+        return nullptr;
+    }
+    sAllocCount++;
+    PoolBuffer *buffer = (PoolBuffer *) memory;
+    buffer->data = (uint8_t *) memory + BUFFER_HEADER_SIZE;
+    buffer->size = size;
+    buffer->capacity = capacity;
+    buffer->sizeClass = sizeClass;
+    buffer->next = nullptr;
+    return buffer;
+}
+
+void releasePoolBuffer(PoolBuffer *buffer) {
+    if (buffer == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sBufferPool->mutex);
+        if (sBufferPool->cachedBytes + (int64_t) buffer->capacity <= sBufferPool->limit) {
+            buffer->next = sBufferPool->freeList[buffer->sizeClass];
+            sBufferPool->freeList[buffer->sizeClass] = buffer;
+            sBufferPool->cachedBytes += buffer->capacity;
+            return;
+        }
+    }
+    freePoolBuffer(buffer);
+}
+
+void trimBufferPool() {
+    PoolBuffer *freeList[BUFFER_POOL_CLASS_COUNT];
+    {
+        std::lock_guard<std::mutex> lock(sBufferPool->mutex);
+        for (int i = 0; i < BUFFER_POOL_CLASS_COUNT; i++) {
+            freeList[i] = sBufferPool->freeList[i];
+            sBufferPool->freeList[i] = nullptr;
+        }
+        sBufferPool->cachedBytes = 0;
+    }
+    // 锁外释放，不阻塞其他线程取用
+    for (int i = 0; i < BUFFER_POOL_CLASS_COUNT; i++) {
+        PoolBuffer *buffer = freeList[i];
+        while (buffer != nullptr) {
+            PoolBuffer *next = buffer->next;
+            freePoolBuffer(buffer);
+            buffer = next;
+        }
+    }
+}
+
+void setBufferPoolLimit(int64_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(sBufferPool->mutex);
+        sBufferPool->limit = bytes < 0 ? BUFFER_POOL_DEFAULT_LIMIT : bytes;
+        if (sBufferPool->cachedBytes <= sBufferPool->limit) {
+            return;
+        }
+    }
+    // 上限调小后已缓存的超出部分直接清空，之后按新上限重新缓存
+    trimBufferPool();
+}
+
+int64_t getBufferPoolAllocCount() {
+    return sAllocCount;
+}
+
+int64_t getBufferPoolCachedBytes() {
+    std::lock_guard<std::mutex> lock(sBufferPool->mutex);
+    return sBufferPool->cachedBytes;
+}
+
+// arena 中每块前的header，保证返回的地址16字节对齐
+#define SCRATCH_HEADER_SIZE 16
+#define SCRATCH_IN_ARENA 1
+#define SCRATCH_IN_HEAP 2
+
+struct ScratchHeader {
+    size_t size;
+    size_t kind;
+};
+
+static_assert(sizeof(ScratchHeader) <= SCRATCH_HEADER_SIZE, "ScratchHeader too large");
+
+/**
+ * 线程私有的 scratch 内存，线程退出时释放
+ */
+struct ScratchArena {
+    uint8_t *base = nullptr;
+    size_t capacity = 0;
+    size_t top = 0;
+    // 未归还的块数，为0时从头复用
+    int live = 0;
+    // 当前及本轮调用中同时占用的字节数峰值，用于扩容
+    size_t inUse = 0;
+    size_t peak = 0;
+
+    ~ScratchArena() {
+        free(base);
+    }
+};
+
+static thread_local ScratchArena sScratchArena;
+static std::atomic<int64_t> sScratchAllocCount(0);
+
+static void *scratchAlloc(size_t size) {
+    ScratchArena &arena = sScratchArena;
+    size_t need = (size + SCRATCH_HEADER_SIZE + 15) & ~(size_t) 15;
+    ScratchHeader *header;
+    if (arena.top + need <= arena.capacity) {
+        header = (ScratchHeader *) (arena.base + arena.top);
+        header->kind = SCRATCH_IN_ARENA;
+        arena.top += need;
+    } else {
+        header = (ScratchHeader *) malloc(need);
+        if (header == nullptr) {
+            return nullptr;
+        }
+        sScratchAllocCount++;
+        header->kind = SCRATCH_IN_HEAP;
+    }
+    header->size = need;
+    arena.live++;
+    if (need <= SCRATCH_ARENA_MAX_SIZE) {
+        arena.inUse += need;
+        if (arena.inUse > arena.peak) {
+            arena.peak = arena.inUse;
+        }
+    }
+    return (uint8_t *) header + SCRATCH_HEADER_SIZE;
+}
+
+static void scratchFree(void *ptr) {
+    ScratchArena &arena = sScratchArena;
+    ScratchHeader *header = (ScratchHeader *) ((uint8_t *) ptr - SCRATCH_HEADER_SIZE);
+    if (header->size <= SCRATCH_ARENA_MAX_SIZE) {
+        arena.inUse -= header->size;
+    }
+    if (header->kind == SCRATCH_IN_HEAP) {
+        free(header);
+    }
+    if (--arena.live > 0) {
+        return;
+    }
+    // 所有块都已归还，从头复用；本轮峰值超出容量时扩容，峰值不超过上限
+    arena.top = 0;
+    if (arena.peak > arena.capacity) {
+        size_t capacity = (arena.peak + 4095) & ~(size_t) 4095;
+        if (capacity > SCRATCH_ARENA_MAX_SIZE) {
+            capacity = SCRATCH_ARENA_MAX_SIZE;
+        }
+        if (capacity > arena.capacity) {
+            void *base = nullptr;
+            if (posix_memalign(&base, BUFFER_POOL_ALIGN, capacity) == 0) {
+                sScratchAllocCount++;
+                free(arena.base);
+                arena.base = (uint8_t *) base;
+                arena.capacity = capacity;
+            }
+        }
+    }
+    arena.peak = 0;
+}
+
+void installScratchArena() {
+    libyuv::SetScratchAllocator(scratchAlloc, scratchFree);
+}
+
+int64_t getScratchAllocCount() {
+    return sScratchAllocCount;
+}
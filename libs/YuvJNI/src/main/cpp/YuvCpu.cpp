@@ -0,0 +1,562 @@
+#include <dlfcn.h>
+#include <stdarg.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include "libyuv.h"
+#include "libyuv/rotate_row.h"
+#include "libyuv/row.h"
+#include "libyuv/scale_row.h"
+#include "YuvCpu.h"
+#include "YuvOps.h"
+
+using namespace libyuv;
+
+struct CpuFlagName {
+    int flag;
+    const char *name;
+};
+
+static const CpuFlagName kCpuFlagNames[] = {
+        {kCpuHasARM,             "ARM"},
+        {kCpuHasNEON,            "NEON"},
+        {kCpuHasX86,             "X86"},
+        {kCpuHasSSE2,            "SSE2"},
+        {kCpuHasSSSE3,           "SSSE3"},
+        {kCpuHasSSE41,           "SSE41"},
+        {kCpuHasSSE42,           "SSE42"},
+        {kCpuHasAVX,             "AVX"},
+        {kCpuHasAVX2,            "AVX2"},
+        {kCpuHasERMS,            "ERMS"},
+        {kCpuHasFMA3,            "FMA3"},
+        {kCpuHasF16C,            "F16C"},
+        {kCpuHasGFNI,            "GFNI"},
+        {kCpuHasAVX512BW,        "AVX512BW"},
+        {kCpuHasAVX512VL,        "AVX512VL"},
+        {kCpuHasAVX512VBMI,      "AVX512VBMI"},
+        {kCpuHasAVX512VBMI2,     "AVX512VBMI2"},
+        {kCpuHasAVX512VBITALG,   "AVX512VBITALG"},
+        {kCpuHasAVX512VPOPCNTDQ, "AVX512VPOPCNTDQ"},
+        {kCpuHasMIPS,            "MIPS"},
+        {kCpuHasMSA,             "MSA"},
+        {kCpuHasMMI,             "MMI"},
+};
+
+// 指令集档位的名称，按从高到低取生效的第一个
+static const CpuFlagName kCpuLevelNames[] = {
+        {kCpuHasAVX512BW, "AVX512"},
+        {kCpuHasAVX2,     "AVX2"},
+        {kCpuHasSSSE3,    "SSSE3"},
+        {kCpuHasSSE2,     "SSE2"},
+        {kCpuHasNEON,     "NEON"},
+        {kCpuHasMSA,      "MSA"},
+        {kCpuHasMMI,      "MMI"},
+};
+
+static const int kCpuAVX512 = kCpuHasAVX512BW | kCpuHasAVX512VL | kCpuHasAVX512VBMI |
+                              kCpuHasAVX512VBMI2 | kCpuHasAVX512VBITALG |
+                              kCpuHasAVX512VPOPCNTDQ;
+static const int kCpuAVX = kCpuHasAVX | kCpuHasAVX2 | kCpuHasFMA3 | kCpuHasF16C | kCpuHasGFNI;
+static const int kCpuSSSE3 = kCpuHasSSSE3 | kCpuHasSSE41 | kCpuHasSSE42;
+
+// 自动选择时依次比较的特性位，逐档关闭更高的指令集，最后只用C实现；同一平台上生效结果相同的档位只测一次
+static const int kCpuLevelMasks[CPU_MAX_LEVELS] = {
+        -1,
+        ~kCpuAVX512,
+        ~(kCpuAVX512 | kCpuAVX),
+        ~(kCpuAVX512 | kCpuAVX | kCpuSSSE3),
+        kCpuInitialized,
+};
+
+/**
+ * 行函数的一种SIMD实现，编译进来（row.h 中定义了 HAS_XXX）且CPU支持时可用
+ */
+struct CpuKernel {
+    int flag;
+    const char *name;
+};
+
+// 以下按libyuv选择实现时的判断顺序排列，后面的覆盖前面的
+
+static const CpuKernel kSplitUVKernels[] = {
+#ifdef HAS_SPLITUVROW_SSE2
+        {kCpuHasSSE2,  "SSE2"},
+#endif
+#ifdef HAS_SPLITUVROW_AVX2
+        {kCpuHasAVX2,  "AVX2"},
+#endif
+#ifdef HAS_SPLITUVROW_NEON
+        {kCpuHasNEON,  "NEON"},
+#endif
+#ifdef HAS_SPLITUVROW_MMI
+        {kCpuHasMMI,   "MMI"},
+#endif
+#ifdef HAS_SPLITUVROW_MSA
+        {kCpuHasMSA,   "MSA"},
+#endif
+        {0, nullptr}
+};
+
+static const CpuKernel kMergeUVKernels[] = {
+#ifdef HAS_MERGEUVROW_SSE2
+        {kCpuHasSSE2,  "SSE2"},
+#endif
+#ifdef HAS_MERGEUVROW_AVX2
+        {kCpuHasAVX2,  "AVX2"},
+#endif
+#ifdef HAS_MERGEUVROW_NEON
+        {kCpuHasNEON,  "NEON"},
+#endif
+#ifdef HAS_MERGEUVROW_MMI
+        {kCpuHasMMI,   "MMI"},
+#endif
+#ifdef HAS_MERGEUVROW_MSA
+        {kCpuHasMSA,   "MSA"},
+#endif
+        {0, nullptr}
+};
+
+static const CpuKernel kNV21ToARGBKernels[] = {
+#ifdef HAS_NV21TOARGBROW_SSSE3
+        {kCpuHasSSSE3, "SSSE3"},
+#endif
+#ifdef HAS_NV21TOARGBROW_AVX2
+        {kCpuHasAVX2,  "AVX2"},
+#endif
+#ifdef HAS_NV21TOARGBROW_NEON
+        {kCpuHasNEON,  "NEON"},
+#endif
+#ifdef HAS_NV21TOARGBROW_MSA
+        {kCpuHasMSA,   "MSA"},
+#endif
+        {0, nullptr}
+};
+
+static const CpuKernel kARGBToYKernels[] = {
+#ifdef HAS_ARGBTOYROW_SSSE3
+        {kCpuHasSSSE3, "SSSE3"},
+#endif
+#ifdef HAS_ARGBTOYROW_AVX2
+        {kCpuHasAVX2,  "AVX2"},
+#endif
+#ifdef HAS_ARGBTOYROW_NEON
+        {kCpuHasNEON,  "NEON"},
+#endif
+#ifdef HAS_ARGBTOYROW_MMI
+        {kCpuHasMMI,   "MMI"},
+#endif
+#ifdef HAS_ARGBTOYROW_MSA
+        {kCpuHasMSA,   "MSA"},
+#endif
+        {0, nullptr}
+};
+
+static const CpuKernel kInterpolateKernels[] = {
+#ifdef HAS_INTERPOLATEROW_SSSE3
+        {kCpuHasSSSE3, "SSSE3"},
+#endif
+#ifdef HAS_INTERPOLATEROW_AVX2
+        {kCpuHasAVX2,  "AVX2"},
+#endif
+#ifdef HAS_INTERPOLATEROW_NEON
+        {kCpuHasNEON,  "NEON"},
+#endif
+#ifdef HAS_INTERPOLATEROW_MMI
+        {kCpuHasMMI,   "MMI"},
+#endif
+#ifdef HAS_INTERPOLATEROW_MSA
+        {kCpuHasMSA,   "MSA"},
+#endif
+        {0, nullptr}
+};
+
+static const CpuKernel kTransposeKernels[] = {
+#ifdef HAS_TRANSPOSEWX8_NEON
+        {kCpuHasNEON,  "NEON"},
+#endif
+#ifdef HAS_TRANSPOSEWX8_SSSE3
+        {kCpuHasSSSE3, "SSSE3"},
+#endif
+#ifdef HAS_TRANSPOSEWX8_MMI
+        {kCpuHasMMI,   "MMI"},
+#endif
+#ifdef HAS_TRANSPOSEWX8_FAST_SSSE3
+        {kCpuHasSSSE3, "Fast_SSSE3"},
+#endif
+#ifdef HAS_TRANSPOSEWX16_MSA
+        {kCpuHasMSA,   "MSA"},
+#endif
+        {0, nullptr}
+};
+
+static const CpuKernel kBlendPlaneKernels[] = {
+#ifdef HAS_BLENDPLANEROW_SSSE3
+        {kCpuHasSSSE3, "SSSE3"},
+#endif
+#ifdef HAS_BLENDPLANEROW_AVX2
+        {kCpuHasAVX2,  "AVX2"},
+#endif
+#ifdef HAS_BLENDPLANEROW_NEON
+        {kCpuHasNEON,  "NEON"},
+#endif
+#ifdef HAS_BLENDPLANEROW_MMI
+        {kCpuHasMMI,   "MMI"},
+#endif
+        {0, nullptr}
+};
+
+static const CpuKernel kSwapUVKernels[] = {
+#ifdef HAS_SWAPUVROW_SSSE3
+        {kCpuHasSSSE3, "SSSE3"},
+#endif
+#ifdef HAS_SWAPUVROW_AVX2
+        {kCpuHasAVX2,  "AVX2"},
+#endif
+#ifdef HAS_SWAPUVROW_NEON
+        {kCpuHasNEON,  "NEON"},
+#endif
+        {0, nullptr}
+};
+
+static const CpuKernel kCopyKernels[] = {
+#ifdef HAS_COPYROW_SSE2
+        {kCpuHasSSE2,  "SSE2"},
+#endif
+#ifdef HAS_COPYROW_AVX
+        {kCpuHasAVX,   "AVX"},
+#endif
+#ifdef HAS_COPYROW_ERMS
+        {kCpuHasERMS,  "ERMS"},
+#endif
+#ifdef HAS_COPYROW_NEON
+        {kCpuHasNEON,  "NEON"},
+#endif
+        {0, nullptr}
+};
+
+/**
+ * 基准测试的数据，src、dst 为 width * height * 3 / 2 的YUV420，argb 为 width * height * 4
+ */
+struct CpuBench {
+    uint8_t *src;
+    uint8_t *dst;
+    uint8_t *argb;
+    int width;
+    int height;
+};
+
+static void benchNV21ToI420(const CpuBench &b) {
+    nv21ToI420(b.src, b.dst, b.width, b.height, false);
+}
+
+static void benchI420ToNV21(const CpuBench &b) {
+    i420ToNV21(b.src, b.dst, b.width, b.height, false);
+}
+
+static void benchNV21ToArgb(const CpuBench &b) {
+    nv21ToArgb(b.src, b.argb, b.width, b.height);
+}
+
+static void benchArgbToNV21(const CpuBench &b) {
+    argbToNV21(b.argb, b.dst, b.width, b.height);
+}
+
+static void benchNV21Scale(const CpuBench &b) {
+    nv21Scale(b.src, b.width, b.height, b.dst, (b.width * 2 / 3) & ~1, (b.height * 2 / 3) & ~1,
+              kFilterBilinear);
+}
+
+static void benchNV21Rotate(const CpuBench &b) {
+    nv21ToI420Rotate(b.src, b.width, b.height, b.dst, 0, false);
+}
+
+static void benchBlendPlane(const CpuBench &b) {
+    size_t size = (size_t) b.width * b.height;
+    BlendPlane(b.src, b.width, b.dst, b.width, b.argb, b.width, b.argb + size, b.width, b.width,
+               b.height);
+}
+
+static void benchSwapUV(const CpuBench &b) {
+    nv12ToNV21(b.dst, b.width, b.height);
+}
+
+static void benchCopy(const CpuBench &b) {
+    CopyPlane(b.src, b.width, b.dst, b.width, b.width, b.height * 3 / 2);
+}
+
+/**
+ * 报告、基准测试的操作及其主要的行函数
+ */
+struct CpuOp {
+    const char *name;
+    const char *row;
+    const CpuKernel *kernels;
+    void (*bench)(const CpuBench &bench);
+};
+
+static const CpuOp kCpuOps[CPU_OP_COUNT] = {
+        {"NV21ToI420",   "SplitUVRow",     kSplitUVKernels,     benchNV21ToI420},
+        {"I420ToNV21",   "MergeUVRow",     kMergeUVKernels,     benchI420ToNV21},
+        {"NV21ToArgb",   "NV21ToARGBRow",  kNV21ToARGBKernels,  benchNV21ToArgb},
+        {"ArgbToNV21",   "ARGBToYRow",     kARGBToYKernels,     benchArgbToNV21},
+        {"Scale",        "InterpolateRow", kInterpolateKernels, benchNV21Scale},
+        {"Rotate",       "TransposeWx8",   kTransposeKernels,   benchNV21Rotate},
+        {"BlendOverlay", "BlendPlaneRow",  kBlendPlaneKernels,  benchBlendPlane},
+        {"NV12ToNV21",   "SwapUVRow",      kSwapUVKernels,      benchSwapUV},
+        {"Copy",         "CopyRow",        kCopyKernels,        benchCopy},
+};
+
+/**
+ * 最近一次 autoSelectCpuFlags 的结果
+ */
+struct CpuBenchResult {
+    int width = 0;
+    int height = 0;
+    int iterations = 0;
+    int levelCount = 0;
+    int flags[CPU_MAX_LEVELS];
+    // 每帧耗时 us
+    double costs[CPU_MAX_LEVELS][CPU_OP_COUNT];
+    int selected = -1;
+};
+
+static std::mutex sBenchMutex;
+static CpuBenchResult sBenchResult;
+
+int getCpuFlags() {
+    return TestCpuFlag(-1);
+}
+
+int maskCpuFlags(int mask) {
+    return MaskCpuFlags(mask);
+}
+
+/**
+ * 检测到的全部特性，不受 maskCpuFlags 影响
+ */
+static int detectCpuFlags() {
+    int flags = getCpuFlags();
+    int detected = MaskCpuFlags(-1);
+    SetCpuFlags(flags);
+    return detected;
+}
+
+static const char *cpuLevelName(int flags) {
+    for (const CpuFlagName &level : kCpuLevelNames) {
+        if (flags & level.flag) {
+            return level.name;
+        }
+    }
+    return "C";
+}
+
+/**
+ * 当前特性位下操作使用的行函数实现
+ */
+static const char *cpuKernelOf(const CpuOp &op, int flags) {
+    const char *name = "C";
+    for (const CpuKernel *kernel = op.kernels; kernel->name != nullptr; kernel++) {
+        if (flags & kernel->flag) {
+            name = kernel->name;
+        }
+    }
+    return name;
+}
+
+int autoSelectCpuFlags(int width, int height, int iterations) {
+    width &= ~1;
+    height &= ~1;
+    if (width <= 0 || height <= 0 || iterations <= 0) {
+        return -1;
+    }
+    size_t yuvSize = (size_t) width * height * 3 / 2;
+    size_t argbSize = (size_t) width * height * 4;
+    uint8_t *memory = (uint8_t *) malloc(yuvSize * 2 + argbSize);
+    if (memory == nullptr) {
+        return -1;
+    }
+    CpuBench bench = {memory, memory + yuvSize, memory + yuvSize * 2, width, height};
+    // 伪随机内容，避免全零数据走特殊分支
+    uint32_t seed = 1;
+    for (size_t i = 0; i < yuvSize * 2 + argbSize; i++) {
+        seed = seed * 1103515245 + 12345;
+        memory[i] = (uint8_t) (seed >> 16);
+    }
+
+    std::lock_guard<std::mutex> lock(sBenchMutex);
+    CpuBenchResult &result = sBenchResult;
+    result.width = width;
+    result.height = height;
+    result.iterations = iterations;
+    result.levelCount = 0;
+    result.selected = -1;
+    double bestTotal = 0;
+    for (int mask : kCpuLevelMasks) {
+        int flags = MaskCpuFlags(mask);
+        bool tested = false;
+        for (int i = 0; i < result.levelCount; i++) {
+            tested = tested || result.flags[i] == flags;
+        }
+        if (tested) {
+            continue;
+        }
+        int level = result.levelCount++;
+        result.flags[level] = flags;
+        double total = 0;
+        for (int op = 0; op < CPU_OP_COUNT; op++) {
+            // 预热一次，排除首次调用的缓存、scratch 分配
+            kCpuOps[op].bench(bench);
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                kCpuOps[op].bench(bench);
+            }
+            std::chrono::duration<double, std::micro> cost =
+                    std::chrono::steady_clock::now() - start;
+            result.costs[level][op] = cost.count() / iterations;
+            total += result.costs[level][op];
+        }
+        if (result.selected < 0 || total < bestTotal) {
+            result.selected = level;
+            bestTotal = total;
+        }
+    }
+    free(memory);
+    SetCpuFlags(result.flags[result.selected]);
+    return result.flags[result.selected];
+}
+
+static void appendReport(char *buf, int size, int *len, const char *format, ...) {
+    if (*len >= size - 1) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    int count = vsnprintf(buf + *len, (size_t) (size - *len), format, args);
+    va_end(args);
+    if (count > 0) {
+        *len = *len + count < size - 1 ? *len + count : size - 1;
+    }
+}
+
+static void appendFlags(char *buf, int size, int *len, const char *title, int flags) {
+    appendReport(buf, size, len, "%s:", title);
+    for (const CpuFlagName &flag : kCpuFlagNames) {
+        if (flags & flag.flag) {
+            appendReport(buf, size, len, " %s", flag.name);
+        }
+    }
+    appendReport(buf, size, len, "\n");
+}
+
+int formatCpuReport(char *buf, int size) {
+    if (buf == nullptr || size <= 0) {
+        return 0;
+    }
+    int len = 0;
+    buf[0] = '\0';
+    int flags = getCpuFlags();
+    appendFlags(buf, size, &len, "detected", detectCpuFlags());
+    appendFlags(buf, size, &len, "enabled", flags);
+    for (const CpuOp &op : kCpuOps) {
+        appendReport(buf, size, &len, "%-13s %-15s %s\n", op.name, op.row, cpuKernelOf(op, flags));
+    }
+
+    std::lock_guard<std::mutex> lock(sBenchMutex);
+    const CpuBenchResult &result = sBenchResult;
+    if (result.levelCount == 0) {
+        return len;
+    }
+    appendReport(buf, size, &len, "benchmark %dx%d x%d, us per frame:\n%-8s", result.width,
+                 result.height, result.iterations, "level");
+    for (const CpuOp &op : kCpuOps) {
+        appendReport(buf, size, &len, " %12s", op.name);
+    }
+    appendReport(buf, size, &len, "\n");
+    for (int level = 0; level < result.levelCount; level++) {
+        appendReport(buf, size, &len, "%-6s %s", cpuLevelName(result.flags[level]),
+                     level == result.selected ? "* " : "  ");
+        for (int op = 0; op < CPU_OP_COUNT; op++) {
+            appendReport(buf, size, &len, " %12.1f", result.costs[level][op]);
+        }
+        appendReport(buf, size, &len, "\n");
+    }
+    return len;
+}
+
+/**
+ * 一个行函数在各线程的统计之和
+ */
+struct KernelProfile {
+    const void *func;
+    const char *name;
+    int threads;
+    uint64_t calls;
+    uint64_t pixels;
+    uint64_t cycles;
+};
+
+int formatKernelProfile(char *buf, int size) {
+    if (buf == nullptr || size <= 0) {
+        return 0;
+    }
+    int len = 0;
+    buf[0] = '\0';
+    if (!ProfileEnabled()) {
+        appendReport(buf, size, &len, "kernel profile disabled, build with -DYUV_PROFILE=ON\n");
+        return len;
+    }
+    // 统计期间其他线程可能新增行函数，多取一些
+    std::vector<ProfileKernel> counters(GetProfileKernels(nullptr, 0) + 64);
+    int count = std::min(GetProfileKernels(counters.data(), (int) counters.size()),
+                         (int) counters.size());
+    std::vector<KernelProfile> kernels;
+    for (int i = 0; i < count; i++) {
+        const ProfileKernel &counter = counters[i];
+        auto it = std::find_if(kernels.begin(), kernels.end(), [&counter](const KernelProfile &k) {
+            return k.func == counter.func;
+        });
+        if (it == kernels.end()) {
+            kernels.push_back({counter.func, counter.name, 0, 0, 0, 0});
+            it = kernels.end() - 1;
+        }
+        it->threads++;
+        it->calls += counter.calls;
+        it->pixels += counter.pixels;
+        it->cycles += counter.cycles;
+    }
+    std::sort(kernels.begin(), kernels.end(), [](const KernelProfile &a, const KernelProfile &b) {
+        return a.cycles > b.cycles;
+    });
+
+    double cyclesPerUs = GetProfileCyclesPerSecond() / 1e6;
+    appendReport(buf, size, &len, "%.0f cycles/us\n%-36s %-20s %7s %10s %12s %10s %8s\n",
+                 cyclesPerUs, "kernel", "site", "threads", "calls", "pixels", "us",
+                 "cyc/px");
+    for (const KernelProfile &kernel : kernels) {
+        // 行函数的符号名，如 SplitUVRow_Any_AVX2；未导出的函数（如 scratch 分配器）用调用处的名称及地址
+        Dl_info info;
+        char address[64];
+        const char *symbol = nullptr;
+        if (dladdr(kernel.func, &info) != 0 && info.dli_saddr == kernel.func) {
+            symbol = info.dli_sname;
+        }
+        if (symbol == nullptr) {
+            snprintf(address, sizeof(address), "%s@%p", kernel.name != nullptr ? kernel.name : "",
+                     kernel.func);
+            symbol = address;
+        }
+        appendReport(buf, size, &len, "%-36s %-20s %7d %10llu %12llu %10.0f %8.2f\n", symbol,
+                     kernel.name != nullptr ? kernel.name : "?", kernel.threads,
+                     (unsigned long long) kernel.calls, (unsigned long long) kernel.pixels,
+                     cyclesPerUs > 0 ? kernel.cycles / cyclesPerUs : 0.0,
+                     kernel.pixels > 0 ? (double) kernel.cycles / kernel.pixels : 0.0);
+    }
+    return len;
+}
+
+void resetKernelProfile() {
+    ResetProfile();
+}
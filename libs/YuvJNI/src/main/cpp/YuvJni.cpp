@@ -1,10 +1,19 @@
 #include <assert.h>
+#include <cstdlib>
 #include <cstring>
-#include "libyuv.h"
+#include <vector>
 #include "jni.h"
+#include "YuvBufferPool.h"
+#include "YuvCpu.h"
+#include "YuvJobQueue.h"
+#include "YuvOps.h"
+#include "YuvThreadPool.h"
+#include "YuvTrace.h"
 
 #ifdef ANDROID
 
+#include <android/log.h>
+
 #define LOG_TAG    "Native_YUV"
 #define LOGD(format, ...)  __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, format, ##__VA_ARGS__)
 #define LOGE(format, ...)  __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, format, ##__VA_ARGS__)
@@ -15,374 +24,214 @@
 #endif
 
 #define YUV_UTILS_JAVA "com/lkl/yuvjni/YuvUtils"
+#define ILLEGAL_ARGUMENT_EXCEPTION_JAVA "java/lang/IllegalArgumentException"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// debug 输出 YUV 文件
-//#define SAVE_RET
-
-static int
-(*rgbaToI420Func[])(const uint8_t *, int, uint8_t *, int, uint8_t *, int, uint8_t *, int, int,
-                    int) ={
-        libyuv::ABGRToI420, libyuv::RGBAToI420, libyuv::ARGBToI420, libyuv::BGRAToI420,
-        libyuv::RGB24ToI420, libyuv::RGB565ToI420
-};
-
-static int
-(*i420ToRgbaFunc[])(const uint8_t *, int, const uint8_t *, int, const uint8_t *, int, uint8_t *,
-                    int, int, int) ={
-        libyuv::I420ToABGR, libyuv::I420ToRGBA, libyuv::I420ToARGB, libyuv::I420ToBGRA,
-        libyuv::I420ToRGB24, libyuv::I420ToRGB565
-};
-
-static void (*rotatePlaneFunc[])(const uint8_t *src, int src_stride, uint8_t *dst, int dst_stride,
-                                 int width, int height) ={
-        libyuv::RotatePlane90, libyuv::RotatePlane180, libyuv::RotatePlane270,
-};
-
-static void (*rotateUVFunc[])(const uint8_t *src, int src_stride, uint8_t *dst_a, int dst_stride_a,
-                              uint8_t *dst_b, int dst_stride_b, int width, int height) ={
-        libyuv::RotateUV90, libyuv::RotateUV180, libyuv::RotateUV270,
-};
+// JNI_OnLoad 中缓存的全局引用，避免每次抛异常都 FindClass
+static jclass sIllegalArgumentClass = nullptr;
 
 /**
- * 裁剪NV21、NV12数据
- * @param tarYuv 裁剪后的数据
- * @param srcYuv 要裁剪的源数据
- * @param startW 开始裁剪的Width位置
- * @param startH 开始裁剪的Height位置
- * @param cutW 裁剪的Width
- * @param cutH 裁剪的Height
- * @param srcW 源数据的Width
- * @param srcH 源数据的Height
+ * 获取direct ByteBuffer偏移offset后的native地址
+ *
+ * @param required offset之后至少需要的字节数
+ * @return 非direct ByteBuffer、offset越界或剩余容量不足required时抛出IllegalArgumentException并返回nullptr，
+ * 调用方须立即返回，不能在异常未处理时继续调用JNI
  */
-static void cutYuv(unsigned char *tarYuv, unsigned char *srcYuv, int startW,
-                   int startH, int cutW, int cutH, int srcW, int srcH) {
-    int i;
-    int j = 0;
-    int k = 0;
-    //分配一段内存，用于存储裁剪后的Y分量
-    unsigned char *tmpY = tarYuv;
-    //分配一段内存，用于存储裁剪后的UV分量
-    unsigned char *tmpUV = tarYuv + cutW * cutH;
-
-    for (i = startH; i < cutH + startH; i++) {
-        // 逐行拷贝Y分量，共拷贝cutW*cutH
-        memcpy(tmpY + j * cutW, srcYuv + startW + i * srcW, cutW);
-        j++;
-    }
-    for (i = startH / 2; i < (cutH + startH) / 2; i++) {
-        //逐行拷贝UV分量，共拷贝cutW*cutH/2
-        memcpy(tmpUV + k * cutW, srcYuv + startW + srcW * srcH + i * srcW, cutW);
-        k++;
-    }
-
-#ifdef SAVE_RET
-    FILE *outPutFp = fopen("/sdcard/Pictures/cutSrcYuv.yuv", "w+");
-    fwrite(tarYuv, 1, cutW * cutH * 3 / 2, outPutFp);
-    fclose(outPutFp);
-#endif
+static uint8_t *getDirectAddress(JNIEnv *env, jobject buffer, jint offset, jlong required) {
+    uint8_t *address = nullptr;
+    jlong capacity = -1;
+    if (buffer != nullptr) {
+        address = (uint8_t *) env->GetDirectBufferAddress(buffer);
+        capacity = env->GetDirectBufferCapacity(buffer);
+    }
+    if (address == nullptr || offset < 0 || offset > capacity) {
+        env->ThrowNew(sIllegalArgumentClass, "need direct ByteBuffer and valid offset");
+        return nullptr;
+    }
+    if (capacity - offset < required) {
+        env->ThrowNew(sIllegalArgumentClass, "direct ByteBuffer too small");
+        return nullptr;
+    }
+    return address + offset;
 }
 
 JNIEXPORT void JNICALL
 Jni_NV21CutData(JNIEnv *env, jclass clazz, jbyteArray tar, jbyteArray src, jint startW,
-            jint startH, jint cutW, jint cutH, jint srcW, jint srcH) {
-    jbyte *srcData = env->GetByteArrayElements(src, JNI_FALSE);
-    jbyte *tarData = env->GetByteArrayElements(tar, JNI_FALSE);
-
-    cutYuv((unsigned char *)tarData, (unsigned char *)srcData, startW, startH, cutW, cutH, srcW, srcH);
-
-    env->ReleaseByteArrayElements(src, srcData, JNI_OK);
-    env->ReleaseByteArrayElements(tar, tarData, JNI_OK);
-}
+                jint startH, jint cutW, jint cutH, jint srcW, jint srcH) {
+    TRACE_SCOPE(__func__);
+    jbyte *srcData = (jbyte *) env->GetPrimitiveArrayCritical(src, nullptr);
+    jbyte *tarData = (jbyte *) env->GetPrimitiveArrayCritical(tar, nullptr);
 
-static int
-fCutWaterMark(unsigned char *waterMarkSrc, unsigned char *srcYuv, int waterMarkW, int waterMarkH) {
-    int i;
-    size_t data_length = (size_t) waterMarkW * waterMarkH * 3 / 2;
-    unsigned char *tmpData = (unsigned char *) malloc(data_length);;
-    unsigned char *tmpWaterMark = (unsigned char *) malloc(data_length);
-    memcpy(tmpData, srcYuv, data_length);
-    memcpy(tmpWaterMark, waterMarkSrc, data_length);
+    nv21CutData((uint8_t *) tarData, (const uint8_t *) srcData, startW, startH, cutW, cutH, srcW,
+                srcH);
 
-    for (i = 0; i < data_length; i++) {
-        if (tmpWaterMark[i] != 0x10 && tmpWaterMark[i] != 0x80 && tmpWaterMark[i] != 0xeb) {
-            tmpData[i] = tmpWaterMark[i];
-            // printf("0x%X\n", tmpData[i]);
-        }
-    }
-
-    memcpy(waterMarkSrc, tmpData, data_length);
-
-#ifdef SAVE_RET
-    FILE *outPutFp = fopen("/sdcard/Pictures/afterCutWaterMark.yuv", "w+");
-    fwrite(waterMarkSrc, 1, data_length, outPutFp);
-    fclose(outPutFp);
-#endif
-
-    free(tmpData);
-    free(tmpWaterMark);
-#if 0
-    FILE *tarFp = fopen("afterCutWaterMark.yuv", "w+");
-    fwrite(waterMarkSrc, 1, waterMarkW*waterMarkH*3/2, tarFp);
-    fclose(tarFp);
-#endif
-    return 0;
-}
-
-
-JNIEXPORT jint JNICALL
-rgbaToI420(JNIEnv *env, jclass clazz, jbyteArray rgba, jint rgba_stride,
-           jbyteArray yuv, jint y_stride, jint u_stride, jint v_stride,
-           jint width, jint height,
-           int (*func)(const uint8_t *, int, uint8_t *, int, uint8_t *, int, uint8_t *, int,
-                       int,
-                       int)) {
-    size_t ySize = (size_t) (y_stride * height);
-    size_t uSize = (size_t) (u_stride * height >> 1);
-    jbyte *rgbaData = env->GetByteArrayElements(rgba, JNI_FALSE);
-    jbyte *yuvData = env->GetByteArrayElements(yuv, JNI_FALSE);
-    int ret = func((const uint8_t *) rgbaData, rgba_stride, (uint8_t *) yuvData, y_stride,
-                   (uint8_t *) (yuvData) + ySize, u_stride, (uint8_t *) (yuvData) + ySize + uSize,
-                   v_stride, width, height);
-    env->ReleaseByteArrayElements(rgba, rgbaData, JNI_OK);
-    env->ReleaseByteArrayElements(yuv, yuvData, JNI_OK);
-    return ret;
-}
-
-JNIEXPORT jint JNICALL
-i420ToRgba(JNIEnv *env, jclass clazz, jbyteArray yuv, jint y_stride, jint u_stride, jint v_stride,
-           jbyteArray rgba, jint rgba_stride, jint width, jint height,
-           int (*func)(const uint8_t *, int, const uint8_t *, int, const uint8_t *, int, uint8_t *,
-                       int, int, int)) {
-    size_t ySize = (size_t) (y_stride * height);
-    size_t uSize = (size_t) (u_stride * height >> 1);
-    jbyte *rgbaData = env->GetByteArrayElements(rgba, JNI_FALSE);
-    jbyte *yuvData = env->GetByteArrayElements(yuv, JNI_FALSE);
-    int ret = func((const uint8_t *) yuvData, y_stride, (uint8_t *) yuvData + ySize, u_stride,
-                   (uint8_t *) (yuvData) + ySize + uSize, v_stride, (uint8_t *) (rgbaData),
-                   rgba_stride, width, height);
-    env->ReleaseByteArrayElements(rgba, rgbaData, JNI_OK);
-    env->ReleaseByteArrayElements(yuv, yuvData, JNI_OK);
-    return ret;
+    env->ReleasePrimitiveArrayCritical(src, srcData, JNI_ABORT);
+    env->ReleasePrimitiveArrayCritical(tar, tarData, 0);
 }
 
 JNIEXPORT jint JNICALL
 Jni_I420ToNV21(JNIEnv *env, jclass clazz, jbyteArray yuv420p, jbyteArray yuv420sp, jint width,
                jint height, jboolean swapUV) {
-    size_t ySize = (size_t) (width * height);
-    size_t uSize = (size_t) (width * height >> 2);
-    size_t stride[] = {0, uSize};
-    jbyte *yuv420pData = env->GetByteArrayElements(yuv420p, JNI_FALSE);
-    jbyte *yuv420spData = env->GetByteArrayElements(yuv420sp, JNI_FALSE);
-    int ret = libyuv::I420ToNV21((const uint8_t *) yuv420pData, width,
-                                 (const uint8_t *) (yuv420pData + ySize + stride[swapUV]),
-                                 width >> 1,
-                                 (const uint8_t *) (yuv420pData + ySize + stride[1 - swapUV]),
-                                 width >> 1,
-                                 (uint8_t *) yuv420spData, width,
-                                 (uint8_t *) (yuv420spData + ySize),
-                                 width, width, height);
-    env->ReleaseByteArrayElements(yuv420p, yuv420pData, JNI_OK);
-    env->ReleaseByteArrayElements(yuv420sp, yuv420spData, JNI_OK);
+    TRACE_SCOPE(__func__);
+    jbyte *yuv420pData = (jbyte *) env->GetPrimitiveArrayCritical(yuv420p, nullptr);
+    jbyte *yuv420spData = (jbyte *) env->GetPrimitiveArrayCritical(yuv420sp, nullptr);
+    int ret = i420ToNV21((const uint8_t *) yuv420pData, (uint8_t *) yuv420spData, width, height,
+                         swapUV);
+    env->ReleasePrimitiveArrayCritical(yuv420p, yuv420pData, JNI_ABORT);
+    env->ReleasePrimitiveArrayCritical(yuv420sp, yuv420spData, 0);
     return ret;
 }
 
 JNIEXPORT jint JNICALL
 Jni_NV21ToI420(JNIEnv *env, jclass clazz, jbyteArray yuv420sp, jbyteArray yuv420p, jint width,
                jint height, jboolean swapUV) {
-    size_t ySize = (size_t) (width * height);
-    size_t uSize = (size_t) (width * height >> 2);
-    size_t stride[] = {0, uSize};
-    jbyte *yuv420pData = env->GetByteArrayElements(yuv420p, JNI_FALSE);
-    jbyte *yuv420spData = env->GetByteArrayElements(yuv420sp, JNI_FALSE);
-    int ret = libyuv::NV21ToI420((const uint8_t *) yuv420spData, width,
-                                 (const uint8_t *) (yuv420spData + ySize), width,
-                                 (uint8_t *) yuv420pData, width,
-                                 (uint8_t *) (yuv420pData + ySize + stride[swapUV]), width >> 1,
-                                 (uint8_t *) (yuv420pData + ySize + stride[1 - swapUV]), width >> 1,
-                                 width, height);
-    env->ReleaseByteArrayElements(yuv420p, yuv420pData, JNI_OK);
-    env->ReleaseByteArrayElements(yuv420sp, yuv420spData, JNI_OK);
+    TRACE_SCOPE(__func__);
+    jbyte *yuv420pData = (jbyte *) env->GetPrimitiveArrayCritical(yuv420p, nullptr);
+    jbyte *yuv420spData = (jbyte *) env->GetPrimitiveArrayCritical(yuv420sp, nullptr);
+    int ret = nv21ToI420((const uint8_t *) yuv420spData, (uint8_t *) yuv420pData, width, height,
+                         swapUV);
+    env->ReleasePrimitiveArrayCritical(yuv420p, yuv420pData, 0);
+    env->ReleasePrimitiveArrayCritical(yuv420sp, yuv420spData, JNI_ABORT);
     return ret;
 }
 
-
 JNIEXPORT jint JNICALL
 Jni_ArgbToNV21(JNIEnv *env, jclass clazz, jbyteArray argb, jbyteArray nv21, jint width,
                jint height) {
-    jbyte *argbData = env->GetByteArrayElements(argb, JNI_FALSE);
-    jbyte *nv21Data = env->GetByteArrayElements(nv21, JNI_FALSE);
-
-    size_t ySize = (size_t) (width * height);
+    TRACE_SCOPE(__func__);
+    jbyte *argbData = (jbyte *) env->GetPrimitiveArrayCritical(argb, nullptr);
+    jbyte *nv21Data = (jbyte *) env->GetPrimitiveArrayCritical(nv21, nullptr);
 
-    int res = libyuv::ARGBToNV21((const uint8_t *) argbData, width * 4, (uint8_t *) nv21Data, width,
-                                 (uint8_t *) (nv21Data + ySize), width, width, height);
+    int res = argbToNV21((const uint8_t *) argbData, (uint8_t *) nv21Data, width, height);
 
-    env->ReleaseByteArrayElements(argb, argbData, JNI_OK);
-    env->ReleaseByteArrayElements(nv21, nv21Data, JNI_OK);
+    env->ReleasePrimitiveArrayCritical(argb, argbData, JNI_ABORT);
+    env->ReleasePrimitiveArrayCritical(nv21, nv21Data, 0);
     return res;
 }
+
 JNIEXPORT void JNICALL
 Jni_NV12ToNV21(JNIEnv *env, jclass clazz, jbyteArray yuv, jint width,
                jint height) {
-    jbyte *nv12Data = env->GetByteArrayElements(yuv, JNI_FALSE);
-
-    int ySize = width * height;
+    TRACE_SCOPE(__func__);
+    jbyte *nv12Data = (jbyte *) env->GetPrimitiveArrayCritical(yuv, nullptr);
 
-    jbyte tmp;
-    for (int index = ySize; index < ySize * 1.5; index++) {
-        if ((index + 1) % 2 == 0) {
-            tmp = nv12Data[index - 1];
-            nv12Data[index - 1] = nv12Data[index];
-            nv12Data[index] = tmp;
-        }
-    }
+    nv12ToNV21((uint8_t *) nv12Data, width, height);
 
-    env->ReleaseByteArrayElements(yuv, nv12Data, JNI_OK);
+    env->ReleasePrimitiveArrayCritical(yuv, nv12Data, 0);
 }
 
 JNIEXPORT jint JNICALL
 Jni_NV12ToArgb(JNIEnv *env, jclass clazz, jbyteArray nv12, jbyteArray argb, jint width,
                jint height) {
-    jbyte *nv12Data = env->GetByteArrayElements(nv12, JNI_FALSE);
-    jbyte *argbData = env->GetByteArrayElements(argb, JNI_FALSE);
+    TRACE_SCOPE(__func__);
+    jbyte *nv12Data = (jbyte *) env->GetPrimitiveArrayCritical(nv12, nullptr);
+    jbyte *argbData = (jbyte *) env->GetPrimitiveArrayCritical(argb, nullptr);
 
-    size_t ySize = (size_t) (width * height);
+    int res = nv12ToArgb((const uint8_t *) nv12Data, (uint8_t *) argbData, width, height);
 
-    int res = libyuv::NV12ToABGR((const uint8_t *) nv12Data, width,
-                                 (const uint8_t *) (nv12Data + ySize), width, (uint8_t *) argbData,
-                                 width * 4, width, height);
-
-    env->ReleaseByteArrayElements(argb, argbData, JNI_OK);
-    env->ReleaseByteArrayElements(nv12, nv12Data, JNI_OK);
+    env->ReleasePrimitiveArrayCritical(argb, argbData, 0);
+    env->ReleasePrimitiveArrayCritical(nv12, nv12Data, JNI_ABORT);
     return res;
 }
 
 JNIEXPORT jint JNICALL
 Jni_NV21ToArgb(JNIEnv *env, jclass clazz, jbyteArray nv21, jbyteArray argb, jint width,
                jint height) {
-    jbyte *nv21Data = env->GetByteArrayElements(nv21, JNI_FALSE);
-    jbyte *argbData = env->GetByteArrayElements(argb, JNI_FALSE);
-
-    size_t ySize = (size_t) (width * height);
+    TRACE_SCOPE(__func__);
+    jbyte *nv21Data = (jbyte *) env->GetPrimitiveArrayCritical(nv21, nullptr);
+    jbyte *argbData = (jbyte *) env->GetPrimitiveArrayCritical(argb, nullptr);
 
-    int res = libyuv::NV21ToABGR((const uint8_t *) nv21Data, width,
-                                 (const uint8_t *) (nv21Data + ySize), width, (uint8_t *) argbData,
-                                 width * 4, width, height);
+    int res = nv21ToArgb((const uint8_t *) nv21Data, (uint8_t *) argbData, width, height);
 
-    env->ReleaseByteArrayElements(argb, argbData, JNI_OK);
-    env->ReleaseByteArrayElements(nv21, nv21Data, JNI_OK);
+    env->ReleasePrimitiveArrayCritical(argb, argbData, 0);
+    env->ReleasePrimitiveArrayCritical(nv21, nv21Data, JNI_ABORT);
     return res;
 }
 
 JNIEXPORT jint JNICALL
 Jni_NV21ToRGB24(JNIEnv *env, jclass clazz, jbyteArray nv21, jbyteArray rgb24, jint width,
                 jint height) {
-    jbyte *nv21Data = env->GetByteArrayElements(nv21, JNI_FALSE);
-    jbyte *rgbData = env->GetByteArrayElements(rgb24, JNI_FALSE);
+    TRACE_SCOPE(__func__);
+    jbyte *nv21Data = (jbyte *) env->GetPrimitiveArrayCritical(nv21, nullptr);
+    jbyte *rgbData = (jbyte *) env->GetPrimitiveArrayCritical(rgb24, nullptr);
 
-    size_t ySize = (size_t) (width * height);
+    int res = nv21ToRgb24((const uint8_t *) nv21Data, (uint8_t *) rgbData, width, height);
 
-    int res = libyuv::NV21ToRGB24((const uint8_t *) nv21Data, width,
-                                  (const uint8_t *) (nv21Data + ySize), width, (uint8_t *) rgbData,
-                                  width * 3, width, height);
-
-    env->ReleaseByteArrayElements(rgb24, rgbData, JNI_OK);
-    env->ReleaseByteArrayElements(nv21, nv21Data, JNI_OK);
+    env->ReleasePrimitiveArrayCritical(rgb24, rgbData, 0);
+    env->ReleasePrimitiveArrayCritical(nv21, nv21Data, JNI_ABORT);
     return res;
 }
 
 JNIEXPORT void JNICALL
 Jni_NV21Scale(JNIEnv *env, jclass clazz, jbyteArray src, jint width, jint height, jbyteArray dst,
-              jint dst_width, jint dst_height, int mode) {
-    size_t ySize = (size_t) (width * height);
-    size_t dstYSize = (size_t) (dst_width * dst_height);
-    jbyte *srcData = env->GetByteArrayElements(src, JNI_FALSE);
-    jbyte *dstData = env->GetByteArrayElements(dst, JNI_FALSE);
-    libyuv::ScalePlane((const uint8_t *) srcData, width, width, height,
-                       (uint8_t *) dstData, dst_width, dst_width, dst_height,
-                       (libyuv::FilterMode) mode);
-    libyuv::ScalePlane((const uint8_t *) (srcData + ySize), width, width, height >> 1,
-                       (uint8_t *) (dstData + dstYSize), dst_width, dst_width, dst_height >> 1,
-                       (libyuv::FilterMode) mode);
-    env->ReleaseByteArrayElements(src, srcData, JNI_OK);
-    env->ReleaseByteArrayElements(dst, dstData, JNI_OK);
+              jint dst_width, jint dst_height, jint mode) {
+    TRACE_SCOPE(__func__);
+    jbyte *srcData = (jbyte *) env->GetPrimitiveArrayCritical(src, nullptr);
+    jbyte *dstData = (jbyte *) env->GetPrimitiveArrayCritical(dst, nullptr);
+    nv21Scale((const uint8_t *) srcData, width, height, (uint8_t *) dstData, dst_width,
+              dst_height, mode);
+    env->ReleasePrimitiveArrayCritical(src, srcData, JNI_ABORT);
+    env->ReleasePrimitiveArrayCritical(dst, dstData, 0);
 }
 
 JNIEXPORT void JNICALL
 Jni_I420Scale(JNIEnv *env, jclass clazz, jbyteArray src, jint width, jint height, jbyteArray dst,
-              jint dst_width, jint dst_height, int mode, jboolean swapUV) {
-    int ySize = width * height;
-    int swap[] = {0, ySize >> 2};
-    size_t dstYSize = (size_t) (dst_width * dst_height);
-    jbyte *srcData = env->GetByteArrayElements(src, JNI_FALSE);
-    jbyte *dstData = env->GetByteArrayElements(dst, JNI_FALSE);
-    libyuv::I420Scale((const uint8_t *) srcData, width, (const uint8_t *) (srcData + ySize),
-                      width >> 1,
-                      (uint8_t *) (srcData + ySize + (ySize >> 2)), width >> 1, width, height,
-                      (uint8_t *) dstData, dst_width,
-                      (uint8_t *) (dstData + dstYSize + swap[swapUV]),
-                      dst_width >> 1,
-                      (uint8_t *) (dstData + dstYSize + swap[1 - swapUV]), dst_width >> 1,
-                      dst_width, dst_height, (libyuv::FilterMode) mode);
-    env->ReleaseByteArrayElements(src, srcData, JNI_OK);
-    env->ReleaseByteArrayElements(dst, dstData, JNI_OK);
-}
-
-JNIEXPORT void JNICALL
-Jni_RgbaScale(JNIEnv *env, jclass clazz, jint type, jbyteArray src, jint src_width, jint src_height,
+              jint dst_width, jint dst_height, jint mode, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    jbyte *srcData = (jbyte *) env->GetPrimitiveArrayCritical(src, nullptr);
+    jbyte *dstData = (jbyte *) env->GetPrimitiveArrayCritical(dst, nullptr);
+    i420Scale((const uint8_t *) srcData, width, height, (uint8_t *) dstData, dst_width,
+              dst_height, mode, swapUV);
+    env->ReleasePrimitiveArrayCritical(src, srcData, JNI_ABORT);
+    env->ReleasePrimitiveArrayCritical(dst, dstData, 0);
+}
+
+JNIEXPORT void JNICALL
+Jni_RgbaScale(JNIEnv *env, jclass clazz, jbyteArray src, jint src_width, jint src_height,
               jbyteArray dst, jint dst_width, jint dst_height, jint mode) {
-    int bytes = (type & 0x0F000000) >> 24;
-    jbyte *srcData = env->GetByteArrayElements(src, JNI_FALSE);
-    jbyte *dstData = env->GetByteArrayElements(dst, JNI_FALSE);
-    libyuv::ARGBScale((const uint8_t *) srcData, bytes * src_width, src_width, src_height,
-                      (uint8_t *) dstData, bytes * dst_width, dst_width, dst_height,
-                      (libyuv::FilterMode) mode);
-    env->ReleaseByteArrayElements(src, srcData, JNI_OK);
-    env->ReleaseByteArrayElements(dst, dstData, JNI_OK);
+    TRACE_SCOPE(__func__);
+    jbyte *srcData = (jbyte *) env->GetPrimitiveArrayCritical(src, nullptr);
+    jbyte *dstData = (jbyte *) env->GetPrimitiveArrayCritical(dst, nullptr);
+    rgbaScale((const uint8_t *) srcData, src_width, src_height, (uint8_t *) dstData, dst_width,
+              dst_height, mode);
+    env->ReleasePrimitiveArrayCritical(src, srcData, JNI_ABORT);
+    env->ReleasePrimitiveArrayCritical(dst, dstData, 0);
 }
 
 JNIEXPORT void JNICALL
 Jni_NV21ToI420Rotate(JNIEnv *env, jclass clazz, jbyteArray src, jint width, jint height,
                      jbyteArray dst, jint de, jboolean swapUV) {
-    int dst_stride[] = {height, width, height};
-    size_t ySize = (size_t) (width * height);
-    size_t swap[] = {0, ySize >> 2};
-    jbyte *srcData = env->GetByteArrayElements(src, JNI_FALSE);
-    jbyte *dstData = env->GetByteArrayElements(dst, JNI_FALSE);
-    rotatePlaneFunc[de]((const uint8_t *) srcData, width, (uint8_t *) dstData, dst_stride[de],
-                        width,
-                        height);
-    rotateUVFunc[de]((const uint8_t *) (srcData + ySize), width,
-                     (uint8_t *) (dstData + ySize + swap[swapUV]), dst_stride[de] >> 1,
-                     (uint8_t *) (dstData + ySize + swap[1 - swapUV]), dst_stride[de] >> 1,
-                     width >> 1, height >> 1);
-    env->ReleaseByteArrayElements(src, srcData, JNI_OK);
-    env->ReleaseByteArrayElements(dst, dstData, JNI_OK);
+    TRACE_SCOPE(__func__);
+    jbyte *srcData = (jbyte *) env->GetPrimitiveArrayCritical(src, nullptr);
+    jbyte *dstData = (jbyte *) env->GetPrimitiveArrayCritical(dst, nullptr);
+    nv21ToI420Rotate((const uint8_t *) srcData, width, height, (uint8_t *) dstData, de, swapUV);
+    env->ReleasePrimitiveArrayCritical(src, srcData, JNI_ABORT);
+    env->ReleasePrimitiveArrayCritical(dst, dstData, 0);
 }
 
 JNIEXPORT jint JNICALL
 Jni_RgbaToI420WithStride(JNIEnv *env, jclass clazz, jint type, jbyteArray rgba, jint rgba_stride,
                          jbyteArray yuv, jint y_stride, jint u_stride, jint v_stride,
                          jint width, jint height) {
-    uint8_t cType = (uint8_t) (type & 0x0F);
-    return rgbaToI420(env, clazz, rgba, rgba_stride, yuv, y_stride, u_stride, v_stride, width,
-                      height, rgbaToI420Func[cType]);
+    TRACE_SCOPE(__func__);
+    jbyte *rgbaData = (jbyte *) env->GetPrimitiveArrayCritical(rgba, nullptr);
+    jbyte *yuvData = (jbyte *) env->GetPrimitiveArrayCritical(yuv, nullptr);
+    int ret = rgbaToI420(type, (const uint8_t *) rgbaData, rgba_stride, (uint8_t *) yuvData,
+                         y_stride, u_stride, v_stride, width, height);
+    env->ReleasePrimitiveArrayCritical(rgba, rgbaData, JNI_ABORT);
+    env->ReleasePrimitiveArrayCritical(yuv, yuvData, 0);
+    return ret;
 }
 
 JNIEXPORT jint JNICALL
 Jni_RgbaToI420(JNIEnv *env, jclass clazz, jint type, jbyteArray rgba, jbyteArray yuv, jint width,
                jint height) {
-    uint8_t cType = (uint8_t) (type & 0x0F);
-    int rgba_stride = ((type & 0xF0) >> 4) * width;
-    int y_stride = width;
-    int u_stride = width >> 1;
-    int v_stride = u_stride;
-    return rgbaToI420(env, clazz, rgba, rgba_stride, yuv, y_stride, u_stride, v_stride, width,
-                      height, rgbaToI420Func[cType]);
+    TRACE_SCOPE(__func__);
+    return Jni_RgbaToI420WithStride(env, clazz, type, rgba, rgbaStrideOf(type, width), yuv, width,
+                                    width >> 1, width >> 1, width, height);
 }
 
 JNIEXPORT jint JNICALL
@@ -390,136 +239,1808 @@ Jni_I420ToRgbaWithStride(JNIEnv *env, jclass clazz, jint type, jbyteArray yuv, j
                          jint u_stride, jint v_stride,
                          jbyteArray rgba, jint rgba_stride,
                          jint width, jint height) {
-    uint8_t cType = (uint8_t) (type & 0x0F);
-    return i420ToRgba(env, clazz, yuv, y_stride, u_stride, v_stride, rgba, rgba_stride, width,
-                      height, i420ToRgbaFunc[cType]);
+    TRACE_SCOPE(__func__);
+    jbyte *rgbaData = (jbyte *) env->GetPrimitiveArrayCritical(rgba, nullptr);
+    jbyte *yuvData = (jbyte *) env->GetPrimitiveArrayCritical(yuv, nullptr);
+    int ret = i420ToRgba(type, (const uint8_t *) yuvData, y_stride, u_stride, v_stride,
+                         (uint8_t *) rgbaData, rgba_stride, width, height);
+    env->ReleasePrimitiveArrayCritical(rgba, rgbaData, 0);
+    env->ReleasePrimitiveArrayCritical(yuv, yuvData, JNI_ABORT);
+    return ret;
 }
 
 JNIEXPORT jint JNICALL
 Jni_I420ToRgba(JNIEnv *env, jclass clazz, jint type, jbyteArray yuv, jbyteArray rgba, jint width,
                jint height) {
-    uint8_t cType = (uint8_t) (type & 0x0F);
-    int rgba_stride = ((type & 0xF0) >> 4) * width;
-    int y_stride = width;
-    int u_stride = width >> 1;
-    int v_stride = u_stride;
-    return i420ToRgba(env, clazz, yuv, y_stride, u_stride, v_stride, rgba, rgba_stride, width,
-                      height, i420ToRgbaFunc[cType]);
+    TRACE_SCOPE(__func__);
+    return Jni_I420ToRgbaWithStride(env, clazz, type, yuv, width, width >> 1, width >> 1, rgba,
+                                    rgbaStrideOf(type, width), width, height);
 }
 
 JNIEXPORT void JNICALL
 Jni_NV21AddWaterMark(JNIEnv *env, jclass clazz, jint startX, jint startY, jbyteArray waterMarkData,
                      jint waterMarkW, jint waterMarkH, jbyteArray yuvData, jint yuvW, jint yuvH) {
-    int i = 0;
-    int j = 0;
-    int k = 0;
-
-    jbyte *srcData = env->GetByteArrayElements(yuvData, JNI_FALSE);
-    jbyte *dstData = env->GetByteArrayElements(waterMarkData, JNI_FALSE);
-
-#if 1
-    // 方法一：直接在原始数据上计算，一步到位
-    // 注意：该处必须使用 unsigned char 不能使用 jbyte（signed char），否则判断会出错
-    unsigned char temp_char;
-    for (i = startY, k = 0; i < waterMarkH + startY; i++) {
-        for (j = 0; j < waterMarkW; j++) {
-            temp_char = dstData[k * waterMarkW + j];
-            // 透明背景的 Y分量是0x10
-            if (temp_char != 0x10) {
-                srcData[startX + i * yuvW + j] = temp_char;
-            }
-        }
-        k++;
+    TRACE_SCOPE(__func__);
+    jbyte *srcData = (jbyte *) env->GetPrimitiveArrayCritical(yuvData, nullptr);
+    jbyte *dstData = (jbyte *) env->GetPrimitiveArrayCritical(waterMarkData, nullptr);
+
+    nv21AddWaterMark(startX, startY, (const uint8_t *) dstData, waterMarkW, waterMarkH,
+                     (uint8_t *) srcData, yuvW, yuvH);
+
+    env->ReleasePrimitiveArrayCritical(yuvData, srcData, 0);
+    env->ReleasePrimitiveArrayCritical(waterMarkData, dstData, JNI_ABORT);
+}
+
+// direct ByteBuffer 版本，直接操作native内存，省去java数组的拷贝/pin，每个buffer后面跟一个字节偏移
+
+/**
+ * 宽高为 width * height 的 yuv420（NV21/NV12/I420）数据的字节数
+ */
+static inline jlong yuv420SizeOf(jint width, jint height) {
+    return (jlong) width * height * 3 / 2;
+}
+
+/**
+ * 按 stride 存放的 I420 数据的字节数，U、V 平面紧跟在 Y 平面之后
+ */
+static inline jlong i420SizeOf(jint yStride, jint uStride, jint vStride, jint height) {
+    return (jlong) yStride * height + ((jlong) uStride + vStride) * (height >> 1);
+}
+
+JNIEXPORT void JNICALL
+Jni_NV21CutDataDirect(JNIEnv *env, jclass clazz, jobject tar, jint tarOffset, jobject src,
+                      jint srcOffset, jint startW, jint startH, jint cutW, jint cutH, jint srcW,
+                      jint srcH) {
+    TRACE_SCOPE(__func__);
+    uint8_t *tarData = getDirectAddress(env, tar, tarOffset, yuv420SizeOf(cutW, cutH));
+    if (tarData == nullptr) {
+        return;
+    }
+    uint8_t *srcData = getDirectAddress(env, src, srcOffset, yuv420SizeOf(srcW, srcH));
+    if (srcData == nullptr) {
+        return;
     }
+    nv21CutData(tarData, srcData, startW, startH, cutW, cutH, srcW, srcH);
+}
 
-    for (i = startY / 2, k = 0; i < (waterMarkH + startY) / 2; i++) {
-        for (j = 0; j < waterMarkW; j++) {
-            temp_char = dstData[waterMarkW * waterMarkH + k * waterMarkW + j];
-            // 透明背景的 UV分量是0x80
-            if (temp_char != 0x80 && temp_char != 0xeb) {
-                srcData[startX + yuvW * yuvH + i * yuvW + j] = temp_char;
-            }
-        }
-        k++;
+JNIEXPORT jint JNICALL
+Jni_I420ToNV21Direct(JNIEnv *env, jclass clazz, jobject yuv420p, jint srcOffset, jobject yuv420sp,
+                     jint dstOffset, jint width, jint height, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, yuv420p, srcOffset, yuv420SizeOf(width, height));
+    if (srcData == nullptr) {
+        return -1;
     }
-#else
-    // 方法二：裁剪 -> 合成水印 -> 合成完整图片 缺点：大量的内存频繁开辟释放
-    unsigned char *tmpY = (unsigned char *) malloc(waterMarkW * waterMarkH * 3 / 2);
-    cutYuv(tmpY, (unsigned char *) srcData, startX, startY, waterMarkW, waterMarkH, yuvW, yuvH);
-    fCutWaterMark((unsigned char *) dstData, tmpY, waterMarkW, waterMarkH);
+    uint8_t *dstData = getDirectAddress(env, yuv420sp, dstOffset, yuv420SizeOf(width, height));
+    if (dstData == nullptr) {
+        return -1;
+    }
+    return i420ToNV21(srcData, dstData, width, height, swapUV);
+}
 
-    for (i = startY, j = 0; i < waterMarkH + startY; i++) {
-        memcpy(srcData + startX + i * yuvW, dstData + j * waterMarkW,
-               (size_t) waterMarkW);
-        j++;
+JNIEXPORT jint JNICALL
+Jni_NV21ToI420Direct(JNIEnv *env, jclass clazz, jobject yuv420sp, jint srcOffset, jobject yuv420p,
+                     jint dstOffset, jint width, jint height, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, yuv420sp, srcOffset, yuv420SizeOf(width, height));
+    if (srcData == nullptr) {
+        return -1;
     }
-    for (i = startY / 2, k = 0; i < (waterMarkH + startY) / 2; i++) {
-        memcpy(srcData + startX + yuvW * yuvH + i * yuvW,
-               dstData + waterMarkW * waterMarkH + k * waterMarkW, (size_t) waterMarkW);
-        k++;
+    uint8_t *dstData = getDirectAddress(env, yuv420p, dstOffset, yuv420SizeOf(width, height));
+    if (dstData == nullptr) {
+        return -1;
     }
-#endif
+    return nv21ToI420(srcData, dstData, width, height, swapUV);
+}
 
-#ifdef SAVE_RET
-    FILE *outPutFp = fopen("/sdcard/Pictures/Final.yuv", "w+");
-//    fwrite(dstData, 1, waterMarkW * waterMarkH * 3 / 2, outPutFp);
-    fwrite(srcData, 1, yuvW * yuvH * 3 / 2, outPutFp);
-    fclose(outPutFp);
-#endif
+JNIEXPORT jint JNICALL
+Jni_ArgbToNV21Direct(JNIEnv *env, jclass clazz, jobject argb, jint srcOffset, jobject nv21,
+                     jint dstOffset, jint width, jint height) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, argb, srcOffset, (jlong) width * height * 4);
+    if (srcData == nullptr) {
+        return -1;
+    }
+    uint8_t *dstData = getDirectAddress(env, nv21, dstOffset, yuv420SizeOf(width, height));
+    if (dstData == nullptr) {
+        return -1;
+    }
+    return argbToNV21(srcData, dstData, width, height);
+}
 
-    env->ReleaseByteArrayElements(yuvData, srcData, JNI_OK);
-    env->ReleaseByteArrayElements(waterMarkData, dstData, JNI_OK);
+JNIEXPORT void JNICALL
+Jni_NV12ToNV21Direct(JNIEnv *env, jclass clazz, jobject yuv, jint offset, jint width,
+                     jint height) {
+    TRACE_SCOPE(__func__);
+    uint8_t *data = getDirectAddress(env, yuv, offset, yuv420SizeOf(width, height));
+    if (data == nullptr) {
+        return;
+    }
+    nv12ToNV21(data, width, height);
 }
 
+JNIEXPORT jint JNICALL
+Jni_NV12ToArgbDirect(JNIEnv *env, jclass clazz, jobject nv12, jint srcOffset, jobject argb,
+                     jint dstOffset, jint width, jint height) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, nv12, srcOffset, yuv420SizeOf(width, height));
+    if (srcData == nullptr) {
+        return -1;
+    }
+    uint8_t *dstData = getDirectAddress(env, argb, dstOffset, (jlong) width * height * 4);
+    if (dstData == nullptr) {
+        return -1;
+    }
+    return nv12ToArgb(srcData, dstData, width, height);
+}
 
-//libyuv中，rgba表示abgrabgrabgr这样的顺序写入文件，java使用的时候习惯rgba表示rgbargbargba写入文件
-static JNINativeMethod g_methods[] = {
-        {"RgbaToI420",       "(I[BI[BIIIII)I", (jint *) Jni_RgbaToI420WithStride},
-        {"RgbaToI420",       "(I[B[BII)I",     (jint *) Jni_RgbaToI420},
-        {"ArgbToNV21",       "([B[BII)I",      (jint *) Jni_ArgbToNV21},
-        {"NV12ToNV21",       "([BII)V",        (jint *) Jni_NV12ToNV21},
-        {"NV12ToArgb",       "([B[BII)I",      (jint *) Jni_NV12ToArgb},
-        {"NV21ToArgb",       "([B[BII)I",      (jint *) Jni_NV21ToArgb},
-        {"NV21ToRgb24",      "([B[BII)I",      (jint *) Jni_NV21ToRGB24},
-        {"NV21AddWaterMark", "(II[BII[BII)V",  (void *) Jni_NV21AddWaterMark},
+JNIEXPORT jint JNICALL
+Jni_NV21ToArgbDirect(JNIEnv *env, jclass clazz, jobject nv21, jint srcOffset, jobject argb,
+                     jint dstOffset, jint width, jint height) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, nv21, srcOffset, yuv420SizeOf(width, height));
+    if (srcData == nullptr) {
+        return -1;
+    }
+    uint8_t *dstData = getDirectAddress(env, argb, dstOffset, (jlong) width * height * 4);
+    if (dstData == nullptr) {
+        return -1;
+    }
+    return nv21ToArgb(srcData, dstData, width, height);
+}
 
-        {"I420ToRgba",       "(I[BIII[BIII)I", (jint *) Jni_I420ToRgbaWithStride},
-        {"I420ToRgba",       "(I[B[BII)I",     (jint *) Jni_I420ToRgba},
+JNIEXPORT jint JNICALL
+Jni_NV21ToRGB24Direct(JNIEnv *env, jclass clazz, jobject nv21, jint srcOffset, jobject rgb24,
+                      jint dstOffset, jint width, jint height) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, nv21, srcOffset, yuv420SizeOf(width, height));
+    if (srcData == nullptr) {
+        return -1;
+    }
+    uint8_t *dstData = getDirectAddress(env, rgb24, dstOffset, (jlong) width * height * 3);
+    if (dstData == nullptr) {
+        return -1;
+    }
+    return nv21ToRgb24(srcData, dstData, width, height);
+}
 
-        {"I420ToNV21",       "([B[BIIZ)I",     (jint *) Jni_I420ToNV21},
-        {"NV21ToI420",       "([B[BIIZ)I",     (jint *) Jni_NV21ToI420},
+JNIEXPORT void JNICALL
+Jni_NV21ScaleDirect(JNIEnv *env, jclass clazz, jobject src, jint srcOffset, jint width,
+                    jint height, jobject dst, jint dstOffset, jint dst_width, jint dst_height,
+                    jint mode) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, src, srcOffset, yuv420SizeOf(width, height));
+    if (srcData == nullptr) {
+        return;
+    }
+    uint8_t *dstData = getDirectAddress(env, dst, dstOffset, yuv420SizeOf(dst_width, dst_height));
+    if (dstData == nullptr) {
+        return;
+    }
+    nv21Scale(srcData, width, height, dstData, dst_width, dst_height, mode);
+}
 
-        {"NV21Scale",        "([BII[BIII)V",   (void *) Jni_NV21Scale},
-        {"I420Scale",        "([BII[BIIIZ)V",  (void *) Jni_I420Scale},
-        {"RgbaScale",        "([BII[BIII)V",   (void *) Jni_RgbaScale},
-        {"NV21ToI420Rotate", "([BII[BIZ)V",    (void *) Jni_NV21ToI420Rotate},
+JNIEXPORT void JNICALL
+Jni_I420ScaleDirect(JNIEnv *env, jclass clazz, jobject src, jint srcOffset, jint width,
+                    jint height, jobject dst, jint dstOffset, jint dst_width, jint dst_height,
+                    jint mode, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, src, srcOffset, yuv420SizeOf(width, height));
+    if (srcData == nullptr) {
+        return;
+    }
+    uint8_t *dstData = getDirectAddress(env, dst, dstOffset, yuv420SizeOf(dst_width, dst_height));
+    if (dstData == nullptr) {
+        return;
+    }
+    i420Scale(srcData, width, height, dstData, dst_width, dst_height, mode, swapUV);
+}
 
-        {"NV21CutData",      "([B[BIIIIII)V",  (void *) Jni_NV21CutData},
-};
+JNIEXPORT void JNICALL
+Jni_RgbaScaleDirect(JNIEnv *env, jclass clazz, jobject src, jint srcOffset, jint src_width,
+                    jint src_height, jobject dst, jint dstOffset, jint dst_width,
+                    jint dst_height, jint mode) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, src, srcOffset, (jlong) src_width * src_height * 4);
+    if (srcData == nullptr) {
+        return;
+    }
+    uint8_t *dstData = getDirectAddress(env, dst, dstOffset, (jlong) dst_width * dst_height * 4);
+    if (dstData == nullptr) {
+        return;
+    }
+    rgbaScale(srcData, src_width, src_height, dstData, dst_width, dst_height, mode);
+}
 
-JNIEXPORT jint JNI_OnLoad(JavaVM *vm, void *reserved) {
-    JNIEnv *env = nullptr;
+JNIEXPORT void JNICALL
+Jni_NV21ToI420RotateDirect(JNIEnv *env, jclass clazz, jobject src, jint srcOffset, jint width,
+                           jint height, jobject dst, jint dstOffset, jint de, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, src, srcOffset, yuv420SizeOf(width, height));
+    if (srcData == nullptr) {
+        return;
+    }
+    uint8_t *dstData = getDirectAddress(env, dst, dstOffset, yuv420SizeOf(width, height));
+    if (dstData == nullptr) {
+        return;
+    }
+    nv21ToI420Rotate(srcData, width, height, dstData, de, swapUV);
+}
 
-    if (vm->GetEnv((void **) &env, JNI_VERSION_1_6) != JNI_OK) {
-        return JNI_ERR;
+JNIEXPORT jint JNICALL
+Jni_RgbaToI420WithStrideDirect(JNIEnv *env, jclass clazz, jint type, jobject rgba,
+                               jint srcOffset, jint rgba_stride, jobject yuv, jint dstOffset,
+                               jint y_stride, jint u_stride, jint v_stride, jint width,
+                               jint height) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, rgba, srcOffset, (jlong) rgba_stride * height);
+    if (srcData == nullptr) {
+        return -1;
     }
-    assert(env != nullptr);
-    jclass clazz = env->FindClass(YUV_UTILS_JAVA);
-    env->RegisterNatives(clazz, g_methods, (int) (sizeof(g_methods) / sizeof((g_methods)[0])));
+    uint8_t *dstData = getDirectAddress(env, yuv, dstOffset,
+                                        i420SizeOf(y_stride, u_stride, v_stride, height));
+    if (dstData == nullptr) {
+        return -1;
+    }
+    return rgbaToI420(type, srcData, rgba_stride, dstData, y_stride, u_stride, v_stride, width,
+                      height);
+}
 
-    return JNI_VERSION_1_6;
+JNIEXPORT jint JNICALL
+Jni_RgbaToI420Direct(JNIEnv *env, jclass clazz, jint type, jobject rgba, jint srcOffset,
+                     jobject yuv, jint dstOffset, jint width, jint height) {
+    TRACE_SCOPE(__func__);
+    return Jni_RgbaToI420WithStrideDirect(env, clazz, type, rgba, srcOffset,
+                                          rgbaStrideOf(type, width), yuv, dstOffset, width,
+                                          width >> 1, width >> 1, width, height);
 }
 
-JNIEXPORT void JNI_OnUnload(JavaVM *jvm, void *reserved) {
-    JNIEnv *env = nullptr;
+JNIEXPORT jint JNICALL
+Jni_I420ToRgbaWithStrideDirect(JNIEnv *env, jclass clazz, jint type, jobject yuv,
+                               jint srcOffset, jint y_stride, jint u_stride, jint v_stride,
+                               jobject rgba, jint dstOffset, jint rgba_stride, jint width,
+                               jint height) {
+    TRACE_SCOPE(__func__);
+    uint8_t *srcData = getDirectAddress(env, yuv, srcOffset,
+                                        i420SizeOf(y_stride, u_stride, v_stride, height));
+    if (srcData == nullptr) {
+        return -1;
+    }
+    uint8_t *dstData = getDirectAddress(env, rgba, dstOffset, (jlong) rgba_stride * height);
+    if (dstData == nullptr) {
+        return -1;
+    }
+    return i420ToRgba(type, srcData, y_stride, u_stride, v_stride, dstData, rgba_stride, width,
+                      height);
+}
 
-    if (jvm->GetEnv((void **) &env, JNI_VERSION_1_6) != JNI_OK) {
+JNIEXPORT jint JNICALL
+Jni_I420ToRgbaDirect(JNIEnv *env, jclass clazz, jint type, jobject yuv, jint srcOffset,
+                     jobject rgba, jint dstOffset, jint width, jint height) {
+    TRACE_SCOPE(__func__);
+    return Jni_I420ToRgbaWithStrideDirect(env, clazz, type, yuv, srcOffset, width, width >> 1,
+                                          width >> 1, rgba, dstOffset,
+                                          rgbaStrideOf(type, width), width, height);
+}
+
+JNIEXPORT void JNICALL
+Jni_NV21AddWaterMarkDirect(JNIEnv *env, jclass clazz, jint startX, jint startY,
+                           jobject waterMarkData, jint waterMarkOffset, jint waterMarkW,
+                           jint waterMarkH, jobject yuvData, jint yuvOffset, jint yuvW,
+                           jint yuvH) {
+    TRACE_SCOPE(__func__);
+    uint8_t *waterMark = getDirectAddress(env, waterMarkData, waterMarkOffset,
+                                          yuv420SizeOf(waterMarkW, waterMarkH));
+    if (waterMark == nullptr) {
         return;
     }
-    jclass clazz = env->FindClass(YUV_UTILS_JAVA);
-    env->UnregisterNatives(clazz);
+    uint8_t *yuv = getDirectAddress(env, yuvData, yuvOffset, yuv420SizeOf(yuvW, yuvH));
+    if (yuv == nullptr) {
+        return;
+    }
+    nv21AddWaterMark(startX, startY, waterMark, waterMarkW, waterMarkH, yuv, yuvW, yuvH);
 }
 
-#ifdef __cplusplus
+JNIEXPORT jint JNICALL
+Jni_NV21ToYuv420WithWaterMark(JNIEnv *env, jclass clazz, jbyteArray nv21, jint width, jint height,
+                              jbyteArray waterMarkData, jint waterMarkW, jint waterMarkH,
+                              jint startX, jint startY, jobject dst, jint dstOffset,
+                              jint dstStride, jint dstSliceHeight, jint dstFormat) {
+    TRACE_SCOPE(__func__);
+    if (nv21 == nullptr || env->GetArrayLength(nv21) < yuv420SizeOf(width, height)) {
+        env->ThrowNew(sIllegalArgumentClass, "nv21 too small");
+        return -1;
+    }
+    if (waterMarkData != nullptr &&
+        env->GetArrayLength(waterMarkData) < yuv420SizeOf(waterMarkW, waterMarkH)) {
+        env->ThrowNew(sIllegalArgumentClass, "waterMarkData too small");
+        return -1;
+    }
+    uint8_t *dstData = getDirectAddress(env, dst, dstOffset,
+                                        (jlong) dstStride * dstSliceHeight * 3 / 2);
+    if (dstData == nullptr) {
+        return -1;
+    }
+    jbyte *srcData = (jbyte *) env->GetPrimitiveArrayCritical(nv21, nullptr);
+    jbyte *markData = waterMarkData == nullptr ? nullptr
+                                               : (jbyte *) env->GetPrimitiveArrayCritical(
+                    waterMarkData, nullptr);
+
+    int ret = nv21ToYuv420WithWaterMark((const uint8_t *) srcData, width, height,
+                                        (const uint8_t *) markData, waterMarkW, waterMarkH,
+                                        startX, startY, dstData, dstStride, dstSliceHeight,
+                                        dstFormat);
+
+    if (markData != nullptr) {
+        env->ReleasePrimitiveArrayCritical(waterMarkData, markData, JNI_ABORT);
+    }
+    env->ReleasePrimitiveArrayCritical(nv21, srcData, JNI_ABORT);
+    return ret;
+}
+
+/**
+ * 检查 yuv420spTransform 的源、目标数据长度，不足时抛出异常
+ */
+static bool checkTransformSize(JNIEnv *env, jlong srcLength, jint srcHeight, jint srcStride,
+                               jint srcSliceHeight, jlong dstLength, jint dstStride,
+                               jint dstSliceHeight) {
+    // 源数据最后一行UV之后可能没有padding
+    if (srcLength < (jlong) srcStride * (srcSliceHeight + srcHeight / 2) ||
+        dstLength < (jlong) dstStride * dstSliceHeight * 3 / 2) {
+        env->ThrowNew(sIllegalArgumentClass, "src or dst too small");
+        return false;
+    }
+    return true;
+}
+
+JNIEXPORT jint JNICALL
+Jni_YUV420SPTransform(JNIEnv *env, jclass clazz, jbyteArray src, jint srcWidth, jint srcHeight,
+                      jint srcStride, jint srcSliceHeight, jint srcFormat, jint cropX, jint cropY,
+                      jint cropWidth, jint cropHeight, jint rotation, jbyteArray dst,
+                      jint dstWidth, jint dstHeight, jint dstStride, jint dstSliceHeight,
+                      jint dstFormat, jint mode) {
+    TRACE_SCOPE(__func__);
+    if (!checkTransformSize(env, env->GetArrayLength(src), srcHeight, srcStride, srcSliceHeight,
+                            env->GetArrayLength(dst), dstStride, dstSliceHeight)) {
+        return -1;
+    }
+    jbyte *srcData = (jbyte *) env->GetPrimitiveArrayCritical(src, nullptr);
+    jbyte *dstData = (jbyte *) env->GetPrimitiveArrayCritical(dst, nullptr);
+
+    int ret = yuv420spTransform((const uint8_t *) srcData, srcWidth, srcHeight, srcStride,
+                                srcSliceHeight, srcFormat, cropX, cropY, cropWidth, cropHeight,
+                                rotation, (uint8_t *) dstData, dstWidth, dstHeight, dstStride,
+                                dstSliceHeight, dstFormat, mode);
+
+    env->ReleasePrimitiveArrayCritical(dst, dstData, 0);
+    env->ReleasePrimitiveArrayCritical(src, srcData, JNI_ABORT);
+    return ret;
+}
+
+JNIEXPORT jint JNICALL
+Jni_YUV420SPTransformDirect(JNIEnv *env, jclass clazz, jobject src, jint srcOffset,
+                            jint srcWidth, jint srcHeight, jint srcStride, jint srcSliceHeight,
+                            jint srcFormat, jint cropX, jint cropY, jint cropWidth,
+                            jint cropHeight, jint rotation, jobject dst, jint dstOffset,
+                            jint dstWidth, jint dstHeight, jint dstStride, jint dstSliceHeight,
+                            jint dstFormat, jint mode) {
+    TRACE_SCOPE(__func__);
+    // 与 checkTransformSize 一致，源数据最后一行UV之后可能没有padding
+    uint8_t *srcData = getDirectAddress(env, src, srcOffset,
+                                        (jlong) srcStride * (srcSliceHeight + srcHeight / 2));
+    if (srcData == nullptr) {
+        return -1;
+    }
+    uint8_t *dstData = getDirectAddress(env, dst, dstOffset,
+                                        (jlong) dstStride * dstSliceHeight * 3 / 2);
+    if (dstData == nullptr) {
+        return -1;
+    }
+    return yuv420spTransform(srcData, srcWidth, srcHeight, srcStride, srcSliceHeight, srcFormat,
+                             cropX, cropY, cropWidth, cropHeight, rotation, dstData, dstWidth,
+                             dstHeight, dstStride, dstSliceHeight, dstFormat, mode);
+}
+
+/**
+ * 检查执行变换方案时源、目标数据的长度，失败时已抛出异常并返回false
+ */
+static bool checkPlanSize(JNIEnv *env, const TransformPlan *plan, jlong srcLength,
+                          jlong dstLength) {
+    if (plan == nullptr) {
+        env->ThrowNew(sIllegalArgumentClass, "invalid transform plan");
+        return false;
+    }
+    if (srcLength < plan->srcSize || dstLength < plan->size) {
+        env->ThrowNew(sIllegalArgumentClass, "src or dst too small");
+        return false;
+    }
+    return true;
+}
+
+JNIEXPORT jint JNICALL
+Jni_ExecuteTransformPlan(JNIEnv *env, jclass clazz, jlong plan, jbyteArray src, jbyteArray dst) {
+    TRACE_SCOPE(__func__);
+    TransformPlan *transformPlan = (TransformPlan *) plan;
+    if (!checkPlanSize(env, transformPlan, env->GetArrayLength(src), env->GetArrayLength(dst))) {
+        return -1;
+    }
+    jbyte *srcData = (jbyte *) env->GetPrimitiveArrayCritical(src, nullptr);
+    jbyte *dstData = (jbyte *) env->GetPrimitiveArrayCritical(dst, nullptr);
+
+    int ret = executeTransformPlan(transformPlan, (const uint8_t *) srcData, (uint8_t *) dstData);
+
+    env->ReleasePrimitiveArrayCritical(dst, dstData, 0);
+    env->ReleasePrimitiveArrayCritical(src, srcData, JNI_ABORT);
+    return ret;
+}
+
+JNIEXPORT jint JNICALL
+Jni_ExecuteTransformPlanDirect(JNIEnv *env, jclass clazz, jlong plan, jobject src,
+                               jint srcOffset, jobject dst, jint dstOffset) {
+    TRACE_SCOPE(__func__);
+    TransformPlan *transformPlan = (TransformPlan *) plan;
+    if (transformPlan == nullptr) {
+        env->ThrowNew(sIllegalArgumentClass, "invalid transform plan");
+        return -1;
+    }
+    uint8_t *srcData = getDirectAddress(env, src, srcOffset, transformPlan->srcSize);
+    if (srcData == nullptr) {
+        return -1;
+    }
+    uint8_t *dstData = getDirectAddress(env, dst, dstOffset, transformPlan->size);
+    if (dstData == nullptr) {
+        return -1;
+    }
+    return executeTransformPlan(transformPlan, srcData, dstData);
+}
+
+/**
+ * 检查执行处理图时源、目标数据的长度，失败时已抛出异常并返回false
+ */
+static bool checkGraphSize(JNIEnv *env, const YuvGraph *graph, jlong srcLength,
+                           jlong dstLength) {
+    if (graph == nullptr || graph->size <= 0) {
+        env->ThrowNew(sIllegalArgumentClass, "graph not prepared");
+        return false;
+    }
+    if (srcLength < graph->srcSize || dstLength < graph->size) {
+        env->ThrowNew(sIllegalArgumentClass, "src or dst too small");
+        return false;
+    }
+    return true;
+}
+
+JNIEXPORT jint JNICALL
+Jni_ExecuteGraph(JNIEnv *env, jclass clazz, jlong graph, jbyteArray src, jbyteArray dst) {
+    TRACE_SCOPE(__func__);
+    YuvGraph *yuvGraph = (YuvGraph *) graph;
+    if (!checkGraphSize(env, yuvGraph, env->GetArrayLength(src), env->GetArrayLength(dst))) {
+        return -1;
+    }
+    jbyte *srcData = (jbyte *) env->GetPrimitiveArrayCritical(src, nullptr);
+    jbyte *dstData = (jbyte *) env->GetPrimitiveArrayCritical(dst, nullptr);
+
+    int ret = executeGraph(yuvGraph, (const uint8_t *) srcData, (uint8_t *) dstData);
+
+    env->ReleasePrimitiveArrayCritical(dst, dstData, 0);
+    env->ReleasePrimitiveArrayCritical(src, srcData, JNI_ABORT);
+    return ret;
+}
+
+JNIEXPORT jint JNICALL
+Jni_ExecuteGraphDirect(JNIEnv *env, jclass clazz, jlong graph, jobject src, jint srcOffset,
+                       jobject dst, jint dstOffset) {
+    TRACE_SCOPE(__func__);
+    YuvGraph *yuvGraph = (YuvGraph *) graph;
+    if (yuvGraph == nullptr || yuvGraph->size <= 0) {
+        env->ThrowNew(sIllegalArgumentClass, "graph not prepared");
+        return -1;
+    }
+    uint8_t *srcData = getDirectAddress(env, src, srcOffset, yuvGraph->srcSize);
+    if (srcData == nullptr) {
+        return -1;
+    }
+    uint8_t *dstData = getDirectAddress(env, dst, dstOffset, yuvGraph->size);
+    if (dstData == nullptr) {
+        return -1;
+    }
+    return executeGraph(yuvGraph, srcData, dstData);
+}
+
+/**
+ * 获取Image平面偏移后的native地址，并检查按stride访问width * height个像素不越界
+ */
+static const uint8_t *getPlaneAddress(JNIEnv *env, jobject plane, jint offset, jint rowStride,
+                                      jint pixelStride, jint width, jint height) {
+    if (width <= 0 || height <= 0 || rowStride < (jlong) pixelStride * (width - 1) + 1) {
+        env->ThrowNew(sIllegalArgumentClass, "invalid plane stride");
+        return nullptr;
+    }
+    // 平面最后一行没有padding
+    jlong size = (jlong) rowStride * (height - 1) + (jlong) pixelStride * (width - 1) + 1;
+    return getDirectAddress(env, plane, offset, size);
+}
+
+/**
+ * 获取Image三个平面的native地址，失败时已抛出异常并返回false
+ */
+static bool getImagePlanes(JNIEnv *env, jobject y, jint yOffset, jint yRowStride, jobject u,
+                           jint uOffset, jint uRowStride, jobject v, jint vOffset,
+                           jint vRowStride, jint uvPixelStride, jint width, jint height,
+                           const uint8_t **planes) {
+    int halfWidth = (width + 1) >> 1;
+    int halfHeight = (height + 1) >> 1;
+    planes[0] = getPlaneAddress(env, y, yOffset, yRowStride, 1, width, height);
+    planes[1] = planes[0] == nullptr ? nullptr :
+                getPlaneAddress(env, u, uOffset, uRowStride, uvPixelStride, halfWidth,
+                                halfHeight);
+    planes[2] = planes[1] == nullptr ? nullptr :
+                getPlaneAddress(env, v, vOffset, vRowStride, uvPixelStride, halfWidth,
+                                halfHeight);
+    return planes[2] != nullptr;
+}
+
+JNIEXPORT jint JNICALL
+Jni_Android420ToYuv(JNIEnv *env, jclass clazz, jobject y, jint yOffset, jint yRowStride,
+                    jobject u, jint uOffset, jint uRowStride, jobject v, jint vOffset,
+                    jint vRowStride, jint uvPixelStride, jbyteArray dst, jint width, jint height,
+                    jint dstFormat) {
+    TRACE_SCOPE(__func__);
+    const uint8_t *planes[3];
+    if (!getImagePlanes(env, y, yOffset, yRowStride, u, uOffset, uRowStride, v, vOffset,
+                        vRowStride, uvPixelStride, width, height, planes)) {
+        return -1;
+    }
+    if (env->GetArrayLength(dst) < android420SizeOf(width, height)) {
+        env->ThrowNew(sIllegalArgumentClass, "dst too small");
+        return -1;
+    }
+    jbyte *dstData = (jbyte *) env->GetPrimitiveArrayCritical(dst, nullptr);
+
+    int ret = android420ToYuv(planes[0], yRowStride, planes[1], uRowStride, planes[2],
+                              vRowStride, uvPixelStride, (uint8_t *) dstData, width, height,
+                              dstFormat);
+
+    env->ReleasePrimitiveArrayCritical(dst, dstData, 0);
+    return ret;
+}
+
+JNIEXPORT jint JNICALL
+Jni_Android420ToYuvDirect(JNIEnv *env, jclass clazz, jobject y, jint yOffset, jint yRowStride,
+                          jobject u, jint uOffset, jint uRowStride, jobject v, jint vOffset,
+                          jint vRowStride, jint uvPixelStride, jobject dst, jint dstOffset,
+                          jint width, jint height, jint dstFormat) {
+    TRACE_SCOPE(__func__);
+    const uint8_t *planes[3];
+    if (!getImagePlanes(env, y, yOffset, yRowStride, u, uOffset, uRowStride, v, vOffset,
+                        vRowStride, uvPixelStride, width, height, planes)) {
+        return -1;
+    }
+    uint8_t *dstData = getDirectAddress(env, dst, dstOffset, android420SizeOf(width, height));
+    if (dstData == nullptr) {
+        return -1;
+    }
+    return android420ToYuv(planes[0], yRowStride, planes[1], uRowStride, planes[2], vRowStride,
+                           uvPixelStride, dstData, width, height, dstFormat);
+}
+
+/**
+ * 检查 rgba 数组至少有 stride * height 字节且每行能放下 width 个像素，失败时已抛出异常并返回false
+ */
+static bool checkRgbaSize(JNIEnv *env, jbyteArray rgba, jint stride, jint width, jint height) {
+    if (rgba == nullptr || width <= 0 || height <= 0 || stride < (jlong) width * 4 ||
+        env->GetArrayLength(rgba) < (jlong) stride * height) {
+        env->ThrowNew(sIllegalArgumentClass, "invalid rgba size or stride");
+        return false;
+    }
+    return true;
+}
+
+JNIEXPORT jlong JNICALL
+Jni_CreateOverlay(JNIEnv *env, jclass clazz, jbyteArray rgba, jint stride, jint width,
+                  jint height) {
+    TRACE_SCOPE(__func__);
+    if (!checkRgbaSize(env, rgba, stride, width, height)) {
+        return 0;
+    }
+    jbyte *rgbaData = (jbyte *) env->GetPrimitiveArrayCritical(rgba, nullptr);
+    YuvOverlay *overlay = createOverlay((const uint8_t *) rgbaData, stride, width, height);
+    env->ReleasePrimitiveArrayCritical(rgba, rgbaData, JNI_ABORT);
+    return (jlong) overlay;
 }
-#endif
\ No newline at end of file
+
+/**
+ * 拷贝要叠加的图层及坐标，须在取得 yuv 的 critical 区域之前调用，失败时已抛出异常并返回false
+ *
+ * @param positions 每个图层左上角的坐标，x、y交替存放
+ */
+static bool copyOverlays(JNIEnv *env, jlongArray overlays, jintArray positions, jint count,
+                         std::vector<jlong> &overlayData, std::vector<jint> &positionData) {
+    if (overlays == nullptr || positions == nullptr || count < 0 ||
+        count > env->GetArrayLength(overlays) ||
+        (jlong) count * 2 > env->GetArrayLength(positions)) {
+        env->ThrowNew(sIllegalArgumentClass, "overlays or positions too short");
+        return false;
+    }
+    overlayData.resize((size_t) count);
+    positionData.resize((size_t) count * 2);
+    env->GetLongArrayRegion(overlays, 0, count, overlayData.data());
+    env->GetIntArrayRegion(positions, 0, count * 2, positionData.data());
+    return true;
+}
+
+/**
+ * 依次叠加多个图层
+ */
+static void blendOverlays(uint8_t *yuv, jint width, jint height,
+                          const std::vector<jlong> &overlays, const std::vector<jint> &positions) {
+    for (size_t i = 0; i < overlays.size(); i++) {
+        nv21BlendOverlay(yuv, width, height, (const YuvOverlay *) overlays[i], positions[2 * i],
+                         positions[2 * i + 1]);
+    }
+}
+
+JNIEXPORT void JNICALL
+Jni_NV21BlendOverlays(JNIEnv *env, jclass clazz, jbyteArray yuv, jint width, jint height,
+                      jlongArray overlays, jintArray positions, jint count) {
+    TRACE_SCOPE(__func__);
+    if (yuv == nullptr || env->GetArrayLength(yuv) < yuv420SizeOf(width, height)) {
+        env->ThrowNew(sIllegalArgumentClass, "yuv too small");
+        return;
+    }
+    std::vector<jlong> overlayData;
+    std::vector<jint> positionData;
+    if (!copyOverlays(env, overlays, positions, count, overlayData, positionData)) {
+        return;
+    }
+    jbyte *yuvData = (jbyte *) env->GetPrimitiveArrayCritical(yuv, nullptr);
+    blendOverlays((uint8_t *) yuvData, width, height, overlayData, positionData);
+    env->ReleasePrimitiveArrayCritical(yuv, yuvData, 0);
+}
+
+JNIEXPORT void JNICALL
+Jni_NV21BlendOverlaysDirect(JNIEnv *env, jclass clazz, jobject yuv, jint offset, jint width,
+                            jint height, jlongArray overlays, jintArray positions, jint count) {
+    TRACE_SCOPE(__func__);
+    uint8_t *yuvData = getDirectAddress(env, yuv, offset, yuv420SizeOf(width, height));
+    if (yuvData == nullptr) {
+        return;
+    }
+    std::vector<jlong> overlayData;
+    std::vector<jint> positionData;
+    if (!copyOverlays(env, overlays, positions, count, overlayData, positionData)) {
+        return;
+    }
+    blendOverlays(yuvData, width, height, overlayData, positionData);
+}
+
+JNIEXPORT jlong JNICALL
+Jni_CreateGlyphAtlas(JNIEnv *env, jclass clazz) {
+    TRACE_SCOPE(__func__);
+    return (jlong) createGlyphAtlas();
+}
+
+JNIEXPORT jint JNICALL
+Jni_GlyphAtlasAddGlyph(JNIEnv *env, jclass clazz, jlong atlas, jchar glyph, jbyteArray rgba,
+                       jint stride, jint width, jint height) {
+    TRACE_SCOPE(__func__);
+    if (glyph >= GLYPH_ATLAS_SIZE) {
+        env->ThrowNew(sIllegalArgumentClass, "glyph must be ASCII");
+        return -1;
+    }
+    if (!checkRgbaSize(env, rgba, stride, width, height)) {
+        return -1;
+    }
+    jbyte *rgbaData = (jbyte *) env->GetPrimitiveArrayCritical(rgba, nullptr);
+    int ret = glyphAtlasAddGlyph((GlyphAtlas *) atlas, (char) glyph, (const uint8_t *) rgbaData,
+                                 stride, width, height);
+    env->ReleasePrimitiveArrayCritical(rgba, rgbaData, JNI_ABORT);
+    return ret;
+}
+
+JNIEXPORT jint JNICALL
+Jni_NV21DrawTimestamp(JNIEnv *env, jclass clazz, jbyteArray yuv, jint width, jint height,
+                      jlong atlas, jlong timestamp, jint format, jint x, jint y) {
+    TRACE_SCOPE(__func__);
+    if (yuv == nullptr || env->GetArrayLength(yuv) < yuv420SizeOf(width, height)) {
+        env->ThrowNew(sIllegalArgumentClass, "yuv too small");
+        return -1;
+    }
+    jbyte *yuvData = (jbyte *) env->GetPrimitiveArrayCritical(yuv, nullptr);
+    int ret = nv21DrawTimestamp((uint8_t *) yuvData, width, height, (const GlyphAtlas *) atlas,
+                                timestamp, format, x, y);
+    env->ReleasePrimitiveArrayCritical(yuv, yuvData, 0);
+    return ret;
+}
+
+/**
+ * 检查批量处理的参数，计算每帧源数据、目标数据的大小
+ */
+static bool checkBatch(JNIEnv *env, const BatchOp *op, jint count, int64_t *srcSize,
+                       int64_t *dstSize) {
+    if (count < 0 || count > BATCH_MAX_FRAMES) {
+        env->ThrowNew(sIllegalArgumentClass, "batch count out of range");
+        return false;
+    }
+    if (batchFrameSize(op, srcSize, dstSize) != 0) {
+        env->ThrowNew(sIllegalArgumentClass, "invalid batch parameters");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 读取 native 地址数组中的各帧，地址来自 YuvBuffer.address()、getDirectBufferAddress 等
+ *
+ * @param dst 直接在源数据上处理的操作传nullptr
+ */
+static bool getBatchAddresses(JNIEnv *env, const BatchOp *op, jlongArray src, jlongArray dst,
+                              jint count, uint8_t **srcFrames, uint8_t **dstFrames) {
+    int64_t srcSize;
+    int64_t dstSize;
+    if (!checkBatch(env, op, count, &srcSize, &dstSize)) {
+        return false;
+    }
+    if (count > env->GetArrayLength(src) || (dst != nullptr && count > env->GetArrayLength(dst))) {
+        env->ThrowNew(sIllegalArgumentClass, "src or dst too short");
+        return false;
+    }
+    jlong addresses[BATCH_MAX_FRAMES];
+    env->GetLongArrayRegion(src, 0, count, addresses);
+    for (int i = 0; i < count; i++) {
+        srcFrames[i] = (uint8_t *) addresses[i];
+    }
+    if (dst != nullptr) {
+        env->GetLongArrayRegion(dst, 0, count, addresses);
+        for (int i = 0; i < count; i++) {
+            dstFrames[i] = (uint8_t *) addresses[i];
+        }
+    }
+    return true;
+}
+
+/**
+ * 批量处理 native 地址数组中的各帧
+ */
+static jint batchAddresses(JNIEnv *env, const BatchOp *op, jlongArray src, jlongArray dst,
+                           jint count) {
+    uint8_t *srcFrames[BATCH_MAX_FRAMES];
+    uint8_t *dstFrames[BATCH_MAX_FRAMES];
+    if (!getBatchAddresses(env, op, src, dst, count, srcFrames, dstFrames)) {
+        return -1;
+    }
+    return runBatch(op, srcFrames, dst == nullptr ? nullptr : dstFrames, count);
+}
+
+/**
+ * 读取每帧的偏移并检查该帧是否在数组范围内
+ */
+static bool getBatchOffsets(JNIEnv *env, jbyteArray frames, jintArray offsets, jint count,
+                            int64_t frameSize, jint *offsetData) {
+    if (count > env->GetArrayLength(offsets)) {
+        env->ThrowNew(sIllegalArgumentClass, "offsets too short");
+        return false;
+    }
+    env->GetIntArrayRegion(offsets, 0, count, offsetData);
+    jlong length = env->GetArrayLength(frames);
+    for (int i = 0; i < count; i++) {
+        if (offsetData[i] < 0 || offsetData[i] + frameSize > length) {
+            env->ThrowNew(sIllegalArgumentClass, "frame out of array bounds");
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 批量处理打包在 java 数组中的各帧，一次调用只取一次数组
+ *
+ * 整批在线程池上处理，耗时可能较长，不能持有 GetPrimitiveArrayCritical（会阻塞GC），改用 GetByteArrayElements，
+ * 数组可移动时会拷贝一次
+ *
+ * @param dst 直接在源数据上处理的操作传nullptr
+ */
+static jint batchPacked(JNIEnv *env, const BatchOp *op, jbyteArray src, jintArray srcOffsets,
+                        jbyteArray dst, jintArray dstOffsets, jint count) {
+    int64_t srcSize;
+    int64_t dstSize;
+    jint srcOffsetData[BATCH_MAX_FRAMES];
+    jint dstOffsetData[BATCH_MAX_FRAMES];
+    if (!checkBatch(env, op, count, &srcSize, &dstSize) ||
+        !getBatchOffsets(env, src, srcOffsets, count, srcSize, srcOffsetData) ||
+        (dst != nullptr &&
+         !getBatchOffsets(env, dst, dstOffsets, count, dstSize, dstOffsetData))) {
+        return -1;
+    }
+    uint8_t *srcFrames[BATCH_MAX_FRAMES];
+    uint8_t *dstFrames[BATCH_MAX_FRAMES];
+    jbyte *srcData = env->GetByteArrayElements(src, nullptr);
+    if (srcData == nullptr) {
+        return -1;
+    }
+    jbyte *dstData = nullptr;
+    if (dst != nullptr) {
+        dstData = env->GetByteArrayElements(dst, nullptr);
+        if (dstData == nullptr) {
+            env->ReleaseByteArrayElements(src, srcData, JNI_ABORT);
+            return -1;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        srcFrames[i] = (uint8_t *) srcData + srcOffsetData[i];
+        if (dstData != nullptr) {
+            dstFrames[i] = (uint8_t *) dstData + dstOffsetData[i];
+        }
+    }
+
+    int ret = runBatch(op, srcFrames, dst == nullptr ? nullptr : dstFrames, count);
+
+    if (dstData != nullptr) {
+        env->ReleaseByteArrayElements(dst, dstData, 0);
+    }
+    env->ReleaseByteArrayElements(src, srcData, dst == nullptr ? 0 : JNI_ABORT);
+    return ret;
+}
+
+/**
+ * 读取每帧的时间戳
+ */
+static bool getBatchTimestamps(JNIEnv *env, jlongArray timestamps, jint count,
+                               int64_t *timestampData) {
+    if (count < 0 || count > BATCH_MAX_FRAMES || count > env->GetArrayLength(timestamps)) {
+        env->ThrowNew(sIllegalArgumentClass, "timestamps too short");
+        return false;
+    }
+    env->GetLongArrayRegion(timestamps, 0, count, (jlong *) timestampData);
+    return true;
+}
+
+static BatchOp batchOpOf(int op, jint width, jint height) {
+    BatchOp batch = {};
+    batch.op = op;
+    batch.width = width;
+    batch.height = height;
+    return batch;
+}
+
+JNIEXPORT jint JNICALL
+Jni_NV21ToI420Batch(JNIEnv *env, jclass clazz, jlongArray src, jlongArray dst, jint count,
+                    jint width, jint height, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    BatchOp op = batchOpOf(BATCH_OP_NV21_TO_I420, width, height);
+    op.swapUV = swapUV;
+    return batchAddresses(env, &op, src, dst, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_NV21ToI420BatchPacked(JNIEnv *env, jclass clazz, jbyteArray src, jintArray srcOffsets,
+                          jbyteArray dst, jintArray dstOffsets, jint count, jint width,
+                          jint height, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    BatchOp op = batchOpOf(BATCH_OP_NV21_TO_I420, width, height);
+    op.swapUV = swapUV;
+    return batchPacked(env, &op, src, srcOffsets, dst, dstOffsets, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_I420ToNV21Batch(JNIEnv *env, jclass clazz, jlongArray src, jlongArray dst, jint count,
+                    jint width, jint height, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    BatchOp op = batchOpOf(BATCH_OP_I420_TO_NV21, width, height);
+    op.swapUV = swapUV;
+    return batchAddresses(env, &op, src, dst, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_I420ToNV21BatchPacked(JNIEnv *env, jclass clazz, jbyteArray src, jintArray srcOffsets,
+                          jbyteArray dst, jintArray dstOffsets, jint count, jint width,
+                          jint height, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    BatchOp op = batchOpOf(BATCH_OP_I420_TO_NV21, width, height);
+    op.swapUV = swapUV;
+    return batchPacked(env, &op, src, srcOffsets, dst, dstOffsets, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_NV21ToArgbBatch(JNIEnv *env, jclass clazz, jlongArray src, jlongArray dst, jint count,
+                    jint width, jint height) {
+    TRACE_SCOPE(__func__);
+    BatchOp op = batchOpOf(BATCH_OP_NV21_TO_ARGB, width, height);
+    return batchAddresses(env, &op, src, dst, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_NV21ToArgbBatchPacked(JNIEnv *env, jclass clazz, jbyteArray src, jintArray srcOffsets,
+                          jbyteArray dst, jintArray dstOffsets, jint count, jint width,
+                          jint height) {
+    TRACE_SCOPE(__func__);
+    BatchOp op = batchOpOf(BATCH_OP_NV21_TO_ARGB, width, height);
+    return batchPacked(env, &op, src, srcOffsets, dst, dstOffsets, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_NV21ScaleBatch(JNIEnv *env, jclass clazz, jlongArray src, jlongArray dst, jint count,
+                   jint width, jint height, jint dstWidth, jint dstHeight, jint mode) {
+    TRACE_SCOPE(__func__);
+    BatchOp op = batchOpOf(BATCH_OP_NV21_SCALE, width, height);
+    op.dstWidth = dstWidth;
+    op.dstHeight = dstHeight;
+    op.mode = mode;
+    return batchAddresses(env, &op, src, dst, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_NV21ScaleBatchPacked(JNIEnv *env, jclass clazz, jbyteArray src, jintArray srcOffsets,
+                         jbyteArray dst, jintArray dstOffsets, jint count, jint width,
+                         jint height, jint dstWidth, jint dstHeight, jint mode) {
+    TRACE_SCOPE(__func__);
+    BatchOp op = batchOpOf(BATCH_OP_NV21_SCALE, width, height);
+    op.dstWidth = dstWidth;
+    op.dstHeight = dstHeight;
+    op.mode = mode;
+    return batchPacked(env, &op, src, srcOffsets, dst, dstOffsets, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_ExecuteTransformPlanBatch(JNIEnv *env, jclass clazz, jlong plan, jlongArray src,
+                              jlongArray dst, jint count) {
+    TRACE_SCOPE(__func__);
+    BatchOp op = batchOpOf(BATCH_OP_TRANSFORM_PLAN, 0, 0);
+    op.plan = (const TransformPlan *) plan;
+    return batchAddresses(env, &op, src, dst, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_ExecuteTransformPlanBatchPacked(JNIEnv *env, jclass clazz, jlong plan, jbyteArray src,
+                                    jintArray srcOffsets, jbyteArray dst, jintArray dstOffsets,
+                                    jint count) {
+    TRACE_SCOPE(__func__);
+    BatchOp op = batchOpOf(BATCH_OP_TRANSFORM_PLAN, 0, 0);
+    op.plan = (const TransformPlan *) plan;
+    return batchPacked(env, &op, src, srcOffsets, dst, dstOffsets, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_NV21DrawTimestampBatch(JNIEnv *env, jclass clazz, jlongArray yuv, jint count, jint width,
+                           jint height, jlong atlas, jlongArray timestamps, jint format, jint x,
+                           jint y) {
+    TRACE_SCOPE(__func__);
+    int64_t timestampData[BATCH_MAX_FRAMES];
+    if (!getBatchTimestamps(env, timestamps, count, timestampData)) {
+        return -1;
+    }
+    BatchOp op = batchOpOf(BATCH_OP_DRAW_TIMESTAMP, width, height);
+    op.atlas = (const GlyphAtlas *) atlas;
+    op.timestamps = timestampData;
+    op.format = format;
+    op.x = x;
+    op.y = y;
+    return batchAddresses(env, &op, yuv, nullptr, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_NV21DrawTimestampBatchPacked(JNIEnv *env, jclass clazz, jbyteArray yuv, jintArray offsets,
+                                 jint count, jint width, jint height, jlong atlas,
+                                 jlongArray timestamps, jint format, jint x, jint y) {
+    TRACE_SCOPE(__func__);
+    int64_t timestampData[BATCH_MAX_FRAMES];
+    if (!getBatchTimestamps(env, timestamps, count, timestampData)) {
+        return -1;
+    }
+    BatchOp op = batchOpOf(BATCH_OP_DRAW_TIMESTAMP, width, height);
+    op.atlas = (const GlyphAtlas *) atlas;
+    op.timestamps = timestampData;
+    op.format = format;
+    op.x = x;
+    op.y = y;
+    return batchPacked(env, &op, yuv, offsets, nullptr, nullptr, count);
+}
+
+// createJobStream 会启动任务线程，submitJob（未完成的任务已满时）、waitJob、releaseJobStream 会等待任务完成，
+// 按普通 JNI 调用，期间不影响GC
+
+JNIEXPORT jlong JNICALL
+Jni_CreateJobStream(JNIEnv *env, jclass clazz) {
+    TRACE_SCOPE(__func__);
+    return (jlong) createJobStream();
+}
+
+/**
+ * 提交异步任务，参数含义同对应的批量方法，handle 按操作分别为变换方案、处理图或字形表
+ */
+JNIEXPORT jlong JNICALL
+Jni_SubmitJob(JNIEnv *env, jclass clazz, jlong stream, jint type, jlongArray src, jlongArray dst,
+              jint count, jint width, jint height, jint dstWidth, jint dstHeight, jint mode,
+              jboolean swapUV, jlong handle, jlongArray timestamps, jint format, jint x,
+              jint y) {
+    TRACE_SCOPE(__func__);
+    if (stream == 0) {
+        env->ThrowNew(sIllegalArgumentClass, "invalid job stream");
+        return -1;
+    }
+    int64_t timestampData[BATCH_MAX_FRAMES];
+    BatchOp op = batchOpOf(type, width, height);
+    op.dstWidth = dstWidth;
+    op.dstHeight = dstHeight;
+    op.mode = mode;
+    op.swapUV = swapUV;
+    op.plan = type == BATCH_OP_TRANSFORM_PLAN ? (const TransformPlan *) handle : nullptr;
+    op.graph = type == BATCH_OP_GRAPH ? (YuvGraph *) handle : nullptr;
+    op.atlas = type == BATCH_OP_DRAW_TIMESTAMP ? (const GlyphAtlas *) handle : nullptr;
+    op.format = format;
+    op.x = x;
+    op.y = y;
+    if (type == BATCH_OP_DRAW_TIMESTAMP) {
+        if (!getBatchTimestamps(env, timestamps, count, timestampData)) {
+            return -1;
+        }
+        op.timestamps = timestampData;
+        dst = nullptr;
+    }
+    uint8_t *srcFrames[BATCH_MAX_FRAMES];
+    uint8_t *dstFrames[BATCH_MAX_FRAMES];
+    if (!getBatchAddresses(env, &op, src, dst, count, srcFrames, dstFrames)) {
+        return -1;
+    }
+    return submitJob((YuvJobStream *) stream, &op, srcFrames,
+                     dst == nullptr ? nullptr : dstFrames, count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_WaitJob(JNIEnv *env, jclass clazz, jlong stream, jlong job, jint timeoutMs) {
+    TRACE_SCOPE(__func__);
+    return waitJob((YuvJobStream *) stream, job, timeoutMs);
+}
+
+JNIEXPORT void JNICALL
+Jni_ReleaseJobStream(JNIEnv *env, jclass clazz, jlong stream) {
+    TRACE_SCOPE(__func__);
+    releaseJobStream((YuvJobStream *) stream);
+}
+
+JNIEXPORT jint JNICALL
+Jni_AutoSelectCpuFlags(JNIEnv *env, jclass clazz, jint width, jint height, jint iterations) {
+    TRACE_SCOPE(__func__);
+    return autoSelectCpuFlags(width, height, iterations);
+}
+
+JNIEXPORT jstring JNICALL
+Jni_GetCpuReport(JNIEnv *env, jclass clazz) {
+    TRACE_SCOPE(__func__);
+    char report[4096];
+    formatCpuReport(report, sizeof(report));
+    return env->NewStringUTF(report);
+}
+
+JNIEXPORT jstring JNICALL
+Jni_GetKernelProfile(JNIEnv *env, jclass clazz) {
+    TRACE_SCOPE(__func__);
+    // 每个行函数一行，最多几百个，不适合放在栈上
+    const int size = 64 * 1024;
+    char *report = (char *) malloc(size);
+    if (report == nullptr) {
+        return nullptr;
+    }
+    formatKernelProfile(report, size);
+    jstring result = env->NewStringUTF(report);
+    free(report);
+    return result;
+}
+
+JNIEXPORT jint JNICALL
+Jni_DumpTrace(JNIEnv *env, jclass clazz, jstring path) {
+    if (path == nullptr) {
+        env->ThrowNew(sIllegalArgumentClass, "invalid trace path");
+        return -1;
+    }
+    const char *pathChars = env->GetStringUTFChars(path, nullptr);
+    if (pathChars == nullptr) {
+        return -1;
+    }
+    int count = yuvtrace::dumpTrace(pathChars);
+    env->ReleaseStringUTFChars(path, pathChars);
+    return count;
+}
+
+JNIEXPORT jlong JNICALL
+Jni_GetDirectBufferAddress(JNIEnv *env, jclass clazz, jobject buffer) {
+    TRACE_SCOPE(__func__);
+    return (jlong) getDirectAddress(env, buffer, 0, 0);
+}
+
+JNIEXPORT jobject JNICALL
+Jni_WrapBuffer(JNIEnv *env, jclass clazz, jlong buffer) {
+    TRACE_SCOPE(__func__);
+    if (buffer == 0) {
+        env->ThrowNew(sIllegalArgumentClass, "invalid buffer handle");
+        return nullptr;
+    }
+    PoolBuffer *poolBuffer = (PoolBuffer *) buffer;
+    return env->NewDirectByteBuffer(poolBuffer->data, (jlong) poolBuffer->size);
+}
+
+// native 内存地址版本，参数为 getDirectBufferAddress 等获取的地址；处理整帧耗时较长，大图还会在线程池上分带并等待，
+// 不能注册为 @CriticalNative（执行期间线程不能被GC挂起），按普通 JNI 注册
+
+JNIEXPORT jint JNICALL
+Jni_I420ToNV21Address(JNIEnv *env, jclass clazz, jlong yuv420p, jlong yuv420sp, jint width,
+                      jint height, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    return i420ToNV21((const uint8_t *) yuv420p, (uint8_t *) yuv420sp, width, height, swapUV);
+}
+
+JNIEXPORT jint JNICALL
+Jni_NV21ToI420Address(JNIEnv *env, jclass clazz, jlong yuv420sp, jlong yuv420p, jint width,
+                      jint height, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    return nv21ToI420((const uint8_t *) yuv420sp, (uint8_t *) yuv420p, width, height, swapUV);
+}
+
+JNIEXPORT jint JNICALL
+Jni_ArgbToNV21Address(JNIEnv *env, jclass clazz, jlong argb, jlong nv21, jint width,
+                      jint height) {
+    TRACE_SCOPE(__func__);
+    return argbToNV21((const uint8_t *) argb, (uint8_t *) nv21, width, height);
+}
+
+JNIEXPORT void JNICALL
+Jni_NV12ToNV21Address(JNIEnv *env, jclass clazz, jlong yuv, jint width, jint height) {
+    TRACE_SCOPE(__func__);
+    nv12ToNV21((uint8_t *) yuv, width, height);
+}
+
+JNIEXPORT void JNICALL
+Jni_NV21ScaleAddress(JNIEnv *env, jclass clazz, jlong src, jint width, jint height, jlong dst,
+                     jint dst_width, jint dst_height, jint mode) {
+    TRACE_SCOPE(__func__);
+    nv21Scale((const uint8_t *) src, width, height, (uint8_t *) dst, dst_width, dst_height, mode);
+}
+
+JNIEXPORT void JNICALL
+Jni_I420ScaleAddress(JNIEnv *env, jclass clazz, jlong src, jint width, jint height, jlong dst,
+                     jint dst_width, jint dst_height, jint mode, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    i420Scale((const uint8_t *) src, width, height, (uint8_t *) dst, dst_width, dst_height, mode,
+              swapUV);
+}
+
+JNIEXPORT void JNICALL
+Jni_NV21ToI420RotateAddress(JNIEnv *env, jclass clazz, jlong src, jint width, jint height,
+                            jlong dst, jint de, jboolean swapUV) {
+    TRACE_SCOPE(__func__);
+    nv21ToI420Rotate((const uint8_t *) src, width, height, (uint8_t *) dst, de, swapUV);
+}
+
+JNIEXPORT void JNICALL
+Jni_NV21AddWaterMarkAddress(JNIEnv *env, jclass clazz, jint startX, jint startY, jlong waterMark,
+                            jint waterMarkW, jint waterMarkH, jlong yuv, jint yuvW, jint yuvH) {
+    TRACE_SCOPE(__func__);
+    nv21AddWaterMark(startX, startY, (const uint8_t *) waterMark, waterMarkW, waterMarkH,
+                     (uint8_t *) yuv, yuvW, yuvH);
+}
+
+JNIEXPORT void JNICALL
+Jni_NV21BlendOverlayAddress(JNIEnv *env, jclass clazz, jlong yuv, jint width, jint height,
+                            jlong overlay, jint x, jint y) {
+    TRACE_SCOPE(__func__);
+    nv21BlendOverlay((uint8_t *) yuv, width, height, (const YuvOverlay *) overlay, x, y);
+}
+
+JNIEXPORT jint JNICALL
+Jni_YUV420SPTransformAddress(JNIEnv *env, jclass clazz, jlong src, jint srcWidth,
+                             jint srcHeight, jint srcStride, jint srcSliceHeight, jint srcFormat,
+                             jint cropX, jint cropY, jint cropWidth, jint cropHeight,
+                             jint rotation, jlong dst, jint dstWidth, jint dstHeight,
+                             jint dstStride, jint dstSliceHeight, jint dstFormat, jint mode) {
+    TRACE_SCOPE(__func__);
+    return yuv420spTransform((const uint8_t *) src, srcWidth, srcHeight, srcStride,
+                             srcSliceHeight, srcFormat, cropX, cropY, cropWidth, cropHeight,
+                             rotation, (uint8_t *) dst, dstWidth, dstHeight, dstStride,
+                             dstSliceHeight, dstFormat, mode);
+}
+
+JNIEXPORT jint JNICALL
+Jni_NV21DrawTimestampAddress(JNIEnv *env, jclass clazz, jlong yuv, jint width, jint height,
+                             jlong atlas, jlong timestamp, jint format, jint x, jint y) {
+    TRACE_SCOPE(__func__);
+    return nv21DrawTimestamp((uint8_t *) yuv, width, height, (const GlyphAtlas *) atlas,
+                             timestamp, format, x, y);
+}
+
+JNIEXPORT jint JNICALL
+Jni_ExecuteTransformPlanAddress(JNIEnv *env, jclass clazz, jlong plan, jlong src, jlong dst) {
+    TRACE_SCOPE(__func__);
+    return executeTransformPlan((TransformPlan *) plan, (const uint8_t *) src, (uint8_t *) dst);
+}
+
+JNIEXPORT jint JNICALL
+Jni_ExecuteGraphAddress(JNIEnv *env, jclass clazz, jlong graph, jlong src, jlong dst) {
+    TRACE_SCOPE(__func__);
+    return executeGraph((YuvGraph *) graph, (const uint8_t *) src, (uint8_t *) dst);
+}
+
+// @CriticalNative 版本，只用于常数时间、不阻塞的调用，没有 JNIEnv 和 jclass 参数
+
+static void Cn_ReleaseOverlay(jlong overlay) {
+    TRACE_SCOPE(__func__);
+    releaseOverlay((YuvOverlay *) overlay);
+}
+
+static void Cn_ReleaseGlyphAtlas(jlong atlas) {
+    TRACE_SCOPE(__func__);
+    releaseGlyphAtlas((GlyphAtlas *) atlas);
+}
+
+static jint Cn_MeasureTimestamp(jlong atlas, jlong timestamp, jint format) {
+    TRACE_SCOPE(__func__);
+    char text[32];
+    if (formatTimestamp(timestamp, format, text, sizeof(text)) < 0) {
+        return -1;
+    }
+    return glyphAtlasMeasureText((const GlyphAtlas *) atlas, text);
+}
+
+static jint Cn_GetGlyphAtlasHeight(jlong atlas) {
+    TRACE_SCOPE(__func__);
+    return atlas == 0 ? 0 : ((const GlyphAtlas *) atlas)->height;
+}
+
+static void Cn_SetThreadCount(jint count) {
+    TRACE_SCOPE(__func__);
+    setParallelThreadCount(count);
+}
+
+static jint Cn_GetThreadCount() {
+    TRACE_SCOPE(__func__);
+    return getParallelThreadCount();
+}
+
+static jlong Cn_CreateTransformPlan(jint srcWidth, jint srcHeight, jint srcStride,
+                                    jint srcSliceHeight, jint srcFormat, jint cropX, jint cropY,
+                                    jint cropWidth, jint cropHeight, jint rotation, jint dstWidth,
+                                    jint dstHeight, jint dstStride, jint dstSliceHeight,
+                                    jint dstFormat, jint mode) {
+    TRACE_SCOPE(__func__);
+    return (jlong) createTransformPlan(srcWidth, srcHeight, srcStride, srcSliceHeight, srcFormat,
+                                       cropX, cropY, cropWidth, cropHeight, rotation, dstWidth,
+                                       dstHeight, dstStride, dstSliceHeight, dstFormat, mode);
+}
+
+static void Cn_ReleaseTransformPlan(jlong plan) {
+    TRACE_SCOPE(__func__);
+    releaseTransformPlan((TransformPlan *) plan);
+}
+
+static jlong Cn_CreateGraph(jint srcWidth, jint srcHeight, jint srcStride, jint srcSliceHeight,
+                            jint srcFormat) {
+    TRACE_SCOPE(__func__);
+    return (jlong) createGraph(srcWidth, srcHeight, srcStride, srcSliceHeight, srcFormat);
+}
+
+static jint Cn_GraphCrop(jlong graph, jint x, jint y, jint width, jint height) {
+    TRACE_SCOPE(__func__);
+    return graphCrop((YuvGraph *) graph, x, y, width, height);
+}
+
+static jint Cn_GraphScale(jlong graph, jint width, jint height, jint mode) {
+    TRACE_SCOPE(__func__);
+    return graphScale((YuvGraph *) graph, width, height, mode);
+}
+
+static jint Cn_GraphRotate(jlong graph, jint rotation) {
+    TRACE_SCOPE(__func__);
+    return graphRotate((YuvGraph *) graph, rotation);
+}
+
+static jint Cn_GraphOverlay(jlong graph, jlong overlay, jint x, jint y) {
+    TRACE_SCOPE(__func__);
+    return graphOverlay((YuvGraph *) graph, (const YuvOverlay *) overlay, x, y);
+}
+
+static jint Cn_PrepareGraph(jlong graph, jint dstStride, jint dstSliceHeight, jint dstFormat) {
+    TRACE_SCOPE(__func__);
+    return prepareGraph((YuvGraph *) graph, dstStride, dstSliceHeight, dstFormat);
+}
+
+static void Cn_ReleaseGraph(jlong graph) {
+    TRACE_SCOPE(__func__);
+    releaseGraph((YuvGraph *) graph);
+}
+
+static jlong Cn_AcquireBuffer(jint size) {
+    TRACE_SCOPE(__func__);
+    return size < 0 ? 0 : (jlong) acquirePoolBuffer((size_t) size);
+}
+
+static void Cn_ReleaseBuffer(jlong buffer) {
+    TRACE_SCOPE(__func__);
+    releasePoolBuffer((PoolBuffer *) buffer);
+}
+
+static jlong Cn_GetBufferAddress(jlong buffer) {
+    TRACE_SCOPE(__func__);
+    return buffer == 0 ? 0 : (jlong) ((PoolBuffer *) buffer)->data;
+}
+
+static void Cn_TrimBufferPool() {
+    TRACE_SCOPE(__func__);
+    trimBufferPool();
+}
+
+static void Cn_SetBufferPoolLimit(jlong bytes) {
+    TRACE_SCOPE(__func__);
+    setBufferPoolLimit(bytes);
+}
+
+static jlong Cn_GetBufferPoolAllocCount() {
+    TRACE_SCOPE(__func__);
+    return getBufferPoolAllocCount();
+}
+
+static jlong Cn_GetScratchAllocCount() {
+    TRACE_SCOPE(__func__);
+    return getScratchAllocCount();
+}
+
+static jint Cn_PollJob(jlong stream, jlong job) {
+    TRACE_SCOPE(__func__);
+    return pollJob((YuvJobStream *) stream, job);
+}
+
+static jlong Cn_GetCompletedJob(jlong stream) {
+    TRACE_SCOPE(__func__);
+    return getCompletedJob((YuvJobStream *) stream);
+}
+
+static jint Cn_GetJobStreamEventFd(jlong stream) {
+    TRACE_SCOPE(__func__);
+    return getJobStreamEventFd((YuvJobStream *) stream);
+}
+
+static jint Cn_GetCpuFlags() {
+    TRACE_SCOPE(__func__);
+    return getCpuFlags();
+}
+
+static jint Cn_MaskCpuFlags(jint mask) {
+    TRACE_SCOPE(__func__);
+    return maskCpuFlags(mask);
+}
+
+static void Cn_ResetKernelProfile() {
+    TRACE_SCOPE(__func__);
+    resetKernelProfile();
+}
+
+static void Cn_SetTraceEnabled(jboolean enabled) {
+    yuvtrace::setTraceEnabled(enabled);
+}
+
+// Android 8.0 以下 @CriticalNative 注解不生效，仍按普通 JNI 调用，需要注册带 JNIEnv、jclass 参数的函数
+
+JNIEXPORT void JNICALL
+Jni_ReleaseOverlay(JNIEnv *env, jclass clazz, jlong overlay) {
+    Cn_ReleaseOverlay(overlay);
+}
+
+JNIEXPORT void JNICALL
+Jni_ReleaseGlyphAtlas(JNIEnv *env, jclass clazz, jlong atlas) {
+    Cn_ReleaseGlyphAtlas(atlas);
+}
+
+JNIEXPORT jint JNICALL
+Jni_MeasureTimestamp(JNIEnv *env, jclass clazz, jlong atlas, jlong timestamp, jint format) {
+    return Cn_MeasureTimestamp(atlas, timestamp, format);
+}
+
+JNIEXPORT jint JNICALL
+Jni_GetGlyphAtlasHeight(JNIEnv *env, jclass clazz, jlong atlas) {
+    return Cn_GetGlyphAtlasHeight(atlas);
+}
+
+JNIEXPORT void JNICALL
+Jni_SetThreadCount(JNIEnv *env, jclass clazz, jint count) {
+    Cn_SetThreadCount(count);
+}
+
+JNIEXPORT jint JNICALL
+Jni_GetThreadCount(JNIEnv *env, jclass clazz) {
+    return Cn_GetThreadCount();
+}
+
+JNIEXPORT jlong JNICALL
+Jni_CreateTransformPlan(JNIEnv *env, jclass clazz, jint srcWidth, jint srcHeight, jint srcStride,
+                        jint srcSliceHeight, jint srcFormat, jint cropX, jint cropY,
+                        jint cropWidth, jint cropHeight, jint rotation, jint dstWidth,
+                        jint dstHeight, jint dstStride, jint dstSliceHeight, jint dstFormat,
+                        jint mode) {
+    return Cn_CreateTransformPlan(srcWidth, srcHeight, srcStride, srcSliceHeight, srcFormat,
+                                  cropX, cropY, cropWidth, cropHeight, rotation, dstWidth,
+                                  dstHeight, dstStride, dstSliceHeight, dstFormat, mode);
+}
+
+JNIEXPORT void JNICALL
+Jni_ReleaseTransformPlan(JNIEnv *env, jclass clazz, jlong plan) {
+    Cn_ReleaseTransformPlan(plan);
+}
+
+JNIEXPORT jlong JNICALL
+Jni_CreateGraph(JNIEnv *env, jclass clazz, jint srcWidth, jint srcHeight, jint srcStride,
+                jint srcSliceHeight, jint srcFormat) {
+    return Cn_CreateGraph(srcWidth, srcHeight, srcStride, srcSliceHeight, srcFormat);
+}
+
+JNIEXPORT jint JNICALL
+Jni_GraphCrop(JNIEnv *env, jclass clazz, jlong graph, jint x, jint y, jint width, jint height) {
+    return Cn_GraphCrop(graph, x, y, width, height);
+}
+
+JNIEXPORT jint JNICALL
+Jni_GraphScale(JNIEnv *env, jclass clazz, jlong graph, jint width, jint height, jint mode) {
+    return Cn_GraphScale(graph, width, height, mode);
+}
+
+JNIEXPORT jint JNICALL
+Jni_GraphRotate(JNIEnv *env, jclass clazz, jlong graph, jint rotation) {
+    return Cn_GraphRotate(graph, rotation);
+}
+
+JNIEXPORT jint JNICALL
+Jni_GraphOverlay(JNIEnv *env, jclass clazz, jlong graph, jlong overlay, jint x, jint y) {
+    return Cn_GraphOverlay(graph, overlay, x, y);
+}
+
+JNIEXPORT jint JNICALL
+Jni_PrepareGraph(JNIEnv *env, jclass clazz, jlong graph, jint dstStride, jint dstSliceHeight,
+                 jint dstFormat) {
+    return Cn_PrepareGraph(graph, dstStride, dstSliceHeight, dstFormat);
+}
+
+JNIEXPORT void JNICALL
+Jni_ReleaseGraph(JNIEnv *env, jclass clazz, jlong graph) {
+    Cn_ReleaseGraph(graph);
+}
+
+JNIEXPORT jlong JNICALL
+Jni_AcquireBuffer(JNIEnv *env, jclass clazz, jint size) {
+    return Cn_AcquireBuffer(size);
+}
+
+JNIEXPORT void JNICALL
+Jni_ReleaseBuffer(JNIEnv *env, jclass clazz, jlong buffer) {
+    Cn_ReleaseBuffer(buffer);
+}
+
+JNIEXPORT jlong JNICALL
+Jni_GetBufferAddress(JNIEnv *env, jclass clazz, jlong buffer) {
+    return Cn_GetBufferAddress(buffer);
+}
+
+JNIEXPORT void JNICALL
+Jni_TrimBufferPool(JNIEnv *env, jclass clazz) {
+    Cn_TrimBufferPool();
+}
+
+JNIEXPORT void JNICALL
+Jni_SetBufferPoolLimit(JNIEnv *env, jclass clazz, jlong bytes) {
+    Cn_SetBufferPoolLimit(bytes);
+}
+
+JNIEXPORT jlong JNICALL
+Jni_GetBufferPoolAllocCount(JNIEnv *env, jclass clazz) {
+    return Cn_GetBufferPoolAllocCount();
+}
+
+JNIEXPORT jlong JNICALL
+Jni_GetScratchAllocCount(JNIEnv *env, jclass clazz) {
+    return Cn_GetScratchAllocCount();
+}
+
+JNIEXPORT jint JNICALL
+Jni_PollJob(JNIEnv *env, jclass clazz, jlong stream, jlong job) {
+    return Cn_PollJob(stream, job);
+}
+
+JNIEXPORT jlong JNICALL
+Jni_GetCompletedJob(JNIEnv *env, jclass clazz, jlong stream) {
+    return Cn_GetCompletedJob(stream);
+}
+
+JNIEXPORT jint JNICALL
+Jni_GetJobStreamEventFd(JNIEnv *env, jclass clazz, jlong stream) {
+    return Cn_GetJobStreamEventFd(stream);
+}
+
+JNIEXPORT jint JNICALL
+Jni_GetCpuFlags(JNIEnv *env, jclass clazz) {
+    return Cn_GetCpuFlags();
+}
+
+JNIEXPORT jint JNICALL
+Jni_MaskCpuFlags(JNIEnv *env, jclass clazz, jint mask) {
+    return Cn_MaskCpuFlags(mask);
+}
+
+JNIEXPORT void JNICALL
+Jni_ResetKernelProfile(JNIEnv *env, jclass clazz) {
+    Cn_ResetKernelProfile();
+}
+
+JNIEXPORT void JNICALL
+Jni_SetTraceEnabled(JNIEnv *env, jclass clazz, jboolean enabled) {
+    Cn_SetTraceEnabled(enabled);
+}
+
+
+//libyuv中，rgba表示abgrabgrabgr这样的顺序写入文件，java使用的时候习惯rgba表示rgbargbargba写入文件
+static JNINativeMethod g_methods[] = {
+        {"RgbaToI420",       "(I[BI[BIIIII)I", (jint *) Jni_RgbaToI420WithStride},
+        {"RgbaToI420",       "(I[B[BII)I",     (jint *) Jni_RgbaToI420},
+        {"ArgbToNV21",       "([B[BII)I",      (jint *) Jni_ArgbToNV21},
+        {"NV12ToNV21",       "([BII)V",        (jint *) Jni_NV12ToNV21},
+        {"NV12ToArgb",       "([B[BII)I",      (jint *) Jni_NV12ToArgb},
+        {"NV21ToArgb",       "([B[BII)I",      (jint *) Jni_NV21ToArgb},
+        {"NV21ToRgb24",      "([B[BII)I",      (jint *) Jni_NV21ToRGB24},
+        {"NV21AddWaterMark", "(II[BII[BII)V",  (void *) Jni_NV21AddWaterMark},
+
+        {"I420ToRgba",       "(I[BIII[BIII)I", (jint *) Jni_I420ToRgbaWithStride},
+        {"I420ToRgba",       "(I[B[BII)I",     (jint *) Jni_I420ToRgba},
+
+        {"I420ToNV21",       "([B[BIIZ)I",     (jint *) Jni_I420ToNV21},
+        {"NV21ToI420",       "([B[BIIZ)I",     (jint *) Jni_NV21ToI420},
+
+        {"NV21Scale",        "([BII[BIII)V",   (void *) Jni_NV21Scale},
+        {"I420Scale",        "([BII[BIIIZ)V",  (void *) Jni_I420Scale},
+        {"RgbaScale",        "([BII[BIII)V",   (void *) Jni_RgbaScale},
+        {"NV21ToI420Rotate", "([BII[BIZ)V",    (void *) Jni_NV21ToI420Rotate},
+
+        {"NV21CutData",      "([B[BIIIIII)V",  (void *) Jni_NV21CutData},
+
+        {"createOverlay",     "([BIII)J",       (jlong *) Jni_CreateOverlay},
+        {"NV21BlendOverlays", "([BII[J[II)V",   (void *) Jni_NV21BlendOverlays},
+
+        {"createGlyphAtlas",  "()J",            (jlong *) Jni_CreateGlyphAtlas},
+        {"addGlyph",          "(JC[BIII)I",     (jint *) Jni_GlyphAtlasAddGlyph},
+        {"NV21DrawTimestamp", "([BIIJJIII)I",   (jint *) Jni_NV21DrawTimestamp},
+
+        {"YUV420SPTransform", "([BIIIIIIIIII[BIIIIII)I", (jint *) Jni_YUV420SPTransform},
+        {"executeTransformPlan", "(J[B[B)I",             (jint *) Jni_ExecuteTransformPlan},
+        {"executeGraph",         "(J[B[B)I",             (jint *) Jni_ExecuteGraph},
+
+        {"NV21ToI420Batch",        "([J[JIIIZ)I",       (jint *) Jni_NV21ToI420Batch},
+        {"NV21ToI420Batch",        "([B[I[B[IIIIZ)I",   (jint *) Jni_NV21ToI420BatchPacked},
+        {"I420ToNV21Batch",        "([J[JIIIZ)I",       (jint *) Jni_I420ToNV21Batch},
+        {"I420ToNV21Batch",        "([B[I[B[IIIIZ)I",   (jint *) Jni_I420ToNV21BatchPacked},
+        {"NV21ToArgbBatch",        "([J[JIII)I",        (jint *) Jni_NV21ToArgbBatch},
+        {"NV21ToArgbBatch",        "([B[I[B[IIII)I",    (jint *) Jni_NV21ToArgbBatchPacked},
+        {"NV21ScaleBatch",         "([J[JIIIIII)I",     (jint *) Jni_NV21ScaleBatch},
+        {"NV21ScaleBatch",         "([B[I[B[IIIIIII)I", (jint *) Jni_NV21ScaleBatchPacked},
+        {"executeTransformPlanBatch", "(J[J[JI)I",      (jint *) Jni_ExecuteTransformPlanBatch},
+        {"executeTransformPlanBatch", "(J[B[I[B[II)I",
+                (jint *) Jni_ExecuteTransformPlanBatchPacked},
+        {"NV21DrawTimestampBatch", "([JIIIJ[JIII)I",    (jint *) Jni_NV21DrawTimestampBatch},
+        {"NV21DrawTimestampBatch", "([B[IIIIJ[JIII)I",  (jint *) Jni_NV21DrawTimestampBatchPacked},
+
+        {"createJobStream",  "()J",                    (jlong *) Jni_CreateJobStream},
+        {"submitJob",        "(JI[J[JIIIIIIZJ[JIII)J", (jlong *) Jni_SubmitJob},
+        {"waitJob",          "(JJI)I",                 (jint *) Jni_WaitJob},
+        {"releaseJobStream", "(J)V",                   (void *) Jni_ReleaseJobStream},
+
+        {"autoSelectCpuFlags", "(III)I",               (jint *) Jni_AutoSelectCpuFlags},
+        {"getCpuReport",       "()Ljava/lang/String;", (jstring *) Jni_GetCpuReport},
+        {"getKernelProfile",   "()Ljava/lang/String;", (jstring *) Jni_GetKernelProfile},
+
+        {"dumpTrace",          "(Ljava/lang/String;)I", (jint *) Jni_DumpTrace},
+};
+
+#define BYTE_BUFFER "Ljava/nio/ByteBuffer;"
+
+// direct ByteBuffer 版本的方法，签名在 g_methods 的基础上把 [B 换成 ByteBuffer + int offset
+static JNINativeMethod g_direct_methods[] = {
+        {"RgbaToI420",       "(I" BYTE_BUFFER "II" BYTE_BUFFER "IIIIII)I",
+                (jint *) Jni_RgbaToI420WithStrideDirect},
+        {"RgbaToI420",       "(I" BYTE_BUFFER "I" BYTE_BUFFER "III)I",
+                (jint *) Jni_RgbaToI420Direct},
+        {"ArgbToNV21",       "(" BYTE_BUFFER "I" BYTE_BUFFER "III)I",
+                (jint *) Jni_ArgbToNV21Direct},
+        {"NV12ToNV21",       "(" BYTE_BUFFER "III)V",
+                (void *) Jni_NV12ToNV21Direct},
+        {"NV12ToArgb",       "(" BYTE_BUFFER "I" BYTE_BUFFER "III)I",
+                (jint *) Jni_NV12ToArgbDirect},
+        {"NV21ToArgb",       "(" BYTE_BUFFER "I" BYTE_BUFFER "III)I",
+                (jint *) Jni_NV21ToArgbDirect},
+        {"NV21ToRgb24",      "(" BYTE_BUFFER "I" BYTE_BUFFER "III)I",
+                (jint *) Jni_NV21ToRGB24Direct},
+        {"NV21AddWaterMark", "(II" BYTE_BUFFER "III" BYTE_BUFFER "III)V",
+                (void *) Jni_NV21AddWaterMarkDirect},
+
+        {"I420ToRgba",       "(I" BYTE_BUFFER "IIII" BYTE_BUFFER "IIII)I",
+                (jint *) Jni_I420ToRgbaWithStrideDirect},
+        {"I420ToRgba",       "(I" BYTE_BUFFER "I" BYTE_BUFFER "III)I",
+                (jint *) Jni_I420ToRgbaDirect},
+
+        {"I420ToNV21",       "(" BYTE_BUFFER "I" BYTE_BUFFER "IIIZ)I",
+                (jint *) Jni_I420ToNV21Direct},
+        {"NV21ToI420",       "(" BYTE_BUFFER "I" BYTE_BUFFER "IIIZ)I",
+                (jint *) Jni_NV21ToI420Direct},
+
+        {"NV21Scale",        "(" BYTE_BUFFER "III" BYTE_BUFFER "IIII)V",
+                (void *) Jni_NV21ScaleDirect},
+        {"I420Scale",        "(" BYTE_BUFFER "III" BYTE_BUFFER "IIIIZ)V",
+                (void *) Jni_I420ScaleDirect},
+        {"RgbaScale",        "(" BYTE_BUFFER "III" BYTE_BUFFER "IIII)V",
+                (void *) Jni_RgbaScaleDirect},
+        {"NV21ToI420Rotate", "(" BYTE_BUFFER "III" BYTE_BUFFER "IIZ)V",
+                (void *) Jni_NV21ToI420RotateDirect},
+
+        {"NV21CutData",      "(" BYTE_BUFFER "I" BYTE_BUFFER "IIIIIII)V",
+                (void *) Jni_NV21CutDataDirect},
+
+        {"NV21ToYuv420WithWaterMark", "([BII[BIIII" BYTE_BUFFER "IIII)I",
+                (jint *) Jni_NV21ToYuv420WithWaterMark},
+
+        {"NV21BlendOverlays", "(" BYTE_BUFFER "III[J[II)V",
+                (void *) Jni_NV21BlendOverlaysDirect},
+
+        {"YUV420SPTransform", "(" BYTE_BUFFER "IIIIIIIIIII" BYTE_BUFFER "IIIIIII)I",
+                (jint *) Jni_YUV420SPTransformDirect},
+
+        {"Android420ToYuv", "(" BYTE_BUFFER "II" BYTE_BUFFER "II" BYTE_BUFFER "III[BIII)I",
+                (jint *) Jni_Android420ToYuv},
+        {"Android420ToYuv", "(" BYTE_BUFFER "II" BYTE_BUFFER "II" BYTE_BUFFER "III"
+                            BYTE_BUFFER "IIII)I",
+                (jint *) Jni_Android420ToYuvDirect},
+
+        {"executeTransformPlan", "(J" BYTE_BUFFER "I" BYTE_BUFFER "I)I",
+                (jint *) Jni_ExecuteTransformPlanDirect},
+        {"executeGraph",         "(J" BYTE_BUFFER "I" BYTE_BUFFER "I)I",
+                (jint *) Jni_ExecuteGraphDirect},
+
+        {"getDirectBufferAddress", "(" BYTE_BUFFER ")J",
+                (jlong *) Jni_GetDirectBufferAddress},
+        {"wrapBuffer",             "(J)" BYTE_BUFFER,
+                (jobject *) Jni_WrapBuffer},
+};
+
+// native 内存地址版本，处理整帧，按普通 JNI 注册
+static JNINativeMethod g_address_methods[] = {
+        {"I420ToNV21",           "(JJIIZ)I",              (jint *) Jni_I420ToNV21Address},
+        {"NV21ToI420",           "(JJIIZ)I",              (jint *) Jni_NV21ToI420Address},
+        {"ArgbToNV21",           "(JJII)I",               (jint *) Jni_ArgbToNV21Address},
+        {"NV12ToNV21",           "(JII)V",                (void *) Jni_NV12ToNV21Address},
+        {"NV21Scale",            "(JIIJIII)V",            (void *) Jni_NV21ScaleAddress},
+        {"I420Scale",            "(JIIJIIIZ)V",           (void *) Jni_I420ScaleAddress},
+        {"NV21ToI420Rotate",     "(JIIJIZ)V",             (void *) Jni_NV21ToI420RotateAddress},
+        {"NV21AddWaterMark",     "(IIJIIJII)V",           (void *) Jni_NV21AddWaterMarkAddress},
+        {"NV21BlendOverlay",     "(JIIJII)V",             (void *) Jni_NV21BlendOverlayAddress},
+        {"NV21DrawTimestamp",    "(JIIJJIII)I",           (jint *) Jni_NV21DrawTimestampAddress},
+        {"YUV420SPTransform",    "(JIIIIIIIIIIJIIIIII)I", (jint *) Jni_YUV420SPTransformAddress},
+        {"executeTransformPlan", "(JJJ)I",                (jint *) Jni_ExecuteTransformPlanAddress},
+        {"executeGraph",         "(JJJ)I",                (jint *) Jni_ExecuteGraphAddress},
+};
+
+// 常数时间、不阻塞的方法，Android 8.0 及以上注册为 @CriticalNative
+static JNINativeMethod g_critical_methods[] = {
+        {"releaseOverlay",      "(J)V",        (void *) Cn_ReleaseOverlay},
+        {"releaseGlyphAtlas",   "(J)V",        (void *) Cn_ReleaseGlyphAtlas},
+        {"measureTimestamp",    "(JJI)I",      (jint *) Cn_MeasureTimestamp},
+        {"getGlyphAtlasHeight", "(J)I",        (jint *) Cn_GetGlyphAtlasHeight},
+        {"setThreadCount",    "(I)V",                  (void *) Cn_SetThreadCount},
+        {"getThreadCount",    "()I",                   (jint *) Cn_GetThreadCount},
+        {"createTransformPlan",  "(IIIIIIIIIIIIIIII)J", (jlong *) Cn_CreateTransformPlan},
+        {"releaseTransformPlan", "(J)V",                (void *) Cn_ReleaseTransformPlan},
+        {"createGraph",  "(IIIII)J", (jlong *) Cn_CreateGraph},
+        {"graphCrop",    "(JIIII)I", (jint *) Cn_GraphCrop},
+        {"graphScale",   "(JIII)I",  (jint *) Cn_GraphScale},
+        {"graphRotate",  "(JI)I",    (jint *) Cn_GraphRotate},
+        {"graphOverlay", "(JJII)I",  (jint *) Cn_GraphOverlay},
+        {"prepareGraph", "(JIII)I",  (jint *) Cn_PrepareGraph},
+        {"releaseGraph", "(J)V",     (void *) Cn_ReleaseGraph},
+        {"acquireBuffer",          "(I)J", (jlong *) Cn_AcquireBuffer},
+        {"releaseBuffer",          "(J)V", (void *) Cn_ReleaseBuffer},
+        {"getBufferAddress",       "(J)J", (jlong *) Cn_GetBufferAddress},
+        {"trimBufferPool",         "()V",  (void *) Cn_TrimBufferPool},
+        {"setBufferPoolLimit",     "(J)V", (void *) Cn_SetBufferPoolLimit},
+        {"getBufferPoolAllocCount", "()J", (jlong *) Cn_GetBufferPoolAllocCount},
+        {"getScratchAllocCount",   "()J", (jlong *) Cn_GetScratchAllocCount},
+        {"pollJob",             "(JJ)I", (jint *) Cn_PollJob},
+        {"getCompletedJob",     "(J)J",  (jlong *) Cn_GetCompletedJob},
+        {"getJobStreamEventFd", "(J)I",  (jint *) Cn_GetJobStreamEventFd},
+        {"getCpuFlags",         "()I",   (jint *) Cn_GetCpuFlags},
+        {"maskCpuFlags",        "(I)I",  (jint *) Cn_MaskCpuFlags},
+        {"resetKernelProfile",  "()V",   (void *) Cn_ResetKernelProfile},
+        {"setTraceEnabled",     "(Z)V",  (void *) Cn_SetTraceEnabled},
+};
+
+// 与 g_critical_methods 一一对应，Android 8.0 以下使用
+static JNINativeMethod g_critical_compat_methods[] = {
+        {"releaseOverlay",      "(J)V",        (void *) Jni_ReleaseOverlay},
+        {"releaseGlyphAtlas",   "(J)V",        (void *) Jni_ReleaseGlyphAtlas},
+        {"measureTimestamp",    "(JJI)I",      (jint *) Jni_MeasureTimestamp},
+        {"getGlyphAtlasHeight", "(J)I",        (jint *) Jni_GetGlyphAtlasHeight},
+        {"setThreadCount",    "(I)V",                  (void *) Jni_SetThreadCount},
+        {"getThreadCount",    "()I",                   (jint *) Jni_GetThreadCount},
+        {"createTransformPlan",  "(IIIIIIIIIIIIIIII)J", (jlong *) Jni_CreateTransformPlan},
+        {"releaseTransformPlan", "(J)V",                (void *) Jni_ReleaseTransformPlan},
+        {"createGraph",  "(IIIII)J", (jlong *) Jni_CreateGraph},
+        {"graphCrop",    "(JIIII)I", (jint *) Jni_GraphCrop},
+        {"graphScale",   "(JIII)I",  (jint *) Jni_GraphScale},
+        {"graphRotate",  "(JI)I",    (jint *) Jni_GraphRotate},
+        {"graphOverlay", "(JJII)I",  (jint *) Jni_GraphOverlay},
+        {"prepareGraph", "(JIII)I",  (jint *) Jni_PrepareGraph},
+        {"releaseGraph", "(J)V",     (void *) Jni_ReleaseGraph},
+        {"acquireBuffer",          "(I)J", (jlong *) Jni_AcquireBuffer},
+        {"releaseBuffer",          "(J)V", (void *) Jni_ReleaseBuffer},
+        {"getBufferAddress",       "(J)J", (jlong *) Jni_GetBufferAddress},
+        {"trimBufferPool",         "()V",  (void *) Jni_TrimBufferPool},
+        {"setBufferPoolLimit",     "(J)V", (void *) Jni_SetBufferPoolLimit},
+        {"getBufferPoolAllocCount", "()J", (jlong *) Jni_GetBufferPoolAllocCount},
+        {"getScratchAllocCount",   "()J", (jlong *) Jni_GetScratchAllocCount},
+        {"pollJob",             "(JJ)I", (jint *) Jni_PollJob},
+        {"getCompletedJob",     "(J)J",  (jlong *) Jni_GetCompletedJob},
+        {"getJobStreamEventFd", "(J)I",  (jint *) Jni_GetJobStreamEventFd},
+        {"getCpuFlags",         "()I",   (jint *) Jni_GetCpuFlags},
+        {"maskCpuFlags",        "(I)I",  (jint *) Jni_MaskCpuFlags},
+        {"resetKernelProfile",  "()V",   (void *) Jni_ResetKernelProfile},
+        {"setTraceEnabled",     "(Z)V",  (void *) Jni_SetTraceEnabled},
+};
+
+static_assert(sizeof(g_critical_methods) == sizeof(g_critical_compat_methods),
+              "g_critical_compat_methods must match g_critical_methods");
+
+/**
+ * 获取系统版本 Build.VERSION.SDK_INT
+ */
+static int getSdkInt(JNIEnv *env) {
+    jclass versionClass = env->FindClass("android/os/Build$VERSION");
+    if (versionClass == nullptr) {
+        env->ExceptionClear();
+        return 0;
+    }
+    jfieldID sdkIntField = env->GetStaticFieldID(versionClass, "SDK_INT", "I");
+    int sdkInt = sdkIntField == nullptr ? 0 : env->GetStaticIntField(versionClass, sdkIntField);
+    env->DeleteLocalRef(versionClass);
+    return sdkInt;
+}
+
+JNIEXPORT jint JNI_OnLoad(JavaVM *vm, void *reserved) {
+    JNIEnv *env = nullptr;
+
+    if (vm->GetEnv((void **) &env, JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+    assert(env != nullptr);
+    // libyuv内部的行缓冲改为线程私有的 scratch arena，须在任何线程调用libyuv之前
+    installScratchArena();
+    jclass exceptionClass = env->FindClass(ILLEGAL_ARGUMENT_EXCEPTION_JAVA);
+    sIllegalArgumentClass = (jclass) env->NewGlobalRef(exceptionClass);
+    env->DeleteLocalRef(exceptionClass);
+
+    jclass clazz = env->FindClass(YUV_UTILS_JAVA);
+    env->RegisterNatives(clazz, g_methods, (int) (sizeof(g_methods) / sizeof((g_methods)[0])));
+    env->RegisterNatives(clazz, g_direct_methods,
+                         (int) (sizeof(g_direct_methods) / sizeof((g_direct_methods)[0])));
+    env->RegisterNatives(clazz, g_address_methods,
+                         (int) (sizeof(g_address_methods) / sizeof((g_address_methods)[0])));
+    int criticalCount = (int) (sizeof(g_critical_methods) / sizeof((g_critical_methods)[0]));
+    env->RegisterNatives(clazz, getSdkInt(env) >= 26 ? g_critical_methods
+                                                     : g_critical_compat_methods, criticalCount);
+
+    return JNI_VERSION_1_6;
+}
+
+JNIEXPORT void JNI_OnUnload(JavaVM *jvm, void *reserved) {
+    JNIEnv *env = nullptr;
+
+    if (jvm->GetEnv((void **) &env, JNI_VERSION_1_6) != JNI_OK) {
+        return;
+    }
+    jclass clazz = env->FindClass(YUV_UTILS_JAVA);
+    env->UnregisterNatives(clazz);
+    env->DeleteGlobalRef(sIllegalArgumentClass);
+    sIllegalArgumentClass = nullptr;
+}
+
+#ifdef __cplusplus
+}
+#endif
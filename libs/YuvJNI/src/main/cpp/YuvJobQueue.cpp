@@ -0,0 +1,171 @@
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "YuvJobQueue.h"
+#include "YuvTrace.h"
+
+/**
+ * 提交时拷贝的任务参数，帧地址、时间戳不引用调用方的数组
+ */
+struct YuvJob {
+    BatchOp op;
+    int count;
+    uint8_t *src[BATCH_MAX_FRAMES];
+    uint8_t *dst[BATCH_MAX_FRAMES];
+    int64_t timestamps[BATCH_MAX_FRAMES];
+};
+
+/**
+ * 任务按ID存放在环形槽位中，未完成的任务不超过 JOB_MAX_PENDING 个，正在执行的槽位不会被新任务覆盖
+ */
+struct YuvJobStream {
+    std::mutex mutex;
+    // 调度线程等待新任务
+    std::condition_variable submitted;
+    // 提交、等待结果的线程等待任务完成
+    std::condition_variable completed;
+    YuvJob jobs[JOB_MAX_PENDING];
+    int results[JOB_RESULT_HISTORY];
+    int64_t submittedId = 0;
+    int64_t completedId = 0;
+    bool quit = false;
+    int eventFd = -1;
+    std::thread thread;
+};
+
+static void runJobStream(YuvJobStream *stream) {
+    for (;;) {
+        YuvJob *job;
+        {
+            std::unique_lock<std::mutex> lock(stream->mutex);
+            stream->submitted.wait(lock, [stream] {
+                return stream->quit || stream->completedId < stream->submittedId;
+            });
+            // 退出前执行完已提交的任务
+            if (stream->completedId == stream->submittedId) {
+                return;
+            }
+            job = &stream->jobs[(stream->completedId + 1) % JOB_MAX_PENDING];
+        }
+        // 不在调度线程的分带中，任务内部仍可在线程池上并行
+        TRACE_SCOPE("runJob");
+        int ret = runBatch(&job->op, job->src, job->dst, job->count);
+        {
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            stream->completedId++;
+            stream->results[stream->completedId % JOB_RESULT_HISTORY] = ret == 0 ? 0 : -1;
+        }
+        stream->completed.notify_all();
+        if (stream->eventFd >= 0) {
+            uint64_t one = 1;
+            write(stream->eventFd, &one, sizeof(one));
+        }
+    }
+}
+
+YuvJobStream *createJobStream() {
+    YuvJobStream *stream = new YuvJobStream();
+    stream->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    stream->thread = std::thread(runJobStream, stream);
+    return stream;
+}
+
+int64_t submitJob(YuvJobStream *stream, const BatchOp *op, uint8_t *const *src,
+                  uint8_t *const *dst, int count) {
+    int64_t srcSize;
+    int64_t dstSize;
+    if (stream == nullptr || batchFrameSize(op, &srcSize, &dstSize) != 0 || count < 0 ||
+        count > BATCH_MAX_FRAMES || (count > 0 && (src == nullptr ||
+                                                   (dstSize > 0 && dst == nullptr)))) {
+        return -1;
+    }
+    std::unique_lock<std::mutex> lock(stream->mutex);
+    stream->completed.wait(lock, [stream] {
+        return stream->submittedId - stream->completedId < JOB_MAX_PENDING;
+    });
+    int64_t id = stream->submittedId + 1;
+    YuvJob *job = &stream->jobs[id % JOB_MAX_PENDING];
+    job->op = *op;
+    job->count = count;
+    for (int i = 0; i < count; i++) {
+        job->src[i] = src[i];
+        job->dst[i] = dstSize > 0 ? dst[i] : nullptr;
+    }
+    if (op->op == BATCH_OP_DRAW_TIMESTAMP) {
+        for (int i = 0; i < count; i++) {
+            job->timestamps[i] = op->timestamps[i];
+        }
+        job->op.timestamps = job->timestamps;
+    }
+    stream->submittedId = id;
+    lock.unlock();
+    stream->submitted.notify_one();
+    return id;
+}
+
+/**
+ * 需持有 stream->mutex
+ */
+static int jobStatus(const YuvJobStream *stream, int64_t job) {
+    if (job <= 0 || job > stream->submittedId ||
+        job <= stream->completedId - JOB_RESULT_HISTORY) {
+        return JOB_UNKNOWN;
+    }
+    if (job > stream->completedId) {
+        return JOB_PENDING;
+    }
+    return stream->results[job % JOB_RESULT_HISTORY];
+}
+
+int pollJob(YuvJobStream *stream, int64_t job) {
+    if (stream == nullptr) {
+        return JOB_UNKNOWN;
+    }
+    std::lock_guard<std::mutex> lock(stream->mutex);
+    return jobStatus(stream, job);
+}
+
+int waitJob(YuvJobStream *stream, int64_t job, int timeoutMs) {
+    if (stream == nullptr) {
+        return JOB_UNKNOWN;
+    }
+    std::unique_lock<std::mutex> lock(stream->mutex);
+    auto done = [stream, job] { return jobStatus(stream, job) != JOB_PENDING; };
+    if (timeoutMs < 0) {
+        stream->completed.wait(lock, done);
+    } else {
+        stream->completed.wait_for(lock, std::chrono::milliseconds(timeoutMs), done);
+    }
+    return jobStatus(stream, job);
+}
+
+int64_t getCompletedJob(YuvJobStream *stream) {
+    if (stream == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(stream->mutex);
+    return stream->completedId;
+}
+
+int getJobStreamEventFd(YuvJobStream *stream) {
+    return stream == nullptr ? -1 : stream->eventFd;
+}
+
+void releaseJobStream(YuvJobStream *stream) {
+    if (stream == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        stream->quit = true;
+    }
+    stream->submitted.notify_one();
+    stream->thread.join();
+    if (stream->eventFd >= 0) {
+        close(stream->eventFd);
+    }
+    delete stream;
+}
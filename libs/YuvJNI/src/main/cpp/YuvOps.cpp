@@ -0,0 +1,2010 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include "libyuv.h"
+#include "YuvBufferPool.h"
+#include "YuvOps.h"
+#include "YuvThreadPool.h"
+#include "YuvTrace.h"
+
+// debug 输出 YUV 文件
+//#define SAVE_RET
+
+static int
+(*rgbaToI420Func[])(const uint8_t *, int, uint8_t *, int, uint8_t *, int, uint8_t *, int, int,
+                    int) ={
+        libyuv::ABGRToI420, libyuv::RGBAToI420, libyuv::ARGBToI420, libyuv::BGRAToI420,
+        libyuv::RGB24ToI420, libyuv::RGB565ToI420
+};
+
+static int
+(*i420ToRgbaFunc[])(const uint8_t *, int, const uint8_t *, int, const uint8_t *, int, uint8_t *,
+                    int, int, int) ={
+        libyuv::I420ToABGR, libyuv::I420ToRGBA, libyuv::I420ToARGB, libyuv::I420ToBGRA,
+        libyuv::I420ToRGB24, libyuv::I420ToRGB565
+};
+
+static void (*rotateUVFunc[])(const uint8_t *src, int src_stride, uint8_t *dst_a, int dst_stride_a,
+                              uint8_t *dst_b, int dst_stride_b, int width, int height) ={
+        libyuv::RotateUV90, libyuv::RotateUV180, libyuv::RotateUV270,
+};
+
+/**
+ * 源数据 [start, end) 行旋转后在目标中的偏移：90度落在右侧的列，180度落在底部的行，270度落在左侧的列
+ */
+static size_t rotatedBandOffset(int rotation, int start, int end, int height, int dstStride) {
+    if (rotation == libyuv::kRotate90) {
+        return (size_t) (height - end);
+    }
+    if (rotation == libyuv::kRotate180) {
+        return (size_t) (height - end) * dstStride;
+    }
+    return (size_t) start;
+}
+
+/**
+ * 按源数据的行分带旋转，每带旋转后写入目标中互不重叠的区域
+ */
+static void rotatePlaneBand(const uint8_t *src, int srcStride, uint8_t *dst, int dstStride,
+                            int width, int height, int start, int end, int rotation) {
+    libyuv::RotatePlane(src + (size_t) start * srcStride, srcStride,
+                        dst + rotatedBandOffset(rotation, start, end, height, dstStride),
+                        dstStride, width, end - start, (libyuv::RotationMode) rotation);
+}
+
+typedef void (*ScaleFunc)(const uint8_t *src, int srcStride, int srcWidth, int srcHeight,
+                          uint8_t *dst, int dstStride, int dstWidth, int dstHeight, int mode);
+
+static void scalePlaneFunc(const uint8_t *src, int srcStride, int srcWidth, int srcHeight,
+                           uint8_t *dst, int dstStride, int dstWidth, int dstHeight, int mode) {
+    libyuv::ScalePlane(src, srcStride, srcWidth, srcHeight, dst, dstStride, dstWidth, dstHeight,
+                       (libyuv::FilterMode) mode);
+}
+
+static void scaleUVFunc(const uint8_t *src, int srcStride, int srcWidth, int srcHeight,
+                        uint8_t *dst, int dstStride, int dstWidth, int dstHeight, int mode) {
+    libyuv::UVScale(src, srcStride, srcWidth, srcHeight, dst, dstStride, dstWidth, dstHeight,
+                    (libyuv::FilterMode) mode);
+}
+
+static int gcd(int a, int b) {
+    while (b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * 纵向缩小时，每 srcUnit 行源数据恰好对应 dstUnit 行目标数据，且16.16定点的纵向步长没有截断误差，
+ * 按整数个周期切带缩放的结果和整帧缩放逐字节一致；3/4缩小走libyuv按3行一组的专用实现，同样按周期切带
+ *
+ * @return dstUnit，不能切带时返回0
+ */
+static int scaleBandUnit(ScaleFunc func, int srcWidth, int srcHeight, int dstWidth,
+                         int dstHeight, int *srcUnit) {
+    if (srcHeight <= 0 || dstHeight <= 0 || dstHeight > srcHeight) {
+        return 0;
+    }
+    if (func == scalePlaneFunc && 4 * dstWidth == 3 * srcWidth &&
+        4 * dstHeight == 3 * srcHeight) {
+        *srcUnit = 4;
+        return 3;
+    }
+    int g = gcd(srcHeight, dstHeight);
+    int p = srcHeight / g;
+    int q = dstHeight / g;
+    if ((((int64_t) p << 16) % q) != 0) {
+        return 0;
+    }
+    *srcUnit = p;
+    return q;
+}
+
+/**
+ * 能按周期切带时把一个平面的缩放分带并行，否则整帧缩放
+ */
+static void scaleBands(ScaleFunc func, const uint8_t *src, int srcStride, int srcWidth,
+                       int srcHeight, uint8_t *dst, int dstStride, int dstWidth, int dstHeight,
+                       int mode) {
+    int srcUnit = 0;
+    int dstUnit = scaleBandUnit(func, srcWidth, srcHeight, dstWidth, dstHeight, &srcUnit);
+    if (dstUnit == 0) {
+        func(src, srcStride, srcWidth, srcHeight, dst, dstStride, dstWidth, dstHeight, mode);
+        return;
+    }
+    // 每行目标数据大约读取的源像素数
+    int64_t rowPixels = (int64_t) srcWidth * srcUnit / dstUnit;
+    parallelRows(dstHeight, dstUnit, rowPixels, [=](int start, int end) {
+        func(src + (size_t) (start / dstUnit * srcUnit) * srcStride, srcStride, srcWidth,
+             (end - start) / dstUnit * srcUnit, dst + (size_t) start * dstStride, dstStride,
+             dstWidth, end - start, mode);
+        return 0;
+    });
+}
+
+/**
+ * 缩放若干个平面：第一个平面能切带时逐个平面分带并行，否则每个平面一个任务并行
+ */
+static void scalePlanes(int count, const ScaleFunc *funcs, const uint8_t *const *src,
+                        const int *srcStride, const int *srcWidth, const int *srcHeight,
+                        uint8_t *const *dst, const int *dstStride, const int *dstWidth,
+                        const int *dstHeight, int mode) {
+    int srcUnit = 0;
+    if (scaleBandUnit(funcs[0], srcWidth[0], srcHeight[0], dstWidth[0], dstHeight[0],
+                      &srcUnit) != 0) {
+        for (int i = 0; i < count; i++) {
+            scaleBands(funcs[i], src[i], srcStride[i], srcWidth[i], srcHeight[i], dst[i],
+                       dstStride[i], dstWidth[i], dstHeight[i], mode);
+        }
+        return;
+    }
+    parallelRows(count, 1, (int64_t) srcWidth[0] * srcHeight[0] / count,
+                 [=](int start, int end) {
+                     for (int i = start; i < end; i++) {
+                         funcs[i](src[i], srcStride[i], srcWidth[i], srcHeight[i], dst[i],
+                                  dstStride[i], dstWidth[i], dstHeight[i], mode);
+                     }
+                     return 0;
+                 });
+}
+
+/**
+ * I420平面数据，U、V分量stride相同
+ */
+struct PlanarImage {
+    uint8_t *y;
+    uint8_t *u;
+    uint8_t *v;
+    int yStride;
+    int uvStride;
+    int width;
+    int height;
+};
+
+static PlanarImage planarImageOf(uint8_t *buffer, int width, int height) {
+    int halfWidth = width >> 1;
+    uint8_t *u = buffer + (size_t) width * height;
+    return {buffer, u, u + (size_t) halfWidth * (height >> 1), width, halfWidth, width, height};
+}
+
+static void scalePlanar(const PlanarImage &src, const PlanarImage &dst, int mode) {
+    TRACE_SCOPE("scale");
+    static const ScaleFunc funcs[] = {scalePlaneFunc, scalePlaneFunc, scalePlaneFunc};
+    const uint8_t *srcPlanes[] = {src.y, src.u, src.v};
+    uint8_t *dstPlanes[] = {dst.y, dst.u, dst.v};
+    // 宽高为奇数时色度向上取整，和 I420Scale 一致
+    int srcHalfWidth = (src.width + 1) >> 1;
+    int srcHalfHeight = (src.height + 1) >> 1;
+    int dstHalfWidth = (dst.width + 1) >> 1;
+    int dstHalfHeight = (dst.height + 1) >> 1;
+    int srcStride[] = {src.yStride, src.uvStride, src.uvStride};
+    int srcWidth[] = {src.width, srcHalfWidth, srcHalfWidth};
+    int srcHeight[] = {src.height, srcHalfHeight, srcHalfHeight};
+    int dstStride[] = {dst.yStride, dst.uvStride, dst.uvStride};
+    int dstWidth[] = {dst.width, dstHalfWidth, dstHalfWidth};
+    int dstHeight[] = {dst.height, dstHalfHeight, dstHalfHeight};
+    scalePlanes(3, funcs, srcPlanes, srcStride, srcWidth, srcHeight, dstPlanes, dstStride,
+                dstWidth, dstHeight, mode);
+}
+
+static void rotatePlanar(const PlanarImage &src, const PlanarImage &dst, int rotation) {
+    int halfHeight = src.height >> 1;
+    // 16行对齐，色度转置按8行一组
+    parallelRows(src.height, 16, src.width, [&](int start, int end) {
+        rotatePlaneBand(src.y, src.yStride, dst.y, dst.yStride, src.width, src.height, start, end,
+                        rotation);
+        rotatePlaneBand(src.u, src.uvStride, dst.u, dst.uvStride, src.width >> 1, halfHeight,
+                        start >> 1, end >> 1, rotation);
+        rotatePlaneBand(src.v, src.uvStride, dst.v, dst.uvStride, src.width >> 1, halfHeight,
+                        start >> 1, end >> 1, rotation);
+        return 0;
+    });
+}
+
+int rgbaStrideOf(int type, int width) {
+    return ((type & 0xF0) >> 4) * width;
+}
+
+int rgbaToI420(int type, const uint8_t *rgba, int rgbaStride, uint8_t *yuv, int yStride,
+               int uStride, int vStride, int width, int height) {
+    uint8_t cType = (uint8_t) (type & 0x0F);
+    size_t ySize = (size_t) (yStride * height);
+    size_t uSize = (size_t) (uStride * height >> 1);
+    uint8_t *u = yuv + ySize;
+    uint8_t *v = yuv + ySize + uSize;
+    // 色度按2x2采样，分带按2行对齐
+    return parallelRows(height, 2, width, [=](int start, int end) {
+        return rgbaToI420Func[cType](rgba + (size_t) start * rgbaStride, rgbaStride,
+                                     yuv + (size_t) start * yStride, yStride,
+                                     u + (size_t) (start >> 1) * uStride, uStride,
+                                     v + (size_t) (start >> 1) * vStride, vStride, width,
+                                     end - start);
+    });
+}
+
+int i420ToRgba(int type, const uint8_t *yuv, int yStride, int uStride, int vStride,
+               uint8_t *rgba, int rgbaStride, int width, int height) {
+    uint8_t cType = (uint8_t) (type & 0x0F);
+    size_t ySize = (size_t) (yStride * height);
+    size_t uSize = (size_t) (uStride * height >> 1);
+    const uint8_t *u = yuv + ySize;
+    const uint8_t *v = yuv + ySize + uSize;
+    return parallelRows(height, 2, width, [=](int start, int end) {
+        return i420ToRgbaFunc[cType](yuv + (size_t) start * yStride, yStride,
+                                     u + (size_t) (start >> 1) * uStride, uStride,
+                                     v + (size_t) (start >> 1) * vStride, vStride,
+                                     rgba + (size_t) start * rgbaStride, rgbaStride, width,
+                                     end - start);
+    });
+}
+
+int i420ToNV21(const uint8_t *yuv420p, uint8_t *yuv420sp, int width, int height, bool swapUV) {
+    size_t ySize = (size_t) (width * height);
+    size_t uSize = (size_t) (width * height >> 2);
+    size_t stride[] = {0, uSize};
+    const uint8_t *u = yuv420p + ySize + stride[swapUV];
+    const uint8_t *v = yuv420p + ySize + stride[1 - swapUV];
+    int halfWidth = width >> 1;
+    return parallelRows(height, 2, width, [=](int start, int end) {
+        size_t uvRow = (size_t) (start >> 1);
+        return libyuv::I420ToNV21(yuv420p + start * (size_t) width, width,
+                                  u + uvRow * halfWidth, halfWidth,
+                                  v + uvRow * halfWidth, halfWidth,
+                                  yuv420sp + start * (size_t) width, width,
+                                  yuv420sp + ySize + uvRow * width, width,
+                                  width, end - start);
+    });
+}
+
+int nv21ToI420(const uint8_t *yuv420sp, uint8_t *yuv420p, int width, int height, bool swapUV) {
+    size_t ySize = (size_t) (width * height);
+    size_t uSize = (size_t) (width * height >> 2);
+    size_t stride[] = {0, uSize};
+    uint8_t *u = yuv420p + ySize + stride[swapUV];
+    uint8_t *v = yuv420p + ySize + stride[1 - swapUV];
+    int halfWidth = width >> 1;
+    return parallelRows(height, 2, width, [=](int start, int end) {
+        size_t uvRow = (size_t) (start >> 1);
+        return libyuv::NV21ToI420(yuv420sp + start * (size_t) width, width,
+                                  yuv420sp + ySize + uvRow * width, width,
+                                  yuv420p + start * (size_t) width, width,
+                                  u + uvRow * halfWidth, halfWidth,
+                                  v + uvRow * halfWidth, halfWidth,
+                                  width, end - start);
+    });
+}
+
+int argbToNV21(const uint8_t *argb, uint8_t *nv21, int width, int height) {
+    size_t ySize = (size_t) (width * height);
+    return parallelRows(height, 2, width, [=](int start, int end) {
+        return libyuv::ARGBToNV21(argb + start * (size_t) width * 4, width * 4,
+                                  nv21 + start * (size_t) width, width,
+                                  nv21 + ySize + (size_t) (start >> 1) * width, width, width,
+                                  end - start);
+    });
+}
+
+void nv12ToNV21(uint8_t *yuv, int width, int height) {
+    if (yuv == nullptr || width <= 0 || height <= 0) {
+        return;
+    }
+    // 原地交换UV
+    uint8_t *uv = yuv + (size_t) width * height;
+    parallelRows(height >> 1, 1, width, [=](int start, int end) {
+        uint8_t *rows = uv + (size_t) start * width;
+        libyuv::SwapUVPlane(rows, width, rows, width, width >> 1, end - start);
+        return 0;
+    });
+}
+
+/**
+ * NV12、NV21转为ABGR、RGB24等交织格式，按行分带并行
+ */
+static int yuv420spToPacked(int (*func)(const uint8_t *, int, const uint8_t *, int, uint8_t *,
+                                        int, int, int), const uint8_t *yuv, uint8_t *dst,
+                            int bytesPerPixel, int width, int height) {
+    size_t ySize = (size_t) (width * height);
+    return parallelRows(height, 2, width, [=](int start, int end) {
+        return func(yuv + start * (size_t) width, width,
+                    yuv + ySize + (size_t) (start >> 1) * width, width,
+                    dst + start * (size_t) width * bytesPerPixel, width * bytesPerPixel, width,
+                    end - start);
+    });
+}
+
+int nv12ToArgb(const uint8_t *nv12, uint8_t *argb, int width, int height) {
+    return yuv420spToPacked(libyuv::NV12ToABGR, nv12, argb, 4, width, height);
+}
+
+int nv21ToArgb(const uint8_t *nv21, uint8_t *argb, int width, int height) {
+    return yuv420spToPacked(libyuv::NV21ToABGR, nv21, argb, 4, width, height);
+}
+
+int nv21ToRgb24(const uint8_t *nv21, uint8_t *rgb24, int width, int height) {
+    return yuv420spToPacked(libyuv::NV21ToRGB24, nv21, rgb24, 3, width, height);
+}
+
+void nv21Scale(const uint8_t *src, int width, int height, uint8_t *dst, int dstWidth,
+               int dstHeight, int mode) {
+    size_t ySize = (size_t) (width * height);
+    size_t dstYSize = (size_t) (dstWidth * dstHeight);
+    // VU交错存储，按UV对缩放，避免相邻的V、U分量被混合
+    static const ScaleFunc funcs[] = {scalePlaneFunc, scaleUVFunc};
+    const uint8_t *srcPlanes[] = {src, src + ySize};
+    uint8_t *dstPlanes[] = {dst, dst + dstYSize};
+    int srcStride[] = {width, width};
+    int srcWidth[] = {width, width >> 1};
+    int srcHeight[] = {height, height >> 1};
+    int dstStride[] = {dstWidth, dstWidth};
+    int dstWidths[] = {dstWidth, dstWidth >> 1};
+    int dstHeights[] = {dstHeight, dstHeight >> 1};
+    scalePlanes(2, funcs, srcPlanes, srcStride, srcWidth, srcHeight, dstPlanes, dstStride,
+                dstWidths, dstHeights, mode);
+}
+
+void i420Scale(const uint8_t *src, int width, int height, uint8_t *dst, int dstWidth,
+               int dstHeight, int mode, bool swapUV) {
+    int ySize = width * height;
+    size_t dstYSize = (size_t) (dstWidth * dstHeight);
+    // 目标U、V分量按目标大小偏移
+    size_t swap[] = {0, dstYSize >> 2};
+    PlanarImage in = {(uint8_t *) src, (uint8_t *) src + ySize,
+                      (uint8_t *) src + ySize + (ySize >> 2), width, width >> 1, width, height};
+    PlanarImage out = {dst, dst + dstYSize + swap[swapUV], dst + dstYSize + swap[1 - swapUV],
+                       dstWidth, dstWidth >> 1, dstWidth, dstHeight};
+    scalePlanar(in, out, mode);
+}
+
+void rgbaScale(const uint8_t *src, int width, int height, uint8_t *dst, int dstWidth,
+               int dstHeight, int mode) {
+    // ARGBScaleClip 只输出目标的一部分行，结果和整帧缩放一致
+    int64_t rowPixels = dstHeight > 0 ? (int64_t) width * height / dstHeight : 0;
+    parallelRows(dstHeight, 1, rowPixels, [=](int start, int end) {
+        return libyuv::ARGBScaleClip(src, width * 4, width, height, dst, dstWidth * 4, dstWidth,
+                                     dstHeight, 0, start, dstWidth, end - start,
+                                     (libyuv::FilterMode) mode);
+    });
+}
+
+void nv21ToI420Rotate(const uint8_t *src, int width, int height, uint8_t *dst, int de,
+                      bool swapUV) {
+    int dst_stride[] = {height, width, height};
+    int rotation = (de + 1) * libyuv::kRotate90;
+    size_t ySize = (size_t) (width * height);
+    size_t swap[] = {0, ySize >> 2};
+    uint8_t *dstU = dst + ySize + swap[swapUV];
+    uint8_t *dstV = dst + ySize + swap[1 - swapUV];
+    int uvStride = dst_stride[de] >> 1;
+    int halfHeight = height >> 1;
+    parallelRows(height, 16, width, [=](int start, int end) {
+        rotatePlaneBand(src, width, dst, dst_stride[de], width, height, start, end, rotation);
+        int uvStart = start >> 1;
+        int uvEnd = end >> 1;
+        size_t uvOffset = rotatedBandOffset(rotation, uvStart, uvEnd, halfHeight, uvStride);
+        rotateUVFunc[de](src + ySize + (size_t) uvStart * width, width, dstU + uvOffset,
+                         uvStride, dstV + uvOffset, uvStride, width >> 1, uvEnd - uvStart);
+        return 0;
+    });
+}
+
+void nv21CutData(uint8_t *tarYuv, const uint8_t *srcYuv, int startW, int startH, int cutW,
+                 int cutH, int srcW, int srcH) {
+    if (cutW <= 0 || cutH <= 0) {
+        return;
+    }
+    //裁剪后的Y分量
+    uint8_t *tmpY = tarYuv;
+    //裁剪后的UV分量
+    uint8_t *tmpUV = tarYuv + cutW * cutH;
+
+    libyuv::CopyPlane(srcYuv + startW + startH * srcW, srcW, tmpY, cutW, cutW, cutH);
+    // 色度按2x2采样，起始位置按2对齐，奇数偏移时不会把VU拆开导致颜色错乱
+    if (cutH >= 2) {
+        libyuv::CopyPlane(srcYuv + (startW & ~1) + srcW * srcH + (startH >> 1) * srcW, srcW,
+                          tmpUV, cutW, cutW, cutH >> 1);
+    }
+
+#ifdef SAVE_RET
+    FILE *outPutFp = fopen("/sdcard/Pictures/cutSrcYuv.yuv", "w+");
+    fwrite(tarYuv, 1, cutW * cutH * 3 / 2, outPutFp);
+    fclose(outPutFp);
+#endif
+}
+
+void nv21AddWaterMark(int startX, int startY, const uint8_t *waterMark, int waterMarkW,
+                      int waterMarkH, uint8_t *yuv, int yuvW, int yuvH) {
+    int i = 0;
+    int j = 0;
+    int k = 0;
+
+    // 直接在原始数据上计算，一步到位
+    // 注意：该处必须使用 unsigned char 不能使用 jbyte（signed char），否则判断会出错
+    unsigned char temp_char;
+    for (i = startY, k = 0; i < waterMarkH + startY; i++) {
+        for (j = 0; j < waterMarkW; j++) {
+            temp_char = waterMark[k * waterMarkW + j];
+            // 透明背景的 Y分量是0x10
+            if (temp_char != 0x10) {
+                yuv[startX + i * yuvW + j] = temp_char;
+            }
+        }
+        k++;
+    }
+
+    for (i = startY / 2, k = 0; i < (waterMarkH + startY) / 2; i++) {
+        for (j = 0; j < waterMarkW; j++) {
+            temp_char = waterMark[waterMarkW * waterMarkH + k * waterMarkW + j];
+            // 透明背景的 UV分量是0x80
+            if (temp_char != 0x80 && temp_char != 0xeb) {
+                yuv[startX + yuvW * yuvH + i * yuvW + j] = temp_char;
+            }
+        }
+        k++;
+    }
+
+#ifdef SAVE_RET
+    FILE *outPutFp = fopen("/sdcard/Pictures/Final.yuv", "w+");
+    fwrite(yuv, 1, yuvW * yuvH * 3 / 2, outPutFp);
+    fclose(outPutFp);
+#endif
+}
+
+/**
+ * NV21的VU分量拷贝到目标格式的UV分量
+ *
+ * @param rows 行数
+ * @param dstU I420的U分量、NV12/NV21的UV分量
+ * @param dstV I420的V分量，其它格式不使用
+ */
+static void copyVURows(const uint8_t *srcVU, int srcStride, int halfWidth, int rows,
+                       uint8_t *dstU, uint8_t *dstV, int dstStride, int dstFormat) {
+    // libyuv的row函数至少处理一个SIMD宽度，0行时不能调用
+    if (rows <= 0) {
+        return;
+    }
+    switch (dstFormat) {
+        case YUV_FORMAT_I420:
+            libyuv::SplitUVPlane(srcVU, srcStride, dstV, dstStride >> 1, dstU, dstStride >> 1,
+                                 halfWidth, rows);
+            break;
+        case YUV_FORMAT_NV12:
+            libyuv::SwapUVPlane(srcVU, srcStride, dstU, dstStride, halfWidth, rows);
+            break;
+        default:
+            libyuv::CopyPlane(srcVU, srcStride, dstU, dstStride, halfWidth * 2, rows);
+            break;
+    }
+}
+
+int nv21ToYuv420WithWaterMark(const uint8_t *nv21, int width, int height,
+                              const uint8_t *waterMark, int waterMarkW, int waterMarkH,
+                              int startX, int startY, uint8_t *dst, int dstStride,
+                              int dstSliceHeight, int dstFormat) {
+    if (nv21 == nullptr || dst == nullptr || width <= 0 || height <= 0 || dstStride < width ||
+        dstSliceHeight < height || dstFormat < YUV_FORMAT_I420 || dstFormat > YUV_FORMAT_NV21) {
+        return -1;
+    }
+    const uint8_t *srcVU = nv21 + width * height;
+    int halfWidth = width >> 1;
+    uint8_t *dstY = dst;
+    uint8_t *dstU = dst + dstStride * dstSliceHeight;
+    uint8_t *dstV = dstU + (dstStride >> 1) * (dstSliceHeight >> 1);
+
+    // 水印区域按2对齐，裁剪到图片范围内
+    startX &= ~1;
+    startY &= ~1;
+    int markW = waterMarkW;
+    int markH = waterMarkH;
+    if (startX + markW > width) {
+        markW = width - startX;
+    }
+    if (startY + markH > height) {
+        markH = height - startY;
+    }
+    if (waterMark == nullptr || startX < 0 || startY < 0 || markW <= 0 || markH <= 0) {
+        markH = 0;
+        startY = height;
+    }
+
+    // Y分量：水印上方、水印所在行、水印下方
+    if (startY > 0) {
+        libyuv::CopyPlane(nv21, width, dstY, dstStride, width, startY);
+    }
+    for (int i = startY; i < startY + markH; i++) {
+        const uint8_t *srcRow = nv21 + i * width;
+        uint8_t *dstRow = dstY + i * dstStride;
+        const uint8_t *markRow = waterMark + (i - startY) * waterMarkW;
+        memcpy(dstRow, srcRow, (size_t) width);
+        for (int j = 0; j < markW; j++) {
+            // 透明背景的 Y分量是0x10
+            if (markRow[j] != 0x10) {
+                dstRow[startX + j] = markRow[j];
+            }
+        }
+    }
+    if (startY + markH < height) {
+        libyuv::CopyPlane(nv21 + (startY + markH) * width, width,
+                          dstY + (startY + markH) * dstStride, dstStride, width,
+                          height - startY - markH);
+    }
+
+    // UV分量，I420的U、V各占一个平面，NV12/NV21交织存储
+    int uvStride = dstFormat == YUV_FORMAT_I420 ? dstStride >> 1 : dstStride;
+    int uvStartY = startY >> 1;
+    int uvMarkH = markH >> 1;
+    int uvHeight = height >> 1;
+    copyVURows(srcVU, width, halfWidth, uvStartY, dstU, dstV, dstStride, dstFormat);
+    for (int i = uvStartY; i < uvStartY + uvMarkH; i++) {
+        const uint8_t *markRow = waterMark + waterMarkW * waterMarkH + (i - uvStartY) * waterMarkW;
+        uint8_t *uRow = dstU + i * uvStride;
+        uint8_t *vRow = dstV + i * uvStride;
+        copyVURows(srcVU + i * width, width, halfWidth, 1, uRow, vRow, dstStride, dstFormat);
+        for (int j = 0; j < markW; j++) {
+            // 透明背景的 UV分量是0x80
+            if (markRow[j] == 0x80 || markRow[j] == 0xeb) {
+                continue;
+            }
+            // 水印数据为VU交织，偶数位为V，奇数位为U
+            int x = startX + j;
+            bool isV = (j & 1) == 0;
+            if (dstFormat == YUV_FORMAT_I420) {
+                (isV ? vRow : uRow)[x >> 1] = markRow[j];
+            } else if (dstFormat == YUV_FORMAT_NV12) {
+                uRow[isV ? x + 1 : x - 1] = markRow[j];
+            } else {
+                uRow[x] = markRow[j];
+            }
+        }
+    }
+    copyVURows(srcVU + (uvStartY + uvMarkH) * width, width, halfWidth,
+               uvHeight - uvStartY - uvMarkH, dstU + (uvStartY + uvMarkH) * uvStride,
+               dstV + (uvStartY + uvMarkH) * uvStride, dstStride, dstFormat);
+
+    return dstStride * dstSliceHeight * 3 / 2;
+}
+
+/**
+ * 校验参数并计算方案中与数据地址无关的部分，不申请临时内存
+ */
+static int initTransformPlan(TransformPlan *plan, int srcWidth, int srcHeight, int srcStride,
+                             int srcSliceHeight, int srcFormat, int cropX, int cropY,
+                             int cropWidth, int cropHeight, int rotation, int dstWidth,
+                             int dstHeight, int dstStride, int dstSliceHeight, int dstFormat,
+                             int mode) {
+    // 裁剪区域按2对齐，保证和色度采样点对齐
+    cropX &= ~1;
+    cropY &= ~1;
+    cropWidth &= ~1;
+    cropHeight &= ~1;
+    if (srcStride < srcWidth || srcSliceHeight < srcHeight || srcFormat < YUV_FORMAT_I420 ||
+        srcFormat > YUV_FORMAT_NV21 || (srcFormat == YUV_FORMAT_I420 && (srcStride & 1)) ||
+        cropX < 0 || cropY < 0 || cropWidth <= 0 || cropHeight <= 0 ||
+        cropX + cropWidth > srcWidth || cropY + cropHeight > srcHeight || dstWidth <= 0 ||
+        dstHeight <= 0 || (dstWidth & 1) || (dstHeight & 1) || dstStride < dstWidth ||
+        dstSliceHeight < dstHeight || dstFormat < YUV_FORMAT_I420 ||
+        dstFormat > YUV_FORMAT_NV21 || mode < libyuv::kFilterNone || mode > libyuv::kFilterBox) {
+        return -1;
+    }
+    if (rotation != libyuv::kRotate0 && rotation != libyuv::kRotate90 &&
+        rotation != libyuv::kRotate180 && rotation != libyuv::kRotate270) {
+        return -1;
+    }
+    bool transpose = rotation == libyuv::kRotate90 || rotation == libyuv::kRotate270;
+    plan->srcFormat = srcFormat;
+    plan->srcStride = srcStride;
+    plan->srcYOffset = (size_t) cropY * srcStride + cropX;
+    size_t srcChroma = (size_t) srcStride * srcSliceHeight;
+    if (srcFormat == YUV_FORMAT_I420) {
+        plan->srcUVStride = srcStride >> 1;
+        plan->srcUOffset = srcChroma + (size_t) (cropY >> 1) * plan->srcUVStride + (cropX >> 1);
+        plan->srcVOffset = plan->srcUOffset + (size_t) plan->srcUVStride * (srcSliceHeight >> 1);
+    } else {
+        plan->srcUVStride = srcStride;
+        plan->srcUOffset = srcChroma + (size_t) (cropY >> 1) * srcStride + cropX;
+        plan->srcVOffset = plan->srcUOffset;
+    }
+    plan->cropWidth = cropWidth;
+    plan->cropHeight = cropHeight;
+    plan->rotation = rotation;
+    plan->mode = mode;
+    plan->dstWidth = dstWidth;
+    plan->dstHeight = dstHeight;
+    plan->dstStride = dstStride;
+    plan->dstFormat = dstFormat;
+    plan->dstUVStride = dstFormat == YUV_FORMAT_I420 ? dstStride >> 1 : dstStride;
+    plan->dstUOffset = (size_t) dstStride * dstSliceHeight;
+    plan->dstVOffset = dstFormat == YUV_FORMAT_I420 ? plan->dstUOffset +
+                                                      (size_t) plan->dstUVStride *
+                                                      (dstSliceHeight >> 1) : 0;
+    // 旋转前的目标大小
+    plan->scaleWidth = transpose ? dstHeight : dstWidth;
+    plan->scaleHeight = transpose ? dstWidth : dstHeight;
+    plan->scale = plan->scaleWidth != cropWidth || plan->scaleHeight != cropHeight;
+    plan->scaleFirst = (size_t) dstWidth * dstHeight <= (size_t) cropWidth * cropHeight;
+
+    bool srcPlanar = srcFormat == YUV_FORMAT_I420;
+    if (!plan->scale && rotation == libyuv::kRotate0) {
+        plan->path = TRANSFORM_PATH_COPY;
+    } else if (!srcPlanar && rotation == libyuv::kRotate0 && dstFormat != YUV_FORMAT_I420 &&
+               mode != libyuv::kFilterBox) {
+        plan->path = TRANSFORM_PATH_UV_SCALE;
+    } else {
+        plan->path = TRANSFORM_PATH_PLANAR;
+    }
+    plan->srcChromaSize = 0;
+    plan->midSize = 0;
+    plan->outChromaSize = 0;
+    if (plan->path == TRANSFORM_PATH_PLANAR) {
+        if (plan->scale && !srcPlanar) {
+            plan->srcChromaSize = (size_t) (cropWidth >> 1) * (cropHeight >> 1) * 2;
+        }
+        if (plan->scale && rotation != libyuv::kRotate0) {
+            plan->midSize = plan->scaleFirst ?
+                            (size_t) plan->scaleWidth * plan->scaleHeight * 3 / 2 :
+                            (size_t) cropWidth * cropHeight * 3 / 2;
+        }
+        if (dstFormat != YUV_FORMAT_I420) {
+            plan->outChromaSize = (size_t) (dstWidth >> 1) * (dstHeight >> 1) * 2;
+        }
+    }
+    // 源数据最后一行色度之后可能没有padding；I420的V分量在 srcSliceHeight / 2 行U分量之后
+    if (srcPlanar) {
+        plan->srcSize = (int64_t) srcStride * srcSliceHeight +
+                        (int64_t) plan->srcUVStride * ((srcSliceHeight >> 1) + (srcHeight >> 1));
+    } else {
+        plan->srcSize = (int64_t) srcStride * (srcSliceHeight + srcHeight / 2);
+    }
+    plan->size = dstStride * dstSliceHeight * 3 / 2;
+    plan->scratch = nullptr;
+    return 0;
+}
+
+/**
+ * 按方案执行一次变换
+ *
+ * @param buffer 至少 srcChromaSize + midSize + outChromaSize 字节的临时内存
+ */
+static int runTransformPlan(const TransformPlan *plan, const uint8_t *src, uint8_t *dst,
+                            uint8_t *buffer) {
+    TRACE_SCOPE("convert");
+    const uint8_t *srcY = src + plan->srcYOffset;
+    const uint8_t *srcU = src + plan->srcUOffset;
+    const uint8_t *srcV = src + plan->srcVOffset;
+    // NV12/NV21的色度交织在一起
+    const uint8_t *srcUV = srcU;
+    int srcStride = plan->srcStride;
+    int srcFormat = plan->srcFormat;
+    int cropWidth = plan->cropWidth;
+    int cropHeight = plan->cropHeight;
+    int cropHalfWidth = cropWidth >> 1;
+    int cropHalfHeight = cropHeight >> 1;
+    int rotation = plan->rotation;
+    int mode = plan->mode;
+    int dstWidth = plan->dstWidth;
+    int dstHeight = plan->dstHeight;
+    int dstHalfWidth = dstWidth >> 1;
+    int dstHalfHeight = dstHeight >> 1;
+    int dstStride = plan->dstStride;
+    int dstUVStride = plan->dstUVStride;
+    int dstFormat = plan->dstFormat;
+    uint8_t *dstY = dst;
+    uint8_t *dstUV = dst + plan->dstUOffset;
+    uint8_t *dstU = dstUV;
+    uint8_t *dstV = dstFormat == YUV_FORMAT_I420 ? dst + plan->dstVOffset : nullptr;
+    bool srcPlanar = srcFormat == YUV_FORMAT_I420;
+    bool sameOrder = srcFormat == dstFormat;
+
+    if (plan->path == TRANSFORM_PATH_COPY) {
+        // 只裁剪：色度保持交织，直接拷贝或交换
+        libyuv::CopyPlane(srcY, srcStride, dstY, dstStride, cropWidth, cropHeight);
+        if (srcPlanar) {
+            if (dstFormat == YUV_FORMAT_I420) {
+                libyuv::CopyPlane(srcU, plan->srcUVStride, dstU, dstUVStride, cropHalfWidth,
+                                  cropHalfHeight);
+                libyuv::CopyPlane(srcV, plan->srcUVStride, dstV, dstUVStride, cropHalfWidth,
+                                  cropHalfHeight);
+            } else {
+                bool nv12 = dstFormat == YUV_FORMAT_NV12;
+                libyuv::MergeUVPlane(nv12 ? srcU : srcV, plan->srcUVStride, nv12 ? srcV : srcU,
+                                     plan->srcUVStride, dstUV, dstUVStride, cropHalfWidth,
+                                     cropHalfHeight);
+            }
+        } else if (dstFormat == YUV_FORMAT_I420) {
+            // NV21的交织顺序为VU
+            libyuv::SplitUVPlane(srcUV, srcStride, srcFormat == YUV_FORMAT_NV12 ? dstU : dstV,
+                                 dstUVStride, srcFormat == YUV_FORMAT_NV12 ? dstV : dstU,
+                                 dstUVStride, cropHalfWidth, cropHalfHeight);
+        } else if (sameOrder) {
+            libyuv::CopyPlane(srcUV, srcStride, dstUV, dstUVStride, cropWidth, cropHalfHeight);
+        } else {
+            libyuv::SwapUVPlane(srcUV, srcStride, dstUV, dstUVStride, cropHalfWidth,
+                                cropHalfHeight);
+        }
+        return plan->size;
+    }
+
+    if (plan->path == TRANSFORM_PATH_UV_SCALE) {
+        // 只缩放且输出NV12/NV21：色度按UV对直接缩放，不拆分、合并
+        // UVScale的box只对整数倍缩小做区域平均，box仍走平面缩放
+        libyuv::ScalePlane(srcY, srcStride, cropWidth, cropHeight, dstY, dstStride, dstWidth,
+                           dstHeight, (libyuv::FilterMode) mode);
+        libyuv::UVScale(srcUV, srcStride, cropHalfWidth, cropHalfHeight, dstUV, dstUVStride,
+                        dstHalfWidth, dstHalfHeight, (libyuv::FilterMode) mode);
+        if (!sameOrder) {
+            libyuv::SwapUVPlane(dstUV, dstUVStride, dstUV, dstUVStride, dstHalfWidth,
+                                dstHalfHeight);
+        }
+        return plan->size;
+    }
+
+    uint8_t *srcChroma = buffer;
+    uint8_t *mid = buffer + plan->srcChromaSize;
+    uint8_t *outChroma = mid + plan->midSize;
+
+    // 输出到I420平面，NV12/NV21的色度先写入临时平面，最后交织
+    PlanarImage out = {dstY, dstU, dstV, dstStride, dstUVStride, dstWidth, dstHeight};
+    if (dstFormat != YUV_FORMAT_I420) {
+        out.u = outChroma;
+        out.v = outChroma + (size_t) dstHalfWidth * dstHalfHeight;
+        out.uvStride = dstHalfWidth;
+    }
+
+    if (!plan->scale && !srcPlanar) {
+        // 只旋转：直接旋转交织的色度，同时拆分为两个平面
+        libyuv::RotatePlane(srcY, srcStride, out.y, out.yStride, cropWidth, cropHeight,
+                            (libyuv::RotationMode) rotation);
+        uint8_t *first = srcFormat == YUV_FORMAT_NV12 ? out.u : out.v;
+        uint8_t *second = srcFormat == YUV_FORMAT_NV12 ? out.v : out.u;
+        rotateUVFunc[rotation / 90 - 1](srcUV, srcStride, first, out.uvStride, second,
+                                        out.uvStride, cropHalfWidth, cropHalfHeight);
+    } else {
+        PlanarImage crop = {(uint8_t *) srcY, (uint8_t *) srcU, (uint8_t *) srcV, srcStride,
+                            plan->srcUVStride, cropWidth, cropHeight};
+        if (!srcPlanar) {
+            // 缩放前把源色度拆分为平面
+            crop.u = srcChroma;
+            crop.v = srcChroma + (size_t) cropHalfWidth * cropHalfHeight;
+            crop.uvStride = cropHalfWidth;
+            libyuv::SplitUVPlane(srcUV, srcStride,
+                                 srcFormat == YUV_FORMAT_NV12 ? crop.u : crop.v, crop.uvStride,
+                                 srcFormat == YUV_FORMAT_NV12 ? crop.v : crop.u, crop.uvStride,
+                                 cropHalfWidth, cropHalfHeight);
+        }
+        if (!plan->scale) {
+            rotatePlanar(crop, out, rotation);
+        } else if (rotation == libyuv::kRotate0) {
+            scalePlanar(crop, out, mode);
+        } else if (plan->scaleFirst) {
+            // 缩小：先缩放，旋转的像素更少
+            PlanarImage scaled = planarImageOf(mid, plan->scaleWidth, plan->scaleHeight);
+            scalePlanar(crop, scaled, mode);
+            rotatePlanar(scaled, out, rotation);
+        } else {
+            // 放大：先旋转
+            bool transpose = rotation == libyuv::kRotate90 || rotation == libyuv::kRotate270;
+            PlanarImage rotated = planarImageOf(mid, transpose ? cropHeight : cropWidth,
+                                                transpose ? cropWidth : cropHeight);
+            rotatePlanar(crop, rotated, rotation);
+            scalePlanar(rotated, out, mode);
+        }
+    }
+
+    if (dstFormat != YUV_FORMAT_I420) {
+        bool nv12 = dstFormat == YUV_FORMAT_NV12;
+        libyuv::MergeUVPlane(nv12 ? out.u : out.v, out.uvStride, nv12 ? out.v : out.u,
+                             out.uvStride, dstUV, dstUVStride, dstHalfWidth, dstHalfHeight);
+    }
+    return plan->size;
+}
+
+static size_t scratchSizeOf(const TransformPlan *plan) {
+    return plan->srcChromaSize + plan->midSize + plan->outChromaSize;
+}
+
+int yuv420spTransform(const uint8_t *src, int srcWidth, int srcHeight, int srcStride,
+                      int srcSliceHeight, int srcFormat, int cropX, int cropY, int cropWidth,
+                      int cropHeight, int rotation, uint8_t *dst, int dstWidth, int dstHeight,
+                      int dstStride, int dstSliceHeight, int dstFormat, int mode) {
+    TransformPlan plan;
+    if (src == nullptr || dst == nullptr || srcFormat == YUV_FORMAT_I420 ||
+        initTransformPlan(&plan, srcWidth, srcHeight, srcStride, srcSliceHeight, srcFormat,
+                          cropX, cropY, cropWidth, cropHeight, rotation, dstWidth, dstHeight,
+                          dstStride, dstSliceHeight, dstFormat, mode) != 0) {
+        return -1;
+    }
+    // 每帧大小相同，从缓冲池取用，稳定运行时不再分配内存
+    PoolBuffer *pool = nullptr;
+    if (scratchSizeOf(&plan) > 0) {
+        pool = acquirePoolBuffer(scratchSizeOf(&plan));
+        if (pool == nullptr) {
+            return -1;
+        }
+    }
+    int ret = runTransformPlan(&plan, src, dst, pool == nullptr ? nullptr : pool->data);
+    releasePoolBuffer(pool);
+    return ret;
+}
+
+TransformPlan *createTransformPlan(int srcWidth, int srcHeight, int srcStride,
+                                   int srcSliceHeight, int srcFormat, int cropX, int cropY,
+                                   int cropWidth, int cropHeight, int rotation, int dstWidth,
+                                   int dstHeight, int dstStride, int dstSliceHeight,
+                                   int dstFormat, int mode) {
+    TransformPlan *plan = (TransformPlan *) malloc(sizeof(TransformPlan));
+    if (plan == nullptr) {
+        return nullptr;
+    }
+    if (initTransformPlan(plan, srcWidth, srcHeight, srcStride, srcSliceHeight, srcFormat, cropX,
+                          cropY, cropWidth, cropHeight, rotation, dstWidth, dstHeight, dstStride,
+                          dstSliceHeight, dstFormat, mode) != 0) {
+        free(plan);
+        return nullptr;
+    }
+    // 临时内存随方案常驻，执行时不再申请
+    if (scratchSizeOf(plan) > 0) {
+        plan->scratch = acquirePoolBuffer(scratchSizeOf(plan));
+        if (plan->scratch == nullptr) {
+            free(plan);
+            return nullptr;
+        }
+    }
+    return plan;
+}
+
+int executeTransformPlan(TransformPlan *plan, const uint8_t *src, uint8_t *dst) {
+    if (plan == nullptr || src == nullptr || dst == nullptr) {
+        return -1;
+    }
+    return runTransformPlan(plan, src, dst,
+                            plan->scratch == nullptr ? nullptr : plan->scratch->data);
+}
+
+void releaseTransformPlan(TransformPlan *plan) {
+    if (plan == nullptr) {
+        return;
+    }
+    releasePoolBuffer(plan->scratch);
+    free(plan);
+}
+
+int android420SizeOf(int width, int height) {
+    return width * height + ((width + 1) >> 1) * ((height + 1) >> 1) * 2;
+}
+
+int android420ToYuv(const uint8_t *srcY, int srcStrideY, const uint8_t *srcU, int srcStrideU,
+                    const uint8_t *srcV, int srcStrideV, int srcPixelStrideUV, uint8_t *dst,
+                    int width, int height, int dstFormat) {
+    if (srcY == nullptr || srcU == nullptr || srcV == nullptr || dst == nullptr || width <= 0 ||
+        height <= 0 || srcPixelStrideUV <= 0 || dstFormat < YUV_FORMAT_I420 ||
+        dstFormat > YUV_FORMAT_NV21) {
+        return -1;
+    }
+    int halfWidth = (width + 1) >> 1;
+    int halfHeight = (height + 1) >> 1;
+    uint8_t *dstUV = dst + (size_t) width * height;
+    if (dstFormat == YUV_FORMAT_I420) {
+        uint8_t *dstV = dstUV + (size_t) halfWidth * halfHeight;
+        libyuv::Android420ToI420(srcY, srcStrideY, srcU, srcStrideU, srcV, srcStrideV,
+                                 srcPixelStrideUV, dst, width, dstUV, halfWidth, dstV, halfWidth,
+                                 width, height);
+        return android420SizeOf(width, height);
+    }
+
+    libyuv::CopyPlane(srcY, srcStrideY, dst, width, width, height);
+    int dstStrideUV = halfWidth * 2;
+    bool nv12 = dstFormat == YUV_FORMAT_NV12;
+    ptrdiff_t vuOffset = srcV - srcU;
+    if (srcPixelStrideUV == 2 && srcStrideU == srcStrideV && (vuOffset == 1 || vuOffset == -1)) {
+        // 色度本身就是交织的NV12（U在前）或NV21（V在前），顺序一致时整行拷贝，否则交换
+        bool srcNV12 = vuOffset == 1;
+        const uint8_t *srcUV = srcNV12 ? srcU : srcV;
+        if (srcNV12 == nv12) {
+            libyuv::CopyPlane(srcUV, srcStrideU, dstUV, dstStrideUV, dstStrideUV, halfHeight);
+        } else {
+            libyuv::SwapUVPlane(srcUV, srcStrideU, dstUV, dstStrideUV, halfWidth, halfHeight);
+        }
+    } else if (srcPixelStrideUV == 1) {
+        // 平面存储的U、V直接交织
+        libyuv::MergeUVPlane(nv12 ? srcU : srcV, nv12 ? srcStrideU : srcStrideV,
+                             nv12 ? srcV : srcU, nv12 ? srcStrideV : srcStrideU, dstUV,
+                             dstStrideUV, halfWidth, halfHeight);
+    } else {
+        // 其他pixelStride先拆成平面再交织
+        PoolBuffer *planes = acquirePoolBuffer((size_t) halfWidth * halfHeight * 2);
+        if (planes == nullptr) {
+            return -1;
+        }
+        uint8_t *u = planes->data;
+        uint8_t *v = u + (size_t) halfWidth * halfHeight;
+        libyuv::Android420ToI420(srcY, srcStrideY, srcU, srcStrideU, srcV, srcStrideV,
+                                 srcPixelStrideUV, nullptr, 0, u, halfWidth, v, halfWidth,
+                                 width, height);
+        libyuv::MergeUVPlane(nv12 ? u : v, halfWidth, nv12 ? v : u, halfWidth, dstUV,
+                             dstStrideUV, halfWidth, halfHeight);
+        releasePoolBuffer(planes);
+    }
+    return android420SizeOf(width, height);
+}
+
+YuvOverlay *createOverlay(const uint8_t *rgba, int rgbaStride, int width, int height) {
+    if (rgba == nullptr || width <= 0 || height <= 0) {
+        return nullptr;
+    }
+    int evenWidth = (width + 1) & ~1;
+    int evenHeight = (height + 1) & ~1;
+    int halfWidth = evenWidth >> 1;
+    int halfHeight = evenHeight >> 1;
+    size_t planeSize = (size_t) evenWidth * evenHeight;
+    size_t halfSize = (size_t) halfWidth * halfHeight;
+
+    // 补齐为偶数宽高的部分是全透明的
+    uint8_t *argb = (uint8_t *) calloc(planeSize, 4);
+    uint8_t *halfArgb = (uint8_t *) malloc(halfSize * 4);
+    uint8_t *halfU = (uint8_t *) malloc(halfSize * 3);
+    YuvOverlay *overlay = (YuvOverlay *) calloc(1, sizeof(YuvOverlay));
+    uint8_t *planes = (uint8_t *) malloc(planeSize * 3);
+    if (argb == nullptr || halfArgb == nullptr || halfU == nullptr || overlay == nullptr ||
+        planes == nullptr) {
+        free(argb);
+        free(halfArgb);
+        free(halfU);
+        free(overlay);
+        free(planes);
+        return nullptr;
+    }
+    uint8_t *halfV = halfU + halfSize;
+    uint8_t *halfAlpha = halfV + halfSize;
+    overlay->width = evenWidth;
+    overlay->height = evenHeight;
+    overlay->y = planes;
+    overlay->alphaY = planes + planeSize;
+    overlay->vu = planes + planeSize * 2;
+    overlay->alphaVU = overlay->vu + planeSize / 2;
+
+    // libyuv中ABGR即内存中的RGBA
+    libyuv::ABGRToARGB(rgba, rgbaStride, argb, evenWidth * 4, width, height);
+    libyuv::ARGBExtractAlpha(argb, evenWidth * 4, overlay->alphaY, evenWidth, evenWidth,
+                             evenHeight);
+    // 色度在预乘状态下做2x2平均，即按alpha加权，避免透明像素把边缘颜色拉黑
+    libyuv::ARGBScale(argb, evenWidth * 4, evenWidth, evenHeight, halfArgb, halfWidth * 4,
+                      halfWidth, halfHeight, libyuv::kFilterBox);
+    libyuv::ARGBExtractAlpha(halfArgb, halfWidth * 4, halfAlpha, halfWidth, halfWidth,
+                             halfHeight);
+    libyuv::ARGBUnattenuate(argb, evenWidth * 4, argb, evenWidth * 4, evenWidth, evenHeight);
+    libyuv::ARGBUnattenuate(halfArgb, halfWidth * 4, halfArgb, halfWidth * 4, halfWidth,
+                            halfHeight);
+
+    libyuv::ARGBToI400(argb, evenWidth * 4, overlay->y, evenWidth, evenWidth, evenHeight);
+    // 半分辨率的图直接转I444，得到每个色度采样点的U、V；Y分量写入argb的空间，不再使用
+    libyuv::ARGBToI444(halfArgb, halfWidth * 4, argb, halfWidth, halfU, halfWidth, halfV,
+                       halfWidth, halfWidth, halfHeight);
+    libyuv::MergeUVPlane(halfV, halfWidth, halfU, halfWidth, overlay->vu, evenWidth, halfWidth,
+                         halfHeight);
+    libyuv::MergeUVPlane(halfAlpha, halfWidth, halfAlpha, halfWidth, overlay->alphaVU, evenWidth,
+                         halfWidth, halfHeight);
+
+    free(argb);
+    free(halfArgb);
+    free(halfU);
+    return overlay;
+}
+
+void releaseOverlay(YuvOverlay *overlay) {
+    if (overlay == nullptr) {
+        return;
+    }
+    free(overlay->y);
+    free(overlay);
+}
+
+void nv21BlendOverlay(uint8_t *yuv, int width, int height, const YuvOverlay *overlay, int x,
+                      int y) {
+    if (yuv == nullptr || overlay == nullptr) {
+        return;
+    }
+    TRACE_SCOPE("blend");
+    x &= ~1;
+    y &= ~1;
+    // 裁剪到图片范围内
+    int srcX = x < 0 ? -x : 0;
+    int srcY = y < 0 ? -y : 0;
+    int dstX = x + srcX;
+    int dstY = y + srcY;
+    int blendW = overlay->width - srcX;
+    int blendH = overlay->height - srcY;
+    if (dstX + blendW > width) {
+        blendW = width - dstX;
+    }
+    if (dstY + blendH > height) {
+        blendH = height - dstY;
+    }
+    blendW &= ~1;
+    blendH &= ~1;
+    if (blendW <= 0 || blendH <= 0) {
+        return;
+    }
+
+    size_t srcOffset = (size_t) srcY * overlay->width + srcX;
+    uint8_t *dst = yuv + (size_t) dstY * width + dstX;
+    libyuv::BlendPlane(overlay->y + srcOffset, overlay->width, dst, width,
+                       overlay->alphaY + srcOffset, overlay->width, dst, width, blendW, blendH);
+
+    size_t srcUVOffset = (size_t) (srcY >> 1) * overlay->width + srcX;
+    uint8_t *dstVU = yuv + (size_t) width * height + (size_t) (dstY >> 1) * width + dstX;
+    libyuv::BlendPlane(overlay->vu + srcUVOffset, overlay->width, dstVU, width,
+                       overlay->alphaVU + srcUVOffset, overlay->width, dstVU, width, blendW,
+                       blendH >> 1);
+}
+
+GlyphAtlas *createGlyphAtlas() {
+    // 按本地时区格式化时间前先加载时区信息
+    tzset();
+    return (GlyphAtlas *) calloc(1, sizeof(GlyphAtlas));
+}
+
+void releaseGlyphAtlas(GlyphAtlas *atlas) {
+    if (atlas == nullptr) {
+        return;
+    }
+    for (int i = 0; i < GLYPH_ATLAS_SIZE; i++) {
+        releaseOverlay(atlas->glyphs[i]);
+    }
+    free(atlas);
+}
+
+int glyphAtlasAddGlyph(GlyphAtlas *atlas, char glyph, const uint8_t *rgba, int rgbaStride,
+                       int width, int height) {
+    uint8_t index = (uint8_t) glyph;
+    if (atlas == nullptr || index >= GLYPH_ATLAS_SIZE) {
+        return -1;
+    }
+    YuvOverlay *overlay = createOverlay(rgba, rgbaStride, width, height);
+    if (overlay == nullptr) {
+        return -1;
+    }
+    releaseOverlay(atlas->glyphs[index]);
+    atlas->glyphs[index] = overlay;
+    if (overlay->height > atlas->height) {
+        atlas->height = overlay->height;
+    }
+    return 0;
+}
+
+static const YuvOverlay *glyphOf(const GlyphAtlas *atlas, char glyph) {
+    uint8_t index = (uint8_t) glyph;
+    return index < GLYPH_ATLAS_SIZE ? atlas->glyphs[index] : nullptr;
+}
+
+int glyphAtlasMeasureText(const GlyphAtlas *atlas, const char *text) {
+    if (atlas == nullptr || text == nullptr) {
+        return 0;
+    }
+    int textWidth = 0;
+    for (const char *c = text; *c != '\0'; c++) {
+        const YuvOverlay *glyph = glyphOf(atlas, *c);
+        if (glyph != nullptr) {
+            textWidth += glyph->width;
+        }
+    }
+    return textWidth;
+}
+
+int nv21DrawText(uint8_t *yuv, int width, int height, const GlyphAtlas *atlas, const char *text,
+                 int x, int y) {
+    if (yuv == nullptr || atlas == nullptr || text == nullptr) {
+        return 0;
+    }
+    x &= ~1;
+    int startX = x;
+    for (const char *c = text; *c != '\0' && x < width; c++) {
+        const YuvOverlay *glyph = glyphOf(atlas, *c);
+        if (glyph == nullptr) {
+            continue;
+        }
+        // 字形宽度按2对齐，逐字叠加后下一个字仍然对齐
+        nv21BlendOverlay(yuv, width, height, glyph, x, y);
+        x += glyph->width;
+    }
+    return x - startX;
+}
+
+int formatTimestamp(int64_t timestamp, int format, char *buf, int bufSize) {
+    time_t seconds = (time_t) (timestamp / 1000);
+    int millis = (int) (timestamp % 1000);
+    if (millis < 0) {
+        seconds -= 1;
+        millis += 1000;
+    }
+    struct tm date;
+    if (localtime_r(&seconds, &date) == nullptr) {
+        return -1;
+    }
+    int len = (int) strftime(buf, bufSize, "%Y-%m-%d %H:%M:%S", &date);
+    if (len == 0) {
+        return -1;
+    }
+    if (format == TIME_FORMAT_DATE_TIME_MS) {
+        if (len + 5 > bufSize) {
+            return -1;
+        }
+        len += snprintf(buf + len, bufSize - len, ".%03d", millis);
+    }
+    return len;
+}
+
+int nv21DrawTimestamp(uint8_t *yuv, int width, int height, const GlyphAtlas *atlas,
+                      int64_t timestamp, int format, int x, int y) {
+    char text[32];
+    if (formatTimestamp(timestamp, format, text, sizeof(text)) < 0) {
+        return -1;
+    }
+    return nv21DrawText(yuv, width, height, atlas, text, x, y);
+}
+
+/**
+ * 处理图中当前最后一个节点（没有节点时为裁剪后的源数据）输出的宽高
+ */
+void graphOutputSize(const YuvGraph *graph, int *width, int *height) {
+    if (graph->nodeCount == 0) {
+        *width = graph->cropWidth;
+        *height = graph->cropHeight;
+        return;
+    }
+    *width = graph->nodes[graph->nodeCount - 1].width;
+    *height = graph->nodes[graph->nodeCount - 1].height;
+}
+
+/**
+ * 追加一个节点，输出大小默认和输入相同
+ *
+ * @return 新节点，节点已满或已经 prepareGraph 时返回nullptr
+ */
+static GraphNode *appendGraphNode(YuvGraph *graph, int type) {
+    if (graph == nullptr || graph->size > 0 || graph->nodeCount >= GRAPH_MAX_NODES) {
+        return nullptr;
+    }
+    GraphNode *node = &graph->nodes[graph->nodeCount];
+    memset(node, 0, sizeof(GraphNode));
+    node->type = type;
+    graphOutputSize(graph, &node->width, &node->height);
+    return node;
+}
+
+YuvGraph *createGraph(int srcWidth, int srcHeight, int srcStride, int srcSliceHeight,
+                      int srcFormat) {
+    if (srcWidth < 2 || srcHeight < 2 || srcStride < srcWidth || srcSliceHeight < srcHeight ||
+        srcFormat < YUV_FORMAT_I420 || srcFormat > YUV_FORMAT_NV21 ||
+        (srcFormat == YUV_FORMAT_I420 && (srcStride & 1))) {
+        return nullptr;
+    }
+    YuvGraph *graph = (YuvGraph *) calloc(1, sizeof(YuvGraph));
+    if (graph == nullptr) {
+        return nullptr;
+    }
+    graph->srcWidth = srcWidth;
+    graph->srcHeight = srcHeight;
+    graph->srcStride = srcStride;
+    graph->srcSliceHeight = srcSliceHeight;
+    graph->srcFormat = srcFormat;
+    graph->srcUVStride = srcFormat == YUV_FORMAT_I420 ? srcStride >> 1 : srcStride;
+    graph->cropWidth = srcWidth & ~1;
+    graph->cropHeight = srcHeight & ~1;
+    if (srcFormat == YUV_FORMAT_I420) {
+        graph->srcSize = (int64_t) srcStride * srcSliceHeight +
+                         (int64_t) graph->srcUVStride * ((srcSliceHeight >> 1) + (srcHeight >> 1));
+    } else {
+        graph->srcSize = (int64_t) srcStride * (srcSliceHeight + srcHeight / 2);
+    }
+    return graph;
+}
+
+int graphCrop(YuvGraph *graph, int x, int y, int width, int height) {
+    x &= ~1;
+    y &= ~1;
+    width &= ~1;
+    height &= ~1;
+    GraphNode *node = appendGraphNode(graph, GRAPH_NODE_CROP);
+    if (node == nullptr || x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        x + width > node->width || y + height > node->height) {
+        return -1;
+    }
+    node->x = x;
+    node->y = y;
+    node->width = width;
+    node->height = height;
+    graph->nodeCount++;
+    return 0;
+}
+
+int graphScale(YuvGraph *graph, int width, int height, int mode) {
+    GraphNode *node = appendGraphNode(graph, GRAPH_NODE_SCALE);
+    if (node == nullptr || width <= 0 || height <= 0 || (width & 1) || (height & 1) ||
+        mode < libyuv::kFilterNone || mode > libyuv::kFilterBox) {
+        return -1;
+    }
+    if (width == node->width && height == node->height) {
+        return 0;
+    }
+    node->width = width;
+    node->height = height;
+    node->mode = mode;
+    graph->nodeCount++;
+    return 0;
+}
+
+int graphRotate(YuvGraph *graph, int rotation) {
+    GraphNode *node = appendGraphNode(graph, GRAPH_NODE_ROTATE);
+    if (node == nullptr || (rotation != libyuv::kRotate0 && rotation != libyuv::kRotate90 &&
+                            rotation != libyuv::kRotate180 && rotation != libyuv::kRotate270)) {
+        return -1;
+    }
+    if (rotation == libyuv::kRotate0) {
+        return 0;
+    }
+    if (rotation != libyuv::kRotate180) {
+        int width = node->width;
+        node->width = node->height;
+        node->height = width;
+    }
+    node->rotation = rotation;
+    graph->nodeCount++;
+    return 0;
+}
+
+int graphOverlay(YuvGraph *graph, const YuvOverlay *overlay, int x, int y) {
+    GraphNode *node = appendGraphNode(graph, GRAPH_NODE_OVERLAY);
+    if (node == nullptr || overlay == nullptr) {
+        return -1;
+    }
+    x &= ~1;
+    y &= ~1;
+    // 裁剪到图片范围内，规则同 nv21BlendOverlay
+    int srcX = x < 0 ? -x : 0;
+    int srcY = y < 0 ? -y : 0;
+    node->x = x + srcX;
+    node->y = y + srcY;
+    int blendW = overlay->width - srcX;
+    int blendH = overlay->height - srcY;
+    if (node->x + blendW > node->width) {
+        blendW = node->width - node->x;
+    }
+    if (node->y + blendH > node->height) {
+        blendH = node->height - node->y;
+    }
+    blendW &= ~1;
+    blendH &= ~1;
+    if (blendW <= 0 || blendH <= 0) {
+        return 0;
+    }
+    // 图层的交织色度拆分为平面，执行时和I420的中间结果直接混合；两份色度alpha相同，只保留一份
+    size_t planeSize = (size_t) blendW * blendH;
+    size_t halfSize = planeSize >> 2;
+    uint8_t *planes = (uint8_t *) malloc(planeSize * 2 + halfSize * 3);
+    if (planes == nullptr) {
+        return -1;
+    }
+    uint8_t *alphaY = planes + planeSize;
+    uint8_t *u = alphaY + planeSize;
+    uint8_t *v = u + halfSize;
+    uint8_t *alphaUV = v + halfSize;
+    int halfW = blendW >> 1;
+    size_t srcOffset = (size_t) srcY * overlay->width + srcX;
+    size_t srcUVOffset = (size_t) (srcY >> 1) * overlay->width + srcX;
+    libyuv::CopyPlane(overlay->y + srcOffset, overlay->width, planes, blendW, blendW, blendH);
+    libyuv::CopyPlane(overlay->alphaY + srcOffset, overlay->width, alphaY, blendW, blendW,
+                      blendH);
+    libyuv::SplitUVPlane(overlay->vu + srcUVOffset, overlay->width, v, halfW, u, halfW, halfW,
+                         blendH >> 1);
+    for (int row = 0; row < (blendH >> 1); row++) {
+        const uint8_t *alphaRow = overlay->alphaVU + srcUVOffset + (size_t) row * overlay->width;
+        for (int i = 0; i < halfW; i++) {
+            alphaUV[(size_t) row * halfW + i] = alphaRow[i * 2];
+        }
+    }
+    node->blendWidth = blendW;
+    node->blendHeight = blendH;
+    node->planes = planes;
+    graph->nodeCount++;
+    return 0;
+}
+
+static size_t alignSize(size_t size) {
+    return (size + BUFFER_POOL_ALIGN - 1) & ~(size_t) (BUFFER_POOL_ALIGN - 1);
+}
+
+static int64_t lcm(int64_t a, int64_t b) {
+    int64_t x = a;
+    int64_t y = b;
+    while (y != 0) {
+        int64_t t = x % y;
+        x = y;
+        y = t;
+    }
+    return a / x * b;
+}
+
+/**
+ * 缩放节点接在切带单位为 unit 的上游之后能否按带执行
+ *
+ * @return 本节点输出的切带单位，不能切带时返回0
+ */
+static int scaleStripUnit(GraphNode *node, int srcWidth, int srcHeight, int unit) {
+    int srcUnit = 0;
+    int uvSrcUnit = 0;
+    int dstUnit = scaleBandUnit(scalePlaneFunc, srcWidth, srcHeight, node->width, node->height,
+                                &srcUnit);
+    int uvDstUnit = scaleBandUnit(scalePlaneFunc, srcWidth >> 1, srcHeight >> 1,
+                                  node->width >> 1, node->height >> 1, &uvSrcUnit);
+    // 亮度、色度的周期比例不同时，同一带的色度行数对不上
+    if (dstUnit == 0 || uvDstUnit == 0 ||
+        (int64_t) srcUnit * uvDstUnit != (int64_t) uvSrcUnit * dstUnit) {
+        return 0;
+    }
+    node->srcUnit = srcUnit;
+    node->dstUnit = dstUnit;
+    // 输出按整数个亮度、色度周期切带，对应的输入行数还要是上游单位的整数倍
+    int64_t stripUnit = lcm(lcm(dstUnit, 2 * uvDstUnit),
+                            (int64_t) dstUnit * (unit / gcd(srcUnit, unit)));
+    return stripUnit > node->height ? 0 : (int) stripUnit;
+}
+
+/**
+ * 段的终点为整帧缩放、裁剪时，输入能否直接使用整帧数据（整帧节点的输出或I420源数据），不需要按带拼接
+ */
+static bool graphWholeInput(const YuvGraph *graph, const GraphSegment *segment) {
+    return segment->begin == segment->end &&
+           (segment->input >= 0 || graph->srcFormat == YUV_FORMAT_I420);
+}
+
+/**
+ * 段的输入大小
+ */
+static void graphInputSize(const YuvGraph *graph, const GraphSegment *segment, int *width,
+                           int *height) {
+    if (segment->input < 0) {
+        *width = graph->cropWidth;
+        *height = graph->cropHeight;
+        return;
+    }
+    *width = graph->nodes[segment->input].width;
+    *height = graph->nodes[segment->input].height;
+}
+
+/**
+ * 计算每带的行数及临时内存中各节点输出的偏移
+ */
+static void layoutGraphSegment(YuvGraph *graph, GraphSegment *segment) {
+    int inWidth;
+    int inHeight;
+    graphInputSize(graph, segment, &inWidth, &inHeight);
+    int width = segment->end > segment->begin ? graph->nodes[segment->end - 1].width : inWidth;
+    int rows = GRAPH_STRIP_PIXELS / width / segment->unit * segment->unit;
+    if (rows < segment->unit) {
+        rows = segment->unit;
+    }
+    segment->stripRows = rows > segment->rows ? segment->rows : rows;
+    segment->rowPixels = (int64_t) inWidth * inHeight / segment->rows *
+                         (segment->end - segment->begin + 1);
+
+    // 从段的输出往回推算每个节点一带的行数
+    size_t offset = 0;
+    rows = segment->stripRows;
+    for (int i = segment->end - 1; i >= segment->begin; i--) {
+        GraphNode *node = &graph->nodes[i];
+        if (node->type == GRAPH_NODE_CROP) {
+            continue;
+        }
+        node->stripOffset = offset;
+        offset += alignSize((size_t) node->width * rows * 3 / 2);
+        if (node->type == GRAPH_NODE_SCALE) {
+            rows = rows / node->dstUnit * node->srcUnit;
+        }
+    }
+    segment->srcChromaOffset = offset;
+    if (segment->input < 0 && graph->srcFormat != YUV_FORMAT_I420) {
+        offset += alignSize((size_t) (inWidth >> 1) * (rows >> 1) * 2);
+    }
+    segment->dstChromaOffset = offset;
+    if (segment->sink == graph->nodeCount && graph->dstFormat != YUV_FORMAT_I420) {
+        offset += alignSize((size_t) (width >> 1) * (segment->stripRows >> 1) * 2);
+    }
+    segment->stripSize = offset;
+}
+
+int prepareGraph(YuvGraph *graph, int dstStride, int dstSliceHeight, int dstFormat) {
+    if (graph == nullptr || graph->size > 0 || dstFormat < YUV_FORMAT_I420 ||
+        dstFormat > YUV_FORMAT_NV21) {
+        return -1;
+    }
+    int width;
+    int height;
+    graphOutputSize(graph, &width, &height);
+    if (dstStride <= 0) {
+        dstStride = width;
+    }
+    if (dstSliceHeight <= 0) {
+        dstSliceHeight = height;
+    }
+    if (dstStride < width || dstSliceHeight < height) {
+        return -1;
+    }
+
+    // 开头的裁剪只影响读取源数据的偏移
+    int first = 0;
+    while (first < graph->nodeCount && graph->nodes[first].type == GRAPH_NODE_CROP) {
+        graph->cropX += graph->nodes[first].x;
+        graph->cropY += graph->nodes[first].y;
+        graph->cropWidth = graph->nodes[first].width;
+        graph->cropHeight = graph->nodes[first].height;
+        first++;
+    }
+    graph->nodeCount -= first;
+    memmove(graph->nodes, graph->nodes + first, sizeof(GraphNode) * graph->nodeCount);
+    graph->srcYOffset = (size_t) graph->cropY * graph->srcStride + graph->cropX;
+    size_t srcChroma = (size_t) graph->srcStride * graph->srcSliceHeight;
+    if (graph->srcFormat == YUV_FORMAT_I420) {
+        graph->srcUOffset = srcChroma + (size_t) (graph->cropY >> 1) * graph->srcUVStride +
+                            (graph->cropX >> 1);
+        graph->srcVOffset = graph->srcUOffset +
+                            (size_t) graph->srcUVStride * (graph->srcSliceHeight >> 1);
+    } else {
+        graph->srcUOffset = srcChroma + (size_t) (graph->cropY >> 1) * graph->srcStride +
+                            graph->cropX;
+        graph->srcVOffset = graph->srcUOffset;
+    }
+    graph->dstStride = dstStride;
+    graph->dstFormat = dstFormat;
+    graph->dstUVStride = dstFormat == YUV_FORMAT_I420 ? dstStride >> 1 : dstStride;
+    graph->dstUOffset = (size_t) dstStride * dstSliceHeight;
+    graph->dstVOffset = dstFormat == YUV_FORMAT_I420 ? graph->dstUOffset +
+                                                       (size_t) graph->dstUVStride *
+                                                       (dstSliceHeight >> 1) : 0;
+
+    // 按整帧节点分段，段内各节点的切带单位依次传递
+    int inWidth = graph->cropWidth;
+    int inHeight = graph->cropHeight;
+    int unit = 2;
+    size_t frameSize = 0;
+    GraphSegment *segment = &graph->segments[0];
+    segment->begin = 0;
+    segment->input = -1;
+    for (int i = 0; i < graph->nodeCount; i++) {
+        GraphNode *node = &graph->nodes[i];
+        int nodeUnit = unit;
+        if (node->type == GRAPH_NODE_CROP) {
+            node->whole = node->y % unit != 0 || node->height % unit != 0;
+        } else if (node->type == GRAPH_NODE_SCALE) {
+            nodeUnit = scaleStripUnit(node, inWidth, inHeight, unit);
+            node->whole = nodeUnit == 0;
+        } else {
+            node->whole = node->type == GRAPH_NODE_ROTATE;
+        }
+        if (!node->whole) {
+            unit = nodeUnit;
+            inWidth = node->width;
+            inHeight = node->height;
+            continue;
+        }
+        segment->end = i;
+        segment->sink = i;
+        segment->rows = inHeight;
+        segment->unit = unit;
+        // 旋转直接按带写入输出，缩放、裁剪需要先拼成整帧输入
+        if (node->type != GRAPH_NODE_ROTATE && !graphWholeInput(graph, segment)) {
+            node->inputOffset = frameSize;
+            frameSize += alignSize((size_t) inWidth * inHeight * 3 / 2);
+        }
+        // 最后一个节点直接输出到目标数据，NV12/NV21只需要临时的平面色度
+        if (node->type != GRAPH_NODE_CROP) {
+            node->frameOffset = frameSize;
+            size_t planeSize = (size_t) node->width * node->height;
+            if (i < graph->nodeCount - 1) {
+                frameSize += alignSize(planeSize * 3 / 2);
+            } else if (dstFormat != YUV_FORMAT_I420) {
+                frameSize += alignSize(planeSize / 2);
+            }
+        }
+        segment++;
+        segment->begin = i + 1;
+        segment->input = i;
+        unit = 2;
+        inWidth = node->width;
+        inHeight = node->height;
+    }
+    segment->end = graph->nodeCount;
+    segment->sink = graph->nodeCount;
+    segment->rows = inHeight;
+    segment->unit = unit;
+    graph->segmentCount = (int) (segment - graph->segments) + 1;
+    for (int i = 0; i < graph->segmentCount; i++) {
+        layoutGraphSegment(graph, &graph->segments[i]);
+    }
+
+    if (frameSize > 0) {
+        releasePoolBuffer(graph->frames);
+        graph->frames = acquirePoolBuffer(frameSize);
+        if (graph->frames == nullptr) {
+            return -1;
+        }
+    }
+    graph->size = dstStride * dstSliceHeight * 3 / 2;
+    return graph->size;
+}
+
+/**
+ * 一带数据的执行上下文
+ */
+struct GraphStrip {
+    const YuvGraph *graph;
+    const GraphSegment *segment;
+    const uint8_t *src;
+    // 各整帧节点的输出及拼接的整帧输入
+    const PlanarImage *frames;
+    const PlanarImage *inputs;
+    uint8_t *buffer;
+};
+
+/**
+ * I420图片中 [start, end) 行的视图，start 为偶数
+ */
+static PlanarImage planarRows(const PlanarImage &image, int start, int end) {
+    PlanarImage rows = image;
+    rows.y += (size_t) start * image.yStride;
+    rows.u += (size_t) (start >> 1) * image.uvStride;
+    rows.v += (size_t) (start >> 1) * image.uvStride;
+    rows.height = end - start;
+    return rows;
+}
+
+/**
+ * 拷贝I420数据，已经在同一块内存的分量跳过
+ */
+static void copyPlanar(const PlanarImage &src, const PlanarImage &dst) {
+    TRACE_SCOPE("copy");
+    if (src.y != dst.y) {
+        libyuv::CopyPlane(src.y, src.yStride, dst.y, dst.yStride, src.width, src.height);
+    }
+    if (src.u != dst.u) {
+        libyuv::CopyPlane(src.u, src.uvStride, dst.u, dst.uvStride, src.width >> 1,
+                          src.height >> 1);
+    }
+    if (src.v != dst.v) {
+        libyuv::CopyPlane(src.v, src.uvStride, dst.v, dst.uvStride, src.width >> 1,
+                          src.height >> 1);
+    }
+}
+
+/**
+ * 段输入的 [start, end) 行，NV12/NV21源数据的色度拆分到 target 或每带的临时内存
+ *
+ * @return 视图是否可写，源数据不可写
+ */
+static bool graphInputRows(const GraphStrip &strip, int start, int end,
+                           const PlanarImage *target, PlanarImage *view) {
+    const GraphSegment *segment = strip.segment;
+    if (segment->input >= 0) {
+        *view = planarRows(strip.frames[segment->input], start, end);
+        return true;
+    }
+    const YuvGraph *graph = strip.graph;
+    const uint8_t *src = strip.src;
+    int halfWidth = graph->cropWidth >> 1;
+    size_t uvRow = (size_t) (start >> 1) * graph->srcUVStride;
+    view->y = (uint8_t *) src + graph->srcYOffset + (size_t) start * graph->srcStride;
+    view->yStride = graph->srcStride;
+    view->width = graph->cropWidth;
+    view->height = end - start;
+    if (graph->srcFormat == YUV_FORMAT_I420) {
+        view->u = (uint8_t *) src + graph->srcUOffset + uvRow;
+        view->v = (uint8_t *) src + graph->srcVOffset + uvRow;
+        view->uvStride = graph->srcUVStride;
+        return false;
+    }
+    if (target != nullptr) {
+        view->u = target->u;
+        view->v = target->v;
+        view->uvStride = target->uvStride;
+    } else {
+        view->u = strip.buffer + segment->srcChromaOffset;
+        view->v = view->u + (size_t) halfWidth * ((end - start) >> 1);
+        view->uvStride = halfWidth;
+    }
+    bool nv12 = graph->srcFormat == YUV_FORMAT_NV12;
+    libyuv::SplitUVPlane(src + graph->srcUOffset + uvRow, graph->srcStride,
+                         nv12 ? view->u : view->v, view->uvStride, nv12 ? view->v : view->u,
+                         view->uvStride, halfWidth, (end - start) >> 1);
+    return false;
+}
+
+/**
+ * 图层和 [start, end) 行相交的部分混合到 image 上
+ */
+static void blendGraphOverlay(const GraphNode &node, const PlanarImage &image, int start,
+                              int end) {
+    int top = start > node.y ? start : node.y;
+    int bottom = end < node.y + node.blendHeight ? end : node.y + node.blendHeight;
+    if (top >= bottom) {
+        return;
+    }
+    TRACE_SCOPE("blend");
+    int blendW = node.blendWidth;
+    int halfW = blendW >> 1;
+    size_t planeSize = (size_t) blendW * node.blendHeight;
+    size_t halfSize = planeSize >> 2;
+    const uint8_t *y = node.planes + (size_t) (top - node.y) * blendW;
+    const uint8_t *alphaY = y + planeSize;
+    size_t uvRow = (size_t) ((top - node.y) >> 1) * halfW;
+    const uint8_t *u = node.planes + planeSize * 2 + uvRow;
+    const uint8_t *v = u + halfSize;
+    const uint8_t *alphaUV = v + halfSize;
+    uint8_t *dstY = image.y + (size_t) (top - start) * image.yStride + node.x;
+    libyuv::BlendPlane(y, blendW, dstY, image.yStride, alphaY, blendW, dstY, image.yStride,
+                       blendW, bottom - top);
+    size_t dstUVOffset = (size_t) ((top - start) >> 1) * image.uvStride + (node.x >> 1);
+    uint8_t *dstU = image.u + dstUVOffset;
+    uint8_t *dstV = image.v + dstUVOffset;
+    libyuv::BlendPlane(u, halfW, dstU, image.uvStride, alphaUV, halfW, dstU, image.uvStride,
+                       halfW, (bottom - top) >> 1);
+    libyuv::BlendPlane(v, halfW, dstV, image.uvStride, alphaUV, halfW, dstV, image.uvStride,
+                       halfW, (bottom - top) >> 1);
+}
+
+/**
+ * 计算第 index 个节点输出的 [start, end) 行，有 target 时尽量直接写入 target
+ *
+ * @param view 输出行的视图，裁剪节点为上游数据的一部分，不拷贝
+ * @return 视图是否可写
+ */
+static bool pullGraphRows(const GraphStrip &strip, int index, int start, int end,
+                          const PlanarImage *target, PlanarImage *view) {
+    if (index < strip.segment->begin) {
+        return graphInputRows(strip, start, end, target, view);
+    }
+    const GraphNode &node = strip.graph->nodes[index];
+    if (node.type == GRAPH_NODE_CROP) {
+        bool writable = pullGraphRows(strip, index - 1, start + node.y, end + node.y, nullptr,
+                                      view);
+        view->y += node.x;
+        view->u += node.x >> 1;
+        view->v += node.x >> 1;
+        view->width = node.width;
+        return writable;
+    }
+    PlanarImage out = target != nullptr ? *target : planarImageOf(
+            strip.buffer + node.stripOffset, node.width, end - start);
+    if (node.type == GRAPH_NODE_SCALE) {
+        PlanarImage in;
+        pullGraphRows(strip, index - 1, start / node.dstUnit * node.srcUnit,
+                      end / node.dstUnit * node.srcUnit, nullptr, &in);
+        libyuv::FilterMode mode = (libyuv::FilterMode) node.mode;
+        libyuv::ScalePlane(in.y, in.yStride, in.width, in.height, out.y, out.yStride, out.width,
+                           out.height, mode);
+        libyuv::ScalePlane(in.u, in.uvStride, in.width >> 1, in.height >> 1, out.u, out.uvStride,
+                           out.width >> 1, out.height >> 1, mode);
+        libyuv::ScalePlane(in.v, in.uvStride, in.width >> 1, in.height >> 1, out.v, out.uvStride,
+                           out.width >> 1, out.height >> 1, mode);
+        *view = out;
+        return true;
+    }
+    // 叠加图层：上游已经写入可写的内存时直接混合，否则先拷贝
+    bool writable = pullGraphRows(strip, index - 1, start, end, target, view);
+    if (target == nullptr && writable) {
+        out = *view;
+    }
+    copyPlanar(*view, out);
+    blendGraphOverlay(node, out, start, end);
+    *view = out;
+    return true;
+}
+
+/**
+ * 执行一段中输出的 [start, end) 行，并写入段的终点
+ */
+static void runGraphStrip(const GraphStrip &strip, uint8_t *dst, int start, int end) {
+    TRACE_SCOPE("graphStrip");
+    const YuvGraph *graph = strip.graph;
+    const GraphSegment *segment = strip.segment;
+    int last = segment->end - 1;
+    PlanarImage view;
+    if (segment->sink == graph->nodeCount) {
+        // 输出到目标数据，I420的U、V直接写入目标，NV12/NV21的色度最后交织
+        int width;
+        int height;
+        graphOutputSize(graph, &width, &height);
+        int halfWidth = width >> 1;
+        int rows = end - start;
+        PlanarImage target = {dst + (size_t) start * graph->dstStride, nullptr, nullptr,
+                              graph->dstStride, graph->dstUVStride, width, rows};
+        if (graph->dstFormat == YUV_FORMAT_I420) {
+            size_t uvRow = (size_t) (start >> 1) * graph->dstUVStride;
+            target.u = dst + graph->dstUOffset + uvRow;
+            target.v = dst + graph->dstVOffset + uvRow;
+        } else {
+            target.u = strip.buffer + segment->dstChromaOffset;
+            target.v = target.u + (size_t) halfWidth * (rows >> 1);
+            target.uvStride = halfWidth;
+        }
+        pullGraphRows(strip, last, start, end, &target, &view);
+        if (graph->dstFormat == YUV_FORMAT_I420) {
+            copyPlanar(view, target);
+            return;
+        }
+        if (view.y != target.y) {
+            libyuv::CopyPlane(view.y, view.yStride, target.y, target.yStride, width, rows);
+        }
+        bool nv12 = graph->dstFormat == YUV_FORMAT_NV12;
+        libyuv::MergeUVPlane(nv12 ? view.u : view.v, view.uvStride, nv12 ? view.v : view.u,
+                             view.uvStride,
+                             dst + graph->dstUOffset + (size_t) (start >> 1) * graph->dstStride,
+                             graph->dstStride, halfWidth, rows >> 1);
+        return;
+    }
+    const GraphNode &sink = graph->nodes[segment->sink];
+    if (sink.type == GRAPH_NODE_ROTATE) {
+        // 每带旋转后写入输出中互不重叠的区域
+        pullGraphRows(strip, last, start, end, nullptr, &view);
+        const PlanarImage &out = strip.frames[segment->sink];
+        libyuv::RotationMode rotation = (libyuv::RotationMode) sink.rotation;
+        int height = segment->rows;
+        libyuv::RotatePlane(view.y, view.yStride,
+                            out.y + rotatedBandOffset(rotation, start, end, height, out.yStride),
+                            out.yStride, view.width, end - start, rotation);
+        size_t uvOffset = rotatedBandOffset(rotation, start >> 1, end >> 1, height >> 1,
+                                            out.uvStride);
+        libyuv::RotatePlane(view.u, view.uvStride, out.u + uvOffset, out.uvStride,
+                            view.width >> 1, (end - start) >> 1, rotation);
+        libyuv::RotatePlane(view.v, view.uvStride, out.v + uvOffset, out.uvStride,
+                            view.width >> 1, (end - start) >> 1, rotation);
+        return;
+    }
+    // 整帧缩放、裁剪的输入按带拼成整帧
+    PlanarImage target = planarRows(strip.inputs[segment->sink], start, end);
+    pullGraphRows(strip, last, start, end, &target, &view);
+    copyPlanar(view, target);
+}
+
+/**
+ * 整帧节点的输出，最后一个节点直接输出到目标数据
+ */
+static PlanarImage graphFrameOf(const YuvGraph *graph, int index, uint8_t *dst,
+                                uint8_t *frames) {
+    const GraphNode &node = graph->nodes[index];
+    if (index < graph->nodeCount - 1) {
+        return planarImageOf(frames + node.frameOffset, node.width, node.height);
+    }
+    int halfWidth = node.width >> 1;
+    PlanarImage image = {dst, dst + graph->dstUOffset, dst + graph->dstVOffset, graph->dstStride,
+                         graph->dstUVStride, node.width, node.height};
+    if (graph->dstFormat != YUV_FORMAT_I420) {
+        image.u = frames + node.frameOffset;
+        image.v = image.u + (size_t) halfWidth * (node.height >> 1);
+        image.uvStride = halfWidth;
+    }
+    return image;
+}
+
+int executeGraph(YuvGraph *graph, const uint8_t *src, uint8_t *dst) {
+    if (graph == nullptr || graph->size <= 0 || src == nullptr || dst == nullptr) {
+        return -1;
+    }
+    PlanarImage frames[GRAPH_MAX_NODES];
+    PlanarImage inputs[GRAPH_MAX_NODES];
+    uint8_t *frameData = graph->frames == nullptr ? nullptr : graph->frames->data;
+    for (int i = 0; i < graph->segmentCount; i++) {
+        const GraphSegment *segment = &graph->segments[i];
+        bool stream = true;
+        if (segment->sink < graph->nodeCount) {
+            int sinkIndex = segment->sink;
+            const GraphNode &sink = graph->nodes[sinkIndex];
+            int inWidth = segment->end > segment->begin ? graph->nodes[segment->end - 1].width : 0;
+            int inHeight = segment->rows;
+            if (segment->end == segment->begin) {
+                graphInputSize(graph, segment, &inWidth, &inHeight);
+            }
+            if (sink.type != GRAPH_NODE_ROTATE) {
+                if (!graphWholeInput(graph, segment)) {
+                    inputs[sinkIndex] = planarImageOf(frameData + sink.inputOffset, inWidth,
+                                                      inHeight);
+                } else if (segment->input >= 0) {
+                    inputs[sinkIndex] = frames[segment->input];
+                    stream = false;
+                } else {
+                    inputs[sinkIndex] = {(uint8_t *) src + graph->srcYOffset,
+                                         (uint8_t *) src + graph->srcUOffset,
+                                         (uint8_t *) src + graph->srcVOffset, graph->srcStride,
+                                         graph->srcUVStride, inWidth, inHeight};
+                    stream = false;
+                }
+            }
+            if (sink.type == GRAPH_NODE_CROP) {
+                // 裁剪的输出是整帧输入的一部分
+                frames[sinkIndex] = planarRows(inputs[sinkIndex], sink.y, sink.y + sink.height);
+                frames[sinkIndex].y += sink.x;
+                frames[sinkIndex].u += sink.x >> 1;
+                frames[sinkIndex].v += sink.x >> 1;
+                frames[sinkIndex].width = sink.width;
+            } else {
+                frames[sinkIndex] = graphFrameOf(graph, sinkIndex, dst, frameData);
+            }
+        }
+        if (stream) {
+            int ret = parallelRows(segment->rows, segment->unit, segment->rowPixels,
+                                   [&](int start, int end) {
+                PoolBuffer *buffer = nullptr;
+                if (segment->stripSize > 0) {
+                    buffer = acquirePoolBuffer(segment->stripSize);
+                    if (buffer == nullptr) {
+                        return -1;
+                    }
+                }
+                GraphStrip strip = {graph, segment, src, frames, inputs,
+                                    buffer == nullptr ? nullptr : buffer->data};
+                for (int row = start; row < end; row += segment->stripRows) {
+                    int rowEnd = row + segment->stripRows;
+                    runGraphStrip(strip, dst, row, rowEnd < end ? rowEnd : end);
+                }
+                releasePoolBuffer(buffer);
+                return 0;
+            });
+            if (ret != 0) {
+                return -1;
+            }
+        }
+        if (segment->sink < graph->nodeCount &&
+            graph->nodes[segment->sink].type == GRAPH_NODE_SCALE) {
+            const GraphNode &sink = graph->nodes[segment->sink];
+            scalePlanar(inputs[segment->sink], frames[segment->sink], sink.mode);
+        }
+    }
+    return graph->size;
+}
+
+void releaseGraph(YuvGraph *graph) {
+    if (graph == nullptr) {
+        return;
+    }
+    for (int i = 0; i < graph->nodeCount; i++) {
+        free(graph->nodes[i].planes);
+    }
+    releasePoolBuffer(graph->frames);
+    free(graph);
+}
+
+int batchFrameSize(const BatchOp *op, int64_t *srcSize, int64_t *dstSize) {
+    if (op == nullptr) {
+        return -1;
+    }
+    int64_t yuvSize = (int64_t) op->width * op->height * 3 / 2;
+    *srcSize = yuvSize;
+    *dstSize = yuvSize;
+    switch (op->op) {
+        case BATCH_OP_NV21_TO_I420:
+        case BATCH_OP_I420_TO_NV21:
+            break;
+        case BATCH_OP_NV21_TO_ARGB:
+            *dstSize = (int64_t) op->width * op->height * 4;
+            break;
+        case BATCH_OP_NV21_SCALE:
+            if (op->dstWidth <= 0 || op->dstHeight <= 0) {
+                return -1;
+            }
+            *dstSize = (int64_t) op->dstWidth * op->dstHeight * 3 / 2;
+            break;
+        case BATCH_OP_TRANSFORM_PLAN:
+            if (op->plan == nullptr) {
+                return -1;
+            }
+            *srcSize = op->plan->srcSize;
+            *dstSize = op->plan->size;
+            return 0;
+        case BATCH_OP_GRAPH:
+            if (op->graph == nullptr || op->graph->size <= 0) {
+                return -1;
+            }
+            *srcSize = op->graph->srcSize;
+            *dstSize = op->graph->size;
+            return 0;
+        case BATCH_OP_DRAW_TIMESTAMP:
+            if (op->atlas == nullptr || op->timestamps == nullptr) {
+                return -1;
+            }
+            *dstSize = 0;
+            break;
+        default:
+            return -1;
+    }
+    return op->width > 0 && op->height > 0 ? 0 : -1;
+}
+
+/**
+ * 批量处理中的一帧
+ *
+ * @param buffer TRANSFORM_PLAN 的临时内存
+ */
+static int runBatchFrame(const BatchOp *op, int index, uint8_t *src, uint8_t *dst,
+                         uint8_t *buffer) {
+    switch (op->op) {
+        case BATCH_OP_NV21_TO_I420:
+            return nv21ToI420(src, dst, op->width, op->height, op->swapUV);
+        case BATCH_OP_I420_TO_NV21:
+            return i420ToNV21(src, dst, op->width, op->height, op->swapUV);
+        case BATCH_OP_NV21_TO_ARGB:
+            return nv21ToArgb(src, dst, op->width, op->height);
+        case BATCH_OP_NV21_SCALE:
+            nv21Scale(src, op->width, op->height, dst, op->dstWidth, op->dstHeight, op->mode);
+            return 0;
+        case BATCH_OP_TRANSFORM_PLAN:
+            return runTransformPlan(op->plan, src, dst, buffer) < 0 ? -1 : 0;
+        case BATCH_OP_GRAPH:
+            return executeGraph(op->graph, src, dst) < 0 ? -1 : 0;
+        case BATCH_OP_DRAW_TIMESTAMP:
+            return nv21DrawTimestamp(src, op->width, op->height, op->atlas,
+                                     op->timestamps[index], op->format, op->x, op->y) < 0 ? -1
+                                                                                           : 0;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * 估算每帧的工作量（像素数），用于决定按帧还是按行并行
+ */
+static int64_t batchFramePixels(const BatchOp *op) {
+    switch (op->op) {
+        case BATCH_OP_TRANSFORM_PLAN:
+            return (int64_t) op->plan->cropWidth * op->plan->cropHeight;
+        case BATCH_OP_GRAPH:
+            return (int64_t) op->graph->cropWidth * op->graph->cropHeight;
+        case BATCH_OP_DRAW_TIMESTAMP:
+            // 只处理一行文字
+            return (int64_t) op->width * op->atlas->height;
+        default:
+            return (int64_t) op->width * op->height;
+    }
+}
+
+int runBatch(const BatchOp *op, uint8_t *const *src, uint8_t *const *dst, int count) {
+    int64_t srcSize;
+    int64_t dstSize;
+    if (batchFrameSize(op, &srcSize, &dstSize) != 0 || count < 0 || count > BATCH_MAX_FRAMES ||
+        (count > 0 && (src == nullptr || (dstSize > 0 && dst == nullptr)))) {
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (src[i] == nullptr || (dstSize > 0 && dst[i] == nullptr)) {
+            return -1;
+        }
+    }
+    // 方案的临时内存同一时间只能被一帧使用，批量处理时每带各取一块
+    size_t scratchSize = op->op == BATCH_OP_TRANSFORM_PLAN ? scratchSizeOf(op->plan) : 0;
+    auto runFrames = [=](int start, int end) {
+        PoolBuffer *pool = nullptr;
+        if (scratchSize > 0) {
+            pool = acquirePoolBuffer(scratchSize);
+            if (pool == nullptr) {
+                return -1;
+            }
+        }
+        int ret = 0;
+        for (int i = start; i < end; i++) {
+            if (runBatchFrame(op, i, src[i], dst == nullptr ? nullptr : dst[i],
+                              pool == nullptr ? nullptr : pool->data) != 0) {
+                ret = -1;
+            }
+        }
+        releasePoolBuffer(pool);
+        return ret;
+    };
+
+    int64_t framePixels = batchFramePixels(op);
+    int threads = getParallelThreadCount();
+    if (op->op == BATCH_OP_GRAPH ||
+        (count < threads && framePixels >= (int64_t) threads * PARALLEL_MIN_BAND_PIXELS)) {
+        // 处理图各帧只能依次执行；帧数少于线程数而单帧足够大时也逐帧执行，帧内按行分带能用满线程
+        return runFrames(0, count);
+    }
+    return parallelRows(count, 1, framePixels, runFrames);
+}
@@ -0,0 +1,140 @@
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "YuvThreadPool.h"
+#include "YuvTrace.h"
+
+/**
+ * 一次 parallelRows 调用的完成计数，调用线程等待所有带执行完
+ */
+struct BandGroup {
+    std::mutex mutex;
+    std::condition_variable done;
+    int remaining;
+    std::atomic<int> failed;
+};
+
+/**
+ * 常驻的工作线程，按需启动，进程退出前不回收（退出时join可能和还在执行的任务互相等待）
+ */
+struct WorkerPool {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> tasks;
+    int started = 0;
+};
+
+static WorkerPool *sPool = new WorkerPool();
+// 用户设置的线程数，<=0 按CPU核数
+static std::atomic<int> sThreadCount(0);
+// 当前线程是否为工作线程或正在执行调用线程的那一带，嵌套调用时不再分发
+static thread_local bool sInWorker = false;
+
+static void workerLoop() {
+    sInWorker = true;
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(sPool->mutex);
+            sPool->wake.wait(lock, [] { return !sPool->tasks.empty(); });
+            task = std::move(sPool->tasks.front());
+            sPool->tasks.pop_front();
+        }
+        task();
+    }
+}
+
+/**
+ * 保证至少启动 count 个工作线程
+ */
+static void ensureWorkers(int count) {
+    std::lock_guard<std::mutex> lock(sPool->mutex);
+    while (sPool->started < count) {
+        std::thread(workerLoop).detach();
+        sPool->started++;
+    }
+}
+
+void setParallelThreadCount(int count) {
+    sThreadCount = count;
+}
+
+int getParallelThreadCount() {
+    int count = sThreadCount;
+    if (count <= 0) {
+        count = (int) std::thread::hardware_concurrency();
+    }
+    if (count < 1) {
+        count = 1;
+    }
+    return count > PARALLEL_MAX_WORKERS + 1 ? PARALLEL_MAX_WORKERS + 1 : count;
+}
+
+static void runBand(BandGroup *group, const std::function<int(int, int)> &func, int start,
+                    int end) {
+    TRACE_SCOPE("parallelBand");
+    if (func(start, end) != 0) {
+        group->failed = 1;
+    }
+    std::lock_guard<std::mutex> lock(group->mutex);
+    if (--group->remaining == 0) {
+        group->done.notify_one();
+    }
+}
+
+int parallelRows(int rows, int unit, int64_t rowPixels, const std::function<int(int, int)> &func) {
+    if (rows <= 0) {
+        // 参数错误（如高度为0）交给 func 自己处理
+        return func(0, rows) == 0 ? 0 : -1;
+    }
+    if (unit < 1) {
+        unit = 1;
+    }
+    int units = (rows + unit - 1) / unit;
+    int64_t work = rows * rowPixels / PARALLEL_MIN_BAND_PIXELS;
+    int bands = sInWorker ? 1 : getParallelThreadCount();
+    if (bands > work) {
+        bands = (int) work;
+    }
+    if (bands > units) {
+        bands = units;
+    }
+    if (bands <= 1) {
+        return func(0, rows) == 0 ? 0 : -1;
+    }
+
+    ensureWorkers(bands - 1);
+    BandGroup group;
+    group.remaining = bands;
+    group.failed = 0;
+    // 按unit均分，前 units % bands 带多分一个unit
+    int start[PARALLEL_MAX_WORKERS + 2];
+    start[0] = 0;
+    for (int i = 0; i < bands; i++) {
+        int count = units / bands + (i < units % bands ? 1 : 0);
+        start[i + 1] = start[i] + count * unit;
+    }
+    start[bands] = rows;
+    {
+        std::lock_guard<std::mutex> lock(sPool->mutex);
+        for (int i = 1; i < bands; i++) {
+            int begin = start[i];
+            int end = start[i + 1];
+            sPool->tasks.emplace_back([&group, &func, begin, end] {
+                runBand(&group, func, begin, end);
+            });
+        }
+    }
+    sPool->wake.notify_all();
+    // 调用线程执行第一带，带内的嵌套调用同样直接执行，不排在其他带之后等待工作线程
+    sInWorker = true;
+    runBand(&group, func, start[0], start[1]);
+    sInWorker = false;
+
+    TRACE_SCOPE("waitBands");
+    std::unique_lock<std::mutex> lock(group.mutex);
+    group.done.wait(lock, [&group] { return group.remaining == 0; });
+    return group.failed ? -1 : 0;
+}
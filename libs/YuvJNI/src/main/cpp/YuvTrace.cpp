@@ -0,0 +1,5 @@
+#include "YuvTrace.h"
+
+#define NATIVE_TRACE_CATEGORY "yuv"
+
+#include "NativeTraceImpl.h"
@@ -0,0 +1,955 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include "libyuv/profile.h"
+#include "libyuv/rotate.h"
+#include "YuvBufferPool.h"
+#include "YuvCpu.h"
+#include "YuvJobQueue.h"
+#include "YuvOps.h"
+#include "YuvThreadPool.h"
+#include "YuvTrace.h"
+
+/**
+ * 主机上测试 g_methods 中各操作的耗时，调用 YuvJni.cpp 转发到的同一份native实现，结果以JSON输出：
+ *
+ *   yuv-benchmark [--filter 名称子串] [--resolution WxH]... [--cpu simd|c|all]
+ *                 [--min-time-ms 毫秒] [--threads 线程数] [--output 文件] [--trace 文件]
+ *                 [--verify on|off|only]
+ *
+ * 每个操作在每个分辨率下，分别以全部SIMD特性（simd）及屏蔽为C实现（c）运行
+ *
+ * --verify 测速前先检查分带并行、变换方案、处理图、批量处理的结果与单线程整帧处理逐字节一致，不一致时以1退出；
+ * only 只检查不测速，off 跳过检查
+ *
+ * --trace 记录各阶段（convert、scale、blend、分带执行等）的trace事件，结束后以 Chrome trace JSON 写入文件
+ */
+
+// Key.RGBA_TO_I420、Key.I420_TO_RGBA
+#define RGBA_TO_I420 0x01001040
+#define I420_TO_RGBA 0x02001040
+
+// Key.ROTATE_XXX
+#define ROTATE_90 0
+#define ROTATE_180 1
+#define ROTATE_270 2
+
+// 水印、叠加图层、时间字形的大小
+#define MARK_WIDTH 320
+#define MARK_HEIGHT 64
+#define GLYPH_WIDTH 16
+#define GLYPH_HEIGHT 32
+
+// 批量处理测试的帧数
+#define BENCH_BATCH_FRAMES 4
+
+struct Resolution {
+    int width;
+    int height;
+};
+
+// 常见的屏幕、录屏分辨率：720p、1080p、1440p、2400x1080（20:9 手机屏）、4K
+static const Resolution kResolutions[] = {
+        {1280, 720},
+        {1920, 1080},
+        {2560, 1440},
+        {2400, 1080},
+        {3840, 2160},
+};
+
+struct CpuMode {
+    const char *name;
+    int mask;
+};
+
+static const CpuMode kCpuModes[] = {
+        {"simd", -1},
+        {"c",    1},
+};
+
+static const char *const kScaleModes[] = {"None", "Linear", "Bilinear", "Box"};
+
+/**
+ * 一个分辨率下各操作共用的数据，内容为伪随机值
+ */
+struct BenchFrames {
+    int width;
+    int height;
+    size_t yuvSize;
+    size_t argbSize;
+    uint8_t *nv21;
+    uint8_t *i420;
+    uint8_t *dst;
+    uint8_t *argb;
+    uint8_t *argbDst;
+    uint8_t *batchSrc[BENCH_BATCH_FRAMES];
+    uint8_t *batchDst[BENCH_BATCH_FRAMES];
+    std::vector<uint8_t *> buffers;
+};
+
+/**
+ * 一个测试项，bytes 为每帧读写的数据量，用于计算吞吐
+ */
+struct BenchCase {
+    std::string name;
+    int64_t bytes;
+    // 每次调用处理的帧数
+    int frames;
+    std::function<void()> run;
+};
+
+struct BenchOptions {
+    std::string filter;
+    std::vector<Resolution> resolutions;
+    std::string cpu = "all";
+    int minTimeMs = 100;
+    int threads = 0;
+    const char *output = nullptr;
+    const char *trace = nullptr;
+    std::string verify = "on";
+};
+
+static uint32_t sSeed = 1;
+
+static void fillRandom(uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        sSeed = sSeed * 1103515245 + 12345;
+        data[i] = (uint8_t) (sSeed >> 16);
+    }
+}
+
+static uint8_t *allocFrame(BenchFrames *frames, size_t size) {
+    // 与 YuvBuffer 一样64字节对齐
+    void *data = nullptr;
+    if (posix_memalign(&data, 64, size) != 0) {
+        fprintf(stderr, "alloc %zu bytes failed\n", size);
+        exit(1);
+    }
+    fillRandom((uint8_t *) data, size);
+    frames->buffers.push_back((uint8_t *) data);
+    return (uint8_t *) data;
+}
+
+static void initFrames(BenchFrames *frames, int width, int height) {
+    frames->width = width;
+    frames->height = height;
+    frames->yuvSize = (size_t) width * height * 3 / 2;
+    frames->argbSize = (size_t) width * height * 4;
+    frames->nv21 = allocFrame(frames, frames->yuvSize);
+    frames->i420 = allocFrame(frames, frames->yuvSize);
+    frames->dst = allocFrame(frames, frames->yuvSize);
+    frames->argb = allocFrame(frames, frames->argbSize);
+    frames->argbDst = allocFrame(frames, frames->argbSize);
+    for (int i = 0; i < BENCH_BATCH_FRAMES; i++) {
+        frames->batchSrc[i] = allocFrame(frames, frames->yuvSize);
+        frames->batchDst[i] = allocFrame(frames, frames->yuvSize);
+    }
+}
+
+static void releaseFrames(BenchFrames *frames) {
+    for (uint8_t *data : frames->buffers) {
+        free(data);
+    }
+    frames->buffers.clear();
+}
+
+/**
+ * 水印、叠加图层及字形共用的资源，与分辨率无关
+ */
+struct BenchAssets {
+    uint8_t waterMark[MARK_WIDTH * MARK_HEIGHT * 3 / 2];
+    YuvOverlay *overlay;
+    GlyphAtlas *atlas;
+    YuvJobStream *jobStream;
+};
+
+/**
+ * 预乘alpha的RGBA图：中间不透明，四周半透明，边缘透明，覆盖叠加时的各个分支
+ */
+static std::vector<uint8_t> makeRgba(int width, int height) {
+    std::vector<uint8_t> rgba((size_t) width * height * 4);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int edge = std::min(std::min(x, width - 1 - x), std::min(y, height - 1 - y));
+            uint8_t alpha = edge == 0 ? 0 : edge < 4 ? 128 : 255;
+            uint8_t *pixel = &rgba[((size_t) y * width + x) * 4];
+            pixel[0] = (uint8_t) (alpha * (x & 0xff) / 255);
+            pixel[1] = (uint8_t) (alpha * (y & 0xff) / 255);
+            pixel[2] = alpha;
+            pixel[3] = alpha;
+        }
+    }
+    return rgba;
+}
+
+static void initAssets(BenchAssets *assets) {
+    // 水印：一半为透明背景（Y 0x10），一半为内容
+    uint8_t *mark = assets->waterMark;
+    fillRandom(mark, sizeof(assets->waterMark));
+    for (int i = 0; i < MARK_WIDTH * MARK_HEIGHT; i += 2) {
+        mark[i] = 0x10;
+    }
+    std::vector<uint8_t> rgba = makeRgba(MARK_WIDTH, MARK_HEIGHT);
+    assets->overlay = createOverlay(rgba.data(), MARK_WIDTH * 4, MARK_WIDTH, MARK_HEIGHT);
+    assets->atlas = createGlyphAtlas();
+    std::vector<uint8_t> glyph = makeRgba(GLYPH_WIDTH, GLYPH_HEIGHT);
+    for (const char *c = "0123456789-:. "; *c != '\0'; c++) {
+        glyphAtlasAddGlyph(assets->atlas, *c, glyph.data(), GLYPH_WIDTH * 4, GLYPH_WIDTH,
+                           GLYPH_HEIGHT);
+    }
+    assets->jobStream = createJobStream();
+    if (assets->overlay == nullptr || assets->atlas == nullptr || assets->jobStream == nullptr) {
+        fprintf(stderr, "create benchmark assets failed\n");
+        exit(1);
+    }
+}
+
+static void releaseAssets(BenchAssets *assets) {
+    releaseOverlay(assets->overlay);
+    releaseGlyphAtlas(assets->atlas);
+    releaseJobStream(assets->jobStream);
+}
+
+/**
+ * 变换类测试的通用参数：居中裁剪到 7/8，顺时针旋转90度并缩小一半，输出I420
+ */
+struct TransformArgs {
+    int cropX;
+    int cropY;
+    int cropWidth;
+    int cropHeight;
+    int dstWidth;
+    int dstHeight;
+};
+
+static TransformArgs transformArgsOf(int width, int height) {
+    TransformArgs args;
+    args.cropWidth = (width * 7 / 8) & ~1;
+    args.cropHeight = (height * 7 / 8) & ~1;
+    args.cropX = ((width - args.cropWidth) / 2) & ~1;
+    args.cropY = ((height - args.cropHeight) / 2) & ~1;
+    args.dstWidth = (args.cropHeight / 2) & ~1;
+    args.dstHeight = (args.cropWidth / 2) & ~1;
+    return args;
+}
+
+/**
+ * 生成一个分辨率下的全部测试项，需要的方案、处理图放入 plans、graphs，测试结束后释放
+ */
+static std::vector<BenchCase> buildCases(BenchFrames *f, BenchAssets *assets,
+                                         std::vector<TransformPlan *> *plans,
+                                         std::vector<YuvGraph *> *graphs) {
+    std::vector<BenchCase> cases;
+    int w = f->width;
+    int h = f->height;
+    int64_t yuv = (int64_t) f->yuvSize;
+    int64_t argb = (int64_t) f->argbSize;
+    int64_t rgb24 = (int64_t) w * h * 3;
+    int64_t uv = (int64_t) w * h / 2;
+
+    cases.push_back({"RgbaToI420", argb + yuv, 1, [=] {
+        rgbaToI420(RGBA_TO_I420, f->argb, w * 4, f->dst, w, w / 2, w / 2, w, h);
+    }});
+    cases.push_back({"I420ToRgba", yuv + argb, 1, [=] {
+        i420ToRgba(I420_TO_RGBA, f->i420, w, w / 2, w / 2, f->argbDst, w * 4, w, h);
+    }});
+    cases.push_back({"I420ToNV21", yuv * 2, 1, [=] {
+        i420ToNV21(f->i420, f->dst, w, h, false);
+    }});
+    cases.push_back({"NV21ToI420", yuv * 2, 1, [=] {
+        nv21ToI420(f->nv21, f->dst, w, h, false);
+    }});
+    cases.push_back({"ArgbToNV21", argb + yuv, 1, [=] {
+        argbToNV21(f->argb, f->dst, w, h);
+    }});
+    cases.push_back({"NV12ToNV21", uv * 2, 1, [=] {
+        nv12ToNV21(f->dst, w, h);
+    }});
+    cases.push_back({"NV12ToArgb", yuv + argb, 1, [=] {
+        nv12ToArgb(f->nv21, f->argbDst, w, h);
+    }});
+    cases.push_back({"NV21ToArgb", yuv + argb, 1, [=] {
+        nv21ToArgb(f->nv21, f->argbDst, w, h);
+    }});
+    cases.push_back({"NV21ToRgb24", yuv + rgb24, 1, [=] {
+        nv21ToRgb24(f->nv21, f->argbDst, w, h);
+    }});
+
+    // 缩小到 2/3，各缩放模式分别测试
+    int scaleWidth = (w * 2 / 3) & ~1;
+    int scaleHeight = (h * 2 / 3) & ~1;
+    int64_t scaledYuv = (int64_t) scaleWidth * scaleHeight * 3 / 2;
+    int64_t scaledArgb = (int64_t) scaleWidth * scaleHeight * 4;
+    for (int mode = 0; mode < 4; mode++) {
+        std::string suffix = std::string("/") + kScaleModes[mode];
+        cases.push_back({"NV21Scale" + suffix, yuv + scaledYuv, 1, [=] {
+            nv21Scale(f->nv21, w, h, f->dst, scaleWidth, scaleHeight, mode);
+        }});
+        cases.push_back({"I420Scale" + suffix, yuv + scaledYuv, 1, [=] {
+            i420Scale(f->i420, w, h, f->dst, scaleWidth, scaleHeight, mode, false);
+        }});
+        cases.push_back({"RgbaScale" + suffix, argb + scaledArgb, 1, [=] {
+            rgbaScale(f->argb, w, h, f->argbDst, scaleWidth, scaleHeight, mode);
+        }});
+    }
+
+    const int rotations[] = {ROTATE_90, ROTATE_180, ROTATE_270};
+    const char *const rotationNames[] = {"/90", "/180", "/270"};
+    for (int i = 0; i < 3; i++) {
+        int de = rotations[i];
+        cases.push_back({std::string("NV21ToI420Rotate") + rotationNames[i], yuv * 2, 1, [=] {
+            nv21ToI420Rotate(f->nv21, w, h, f->dst, de, false);
+        }});
+    }
+
+    int cutWidth = (w / 2) & ~1;
+    int cutHeight = (h / 2) & ~1;
+    int64_t cutYuv = (int64_t) cutWidth * cutHeight * 3 / 2;
+    cases.push_back({"NV21CutData", cutYuv * 2, 1, [=] {
+        nv21CutData(f->dst, f->nv21, (w - cutWidth) / 2 & ~1, (h - cutHeight) / 2 & ~1, cutWidth,
+                    cutHeight, w, h);
+    }});
+
+    int64_t markYuv = MARK_WIDTH * MARK_HEIGHT * 3 / 2;
+    int markX = (w - MARK_WIDTH - 32) & ~1;
+    int markY = 32;
+    cases.push_back({"NV21AddWaterMark", markYuv * 3, 1, [=] {
+        nv21AddWaterMark(markX, markY, assets->waterMark, MARK_WIDTH, MARK_HEIGHT, f->dst, w, h);
+    }});
+    cases.push_back({"NV21ToYuv420WithWaterMark", yuv * 2, 1, [=] {
+        nv21ToYuv420WithWaterMark(f->nv21, w, h, assets->waterMark, MARK_WIDTH, MARK_HEIGHT,
+                                  markX, markY, f->dst, w, h, YUV_FORMAT_NV12);
+    }});
+    cases.push_back({"NV21BlendOverlays", markYuv * 4, 1, [=] {
+        nv21BlendOverlay(f->dst, w, h, assets->overlay, markX, markY);
+    }});
+    int64_t glyphs = (int64_t) GLYPH_WIDTH * GLYPH_HEIGHT * 3 / 2 * 23;
+    cases.push_back({"NV21DrawTimestamp", glyphs * 3, 1, [=] {
+        nv21DrawTimestamp(f->dst, w, h, assets->atlas, 1792000000123LL,
+                          TIME_FORMAT_DATE_TIME_MS, 32, 32);
+    }});
+
+    // android.media.Image 的 YUV_420_888：NV21内存布局，U、V两个平面交织
+    cases.push_back({"Android420ToYuv", yuv * 2, 1, [=] {
+        uint8_t *vu = f->nv21 + (size_t) w * h;
+        android420ToYuv(f->nv21, w, vu + 1, w, vu, w, 2, f->dst, w, h, YUV_FORMAT_I420);
+    }});
+
+    TransformArgs t = transformArgsOf(w, h);
+    int64_t cropYuv = (int64_t) t.cropWidth * t.cropHeight * 3 / 2;
+    int64_t transformYuv = (int64_t) t.dstWidth * t.dstHeight * 3 / 2;
+    cases.push_back({"YUV420SPTransform", cropYuv + transformYuv, 1, [=] {
+        yuv420spTransform(f->nv21, w, h, w, h, YUV_FORMAT_NV21, t.cropX, t.cropY, t.cropWidth,
+                          t.cropHeight, 90, f->dst, t.dstWidth, t.dstHeight, t.dstWidth,
+                          t.dstHeight, YUV_FORMAT_I420, 2);
+    }});
+    TransformPlan *plan = createTransformPlan(w, h, w, h, YUV_FORMAT_NV21, t.cropX, t.cropY,
+                                              t.cropWidth, t.cropHeight, 90, t.dstWidth,
+                                              t.dstHeight, t.dstWidth, t.dstHeight,
+                                              YUV_FORMAT_I420, 2);
+    if (plan != nullptr) {
+        plans->push_back(plan);
+        cases.push_back({"executeTransformPlan", cropYuv + transformYuv, 1, [=] {
+            executeTransformPlan(plan, f->nv21, f->dst);
+        }});
+        cases.push_back({"executeTransformPlanBatch", cropYuv + transformYuv, BENCH_BATCH_FRAMES,
+                         [=] {
+                             BatchOp op = {};
+                             op.op = BATCH_OP_TRANSFORM_PLAN;
+                             op.plan = plan;
+                             runBatch(&op, f->batchSrc, f->batchDst, BENCH_BATCH_FRAMES);
+                         }});
+    }
+
+    YuvGraph *graph = createGraph(w, h, w, h, YUV_FORMAT_NV21);
+    if (graph != nullptr && graphCrop(graph, t.cropX, t.cropY, t.cropWidth, t.cropHeight) == 0 &&
+        graphScale(graph, t.dstHeight, t.dstWidth, 2) == 0 && graphRotate(graph, 90) == 0 &&
+        graphOverlay(graph, assets->overlay, 32, 32) == 0 &&
+        prepareGraph(graph, 0, 0, YUV_FORMAT_I420) > 0) {
+        graphs->push_back(graph);
+        cases.push_back({"executeGraph", cropYuv + transformYuv, 1, [=] {
+            executeGraph(graph, f->nv21, f->dst);
+        }});
+    } else {
+        releaseGraph(graph);
+    }
+
+    BatchOp batch = {};
+    batch.width = w;
+    batch.height = h;
+    batch.op = BATCH_OP_NV21_TO_I420;
+    cases.push_back({"NV21ToI420Batch", yuv * 2, BENCH_BATCH_FRAMES, [=] {
+        runBatch(&batch, f->batchSrc, f->batchDst, BENCH_BATCH_FRAMES);
+    }});
+    batch.op = BATCH_OP_I420_TO_NV21;
+    cases.push_back({"I420ToNV21Batch", yuv * 2, BENCH_BATCH_FRAMES, [=] {
+        runBatch(&batch, f->batchSrc, f->batchDst, BENCH_BATCH_FRAMES);
+    }});
+    batch.op = BATCH_OP_NV21_SCALE;
+    batch.dstWidth = scaleWidth;
+    batch.dstHeight = scaleHeight;
+    batch.mode = 2;
+    cases.push_back({"NV21ScaleBatch", yuv + scaledYuv, BENCH_BATCH_FRAMES, [=] {
+        runBatch(&batch, f->batchSrc, f->batchDst, BENCH_BATCH_FRAMES);
+    }});
+
+    // 提交到任务流并等待，与同步调用的差值即任务调度的开销
+    BatchOp job = {};
+    job.op = BATCH_OP_NV21_TO_I420;
+    job.width = w;
+    job.height = h;
+    cases.push_back({"submitJob", yuv * 2, 1, [=] {
+        uint8_t *src = f->nv21;
+        uint8_t *dst = f->dst;
+        int64_t id = submitJob(assets->jobStream, &job, &src, &dst, 1);
+        waitJob(assets->jobStream, id, -1);
+    }});
+    return cases;
+}
+
+/**
+ * 正确性检查：分带并行、变换方案、处理图、批量处理的结果与单线程整帧处理逐字节比较
+ *
+ * 分辨率的色度宽高为奇数、不按SIMD宽度和分带单位对齐，且足够大，VERIFY_THREADS 个线程时能切成多带
+ */
+#define VERIFY_THREADS 4
+
+static const Resolution kVerifyResolutions[] = {
+        {1282, 722},
+        {642,  482},
+};
+
+struct VerifyContext {
+    BenchFrames *frames;
+    BenchAssets *assets;
+    const char *cpu;
+    const std::string *filter;
+};
+
+/**
+ * 输出数据填充为固定内容，同一个测试项的两次运行从相同的初始数据开始（部分操作直接在目标数据上处理）
+ */
+static void resetOutputs(BenchFrames *f) {
+    uint32_t seed = sSeed;
+    sSeed = 7;
+    fillRandom(f->dst, f->yuvSize);
+    fillRandom(f->argbDst, f->argbSize);
+    for (int i = 0; i < BENCH_BATCH_FRAMES; i++) {
+        fillRandom(f->batchDst[i], f->yuvSize);
+    }
+    sSeed = seed;
+}
+
+/**
+ * 测试项可能写入的全部输出
+ */
+struct FrameOutputs {
+    std::vector<uint8_t> dst;
+    std::vector<uint8_t> argbDst;
+    std::vector<uint8_t> batchDst[BENCH_BATCH_FRAMES];
+};
+
+static void saveOutputs(const BenchFrames *f, FrameOutputs *outputs) {
+    outputs->dst.assign(f->dst, f->dst + f->yuvSize);
+    outputs->argbDst.assign(f->argbDst, f->argbDst + f->argbSize);
+    for (int i = 0; i < BENCH_BATCH_FRAMES; i++) {
+        outputs->batchDst[i].assign(f->batchDst[i], f->batchDst[i] + f->yuvSize);
+    }
+}
+
+/**
+ * 逐字节比较，不一致时输出第一个不同的位置
+ *
+ * @return 0一致，1不一致
+ */
+static int compareOutput(const VerifyContext &ctx, const std::string &name, const uint8_t *expected,
+                         const uint8_t *actual, size_t size) {
+    if (memcmp(expected, actual, size) == 0) {
+        return 0;
+    }
+    size_t offset = 0;
+    while (expected[offset] == actual[offset]) {
+        offset++;
+    }
+    fprintf(stderr, "MISMATCH %-32s %4dx%-4d %-4s offset %zu of %zu: expected %d, got %d\n",
+            name.c_str(), ctx.frames->width, ctx.frames->height, ctx.cpu, offset, size,
+            expected[offset], actual[offset]);
+    return 1;
+}
+
+static bool verifySelected(const VerifyContext &ctx, const std::string &name) {
+    return name.find(*ctx.filter) != std::string::npos;
+}
+
+/**
+ * 各测试项 VERIFY_THREADS 个线程分带执行的结果与单线程执行比较
+ */
+static int verifyBands(const VerifyContext &ctx, const std::vector<BenchCase> &cases) {
+    int mismatches = 0;
+    BenchFrames *f = ctx.frames;
+    FrameOutputs expected;
+    for (const BenchCase &bench : cases) {
+        if (!verifySelected(ctx, bench.name)) {
+            continue;
+        }
+        setParallelThreadCount(1);
+        resetOutputs(f);
+        bench.run();
+        saveOutputs(f, &expected);
+        setParallelThreadCount(VERIFY_THREADS);
+        resetOutputs(f);
+        bench.run();
+        int diff = compareOutput(ctx, bench.name, expected.dst.data(), f->dst, f->yuvSize) +
+                   compareOutput(ctx, bench.name, expected.argbDst.data(), f->argbDst,
+                                 f->argbSize);
+        for (int i = 0; i < BENCH_BATCH_FRAMES; i++) {
+            diff += compareOutput(ctx, bench.name, expected.batchDst[i].data(), f->batchDst[i],
+                                  f->yuvSize);
+        }
+        mismatches += diff > 0;
+    }
+    return mismatches;
+}
+
+/**
+ * 逐步整帧处理的结果：裁剪、转为I420、缩放、顺时针旋转90度，与 transformArgsOf 的参数一致；
+ * overlay 不为空时再转为NV21并叠加图层
+ */
+static std::vector<uint8_t> wholeFrameTransform(const BenchFrames *f, const TransformArgs &t,
+                                                const YuvOverlay *overlay) {
+    size_t cropSize = (size_t) t.cropWidth * t.cropHeight * 3 / 2;
+    size_t dstSize = (size_t) t.dstWidth * t.dstHeight * 3 / 2;
+    std::vector<uint8_t> crop(cropSize);
+    std::vector<uint8_t> planar(cropSize);
+    std::vector<uint8_t> scaled(dstSize);
+    std::vector<uint8_t> rotated(dstSize);
+    nv21CutData(crop.data(), f->nv21, t.cropX, t.cropY, t.cropWidth, t.cropHeight, f->width,
+                f->height);
+    nv21ToI420(crop.data(), planar.data(), t.cropWidth, t.cropHeight, false);
+    // 缩小时先缩放再旋转，缩放后的宽高是旋转后的高宽
+    int scaleWidth = t.dstHeight;
+    int scaleHeight = t.dstWidth;
+    i420Scale(planar.data(), t.cropWidth, t.cropHeight, scaled.data(), scaleWidth, scaleHeight, 2,
+              false);
+    size_t ySize = (size_t) scaleWidth * scaleHeight;
+    size_t uvSize = ySize / 4;
+    libyuv::I420Rotate(scaled.data(), scaleWidth, scaled.data() + ySize, scaleWidth / 2,
+                       scaled.data() + ySize + uvSize, scaleWidth / 2, rotated.data(),
+                       t.dstWidth, rotated.data() + ySize, t.dstWidth / 2,
+                       rotated.data() + ySize + uvSize, t.dstWidth / 2, scaleWidth, scaleHeight,
+                       libyuv::kRotate90);
+    if (overlay == nullptr) {
+        return rotated;
+    }
+    std::vector<uint8_t> nv21(dstSize);
+    i420ToNV21(rotated.data(), nv21.data(), t.dstWidth, t.dstHeight, false);
+    nv21BlendOverlay(nv21.data(), t.dstWidth, t.dstHeight, overlay, 32, 32);
+    return nv21;
+}
+
+/**
+ * 变换方案、处理图在单线程和 VERIFY_THREADS 个线程下的结果与逐步整帧处理比较
+ */
+static int verifyPipelines(const VerifyContext &ctx, TransformPlan *plan, YuvGraph *graph) {
+    int mismatches = 0;
+    BenchFrames *f = ctx.frames;
+    TransformArgs t = transformArgsOf(f->width, f->height);
+    size_t dstSize = (size_t) t.dstWidth * t.dstHeight * 3 / 2;
+    setParallelThreadCount(1);
+    std::vector<uint8_t> expected = wholeFrameTransform(f, t, nullptr);
+    std::vector<uint8_t> expectedGraph = wholeFrameTransform(f, t, ctx.assets->overlay);
+    std::vector<uint8_t> actual(dstSize);
+    const int threads[] = {1, VERIFY_THREADS};
+    for (int count : threads) {
+        setParallelThreadCount(count);
+        std::string suffix = "/threads" + std::to_string(count);
+        if (verifySelected(ctx, "YUV420SPTransform")) {
+            memset(actual.data(), 0, dstSize);
+            yuv420spTransform(f->nv21, f->width, f->height, f->width, f->height, YUV_FORMAT_NV21,
+                              t.cropX, t.cropY, t.cropWidth, t.cropHeight, 90, actual.data(),
+                              t.dstWidth, t.dstHeight, t.dstWidth, t.dstHeight, YUV_FORMAT_I420,
+                              2);
+            mismatches += compareOutput(ctx, "YUV420SPTransform" + suffix, expected.data(),
+                                        actual.data(), dstSize);
+        }
+        if (verifySelected(ctx, "executeTransformPlan")) {
+            memset(actual.data(), 0, dstSize);
+            executeTransformPlan(plan, f->nv21, actual.data());
+            mismatches += compareOutput(ctx, "executeTransformPlan" + suffix, expected.data(),
+                                        actual.data(), dstSize);
+        }
+        if (verifySelected(ctx, "executeGraph")) {
+            memset(actual.data(), 0, dstSize);
+            executeGraph(graph, f->nv21, actual.data());
+            mismatches += compareOutput(ctx, "executeGraph" + suffix, expectedGraph.data(),
+                                        actual.data(), dstSize);
+        }
+    }
+    return mismatches;
+}
+
+/**
+ * 批量处理的一帧用单帧接口处理的结果
+ */
+static void runSingleFrame(const BatchOp &op, int index, uint8_t *src, uint8_t *dst) {
+    switch (op.op) {
+        case BATCH_OP_NV21_TO_I420:
+            nv21ToI420(src, dst, op.width, op.height, op.swapUV);
+            break;
+        case BATCH_OP_I420_TO_NV21:
+            i420ToNV21(src, dst, op.width, op.height, op.swapUV);
+            break;
+        case BATCH_OP_NV21_TO_ARGB:
+            nv21ToArgb(src, dst, op.width, op.height);
+            break;
+        case BATCH_OP_NV21_SCALE:
+            nv21Scale(src, op.width, op.height, dst, op.dstWidth, op.dstHeight, op.mode);
+            break;
+        case BATCH_OP_TRANSFORM_PLAN:
+            executeTransformPlan((TransformPlan *) op.plan, src, dst);
+            break;
+        case BATCH_OP_GRAPH:
+            executeGraph(op.graph, src, dst);
+            break;
+        case BATCH_OP_DRAW_TIMESTAMP:
+            nv21DrawTimestamp(src, op.width, op.height, op.atlas, op.timestamps[index], op.format,
+                              op.x, op.y);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * 批量处理按帧并行（帧数不少于线程数）和逐帧按行并行（只有一帧）的结果与单线程逐帧调用单帧接口比较
+ */
+static int verifyBatches(const VerifyContext &ctx, TransformPlan *plan, YuvGraph *graph) {
+    // 按 BATCH_OP_XXX 的顺序
+    static const char *const kBatchNames[] = {"NV21ToI420Batch", "I420ToNV21Batch",
+                                              "NV21ToArgbBatch", "NV21ScaleBatch",
+                                              "executeTransformPlanBatch",
+                                              "NV21DrawTimestampBatch", "executeGraphBatch"};
+    int mismatches = 0;
+    BenchFrames *f = ctx.frames;
+    int64_t timestamps[BENCH_BATCH_FRAMES];
+    for (int i = 0; i < BENCH_BATCH_FRAMES; i++) {
+        timestamps[i] = 1792000000123LL + i * 1001;
+    }
+    for (int type = BATCH_OP_NV21_TO_I420; type <= BATCH_OP_GRAPH; type++) {
+        const char *name = kBatchNames[type];
+        if (!verifySelected(ctx, name)) {
+            continue;
+        }
+        BatchOp op = {};
+        op.op = type;
+        op.width = f->width;
+        op.height = f->height;
+        op.dstWidth = (f->width * 2 / 3) & ~1;
+        op.dstHeight = (f->height * 2 / 3) & ~1;
+        op.mode = 2;
+        op.plan = plan;
+        op.graph = graph;
+        op.atlas = ctx.assets->atlas;
+        op.timestamps = timestamps;
+        op.format = TIME_FORMAT_DATE_TIME_MS;
+        op.x = 32;
+        op.y = 32;
+        int64_t srcSize;
+        int64_t dstSize;
+        if (batchFrameSize(&op, &srcSize, &dstSize) != 0) {
+            fprintf(stderr, "MISMATCH %s: invalid batch op\n", name);
+            mismatches++;
+            continue;
+        }
+        // 直接在源数据上处理时比较源数据
+        bool inPlace = dstSize == 0;
+        size_t outSize = (size_t) (inPlace ? srcSize : dstSize);
+        std::vector<uint8_t> expected[BENCH_BATCH_FRAMES];
+        setParallelThreadCount(1);
+        for (int i = 0; i < BENCH_BATCH_FRAMES; i++) {
+            expected[i].assign(outSize, 0);
+            if (inPlace) {
+                memcpy(expected[i].data(), f->batchSrc[i], outSize);
+                runSingleFrame(op, i, expected[i].data(), nullptr);
+            } else {
+                runSingleFrame(op, i, f->batchSrc[i], expected[i].data());
+            }
+        }
+        setParallelThreadCount(VERIFY_THREADS);
+        const int counts[] = {1, BENCH_BATCH_FRAMES};
+        for (int count : counts) {
+            std::vector<uint8_t> src[BENCH_BATCH_FRAMES];
+            std::vector<uint8_t> dst[BENCH_BATCH_FRAMES];
+            uint8_t *srcFrames[BENCH_BATCH_FRAMES];
+            uint8_t *dstFrames[BENCH_BATCH_FRAMES];
+            for (int i = 0; i < count; i++) {
+                src[i].assign(f->batchSrc[i], f->batchSrc[i] + srcSize);
+                dst[i].assign(outSize, 0);
+                srcFrames[i] = src[i].data();
+                dstFrames[i] = dst[i].data();
+            }
+            std::string batchName = std::string(name) + "/frames" + std::to_string(count);
+            if (runBatch(&op, srcFrames, inPlace ? nullptr : dstFrames, count) != 0) {
+                fprintf(stderr, "MISMATCH %s: runBatch failed\n", batchName.c_str());
+                mismatches++;
+                continue;
+            }
+            for (int i = 0; i < count; i++) {
+                mismatches += compareOutput(ctx, batchName, expected[i].data(),
+                                            inPlace ? srcFrames[i] : dstFrames[i], outSize);
+            }
+        }
+    }
+    return mismatches;
+}
+
+/**
+ * 在 kVerifyResolutions 的每个分辨率、--cpu 指定的每种CPU模式下执行全部检查，结束后恢复 --threads 指定的线程数
+ *
+ * @return 不一致的结果数
+ */
+static int verifyOutputs(BenchAssets *assets, const BenchOptions &options) {
+    int mismatches = 0;
+    for (const Resolution &resolution : kVerifyResolutions) {
+        BenchFrames frames;
+        initFrames(&frames, resolution.width, resolution.height);
+        std::vector<TransformPlan *> plans;
+        std::vector<YuvGraph *> graphs;
+        std::vector<BenchCase> cases = buildCases(&frames, assets, &plans, &graphs);
+        // 与逐步整帧处理比较的方案、处理图，处理图输出NV21，覆盖叠加图层后的格式转换
+        TransformArgs t = transformArgsOf(resolution.width, resolution.height);
+        TransformPlan *plan = createTransformPlan(resolution.width, resolution.height,
+                                                  resolution.width, resolution.height,
+                                                  YUV_FORMAT_NV21, t.cropX, t.cropY, t.cropWidth,
+                                                  t.cropHeight, 90, t.dstWidth, t.dstHeight,
+                                                  t.dstWidth, t.dstHeight, YUV_FORMAT_I420, 2);
+        YuvGraph *graph = createGraph(resolution.width, resolution.height, resolution.width,
+                                      resolution.height, YUV_FORMAT_NV21);
+        if (plan == nullptr || graph == nullptr ||
+            graphCrop(graph, t.cropX, t.cropY, t.cropWidth, t.cropHeight) != 0 ||
+            graphScale(graph, t.dstHeight, t.dstWidth, 2) != 0 || graphRotate(graph, 90) != 0 ||
+            graphOverlay(graph, assets->overlay, 32, 32) != 0 ||
+            prepareGraph(graph, 0, 0, YUV_FORMAT_NV21) <= 0) {
+            fprintf(stderr, "create verify plan or graph failed\n");
+            exit(1);
+        }
+        for (const CpuMode &mode : kCpuModes) {
+            if (options.cpu != "all" && options.cpu != mode.name) {
+                continue;
+            }
+            maskCpuFlags(mode.mask);
+            VerifyContext ctx = {&frames, assets, mode.name, &options.filter};
+            mismatches += verifyBands(ctx, cases);
+            mismatches += verifyPipelines(ctx, plan, graph);
+            mismatches += verifyBatches(ctx, plan, graph);
+        }
+        maskCpuFlags(-1);
+        releaseTransformPlan(plan);
+        releaseGraph(graph);
+        for (TransformPlan *benchPlan : plans) {
+            releaseTransformPlan(benchPlan);
+        }
+        for (YuvGraph *benchGraph : graphs) {
+            releaseGraph(benchGraph);
+        }
+        releaseFrames(&frames);
+    }
+    setParallelThreadCount(options.threads);
+    return mismatches;
+}
+
+struct BenchResult {
+    std::string name;
+    int width;
+    int height;
+    const char *cpu;
+    int cpuFlags;
+    int64_t iterations;
+    double nsPerFrame;
+    double gbPerSecond;
+};
+
+static BenchResult runCase(const BenchCase &bench, const BenchFrames &frames,
+                           const CpuMode &mode, int minTimeMs) {
+    // 预热一次，排除首次调用的缓存、临时内存分配
+    bench.run();
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> elapsed(0);
+    int64_t iterations = 0;
+    do {
+        bench.run();
+        iterations++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (iterations < 3 || elapsed.count() < minTimeMs * 1e6);
+
+    BenchResult result;
+    result.name = bench.name;
+    result.width = frames.width;
+    result.height = frames.height;
+    result.cpu = mode.name;
+    result.cpuFlags = getCpuFlags();
+    result.iterations = iterations * bench.frames;
+    result.nsPerFrame = elapsed.count() / (double) result.iterations;
+    result.gbPerSecond = (double) bench.bytes / result.nsPerFrame;
+    return result;
+}
+
+static void writeJson(FILE *out, const std::vector<BenchResult> &results,
+                      const BenchOptions &options) {
+    fprintf(out, "{\n  \"context\": {\"threads\": %d, \"min_time_ms\": %d, \"cpu_flags\": %d},\n",
+            getParallelThreadCount(), options.minTimeMs, getCpuFlags());
+    fprintf(out, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult &r = results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"width\": %d, \"height\": %d, \"cpu\": \"%s\", "
+                     "\"cpu_flags\": %d, \"iterations\": %lld, \"ns_per_frame\": %.0f, "
+                     "\"gb_per_s\": %.3f}%s\n",
+                r.name.c_str(), r.width, r.height, r.cpu, r.cpuFlags, (long long) r.iterations,
+                r.nsPerFrame, r.gbPerSecond, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static void usage() {
+    fprintf(stderr, "usage: yuv-benchmark [--filter name] [--resolution WxH]... "
+                    "[--cpu simd|c|all] [--min-time-ms ms] [--threads n] [--output file] "
+                    "[--trace file] [--verify on|off|only]\n");
+}
+
+static bool parseOptions(int argc, char **argv, BenchOptions *options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char *value = argv[++i];
+        if (arg == "--filter") {
+            options->filter = value;
+        } else if (arg == "--resolution") {
+            Resolution resolution;
+            if (sscanf(value, "%dx%d", &resolution.width, &resolution.height) != 2 ||
+                resolution.width < 64 || resolution.height < 64) {
+                return false;
+            }
+            resolution.width &= ~1;
+            resolution.height &= ~1;
+            options->resolutions.push_back(resolution);
+        } else if (arg == "--cpu") {
+            options->cpu = value;
+        } else if (arg == "--min-time-ms") {
+            options->minTimeMs = atoi(value);
+        } else if (arg == "--threads") {
+            options->threads = atoi(value);
+        } else if (arg == "--output") {
+            options->output = value;
+        } else if (arg == "--trace") {
+            options->trace = value;
+        } else if (arg == "--verify") {
+            options->verify = value;
+        } else {
+            return false;
+        }
+    }
+    if (options->resolutions.empty()) {
+        options->resolutions.assign(std::begin(kResolutions), std::end(kResolutions));
+    }
+    if (options->verify != "on" && options->verify != "off" && options->verify != "only") {
+        return false;
+    }
+    return options->cpu == "all" || options->cpu == "simd" || options->cpu == "c";
+}
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, &options)) {
+        usage();
+        return 1;
+    }
+    // 与 JNI_OnLoad 一致，libyuv的行缓冲使用 scratch arena
+    installScratchArena();
+    if (options.threads > 0) {
+        setParallelThreadCount(options.threads);
+    }
+    if (options.trace != nullptr) {
+        yuvtrace::setTraceEnabled(true);
+    }
+    BenchAssets assets;
+    initAssets(&assets);
+    if (options.verify != "off") {
+        int mismatches = verifyOutputs(&assets, options);
+        if (mismatches > 0) {
+            fprintf(stderr, "%d outputs differ from the single-threaded whole-frame path\n",
+                    mismatches);
+            releaseAssets(&assets);
+            return 1;
+        }
+        fprintf(stderr, "verify passed\n");
+        if (options.verify == "only") {
+            releaseAssets(&assets);
+            return 0;
+        }
+    }
+
+    std::vector<BenchResult> results;
+    for (const Resolution &resolution : options.resolutions) {
+        BenchFrames frames;
+        initFrames(&frames, resolution.width, resolution.height);
+        std::vector<TransformPlan *> plans;
+        std::vector<YuvGraph *> graphs;
+        std::vector<BenchCase> cases = buildCases(&frames, &assets, &plans, &graphs);
+        for (const CpuMode &mode : kCpuModes) {
+            if (options.cpu != "all" && options.cpu != mode.name) {
+                continue;
+            }
+            maskCpuFlags(mode.mask);
+            for (const BenchCase &bench : cases) {
+                if (bench.name.find(options.filter) == std::string::npos) {
+                    continue;
+                }
+                BenchResult result = runCase(bench, frames, mode, options.minTimeMs);
+                fprintf(stderr, "%-32s %4dx%-4d %-4s %12.0f ns %8.3f GB/s\n", result.name.c_str(),
+                        result.width, result.height, result.cpu, result.nsPerFrame,
+                        result.gbPerSecond);
+                results.push_back(result);
+            }
+        }
+        maskCpuFlags(-1);
+        for (TransformPlan *plan : plans) {
+            releaseTransformPlan(plan);
+        }
+        for (YuvGraph *graph : graphs) {
+            releaseGraph(graph);
+        }
+        releaseFrames(&frames);
+    }
+    releaseAssets(&assets);
+    if (options.trace != nullptr) {
+        yuvtrace::setTraceEnabled(false);
+        // 每个线程只保留最近的事件，完整的一次调用可配合 --filter、--min-time-ms 缩小范围
+        if (yuvtrace::dumpTrace(options.trace) < 0) {
+            fprintf(stderr, "open %s failed\n", options.trace);
+        }
+    }
+    if (libyuv::ProfileEnabled()) {
+        // 以 -DYUV_PROFILE=ON 编译时，输出所有测试项合计的行函数统计，可配合 --filter 只看一个操作
+        std::vector<char> profile(64 * 1024);
+        formatKernelProfile(profile.data(), (int) profile.size());
+        fputs(profile.data(), stderr);
+    }
+
+    FILE *out = options.output == nullptr ? stdout : fopen(options.output, "w");
+    if (out == nullptr) {
+        fprintf(stderr, "open %s failed\n", options.output);
+        return 1;
+    }
+    writeJson(out, results, options);
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#ifndef YUV_BUFFER_POOL_H
+#define YUV_BUFFER_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 缓冲区首地址的对齐字节数，满足libyuv各平台SIMD的对齐要求
+#define BUFFER_POOL_ALIGN 64
+// 最小规格，更小的申请也按该规格分配
+#define BUFFER_POOL_MIN_SIZE (4 * 1024)
+// 规格数，每个2的幂区间再分4档（1、1.25、1.5、1.75倍），4K~224M
+#define BUFFER_POOL_CLASS_COUNT 64
+// 默认最多缓存的空闲内存字节数，超出后归还的缓冲区直接释放
+#define BUFFER_POOL_DEFAULT_LIMIT (64 * 1024 * 1024)
+
+/**
+ * 缓冲池中的一块内存，header 和数据在同一次分配中，data 按 BUFFER_POOL_ALIGN 对齐
+ */
+struct PoolBuffer {
+    uint8_t *data;
+    // 申请的大小
+    size_t size;
+    // 所属规格的容量，>= size
+    size_t capacity;
+    int sizeClass;
+    // 空闲链表
+    PoolBuffer *next;
+};
+
+/**
+ * 从缓冲池取一块至少 size 字节的内存，有同规格的空闲缓冲区时直接复用，内容未初始化，线程安全
+ *
+ * @return 失败或 size 超出最大规格时返回nullptr
+ */
+PoolBuffer *acquirePoolBuffer(size_t size);
+
+/**
+ * 归还缓冲区，空闲内存未超出上限时留在池中复用，否则直接释放
+ */
+void releasePoolBuffer(PoolBuffer *buffer);
+
+/**
+ * 释放池中所有空闲的缓冲区，不影响已取出的缓冲区
+ */
+void trimBufferPool();
+
+/**
+ * 设置最多缓存的空闲内存字节数，<0恢复默认值，0为不缓存
+ */
+void setBufferPoolLimit(int64_t bytes);
+
+/**
+ * 缓冲池累计向系统分配内存的次数，稳定运行时不应再增长，可用于确认每帧不再分配内存
+ */
+int64_t getBufferPoolAllocCount();
+
+/**
+ * 池中空闲缓冲区占用的字节数
+ */
+int64_t getBufferPoolCachedBytes();
+
+// 单个线程 scratch arena 的容量上限，更大的行缓冲直接 malloc
+#define SCRATCH_ARENA_MAX_SIZE (4 * 1024 * 1024)
+
+/**
+ * 把libyuv内部的行缓冲（align_buffer_64）改为从当前线程的 scratch arena 分配
+ *
+ * 每个线程一块按需增长的连续内存，一次libyuv调用中的缓冲依次向后分配，调用返回时全部归还并从头复用；
+ * 容量不足的那次调用临时 malloc，调用结束后按峰值扩容，之后同尺寸的调用不再分配内存，也不经过malloc的锁。
+ * 需在任何线程使用libyuv之前调用，重复调用无影响
+ */
+void installScratchArena();
+
+/**
+ * scratch arena 累计向系统分配内存的次数（含扩容和超出容量时的临时分配），稳定运行时不再增长
+ */
+int64_t getScratchAllocCount();
+
+#endif //YUV_BUFFER_POOL_H
@@ -0,0 +1,60 @@
+#ifndef YUV_CPU_H
+#define YUV_CPU_H
+
+#include <stdint.h>
+
+// 报告及基准测试的操作数
+#define CPU_OP_COUNT 9
+// 自动选择时最多比较的指令集档位数
+#define CPU_MAX_LEVELS 5
+
+/**
+ * 当前生效的libyuv CPU特性位（检测结果与 maskCpuFlags 的交集），与 Key.CPU_HAS_XXX 对应
+ */
+int getCpuFlags();
+
+/**
+ * 屏蔽CPU特性，用于对比不同SIMD实现的耗时，同 libyuv::MaskCpuFlags：-1恢复全部特性，1只用C实现
+ *
+ * 对之后开始的调用生效，正在执行的转换仍用原来的实现
+ *
+ * @param mask 允许使用的特性位
+ * @return 生效的特性位
+ */
+int maskCpuFlags(int mask);
+
+/**
+ * 在当前设备上按指令集档位（如 AVX2、SSSE3、SSE2、C）依次测试各操作的耗时，选用总耗时最短的档位
+ *
+ * libyuv的特性位为全进程共享，各操作不能分别选择，测试期间其他线程的转换也会受影响，应在开始处理前调用
+ *
+ * @param width 测试图片的宽度
+ * @param height 测试图片的高度
+ * @param iterations 每个操作重复的次数
+ * @return 选用的特性位，失败返回-1
+ */
+int autoSelectCpuFlags(int width, int height, int iterations);
+
+/**
+ * 生成CPU特性报告：检测到及生效的特性位、各操作当前使用的行函数实现，以及最近一次 autoSelectCpuFlags 的耗时
+ *
+ * @return 报告长度（不含结尾的'\0'），超出 size 时被截断
+ */
+int formatCpuReport(char *buf, int size);
+
+/**
+ * 生成行函数统计报告：convert、scale、planar_functions 中每个行函数（含 _Any_ 尾部处理、C实现）及
+ * scratch 分配的调用次数、像素数、耗时，各线程合计后按耗时从高到低排列
+ *
+ * 需以 YUV_PROFILE 编译（libyuv定义 LIBYUV_PROFILE），否则只输出未开启的提示
+ *
+ * @return 报告长度（不含结尾的'\0'），超出 size 时被截断
+ */
+int formatKernelProfile(char *buf, int size);
+
+/**
+ * 清零行函数统计
+ */
+void resetKernelProfile();
+
+#endif //YUV_CPU_H
@@ -0,0 +1,66 @@
+#ifndef YUV_JOB_QUEUE_H
+#define YUV_JOB_QUEUE_H
+
+#include <stdint.h>
+#include "YuvOps.h"
+
+// pollJob、waitJob 的返回值：任务未完成
+#define JOB_PENDING 1
+// pollJob、waitJob 的返回值：任务不存在，或完成后又完成了超过 JOB_RESULT_HISTORY 个任务，结果已被覆盖
+#define JOB_UNKNOWN (-2)
+// 每个任务流最多未完成的任务数，超出时提交会等待
+#define JOB_MAX_PENDING 16
+// 每个任务流保留最近完成的任务结果数
+#define JOB_RESULT_HISTORY 64
+
+struct YuvJobStream;
+
+/**
+ * 创建任务流，同一个任务流的任务在专属的调度线程上按提交顺序依次执行，单个任务内仍按帧、按行在线程池上并行；
+ * 不同任务流之间互不等待，如编码、加水印各用一个任务流
+ *
+ * @return 任务流，失败返回nullptr，使用完需调用 releaseJobStream 释放
+ */
+YuvJobStream *createJobStream();
+
+/**
+ * 提交一个批量处理任务后立即返回，op 及各帧地址在提交时拷贝；帧数据在任务完成前必须保持有效，且不能被修改
+ *
+ * 未完成的任务已有 JOB_MAX_PENDING 个时等待最早的任务完成，生产快于处理时不会无限堆积
+ *
+ * @return 任务ID，从1开始递增，参数错误返回-1
+ */
+int64_t submitJob(YuvJobStream *stream, const BatchOp *op, uint8_t *const *src,
+                  uint8_t *const *dst, int count);
+
+/**
+ * 查询任务结果，不等待
+ *
+ * @return JOB_PENDING 未完成，0成功，-1失败，JOB_UNKNOWN 任务不存在或结果已被覆盖
+ */
+int pollJob(YuvJobStream *stream, int64_t job);
+
+/**
+ * 等待任务完成
+ *
+ * @param timeoutMs 最多等待的毫秒数，<0一直等待
+ * @return 同 pollJob，超时返回 JOB_PENDING
+ */
+int waitJob(YuvJobStream *stream, int64_t job, int timeoutMs);
+
+/**
+ * 最近完成的任务ID，同一个任务流按提交顺序完成，不大于该ID的任务都已完成；没有完成的任务时返回0
+ */
+int64_t getCompletedJob(YuvJobStream *stream);
+
+/**
+ * 任务完成通知的 eventfd（非阻塞），每完成一个任务计数加1，可交给 Looper 监听可读事件；创建失败时返回-1
+ */
+int getJobStreamEventFd(YuvJobStream *stream);
+
+/**
+ * 等待已提交的任务全部完成后释放任务流
+ */
+void releaseJobStream(YuvJobStream *stream);
+
+#endif //YUV_JOB_QUEUE_H
@@ -0,0 +1,594 @@
+#ifndef YUV_OPS_H
+#define YUV_OPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// YUV420数据格式，与 Key.YUV_XXX 对应
+#define YUV_FORMAT_I420 0
+#define YUV_FORMAT_NV12 1
+#define YUV_FORMAT_NV21 2
+
+/**
+ * YUV图片处理的native实现，不依赖JNI，java数组和direct ByteBuffer的JNI接口共用
+ */
+
+/**
+ * RGBA系列数据转I420
+ *
+ * @param type 转换类型 Key.XXX_TO_I420
+ * @param rgba RGBA数据
+ * @param rgbaStride RGBA数据每行的字节数
+ * @param yuv I420数据
+ * @param yStride Y分量每行的字节数
+ * @param uStride U分量每行的字节数
+ * @param vStride V分量每行的字节数
+ * @param width 宽度
+ * @param height 高度
+ * @return 0成功
+ */
+int rgbaToI420(int type, const uint8_t *rgba, int rgbaStride, uint8_t *yuv, int yStride,
+               int uStride, int vStride, int width, int height);
+
+/**
+ * I420转RGBA系列数据
+ *
+ * @param type 转换类型 Key.I420_TO_XXX
+ * @return 0成功
+ */
+int i420ToRgba(int type, const uint8_t *yuv, int yStride, int uStride, int vStride,
+               uint8_t *rgba, int rgbaStride, int width, int height);
+
+/**
+ * 根据转换类型计算RGBA数据每行的字节数
+ */
+int rgbaStrideOf(int type, int width);
+
+int i420ToNV21(const uint8_t *yuv420p, uint8_t *yuv420sp, int width, int height, bool swapUV);
+
+int nv21ToI420(const uint8_t *yuv420sp, uint8_t *yuv420p, int width, int height, bool swapUV);
+
+int argbToNV21(const uint8_t *argb, uint8_t *nv21, int width, int height);
+
+/**
+ * NV12、NV21互相转换，直接在原数据上交换UV分量
+ */
+void nv12ToNV21(uint8_t *yuv, int width, int height);
+
+int nv12ToArgb(const uint8_t *nv12, uint8_t *argb, int width, int height);
+
+int nv21ToArgb(const uint8_t *nv21, uint8_t *argb, int width, int height);
+
+int nv21ToRgb24(const uint8_t *nv21, uint8_t *rgb24, int width, int height);
+
+void nv21Scale(const uint8_t *src, int width, int height, uint8_t *dst, int dstWidth,
+               int dstHeight, int mode);
+
+void i420Scale(const uint8_t *src, int width, int height, uint8_t *dst, int dstWidth,
+               int dstHeight, int mode, bool swapUV);
+
+/**
+ * ARGB（4字节）图片缩放
+ */
+void rgbaScale(const uint8_t *src, int width, int height, uint8_t *dst, int dstWidth,
+               int dstHeight, int mode);
+
+/**
+ * NV21旋转并转为I420
+ *
+ * @param de 旋转角度 Key.ROTATE_XXX
+ */
+void nv21ToI420Rotate(const uint8_t *src, int width, int height, uint8_t *dst, int de,
+                      bool swapUV);
+
+/**
+ * NV21数据添加水印
+ *
+ * @param startX 水印左上角X坐标
+ * @param startY 水印左上角Y坐标
+ * @param waterMark 水印NV21数据，Y分量0x10、UV分量0x80/0xeb的部分视为透明
+ * @param waterMarkW 水印宽度
+ * @param waterMarkH 水印高度
+ * @param yuv 要添加水印的NV21数据
+ * @param yuvW 宽度
+ * @param yuvH 高度
+ */
+void nv21AddWaterMark(int startX, int startY, const uint8_t *waterMark, int waterMarkW,
+                      int waterMarkH, uint8_t *yuv, int yuvW, int yuvH);
+
+/**
+ * 裁剪NV21、NV12数据
+ *
+ * @param tarYuv 裁剪后的数据
+ * @param srcYuv 要裁剪的源数据
+ * @param startW 开始裁剪的Width位置
+ * @param startH 开始裁剪的Height位置
+ * @param cutW 裁剪的Width
+ * @param cutH 裁剪的Height
+ * @param srcW 源数据的Width
+ * @param srcH 源数据的Height
+ */
+void nv21CutData(uint8_t *tarYuv, const uint8_t *srcYuv, int startW, int startH, int cutW,
+                 int cutH, int srcW, int srcH);
+
+/**
+ * NV21数据添加水印并转为YUV420（I420/NV12/NV21），一次遍历直接写入目标内存（如MediaCodec的InputBuffer），不修改源数据
+ *
+ * @param nv21 源NV21数据
+ * @param width 宽度
+ * @param height 高度
+ * @param waterMark 水印NV21数据，透明规则同 nv21AddWaterMark，nullptr时不添加水印
+ * @param waterMarkW 水印宽度
+ * @param waterMarkH 水印高度
+ * @param startX 水印左上角X坐标
+ * @param startY 水印左上角Y坐标
+ * @param dst 目标数据
+ * @param dstStride 目标Y分量每行的字节数
+ * @param dstSliceHeight 目标Y分量的行数（UV分量紧跟其后）
+ * @param dstFormat 目标格式 YUV_FORMAT_XXX
+ * @return 写入目标数据的总长度，-1参数错误
+ */
+int nv21ToYuv420WithWaterMark(const uint8_t *nv21, int width, int height,
+                              const uint8_t *waterMark, int waterMarkW, int waterMarkH,
+                              int startX, int startY, uint8_t *dst, int dstStride,
+                              int dstSliceHeight, int dstFormat);
+
+/**
+ * NV21、NV12数据一次完成裁剪、旋转、缩放，并输出为I420、NV12或NV21，源和目标都支持任意stride
+ *
+ * 裁剪区域按2对齐，保证色度2x2采样不错位；缩放在旋转前还是旋转后做，取决于哪边的像素更少
+ *
+ * @param src 源数据
+ * @param srcWidth 源数据宽度
+ * @param srcHeight 源数据高度
+ * @param srcStride 源数据Y、UV分量每行的字节数
+ * @param srcSliceHeight 源数据Y分量的行数，UV分量紧跟其后
+ * @param srcFormat 源数据格式，YUV_FORMAT_NV12 或 YUV_FORMAT_NV21
+ * @param cropX 裁剪区域左上角X坐标
+ * @param cropY 裁剪区域左上角Y坐标
+ * @param cropWidth 裁剪区域宽度
+ * @param cropHeight 裁剪区域高度
+ * @param rotation 顺时针旋转角度，0、90、180、270
+ * @param dst 目标数据
+ * @param dstWidth 旋转、缩放后的宽度，偶数
+ * @param dstHeight 旋转、缩放后的高度，偶数
+ * @param dstStride 目标Y分量每行的字节数，I420的U、V分量为其一半
+ * @param dstSliceHeight 目标Y分量的行数
+ * @param dstFormat 目标数据格式 YUV_FORMAT_XXX
+ * @param mode 缩放模式 Key.SCALE_MODE_XXX
+ * @return 目标数据的大小 dstStride * dstSliceHeight * 3 / 2，失败返回-1
+ */
+int yuv420spTransform(const uint8_t *src, int srcWidth, int srcHeight, int srcStride,
+                      int srcSliceHeight, int srcFormat, int cropX, int cropY, int cropWidth,
+                      int cropHeight, int rotation, uint8_t *dst, int dstWidth, int dstHeight,
+                      int dstStride, int dstSliceHeight, int dstFormat, int mode);
+
+struct PoolBuffer;
+
+// 变换方案的处理路径
+// 只裁剪，整行拷贝
+#define TRANSFORM_PATH_COPY 0
+// 只缩放且NV12/NV21之间转换，色度按UV对直接缩放
+#define TRANSFORM_PATH_UV_SCALE 1
+// 拆分为平面后旋转、缩放
+#define TRANSFORM_PATH_PLANAR 2
+
+/**
+ * 固定几何参数的裁剪、旋转、缩放方案，类似FFTW的plan：创建时完成参数校验、裁剪偏移、处理路径、
+ * 缩放/旋转顺序的计算并预留临时内存，之后每帧只传入数据地址执行
+ */
+struct TransformPlan {
+    int path;
+    int srcFormat;
+    int srcStride;
+    int srcUVStride;
+    // 裁剪区域在源数据中的偏移，NV12/NV21的U、V偏移都指向交织的色度
+    size_t srcYOffset;
+    size_t srcUOffset;
+    size_t srcVOffset;
+    int cropWidth;
+    int cropHeight;
+    int rotation;
+    int mode;
+    int dstWidth;
+    int dstHeight;
+    int dstStride;
+    int dstUVStride;
+    int dstFormat;
+    // 色度在目标数据中的偏移，dstVOffset 只对I420有效
+    size_t dstUOffset;
+    size_t dstVOffset;
+    // 旋转前的目标大小
+    int scaleWidth;
+    int scaleHeight;
+    bool scale;
+    // 缩小时先缩放再旋转
+    bool scaleFirst;
+    // 临时内存：拆分后的源色度、旋转/缩放的中间结果、NV12/NV21输出前的平面色度
+    size_t srcChromaSize;
+    size_t midSize;
+    size_t outChromaSize;
+    // 执行时源数据至少需要的长度
+    int64_t srcSize;
+    // 目标数据的大小 dstStride * dstSliceHeight * 3 / 2
+    int size;
+    PoolBuffer *scratch;
+};
+
+/**
+ * 创建裁剪、旋转、缩放方案，参数含义同 yuv420spTransform，源数据格式额外支持 YUV_FORMAT_I420
+ * （U、V分量的stride为 srcStride 的一半，V紧跟在U之后）
+ *
+ * @return 方案，参数错误或内存不足返回nullptr，使用完需调用 releaseTransformPlan 释放
+ */
+TransformPlan *createTransformPlan(int srcWidth, int srcHeight, int srcStride,
+                                   int srcSliceHeight, int srcFormat, int cropX, int cropY,
+                                   int cropWidth, int cropHeight, int rotation, int dstWidth,
+                                   int dstHeight, int dstStride, int dstSliceHeight,
+                                   int dstFormat, int mode);
+
+/**
+ * 按方案处理一帧，结果和同样参数的 yuv420spTransform 逐字节一致
+ *
+ * 方案的临时内存在执行期间被占用，同一个方案不能同时在多个线程执行
+ *
+ * @return 目标数据的大小，失败返回-1
+ */
+int executeTransformPlan(TransformPlan *plan, const uint8_t *src, uint8_t *dst);
+
+void releaseTransformPlan(TransformPlan *plan);
+
+/**
+ * android.media.Image YUV_420_888 的三个平面按各自的rowStride、pixelStride打包为I420、NV12或NV21
+ *
+ * 色度pixelStride为2且U、V交织在同一块内存时（绝大多数设备），直接整行拷贝或交换UV
+ *
+ * @param srcY Y平面，已偏移到裁剪区域左上角
+ * @param srcStrideY Y平面每行的字节数
+ * @param srcU U平面，已偏移到裁剪区域左上角
+ * @param srcStrideU U平面每行的字节数
+ * @param srcV V平面，已偏移到裁剪区域左上角
+ * @param srcStrideV V平面每行的字节数
+ * @param srcPixelStrideUV U、V平面相邻像素的间隔字节数
+ * @param dst 目标数据，紧凑排列，stride为width
+ * @param width 宽度
+ * @param height 高度
+ * @param dstFormat 目标格式 YUV_FORMAT_XXX
+ * @return 目标数据的大小，失败返回-1
+ */
+int android420ToYuv(const uint8_t *srcY, int srcStrideY, const uint8_t *srcU, int srcStrideU,
+                    const uint8_t *srcV, int srcStrideV, int srcPixelStrideUV, uint8_t *dst,
+                    int width, int height, int dstFormat);
+
+/**
+ * android420ToYuv 输出数据的大小，宽高为奇数时色度向上取整
+ */
+int android420SizeOf(int width, int height);
+
+/**
+ * 带透明通道的叠加图层（水印、点击提示、光标等），创建时转为YUV和alpha平面，每帧叠加时直接使用
+ */
+struct YuvOverlay {
+    // 宽高，按2对齐
+    int width;
+    int height;
+    // Y分量及其alpha，width * height
+    uint8_t *y;
+    uint8_t *alphaY;
+    // NV21交织的VU分量及其alpha（2x2下采样后的alpha，V、U各一份），width * height / 2
+    uint8_t *vu;
+    uint8_t *alphaVU;
+};
+
+/**
+ * 通过预乘alpha的RGBA数据（Android Bitmap ARGB_8888 的内存顺序）创建叠加图层
+ *
+ * @param rgba RGBA数据
+ * @param rgbaStride 每行的字节数
+ * @param width 宽度
+ * @param height 高度
+ * @return 叠加图层，失败返回nullptr，使用完需调用 releaseOverlay 释放
+ */
+YuvOverlay *createOverlay(const uint8_t *rgba, int rgbaStride, int width, int height);
+
+void releaseOverlay(YuvOverlay *overlay);
+
+/**
+ * NV21数据上按alpha混合叠加图层，超出图片范围的部分被裁剪
+ *
+ * @param yuv NV21数据
+ * @param width 宽度
+ * @param height 高度
+ * @param overlay 叠加图层
+ * @param x 图层左上角X坐标，按2对齐
+ * @param y 图层左上角Y坐标，按2对齐
+ */
+void nv21BlendOverlay(uint8_t *yuv, int width, int height, const YuvOverlay *overlay, int x,
+                      int y);
+
+// 时间水印格式，对应 DateUtils.DATE_TIME、DateUtils.DATE_TIME_MS
+#define TIME_FORMAT_DATE_TIME 0
+#define TIME_FORMAT_DATE_TIME_MS 1
+
+// 字形表按ASCII码索引
+#define GLYPH_ATLAS_SIZE 128
+
+/**
+ * 字形表：数字、分隔符等字符预先渲染并转为带alpha的YUV图层，常驻内存，逐字叠加到帧上
+ */
+struct GlyphAtlas {
+    // 所有字形中最大的高度
+    int height;
+    YuvOverlay *glyphs[GLYPH_ATLAS_SIZE];
+};
+
+GlyphAtlas *createGlyphAtlas();
+
+void releaseGlyphAtlas(GlyphAtlas *atlas);
+
+/**
+ * 向字形表中添加一个字形，已存在的同名字形会被替换
+ *
+ * @param glyph 字符，仅支持ASCII
+ * @param rgba 字符渲染结果，预乘alpha的RGBA数据
+ * @return 0成功，-1失败
+ */
+int glyphAtlasAddGlyph(GlyphAtlas *atlas, char glyph, const uint8_t *rgba, int rgbaStride,
+                       int width, int height);
+
+/**
+ * 计算字符串绘制后的宽度，字形表中没有的字符不占宽度
+ */
+int glyphAtlasMeasureText(const GlyphAtlas *atlas, const char *text);
+
+/**
+ * NV21数据上逐字叠加字符串，超出图片范围的部分被裁剪
+ *
+ * @param x 左上角X坐标，按2对齐
+ * @param y 左上角Y坐标，按2对齐
+ * @return 绘制的宽度
+ */
+int nv21DrawText(uint8_t *yuv, int width, int height, const GlyphAtlas *atlas, const char *text,
+                 int x, int y);
+
+/**
+ * 按本地时区格式化时间戳
+ *
+ * @param timestamp 时间戳 ms
+ * @param format TIME_FORMAT_DATE_TIME 或 TIME_FORMAT_DATE_TIME_MS
+ * @param buf 输出缓冲区，至少 24 字节
+ * @return 字符串长度，失败返回-1
+ */
+int formatTimestamp(int64_t timestamp, int format, char *buf, int bufSize);
+
+/**
+ * NV21数据上叠加时间水印，时间字符串在native格式化，每帧不产生Bitmap及Java对象
+ *
+ * @return 绘制的宽度，失败返回-1
+ */
+int nv21DrawTimestamp(uint8_t *yuv, int width, int height, const GlyphAtlas *atlas,
+                      int64_t timestamp, int format, int x, int y);
+
+// 处理图节点的类型
+#define GRAPH_NODE_CROP 0
+#define GRAPH_NODE_SCALE 1
+#define GRAPH_NODE_ROTATE 2
+#define GRAPH_NODE_OVERLAY 3
+// 一个处理图最多的节点数
+#define GRAPH_MAX_NODES 16
+// 流式执行时每带输出的目标像素数，各节点的中间结果留在缓存中
+#define GRAPH_STRIP_PIXELS (32 * 1024)
+
+/**
+ * 处理图中的一个节点，输入为上一个节点（第一个节点为源数据）的输出，输出为宽高都是偶数的I420
+ */
+struct GraphNode {
+    int type;
+    // 输出大小
+    int width;
+    int height;
+    // 裁剪区域、图层叠加区域（已裁剪到图片范围内）左上角坐标
+    int x;
+    int y;
+    // 缩放模式 Key.SCALE_MODE_XXX
+    int mode;
+    // 顺时针旋转角度
+    int rotation;
+    // 图层叠加区域的宽高，及拷贝的Y、alpha、U、V、色度alpha平面，stride为 blendWidth、blendWidth / 2
+    int blendWidth;
+    int blendHeight;
+    uint8_t *planes;
+    // 缩放按周期切带：每 srcUnit 行输入对应 dstUnit 行输出，0为不能切带
+    int srcUnit;
+    int dstUnit;
+    // 需要整帧处理（旋转、不能切带的缩放、与上游切带边界不对齐的裁剪），是一段流式执行的终点
+    bool whole;
+    // 每带临时内存中本节点输出的偏移
+    size_t stripOffset;
+    // 整帧临时内存中本节点输出、整帧输入的偏移
+    size_t frameOffset;
+    size_t inputOffset;
+};
+
+/**
+ * 两个整帧节点之间按带流式执行的一段
+ */
+struct GraphSegment {
+    // 段内流式节点 [begin, end)
+    int begin;
+    int end;
+    // 段的输入：-1为源数据，否则为该整帧节点的输出
+    int input;
+    // 段的终点：整帧节点序号，nodeCount 为输出到目标数据
+    int sink;
+    // 段输出的行数、切带的行数单位及每带的行数
+    int rows;
+    int unit;
+    int stripRows;
+    // 每行输出大约处理的像素数，用于估算并行的工作量
+    int64_t rowPixels;
+    // 每带临时内存中源数据拆分的色度、NV12/NV21输出前的平面色度的偏移
+    size_t srcChromaOffset;
+    size_t dstChromaOffset;
+    size_t stripSize;
+};
+
+/**
+ * 声明式的处理图：裁剪、缩放、旋转、叠加图层组成的链，创建时描述一次，prepareGraph 时划分流式执行的段并预留临时内存；
+ * 执行时每段按带（几十行）依次经过段内所有节点，中间结果只有一带大小，留在缓存中，多个带在线程池上并行，
+ * 多步处理的内存带宽接近单次遍历
+ */
+struct YuvGraph {
+    int srcWidth;
+    int srcHeight;
+    int srcStride;
+    int srcSliceHeight;
+    int srcFormat;
+    int srcUVStride;
+    // 开头的裁剪节点合并到读取源数据的偏移中
+    int cropX;
+    int cropY;
+    size_t srcYOffset;
+    size_t srcUOffset;
+    size_t srcVOffset;
+    int cropWidth;
+    int cropHeight;
+    int nodeCount;
+    GraphNode nodes[GRAPH_MAX_NODES];
+    int segmentCount;
+    GraphSegment segments[GRAPH_MAX_NODES + 1];
+    int dstStride;
+    int dstUVStride;
+    int dstFormat;
+    size_t dstUOffset;
+    size_t dstVOffset;
+    // 执行时源数据至少需要的长度
+    int64_t srcSize;
+    // 目标数据的大小 dstStride * dstSliceHeight * 3 / 2，0为还未 prepareGraph
+    int size;
+    // 整帧节点的中间结果
+    PoolBuffer *frames;
+};
+
+/**
+ * 创建处理图，源数据参数含义同 createTransformPlan，源数据宽高为奇数时忽略最后一列、一行
+ *
+ * @return 处理图，参数错误或内存不足返回nullptr，使用完需调用 releaseGraph 释放
+ */
+YuvGraph *createGraph(int srcWidth, int srcHeight, int srcStride, int srcSliceHeight,
+                      int srcFormat);
+
+/**
+ * 追加裁剪节点，区域按2对齐
+ *
+ * @return 0成功，-1参数错误、节点已满或已经 prepareGraph
+ */
+int graphCrop(YuvGraph *graph, int x, int y, int width, int height);
+
+/**
+ * 追加缩放节点
+ *
+ * @param width 缩放后的宽度，偶数
+ * @param height 缩放后的高度，偶数
+ * @param mode 缩放模式 Key.SCALE_MODE_XXX
+ * @return 0成功，-1失败
+ */
+int graphScale(YuvGraph *graph, int width, int height, int mode);
+
+/**
+ * 追加旋转节点，旋转需要整帧输入，是流式执行的分段点
+ *
+ * @param rotation 顺时针旋转角度，0、90、180、270，0不追加节点
+ * @return 0成功，-1失败
+ */
+int graphRotate(YuvGraph *graph, int rotation);
+
+/**
+ * 追加叠加图层节点，图层数据在追加时拷贝，之后可以释放图层；完全超出图片范围时不追加节点
+ *
+ * @param x 图层左上角X坐标，按2对齐
+ * @param y 图层左上角Y坐标，按2对齐
+ * @return 0成功，-1失败
+ */
+int graphOverlay(YuvGraph *graph, const YuvOverlay *overlay, int x, int y);
+
+/**
+ * 指定输出格式，划分流式执行的段并预留整帧中间结果的内存，之后不能再追加节点
+ *
+ * @param dstStride 目标Y分量每行的字节数，I420的U、V分量为其一半，<=0为输出宽度
+ * @param dstSliceHeight 目标Y分量的行数，<=0为输出高度
+ * @param dstFormat 目标格式 YUV_FORMAT_XXX
+ * @return 目标数据的大小 dstStride * dstSliceHeight * 3 / 2，失败返回-1
+ */
+int prepareGraph(YuvGraph *graph, int dstStride, int dstSliceHeight, int dstFormat);
+
+/**
+ * 最后一个节点输出的宽高
+ */
+void graphOutputSize(const YuvGraph *graph, int *width, int *height);
+
+/**
+ * 按处理图处理一帧，结果和逐个节点整帧处理逐字节一致；整帧中间结果在执行期间被占用，同一个处理图不能同时在多个线程执行
+ *
+ * @return 目标数据的大小，失败返回-1
+ */
+int executeGraph(YuvGraph *graph, const uint8_t *src, uint8_t *dst);
+
+void releaseGraph(YuvGraph *graph);
+
+// 批量处理、异步任务的操作，与 Key.JOB_XXX 对应
+#define BATCH_OP_NV21_TO_I420 0
+#define BATCH_OP_I420_TO_NV21 1
+#define BATCH_OP_NV21_TO_ARGB 2
+#define BATCH_OP_NV21_SCALE 3
+#define BATCH_OP_TRANSFORM_PLAN 4
+#define BATCH_OP_DRAW_TIMESTAMP 5
+#define BATCH_OP_GRAPH 6
+// 一次批量处理最多的帧数，与 Key.BATCH_MAX_FRAMES 对应
+#define BATCH_MAX_FRAMES 64
+
+/**
+ * 批量处理的操作及每帧相同的参数，各字段含义同对应的单帧接口
+ */
+struct BatchOp {
+    int op;
+    int width;
+    int height;
+    // NV21_SCALE
+    int dstWidth;
+    int dstHeight;
+    int mode;
+    // NV21_TO_I420、I420_TO_NV21
+    bool swapUV;
+    // TRANSFORM_PLAN，只读取方案参数，不占用方案的临时内存
+    const TransformPlan *plan;
+    // GRAPH，处理图的中间结果同一时间只能被一帧使用，各帧依次执行
+    YuvGraph *graph;
+    // DRAW_TIMESTAMP，每帧一个时间戳，直接在源数据上绘制
+    const GlyphAtlas *atlas;
+    const int64_t *timestamps;
+    int format;
+    int x;
+    int y;
+};
+
+/**
+ * 批量处理时每帧源数据、目标数据的大小，用于检查打包在同一个数组中的各帧；直接在源数据上处理的操作 dstSize 为0
+ *
+ * @return 0成功，参数错误返回-1
+ */
+int batchFrameSize(const BatchOp *op, int64_t *srcSize, int64_t *dstSize);
+
+/**
+ * 对 count 帧执行同一个操作，每帧结果和单帧接口逐字节一致
+ *
+ * 帧数不少于线程数或单帧太小、帧内分带用不满线程时按帧并行，否则逐帧执行、帧内按行并行
+ *
+ * @param src 每帧的源数据
+ * @param dst 每帧的目标数据，DRAW_TIMESTAMP 不使用
+ * @param count 帧数，不超过 BATCH_MAX_FRAMES
+ * @return 0成功，参数错误或任意一帧失败返回-1
+ */
+int runBatch(const BatchOp *op, uint8_t *const *src, uint8_t *const *dst, int count);
+
+#endif //YUV_OPS_H
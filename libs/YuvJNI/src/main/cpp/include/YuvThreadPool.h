@@ -0,0 +1,36 @@
+#ifndef YUV_THREAD_POOL_H
+#define YUV_THREAD_POOL_H
+
+#include <stdint.h>
+#include <functional>
+
+// 每个分带至少处理的像素数，小图切分的线程调度开销大于收益，留在调用线程执行
+#define PARALLEL_MIN_BAND_PIXELS (128 * 1024)
+// 工作线程数上限（不含调用线程）
+#define PARALLEL_MAX_WORKERS 7
+
+/**
+ * 设置并行使用的线程数（含调用线程），1为关闭并行，<=0恢复为CPU核数
+ */
+void setParallelThreadCount(int count);
+
+/**
+ * 当前并行使用的线程数（含调用线程）
+ */
+int getParallelThreadCount();
+
+/**
+ * 把 [0, rows) 按 unit 行对齐切成若干带，在工作线程池和调用线程上并行执行 func(start, end)，全部完成后返回
+ *
+ * 带数由线程数和 rows * rowPixels / PARALLEL_MIN_BAND_PIXELS 共同决定，小图只切一带，直接在调用线程执行；
+ * 在某一带内（含调用线程执行的那一带）嵌套调用时直接在当前线程执行，避免互相等待；rows <= 0 时直接执行 func(0, rows)
+ *
+ * @param rows 总行数
+ * @param unit 每带行数的对齐单位，最后一带包含剩余的行
+ * @param rowPixels 每行的像素数，用于估算工作量
+ * @param func 处理 [start, end) 行，成功返回0
+ * @return 所有带都返回0时为0，否则-1
+ */
+int parallelRows(int rows, int unit, int64_t rowPixels, const std::function<int(int, int)> &func);
+
+#endif //YUV_THREAD_POOL_H
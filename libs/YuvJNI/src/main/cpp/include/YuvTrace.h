@@ -0,0 +1,9 @@
+#ifndef YUV_TRACE_H
+#define YUV_TRACE_H
+
+// yuv-jni 的 trace 实例，实现见 libs/NativeTrace，与 framedatacachejni 分开开关、分开导出
+#define NATIVE_TRACE_NAMESPACE yuvtrace
+
+#include "NativeTrace.h"
+
+#endif //YUV_TRACE_H
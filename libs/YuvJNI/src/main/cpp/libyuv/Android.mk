@@ -21,6 +21,7 @@ LOCAL_SRC_FILES := \
     source/convert_to_i420.cc   \
     source/cpu_id.cc            \
     source/planar_functions.cc  \
+    source/profile.cc           \
     source/rotate.cc            \
     source/rotate_any.cc        \
     source/rotate_argb.cc       \
@@ -46,6 +47,8 @@ LOCAL_SRC_FILES := \
     source/scale_msa.cc         \
     source/scale_neon.cc        \
     source/scale_neon64.cc      \
+    source/scale_uv.cc          \
+    source/scratch.cc           \
     source/video_common.cc
 
 common_CFLAGS := -Wall -fexceptions
@@ -0,0 +1,103 @@
+/*
+ *  Copyright 2020 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS. All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef INCLUDE_LIBYUV_PROFILE_H_
+#define INCLUDE_LIBYUV_PROFILE_H_
+
+#include "libyuv/basic_types.h"
+
+#if defined(LIBYUV_PROFILE) && !defined(__x86_64__) && !defined(__i386__) && \
+    !defined(__aarch64__)
+#include <time.h>
+#endif
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// Per-kernel instrumentation of the row function calls in convert.cc,
+// scale.cc and planar_functions.cc. Build with LIBYUV_PROFILE defined to
+// count calls, pixels and cycles for every row function (including the
+// _Any_ tail handlers and C fallbacks, which are separate functions) and
+// for the scratch allocator. Without it PROFILE_ROW is a plain call and the
+// functions below report nothing.
+
+// Counters of one row function on one thread.
+typedef struct ProfileKernel {
+  const void* func;  // Address of the row function, e.g. SplitUVRow_AVX2.
+  const char* name;  // Name of the function pointer at the call site.
+  int thread;        // Index of the thread's counter table.
+  uint64_t calls;
+  uint64_t pixels;  // Sum of the width argument of each call.
+  uint64_t cycles;  // Units of ProfileCycles().
+} ProfileKernel;
+
+// Returns 1 if libyuv was built with LIBYUV_PROFILE.
+LIBYUV_API
+int ProfileEnabled(void);
+
+// Copy up to max_kernels counters, one per kernel and thread, into kernels.
+// Returns the number of counters available, which may exceed max_kernels.
+LIBYUV_API
+int GetProfileKernels(ProfileKernel* kernels, int max_kernels);
+
+// Zero all counters. Calls in flight on other threads may still land.
+LIBYUV_API
+void ResetProfile(void);
+
+// Rate of ProfileCycles() per second, measured on first use.
+LIBYUV_API
+uint64_t GetProfileCyclesPerSecond(void);
+
+// Add one call to the calling thread's counters.
+LIBYUV_API
+void ProfileRecord(const void* func,
+                   const char* name,
+                   int pixels,
+                   uint64_t cycles);
+
+#ifdef LIBYUV_PROFILE
+// Time stamp counter on x86, the generic timer on arm64 (the cycle counter
+// is not readable from user space), nanoseconds elsewhere.
+static __inline uint64_t ProfileCycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  uint32_t lo, hi;
+  asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+  return ((uint64_t)hi << 32) | lo;
+#elif defined(__aarch64__)
+  uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+// Call a row function through a function pointer and record it.
+#define PROFILE_ROW(func, pixels, ...)                       \
+  do {                                                       \
+    uint64_t profile_start_ = ProfileCycles();               \
+    func(__VA_ARGS__);                                       \
+    ProfileRecord((const void*)(func), #func, (int)(pixels), \
+                  ProfileCycles() - profile_start_);         \
+  } while (0)
+#else
+#define PROFILE_ROW(func, pixels, ...) func(__VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
+
+#endif  // INCLUDE_LIBYUV_PROFILE_H_
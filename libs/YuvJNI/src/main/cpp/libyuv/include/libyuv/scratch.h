@@ -0,0 +1,50 @@
+/*
+ *  Copyright 2020 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS. All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef INCLUDE_LIBYUV_SCRATCH_H_
+#define INCLUDE_LIBYUV_SCRATCH_H_
+
+#include <stddef.h>  // For size_t
+
+#include "libyuv/basic_types.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+// Allocator for the temporary row buffers that conversion, scaling and
+// rotation functions use internally (align_buffer_64). Every buffer is
+// released before the libyuv call that allocated it returns.
+typedef void* (*ScratchAllocFunc)(size_t size);
+typedef void (*ScratchFreeFunc)(void* ptr);
+
+// Replace the scratch allocator for the whole process. Passing NULL for
+// either function restores malloc / free. Call it before any thread uses
+// libyuv: changing it while a call is in flight would free that call's
+// buffers with the wrong function. The functions may be called from any
+// thread, so per-thread state (e.g. a thread local arena) is up to them.
+LIBYUV_API
+void SetScratchAllocator(ScratchAllocFunc alloc_func,
+                         ScratchFreeFunc free_func);
+
+// Allocate / free through the current scratch allocator.
+LIBYUV_API
+void* ScratchAlloc(size_t size);
+
+LIBYUV_API
+void ScratchFree(void* ptr);
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
+
+#endif  // INCLUDE_LIBYUV_SCRATCH_H_
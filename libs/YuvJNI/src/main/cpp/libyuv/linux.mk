@@ -29,6 +29,7 @@ LOCAL_OBJ_FILES := \
 	source/mjpeg_decoder.o     \
 	source/mjpeg_validate.o    \
 	source/planar_functions.o  \
+	source/profile.o           \
 	source/rotate_any.o        \
 	source/rotate_argb.o       \
 	source/rotate.o            \
@@ -56,6 +57,8 @@ LOCAL_OBJ_FILES := \
 	source/scale_msa.o         \
 	source/scale_neon64.o      \
 	source/scale_neon.o        \
+	source/scale_uv.o          \
+	source/scratch.o           \
 	source/scale_win.o         \
 	source/video_common.o
 
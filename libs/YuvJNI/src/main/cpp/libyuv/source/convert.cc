@@ -13,6 +13,7 @@
 #include "libyuv/basic_types.h"
 #include "libyuv/cpu_id.h"
 #include "libyuv/planar_functions.h"
+#include "libyuv/profile.h"
 #include "libyuv/rotate.h"
 #include "libyuv/row.h"
 #include "libyuv/scale.h"  // For ScalePlane()
@@ -387,16 +388,17 @@ int I422ToNV21(const uint8_t* src_y,
     uint8_t* row_vu_1 = row_vu_0 + awidth;
 
     for (y = 0; y < height - 1; y += 2) {
-      MergeUVRow(src_v, src_u, row_vu_0, halfwidth);
-      MergeUVRow(src_v + src_stride_v, src_u + src_stride_u, row_vu_1,
-                 halfwidth);
-      InterpolateRow(dst_vu, row_vu_0, awidth, awidth, 128);
+      PROFILE_ROW(MergeUVRow, halfwidth, src_v, src_u, row_vu_0, halfwidth);
+      PROFILE_ROW(MergeUVRow, halfwidth, src_v + src_stride_v,
+                  src_u + src_stride_u, row_vu_1, halfwidth);
+      PROFILE_ROW(InterpolateRow, awidth, dst_vu, row_vu_0, awidth, awidth,
+                  128);
       src_u += src_stride_u * 2;
       src_v += src_stride_v * 2;
       dst_vu += dst_stride_vu;
     }
     if (height & 1) {
-      MergeUVRow(src_v, src_u, dst_vu, halfwidth);
+      PROFILE_ROW(MergeUVRow, halfwidth, src_v, src_u, dst_vu, halfwidth);
     }
     free_aligned_buffer_64(row_vu_0);
   }
@@ -559,13 +561,13 @@ static void CopyPlane2(const uint8_t* src,
 
   // Copy plane
   for (y = 0; y < height - 1; y += 2) {
-    CopyRow(src, dst, width);
-    CopyRow(src + src_stride_0, dst + dst_stride, width);
+    PROFILE_ROW(CopyRow, width, src, dst, width);
+    PROFILE_ROW(CopyRow, width, src + src_stride_0, dst + dst_stride, width);
     src += src_stride_0 + src_stride_1;
     dst += dst_stride * 2;
   }
   if (height & 1) {
-    CopyRow(src, dst, width);
+    PROFILE_ROW(CopyRow, width, src, dst, width);
   }
 }
 
@@ -774,17 +776,19 @@ int YUY2ToI420(const uint8_t* src_yuy2,
 #endif
 
   for (y = 0; y < height - 1; y += 2) {
-    YUY2ToUVRow(src_yuy2, src_stride_yuy2, dst_u, dst_v, width);
-    YUY2ToYRow(src_yuy2, dst_y, width);
-    YUY2ToYRow(src_yuy2 + src_stride_yuy2, dst_y + dst_stride_y, width);
+    PROFILE_ROW(YUY2ToUVRow, width, src_yuy2, src_stride_yuy2, dst_u, dst_v,
+                width);
+    PROFILE_ROW(YUY2ToYRow, width, src_yuy2, dst_y, width);
+    PROFILE_ROW(YUY2ToYRow, width, src_yuy2 + src_stride_yuy2,
+                dst_y + dst_stride_y, width);
     src_yuy2 += src_stride_yuy2 * 2;
     dst_y += dst_stride_y * 2;
     dst_u += dst_stride_u;
     dst_v += dst_stride_v;
   }
   if (height & 1) {
-    YUY2ToUVRow(src_yuy2, 0, dst_u, dst_v, width);
-    YUY2ToYRow(src_yuy2, dst_y, width);
+    PROFILE_ROW(YUY2ToUVRow, width, src_yuy2, 0, dst_u, dst_v, width);
+    PROFILE_ROW(YUY2ToYRow, width, src_yuy2, dst_y, width);
   }
   return 0;
 }
@@ -865,17 +869,19 @@ int UYVYToI420(const uint8_t* src_uyvy,
 #endif
 
   for (y = 0; y < height - 1; y += 2) {
-    UYVYToUVRow(src_uyvy, src_stride_uyvy, dst_u, dst_v, width);
-    UYVYToYRow(src_uyvy, dst_y, width);
-    UYVYToYRow(src_uyvy + src_stride_uyvy, dst_y + dst_stride_y, width);
+    PROFILE_ROW(UYVYToUVRow, width, src_uyvy, src_stride_uyvy, dst_u, dst_v,
+                width);
+    PROFILE_ROW(UYVYToYRow, width, src_uyvy, dst_y, width);
+    PROFILE_ROW(UYVYToYRow, width, src_uyvy + src_stride_uyvy,
+                dst_y + dst_stride_y, width);
     src_uyvy += src_stride_uyvy * 2;
     dst_y += dst_stride_y * 2;
     dst_u += dst_stride_u;
     dst_v += dst_stride_v;
   }
   if (height & 1) {
-    UYVYToUVRow(src_uyvy, 0, dst_u, dst_v, width);
-    UYVYToYRow(src_uyvy, dst_y, width);
+    PROFILE_ROW(UYVYToUVRow, width, src_uyvy, 0, dst_u, dst_v, width);
+    PROFILE_ROW(UYVYToYRow, width, src_uyvy, dst_y, width);
   }
   return 0;
 }
@@ -977,17 +983,19 @@ int ARGBToI420(const uint8_t* src_argb,
 #endif
 
   for (y = 0; y < height - 1; y += 2) {
-    ARGBToUVRow(src_argb, src_stride_argb, dst_u, dst_v, width);
-    ARGBToYRow(src_argb, dst_y, width);
-    ARGBToYRow(src_argb + src_stride_argb, dst_y + dst_stride_y, width);
+    PROFILE_ROW(ARGBToUVRow, width, src_argb, src_stride_argb, dst_u, dst_v,
+                width);
+    PROFILE_ROW(ARGBToYRow, width, src_argb, dst_y, width);
+    PROFILE_ROW(ARGBToYRow, width, src_argb + src_stride_argb,
+                dst_y + dst_stride_y, width);
     src_argb += src_stride_argb * 2;
     dst_y += dst_stride_y * 2;
     dst_u += dst_stride_u;
     dst_v += dst_stride_v;
   }
   if (height & 1) {
-    ARGBToUVRow(src_argb, 0, dst_u, dst_v, width);
-    ARGBToYRow(src_argb, dst_y, width);
+    PROFILE_ROW(ARGBToUVRow, width, src_argb, 0, dst_u, dst_v, width);
+    PROFILE_ROW(ARGBToYRow, width, src_argb, dst_y, width);
   }
   return 0;
 }
@@ -1079,17 +1087,19 @@ int BGRAToI420(const uint8_t* src_bgra,
 #endif
 
   for (y = 0; y < height - 1; y += 2) {
-    BGRAToUVRow(src_bgra, src_stride_bgra, dst_u, dst_v, width);
-    BGRAToYRow(src_bgra, dst_y, width);
-    BGRAToYRow(src_bgra + src_stride_bgra, dst_y + dst_stride_y, width);
+    PROFILE_ROW(BGRAToUVRow, width, src_bgra, src_stride_bgra, dst_u, dst_v,
+                width);
+    PROFILE_ROW(BGRAToYRow, width, src_bgra, dst_y, width);
+    PROFILE_ROW(BGRAToYRow, width, src_bgra + src_stride_bgra,
+                dst_y + dst_stride_y, width);
     src_bgra += src_stride_bgra * 2;
     dst_y += dst_stride_y * 2;
     dst_u += dst_stride_u;
     dst_v += dst_stride_v;
   }
   if (height & 1) {
-    BGRAToUVRow(src_bgra, 0, dst_u, dst_v, width);
-    BGRAToYRow(src_bgra, dst_y, width);
+    PROFILE_ROW(BGRAToUVRow, width, src_bgra, 0, dst_u, dst_v, width);
+    PROFILE_ROW(BGRAToYRow, width, src_bgra, dst_y, width);
   }
   return 0;
 }
@@ -1181,17 +1191,19 @@ int ABGRToI420(const uint8_t* src_abgr,
 #endif
 
   for (y = 0; y < height - 1; y += 2) {
-    ABGRToUVRow(src_abgr, src_stride_abgr, dst_u, dst_v, width);
-    ABGRToYRow(src_abgr, dst_y, width);
-    ABGRToYRow(src_abgr + src_stride_abgr, dst_y + dst_stride_y, width);
+    PROFILE_ROW(ABGRToUVRow, width, src_abgr, src_stride_abgr, dst_u, dst_v,
+                width);
+    PROFILE_ROW(ABGRToYRow, width, src_abgr, dst_y, width);
+    PROFILE_ROW(ABGRToYRow, width, src_abgr + src_stride_abgr,
+                dst_y + dst_stride_y, width);
     src_abgr += src_stride_abgr * 2;
     dst_y += dst_stride_y * 2;
     dst_u += dst_stride_u;
     dst_v += dst_stride_v;
   }
   if (height & 1) {
-    ABGRToUVRow(src_abgr, 0, dst_u, dst_v, width);
-    ABGRToYRow(src_abgr, dst_y, width);
+    PROFILE_ROW(ABGRToUVRow, width, src_abgr, 0, dst_u, dst_v, width);
+    PROFILE_ROW(ABGRToYRow, width, src_abgr, dst_y, width);
   }
   return 0;
 }
@@ -1283,17 +1295,19 @@ int RGBAToI420(const uint8_t* src_rgba,
 #endif
 
   for (y = 0; y < height - 1; y += 2) {
-    RGBAToUVRow(src_rgba, src_stride_rgba, dst_u, dst_v, width);
-    RGBAToYRow(src_rgba, dst_y, width);
-    RGBAToYRow(src_rgba + src_stride_rgba, dst_y + dst_stride_y, width);
+    PROFILE_ROW(RGBAToUVRow, width, src_rgba, src_stride_rgba, dst_u, dst_v,
+                width);
+    PROFILE_ROW(RGBAToYRow, width, src_rgba, dst_y, width);
+    PROFILE_ROW(RGBAToYRow, width, src_rgba + src_stride_rgba,
+                dst_y + dst_stride_y, width);
     src_rgba += src_stride_rgba * 2;
     dst_y += dst_stride_y * 2;
     dst_u += dst_stride_u;
     dst_v += dst_stride_v;
   }
   if (height & 1) {
-    RGBAToUVRow(src_rgba, 0, dst_u, dst_v, width);
-    RGBAToYRow(src_rgba, dst_y, width);
+    PROFILE_ROW(RGBAToUVRow, width, src_rgba, 0, dst_u, dst_v, width);
+    PROFILE_ROW(RGBAToYRow, width, src_rgba, dst_y, width);
   }
   return 0;
 }
@@ -1413,14 +1427,17 @@ int RGB24ToI420(const uint8_t* src_rgb24,
 #if (defined(HAS_RGB24TOYROW_NEON) || defined(HAS_RGB24TOYROW_MSA) || \
      defined(HAS_RGB24TOYROW_MMI))
       RGB24ToUVRow(src_rgb24, src_stride_rgb24, dst_u, dst_v, width);
-      RGB24ToYRow(src_rgb24, dst_y, width);
-      RGB24ToYRow(src_rgb24 + src_stride_rgb24, dst_y + dst_stride_y, width);
+      PROFILE_ROW(RGB24ToYRow, width, src_rgb24, dst_y, width);
+      PROFILE_ROW(RGB24ToYRow, width, src_rgb24 + src_stride_rgb24,
+                  dst_y + dst_stride_y, width);
 #else
-      RGB24ToARGBRow(src_rgb24, row, width);
-      RGB24ToARGBRow(src_rgb24 + src_stride_rgb24, row + kRowSize, width);
-      ARGBToUVRow(row, kRowSize, dst_u, dst_v, width);
-      ARGBToYRow(row, dst_y, width);
-      ARGBToYRow(row + kRowSize, dst_y + dst_stride_y, width);
+      PROFILE_ROW(RGB24ToARGBRow, width, src_rgb24, row, width);
+      PROFILE_ROW(RGB24ToARGBRow, width, src_rgb24 + src_stride_rgb24,
+                  row + kRowSize, width);
+      PROFILE_ROW(ARGBToUVRow, width, row, kRowSize, dst_u, dst_v, width);
+      PROFILE_ROW(ARGBToYRow, width, row, dst_y, width);
+      PROFILE_ROW(ARGBToYRow, width, row + kRowSize, dst_y + dst_stride_y,
+                  width);
 #endif
       src_rgb24 += src_stride_rgb24 * 2;
       dst_y += dst_stride_y * 2;
@@ -1431,11 +1448,11 @@ int RGB24ToI420(const uint8_t* src_rgb24,
 #if (defined(HAS_RGB24TOYROW_NEON) || defined(HAS_RGB24TOYROW_MSA) || \
      defined(HAS_RGB24TOYROW_MMI))
       RGB24ToUVRow(src_rgb24, 0, dst_u, dst_v, width);
-      RGB24ToYRow(src_rgb24, dst_y, width);
+      PROFILE_ROW(RGB24ToYRow, width, src_rgb24, dst_y, width);
 #else
-      RGB24ToARGBRow(src_rgb24, row, width);
-      ARGBToUVRow(row, 0, dst_u, dst_v, width);
-      ARGBToYRow(row, dst_y, width);
+      PROFILE_ROW(RGB24ToARGBRow, width, src_rgb24, row, width);
+      PROFILE_ROW(ARGBToUVRow, width, row, 0, dst_u, dst_v, width);
+      PROFILE_ROW(ARGBToYRow, width, row, dst_y, width);
 #endif
     }
 #if !(defined(HAS_RGB24TOYROW_NEON) || defined(HAS_RGB24TOYROW_MSA) || \
@@ -1560,14 +1577,17 @@ int RAWToI420(const uint8_t* src_raw,
 #if (defined(HAS_RAWTOYROW_NEON) || defined(HAS_RAWTOYROW_MSA) || \
      defined(HAS_RAWTOYROW_MMI))
       RAWToUVRow(src_raw, src_stride_raw, dst_u, dst_v, width);
-      RAWToYRow(src_raw, dst_y, width);
-      RAWToYRow(src_raw + src_stride_raw, dst_y + dst_stride_y, width);
+      PROFILE_ROW(RAWToYRow, width, src_raw, dst_y, width);
+      PROFILE_ROW(RAWToYRow, width, src_raw + src_stride_raw,
+                  dst_y + dst_stride_y, width);
 #else
-      RAWToARGBRow(src_raw, row, width);
-      RAWToARGBRow(src_raw + src_stride_raw, row + kRowSize, width);
-      ARGBToUVRow(row, kRowSize, dst_u, dst_v, width);
-      ARGBToYRow(row, dst_y, width);
-      ARGBToYRow(row + kRowSize, dst_y + dst_stride_y, width);
+      PROFILE_ROW(RAWToARGBRow, width, src_raw, row, width);
+      PROFILE_ROW(RAWToARGBRow, width, src_raw + src_stride_raw, row + kRowSize,
+                  width);
+      PROFILE_ROW(ARGBToUVRow, width, row, kRowSize, dst_u, dst_v, width);
+      PROFILE_ROW(ARGBToYRow, width, row, dst_y, width);
+      PROFILE_ROW(ARGBToYRow, width, row + kRowSize, dst_y + dst_stride_y,
+                  width);
 #endif
       src_raw += src_stride_raw * 2;
       dst_y += dst_stride_y * 2;
@@ -1578,11 +1598,11 @@ int RAWToI420(const uint8_t* src_raw,
 #if (defined(HAS_RAWTOYROW_NEON) || defined(HAS_RAWTOYROW_MSA) || \
      defined(HAS_RAWTOYROW_MMI))
       RAWToUVRow(src_raw, 0, dst_u, dst_v, width);
-      RAWToYRow(src_raw, dst_y, width);
+      PROFILE_ROW(RAWToYRow, width, src_raw, dst_y, width);
 #else
-      RAWToARGBRow(src_raw, row, width);
-      ARGBToUVRow(row, 0, dst_u, dst_v, width);
-      ARGBToYRow(row, dst_y, width);
+      PROFILE_ROW(RAWToARGBRow, width, src_raw, row, width);
+      PROFILE_ROW(ARGBToUVRow, width, row, 0, dst_u, dst_v, width);
+      PROFILE_ROW(ARGBToYRow, width, row, dst_y, width);
 #endif
     }
 #if !(defined(HAS_RAWTOYROW_NEON) || defined(HAS_RAWTOYROW_MSA) || \
@@ -1714,14 +1734,17 @@ int RGB565ToI420(const uint8_t* src_rgb565,
 #if (defined(HAS_RGB565TOYROW_NEON) || defined(HAS_RGB565TOYROW_MSA) || \
      defined(HAS_RGB565TOYROW_MMI))
       RGB565ToUVRow(src_rgb565, src_stride_rgb565, dst_u, dst_v, width);
-      RGB565ToYRow(src_rgb565, dst_y, width);
-      RGB565ToYRow(src_rgb565 + src_stride_rgb565, dst_y + dst_stride_y, width);
+      PROFILE_ROW(RGB565ToYRow, width, src_rgb565, dst_y, width);
+      PROFILE_ROW(RGB565ToYRow, width, src_rgb565 + src_stride_rgb565,
+                  dst_y + dst_stride_y, width);
 #else
-      RGB565ToARGBRow(src_rgb565, row, width);
-      RGB565ToARGBRow(src_rgb565 + src_stride_rgb565, row + kRowSize, width);
-      ARGBToUVRow(row, kRowSize, dst_u, dst_v, width);
-      ARGBToYRow(row, dst_y, width);
-      ARGBToYRow(row + kRowSize, dst_y + dst_stride_y, width);
+      PROFILE_ROW(RGB565ToARGBRow, width, src_rgb565, row, width);
+      PROFILE_ROW(RGB565ToARGBRow, width, src_rgb565 + src_stride_rgb565,
+                  row + kRowSize, width);
+      PROFILE_ROW(ARGBToUVRow, width, row, kRowSize, dst_u, dst_v, width);
+      PROFILE_ROW(ARGBToYRow, width, row, dst_y, width);
+      PROFILE_ROW(ARGBToYRow, width, row + kRowSize, dst_y + dst_stride_y,
+                  width);
 #endif
       src_rgb565 += src_stride_rgb565 * 2;
       dst_y += dst_stride_y * 2;
@@ -1732,11 +1755,11 @@ int RGB565ToI420(const uint8_t* src_rgb565,
 #if (defined(HAS_RGB565TOYROW_NEON) || defined(HAS_RGB565TOYROW_MSA) || \
      defined(HAS_RGB565TOYROW_MMI))
       RGB565ToUVRow(src_rgb565, 0, dst_u, dst_v, width);
-      RGB565ToYRow(src_rgb565, dst_y, width);
+      PROFILE_ROW(RGB565ToYRow, width, src_rgb565, dst_y, width);
 #else
-      RGB565ToARGBRow(src_rgb565, row, width);
-      ARGBToUVRow(row, 0, dst_u, dst_v, width);
-      ARGBToYRow(row, dst_y, width);
+      PROFILE_ROW(RGB565ToARGBRow, width, src_rgb565, row, width);
+      PROFILE_ROW(ARGBToUVRow, width, row, 0, dst_u, dst_v, width);
+      PROFILE_ROW(ARGBToYRow, width, row, dst_y, width);
 #endif
     }
 #if !(defined(HAS_RGB565TOYROW_NEON) || defined(HAS_RGB565TOYROW_MSA) || \
@@ -1870,16 +1893,17 @@ int ARGB1555ToI420(const uint8_t* src_argb1555,
 #if (defined(HAS_ARGB1555TOYROW_NEON) || defined(HAS_ARGB1555TOYROW_MSA) || \
      defined(HAS_ARGB1555TOYROW_MMI))
       ARGB1555ToUVRow(src_argb1555, src_stride_argb1555, dst_u, dst_v, width);
-      ARGB1555ToYRow(src_argb1555, dst_y, width);
-      ARGB1555ToYRow(src_argb1555 + src_stride_argb1555, dst_y + dst_stride_y,
-                     width);
+      PROFILE_ROW(ARGB1555ToYRow, width, src_argb1555, dst_y, width);
+      PROFILE_ROW(ARGB1555ToYRow, width, src_argb1555 + src_stride_argb1555,
+                  dst_y + dst_stride_y, width);
 #else
-      ARGB1555ToARGBRow(src_argb1555, row, width);
-      ARGB1555ToARGBRow(src_argb1555 + src_stride_argb1555, row + kRowSize,
-                        width);
-      ARGBToUVRow(row, kRowSize, dst_u, dst_v, width);
-      ARGBToYRow(row, dst_y, width);
-      ARGBToYRow(row + kRowSize, dst_y + dst_stride_y, width);
+      PROFILE_ROW(ARGB1555ToARGBRow, width, src_argb1555, row, width);
+      PROFILE_ROW(ARGB1555ToARGBRow, width, src_argb1555 + src_stride_argb1555,
+                  row + kRowSize, width);
+      PROFILE_ROW(ARGBToUVRow, width, row, kRowSize, dst_u, dst_v, width);
+      PROFILE_ROW(ARGBToYRow, width, row, dst_y, width);
+      PROFILE_ROW(ARGBToYRow, width, row + kRowSize, dst_y + dst_stride_y,
+                  width);
 #endif
       src_argb1555 += src_stride_argb1555 * 2;
       dst_y += dst_stride_y * 2;
@@ -1890,11 +1914,11 @@ int ARGB1555ToI420(const uint8_t* src_argb1555,
 #if (defined(HAS_ARGB1555TOYROW_NEON) || defined(HAS_ARGB1555TOYROW_MSA) || \
      defined(HAS_ARGB1555TOYROW_MMI))
       ARGB1555ToUVRow(src_argb1555, 0, dst_u, dst_v, width);
-      ARGB1555ToYRow(src_argb1555, dst_y, width);
+      PROFILE_ROW(ARGB1555ToYRow, width, src_argb1555, dst_y, width);
 #else
-      ARGB1555ToARGBRow(src_argb1555, row, width);
-      ARGBToUVRow(row, 0, dst_u, dst_v, width);
-      ARGBToYRow(row, dst_y, width);
+      PROFILE_ROW(ARGB1555ToARGBRow, width, src_argb1555, row, width);
+      PROFILE_ROW(ARGBToUVRow, width, row, 0, dst_u, dst_v, width);
+      PROFILE_ROW(ARGBToYRow, width, row, dst_y, width);
 #endif
     }
 #if !(defined(HAS_ARGB1555TOYROW_NEON) || defined(HAS_ARGB1555TOYROW_MSA) || \
@@ -2048,17 +2072,19 @@ int ARGB4444ToI420(const uint8_t* src_argb4444,
 
     for (y = 0; y < height - 1; y += 2) {
 #if (defined(HAS_ARGB4444TOYROW_NEON) || defined(HAS_ARGB4444TOYROW_MMI))
-      ARGB4444ToUVRow(src_argb4444, src_stride_argb4444, dst_u, dst_v, width);
-      ARGB4444ToYRow(src_argb4444, dst_y, width);
-      ARGB4444ToYRow(src_argb4444 + src_stride_argb4444, dst_y + dst_stride_y,
-                     width);
+      PROFILE_ROW(ARGB4444ToUVRow, width, src_argb4444, src_stride_argb4444,
+                  dst_u, dst_v, width);
+      PROFILE_ROW(ARGB4444ToYRow, width, src_argb4444, dst_y, width);
+      PROFILE_ROW(ARGB4444ToYRow, width, src_argb4444 + src_stride_argb4444,
+                  dst_y + dst_stride_y, width);
 #else
-      ARGB4444ToARGBRow(src_argb4444, row, width);
-      ARGB4444ToARGBRow(src_argb4444 + src_stride_argb4444, row + kRowSize,
-                        width);
-      ARGBToUVRow(row, kRowSize, dst_u, dst_v, width);
-      ARGBToYRow(row, dst_y, width);
-      ARGBToYRow(row + kRowSize, dst_y + dst_stride_y, width);
+      PROFILE_ROW(ARGB4444ToARGBRow, width, src_argb4444, row, width);
+      PROFILE_ROW(ARGB4444ToARGBRow, width, src_argb4444 + src_stride_argb4444,
+                  row + kRowSize, width);
+      PROFILE_ROW(ARGBToUVRow, width, row, kRowSize, dst_u, dst_v, width);
+      PROFILE_ROW(ARGBToYRow, width, row, dst_y, width);
+      PROFILE_ROW(ARGBToYRow, width, row + kRowSize, dst_y + dst_stride_y,
+                  width);
 #endif
       src_argb4444 += src_stride_argb4444 * 2;
       dst_y += dst_stride_y * 2;
@@ -2067,12 +2093,12 @@ int ARGB4444ToI420(const uint8_t* src_argb4444,
     }
     if (height & 1) {
 #if (defined(HAS_ARGB4444TOYROW_NEON) || defined(HAS_ARGB4444TOYROW_MMI))
-      ARGB4444ToUVRow(src_argb4444, 0, dst_u, dst_v, width);
-      ARGB4444ToYRow(src_argb4444, dst_y, width);
+      PROFILE_ROW(ARGB4444ToUVRow, width, src_argb4444, 0, dst_u, dst_v, width);
+      PROFILE_ROW(ARGB4444ToYRow, width, src_argb4444, dst_y, width);
 #else
-      ARGB4444ToARGBRow(src_argb4444, row, width);
-      ARGBToUVRow(row, 0, dst_u, dst_v, width);
-      ARGBToYRow(row, dst_y, width);
+      PROFILE_ROW(ARGB4444ToARGBRow, width, src_argb4444, row, width);
+      PROFILE_ROW(ARGBToUVRow, width, row, 0, dst_u, dst_v, width);
+      PROFILE_ROW(ARGBToYRow, width, row, dst_y, width);
 #endif
     }
 #if !(defined(HAS_ARGB4444TOYROW_NEON) || defined(HAS_ARGB4444TOYROW_MMI))
@@ -16,6 +16,7 @@
 #ifdef HAVE_JPEG
 #include "libyuv/mjpeg_decoder.h"
 #endif
+#include "libyuv/profile.h"
 #include "libyuv/row.h"
 #include "libyuv/scale_row.h"  // for ScaleRowDown2
 
@@ -74,7 +75,7 @@ void CopyPlane(const uint8_t* src_y,
 
   // Copy plane
   for (y = 0; y < height; ++y) {
-    CopyRow(src_y, dst_y, width);
+    PROFILE_ROW(CopyRow, width, src_y, dst_y, width);
     src_y += src_stride_y;
     dst_y += dst_stride_y;
   }
@@ -115,7 +116,7 @@ void CopyPlane_16(const uint16_t* src_y,
 
   // Copy plane
   for (y = 0; y < height; ++y) {
-    CopyRow(src_y, dst_y, width);
+    PROFILE_ROW(CopyRow, width, src_y, dst_y, width);
     src_y += src_stride_y;
     dst_y += dst_stride_y;
   }
@@ -165,7 +166,7 @@ void Convert16To8Plane(const uint16_t* src_y,
 
   // Convert plane
   for (y = 0; y < height; ++y) {
-    Convert16To8Row(src_y, dst_y, scale, width);
+    PROFILE_ROW(Convert16To8Row, width, src_y, dst_y, scale, width);
     src_y += src_stride_y;
     dst_y += dst_stride_y;
   }
@@ -215,7 +216,7 @@ void Convert8To16Plane(const uint8_t* src_y,
 
   // Convert plane
   for (y = 0; y < height; ++y) {
-    Convert8To16Row(src_y, dst_y, scale, width);
+    PROFILE_ROW(Convert8To16Row, width, src_y, dst_y, scale, width);
     src_y += src_stride_y;
     dst_y += dst_stride_y;
   }
@@ -421,7 +422,7 @@ void SplitUVPlane(const uint8_t* src_uv,
 
   for (y = 0; y < height; ++y) {
     // Copy a row of UV.
-    SplitUVRow(src_uv, dst_u, dst_v, width);
+    PROFILE_ROW(SplitUVRow, width, src_uv, dst_u, dst_v, width);
     dst_u += dst_stride_u;
     dst_v += dst_stride_v;
     src_uv += src_stride_uv;
@@ -497,13 +498,72 @@ void MergeUVPlane(const uint8_t* src_u,
 
   for (y = 0; y < height; ++y) {
     // Merge a row of U and V into a row of UV.
-    MergeUVRow(src_u, src_v, dst_uv, width);
+    PROFILE_ROW(MergeUVRow, width, src_u, src_v, dst_uv, width);
     src_u += src_stride_u;
     src_v += src_stride_v;
     dst_uv += dst_stride_uv;
   }
 }
 
+// Swap U and V channels in an interleaved UV plane, e.g. NV12 to NV21.
+// src_uv and dst_vu may be the same buffer for in-place conversion.
+LIBYUV_API
+void SwapUVPlane(const uint8_t* src_uv,
+                 int src_stride_uv,
+                 uint8_t* dst_vu,
+                 int dst_stride_vu,
+                 int width,
+                 int height) {
+  int y;
+  void (*SwapUVRow)(const uint8_t* src_uv, uint8_t* dst_vu, int width) =
+      SwapUVRow_C;
+  if (width <= 0 || height == 0) {
+    return;
+  }
+  // Negative height means invert the image.
+  if (height < 0) {
+    height = -height;
+    src_uv = src_uv + (height - 1) * src_stride_uv;
+    src_stride_uv = -src_stride_uv;
+  }
+  // Coalesce rows.
+  if (src_stride_uv == width * 2 && dst_stride_vu == width * 2) {
+    width *= height;
+    height = 1;
+    src_stride_uv = dst_stride_vu = 0;
+  }
+#if defined(HAS_SWAPUVROW_SSSE3)
+  if (TestCpuFlag(kCpuHasSSSE3)) {
+    SwapUVRow = SwapUVRow_Any_SSSE3;
+    if (IS_ALIGNED(width, 16)) {
+      SwapUVRow = SwapUVRow_SSSE3;
+    }
+  }
+#endif
+#if defined(HAS_SWAPUVROW_AVX2)
+  if (TestCpuFlag(kCpuHasAVX2)) {
+    SwapUVRow = SwapUVRow_Any_AVX2;
+    if (IS_ALIGNED(width, 32)) {
+      SwapUVRow = SwapUVRow_AVX2;
+    }
+  }
+#endif
+#if defined(HAS_SWAPUVROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    SwapUVRow = SwapUVRow_Any_NEON;
+    if (IS_ALIGNED(width, 16)) {
+      SwapUVRow = SwapUVRow_NEON;
+    }
+  }
+#endif
+
+  for (y = 0; y < height; ++y) {
+    PROFILE_ROW(SwapUVRow, width, src_uv, dst_vu, width);
+    src_uv += src_stride_uv;
+    dst_vu += dst_stride_vu;
+  }
+}
+
 // Support function for NV12 etc RGB channels.
 // Width and height are plane sizes (typically half pixel width).
 LIBYUV_API
@@ -564,7 +624,7 @@ void SplitRGBPlane(const uint8_t* src_rgb,
 
   for (y = 0; y < height; ++y) {
     // Copy a row of RGB.
-    SplitRGBRow(src_rgb, dst_r, dst_g, dst_b, width);
+    PROFILE_ROW(SplitRGBRow, width, src_rgb, dst_r, dst_g, dst_b, width);
     dst_r += dst_stride_r;
     dst_g += dst_stride_g;
     dst_b += dst_stride_b;
@@ -628,7 +688,7 @@ void MergeRGBPlane(const uint8_t* src_r,
 
   for (y = 0; y < height; ++y) {
     // Merge a row of U and V into a row of RGB.
-    MergeRGBRow(src_r, src_g, src_b, dst_rgb, width);
+    PROFILE_ROW(MergeRGBRow, width, src_r, src_g, src_b, dst_rgb, width);
     src_r += src_stride_r;
     src_g += src_stride_g;
     src_b += src_stride_b;
@@ -694,7 +754,7 @@ void MirrorPlane(const uint8_t* src_y,
 
   // Mirror plane
   for (y = 0; y < height; ++y) {
-    MirrorRow(src_y, dst_y, width);
+    PROFILE_ROW(MirrorRow, width, src_y, dst_y, width);
     src_y += src_stride_y;
     dst_y += dst_stride_y;
   }
@@ -786,8 +846,8 @@ int YUY2ToI422(const uint8_t* src_yuy2,
 #endif
 
   for (y = 0; y < height; ++y) {
-    YUY2ToUV422Row(src_yuy2, dst_u, dst_v, width);
-    YUY2ToYRow(src_yuy2, dst_y, width);
+    PROFILE_ROW(YUY2ToUV422Row, width, src_yuy2, dst_u, dst_v, width);
+    PROFILE_ROW(YUY2ToYRow, width, src_yuy2, dst_y, width);
     src_yuy2 += src_stride_yuy2;
     dst_y += dst_stride_y;
     dst_u += dst_stride_u;
@@ -882,8 +942,8 @@ int UYVYToI422(const uint8_t* src_uyvy,
 #endif
 
   for (y = 0; y < height; ++y) {
-    UYVYToUV422Row(src_uyvy, dst_u, dst_v, width);
-    UYVYToYRow(src_uyvy, dst_y, width);
+    PROFILE_ROW(UYVYToUV422Row, width, src_uyvy, dst_u, dst_v, width);
+    PROFILE_ROW(UYVYToYRow, width, src_uyvy, dst_y, width);
     src_uyvy += src_stride_uyvy;
     dst_y += dst_stride_y;
     dst_u += dst_stride_u;
@@ -960,7 +1020,7 @@ int YUY2ToY(const uint8_t* src_yuy2,
 #endif
 
   for (y = 0; y < height; ++y) {
-    YUY2ToYRow(src_yuy2, dst_y, width);
+    PROFILE_ROW(YUY2ToYRow, width, src_yuy2, dst_y, width);
     src_yuy2 += src_stride_yuy2;
     dst_y += dst_stride_y;
   }
@@ -1094,7 +1154,7 @@ int ARGBMirror(const uint8_t* src_argb,
 
   // Mirror plane
   for (y = 0; y < height; ++y) {
-    ARGBMirrorRow(src_argb, dst_argb, width);
+    PROFILE_ROW(ARGBMirrorRow, width, src_argb, dst_argb, width);
     src_argb += src_stride_argb;
     dst_argb += dst_stride_argb;
   }
@@ -1163,7 +1223,7 @@ int ARGBBlend(const uint8_t* src_argb0,
   }
 
   for (y = 0; y < height; ++y) {
-    ARGBBlendRow(src_argb0, src_argb1, dst_argb, width);
+    PROFILE_ROW(ARGBBlendRow, width, src_argb0, src_argb1, dst_argb, width);
     src_argb0 += src_stride_argb0;
     src_argb1 += src_stride_argb1;
     dst_argb += dst_stride_argb;
@@ -1221,6 +1281,14 @@ int BlendPlane(const uint8_t* src_y0,
     }
   }
 #endif
+#if defined(HAS_BLENDPLANEROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    BlendPlaneRow = BlendPlaneRow_Any_NEON;
+    if (IS_ALIGNED(width, 16)) {
+      BlendPlaneRow = BlendPlaneRow_NEON;
+    }
+  }
+#endif
 #if defined(HAS_BLENDPLANEROW_MMI)
   if (TestCpuFlag(kCpuHasMMI)) {
     BlendPlaneRow = BlendPlaneRow_Any_MMI;
@@ -1231,7 +1299,7 @@ int BlendPlane(const uint8_t* src_y0,
 #endif
 
   for (y = 0; y < height; ++y) {
-    BlendPlaneRow(src_y0, src_y1, alpha, dst_y, width);
+    PROFILE_ROW(BlendPlaneRow, width, src_y0, src_y1, alpha, dst_y, width);
     src_y0 += src_stride_y0;
     src_y1 += src_stride_y1;
     alpha += alpha_stride;
@@ -1305,6 +1373,14 @@ int I420Blend(const uint8_t* src_y0,
     }
   }
 #endif
+#if defined(HAS_BLENDPLANEROW_NEON)
+  if (TestCpuFlag(kCpuHasNEON)) {
+    BlendPlaneRow = BlendPlaneRow_Any_NEON;
+    if (IS_ALIGNED(halfwidth, 16)) {
+      BlendPlaneRow = BlendPlaneRow_NEON;
+    }
+  }
+#endif
 #if defined(HAS_BLENDPLANEROW_MMI)
   if (TestCpuFlag(kCpuHasMMI)) {
     BlendPlaneRow = BlendPlaneRow_Any_MMI;
@@ -1369,10 +1445,13 @@ int I420Blend(const uint8_t* src_y0,
       alpha_stride = 0;
     }
     // Subsample 2 rows of UV to half width and half height.
-    ScaleRowDown2(alpha, alpha_stride, halfalpha, halfwidth);
+    PROFILE_ROW(ScaleRowDown2, halfwidth, alpha, alpha_stride, halfalpha,
+                halfwidth);
     alpha += alpha_stride * 2;
-    BlendPlaneRow(src_u0, src_u1, halfalpha, dst_u, halfwidth);
-    BlendPlaneRow(src_v0, src_v1, halfalpha, dst_v, halfwidth);
+    PROFILE_ROW(BlendPlaneRow, halfwidth, src_u0, src_u1, halfalpha, dst_u,
+                halfwidth);
+    PROFILE_ROW(BlendPlaneRow, halfwidth, src_v0, src_v1, halfalpha, dst_v,
+                halfwidth);
     src_u0 += src_stride_u0;
     src_u1 += src_stride_u1;
     dst_u += dst_stride_u;
@@ -1456,7 +1535,7 @@ int ARGBMultiply(const uint8_t* src_argb0,
 
   // Multiply plane
   for (y = 0; y < height; ++y) {
-    ARGBMultiplyRow(src_argb0, src_argb1, dst_argb, width);
+    PROFILE_ROW(ARGBMultiplyRow, width, src_argb0, src_argb1, dst_argb, width);
     src_argb0 += src_stride_argb0;
     src_argb1 += src_stride_argb1;
     dst_argb += dst_stride_argb;
@@ -1541,7 +1620,7 @@ int ARGBAdd(const uint8_t* src_argb0,
 
   // Add plane
   for (y = 0; y < height; ++y) {
-    ARGBAddRow(src_argb0, src_argb1, dst_argb, width);
+    PROFILE_ROW(ARGBAddRow, width, src_argb0, src_argb1, dst_argb, width);
     src_argb0 += src_stride_argb0;
     src_argb1 += src_stride_argb1;
     dst_argb += dst_stride_argb;
@@ -1621,7 +1700,7 @@ int ARGBSubtract(const uint8_t* src_argb0,
 
   // Subtract plane
   for (y = 0; y < height; ++y) {
-    ARGBSubtractRow(src_argb0, src_argb1, dst_argb, width);
+    PROFILE_ROW(ARGBSubtractRow, width, src_argb0, src_argb1, dst_argb, width);
     src_argb0 += src_stride_argb0;
     src_argb1 += src_stride_argb1;
     dst_argb += dst_stride_argb;
@@ -1688,7 +1767,8 @@ static int I422ToRGBAMatrix(const uint8_t* src_y,
 #endif
 
   for (y = 0; y < height; ++y) {
-    I422ToRGBARow(src_y, src_u, src_v, dst_rgba, yuvconstants, width);
+    PROFILE_ROW(I422ToRGBARow, width, src_y, src_u, src_v, dst_rgba,
+                yuvconstants, width);
     dst_rgba += dst_stride_rgba;
     src_y += src_stride_y;
     src_u += src_stride_u;
@@ -1790,7 +1870,8 @@ int NV12ToRGB565(const uint8_t* src_y,
 #endif
 
   for (y = 0; y < height; ++y) {
-    NV12ToRGB565Row(src_y, src_uv, dst_rgb565, &kYuvI601Constants, width);
+    PROFILE_ROW(NV12ToRGB565Row, width, src_y, src_uv, dst_rgb565,
+                &kYuvI601Constants, width);
     dst_rgb565 += dst_stride_rgb565;
     src_y += src_stride_y;
     if (y & 1) {
@@ -1860,7 +1941,7 @@ int RAWToRGB24(const uint8_t* src_raw,
 #endif
 
   for (y = 0; y < height; ++y) {
-    RAWToRGB24Row(src_raw, dst_rgb24, width);
+    PROFILE_ROW(RAWToRGB24Row, width, src_raw, dst_rgb24, width);
     src_raw += src_stride_raw;
     dst_rgb24 += dst_stride_rgb24;
   }
@@ -1915,7 +1996,7 @@ void SetPlane(uint8_t* dst_y,
 
   // Set plane
   for (y = 0; y < height; ++y) {
-    SetRow(dst_y, value, width);
+    PROFILE_ROW(SetRow, width, dst_y, value, width);
     dst_y += dst_stride_y;
   }
 }
@@ -2004,7 +2085,7 @@ int ARGBRect(uint8_t* dst_argb,
 
   // Set plane
   for (y = 0; y < height; ++y) {
-    ARGBSetRow(dst_argb, value, width);
+    PROFILE_ROW(ARGBSetRow, width, dst_argb, value, width);
     dst_argb += dst_stride_argb;
   }
   return 0;
@@ -2089,7 +2170,7 @@ int ARGBAttenuate(const uint8_t* src_argb,
 #endif
 
   for (y = 0; y < height; ++y) {
-    ARGBAttenuateRow(src_argb, dst_argb, width);
+    PROFILE_ROW(ARGBAttenuateRow, width, src_argb, dst_argb, width);
     src_argb += src_stride_argb;
     dst_argb += dst_stride_argb;
   }
@@ -2140,7 +2221,7 @@ int ARGBUnattenuate(const uint8_t* src_argb,
   // TODO(fbarchard): Neon version.
 
   for (y = 0; y < height; ++y) {
-    ARGBUnattenuateRow(src_argb, dst_argb, width);
+    PROFILE_ROW(ARGBUnattenuateRow, width, src_argb, dst_argb, width);
     src_argb += src_stride_argb;
     dst_argb += dst_stride_argb;
   }
@@ -2194,7 +2275,7 @@ int ARGBGrayTo(const uint8_t* src_argb,
 #endif
 
   for (y = 0; y < height; ++y) {
-    ARGBGrayRow(src_argb, dst_argb, width);
+    PROFILE_ROW(ARGBGrayRow, width, src_argb, dst_argb, width);
     src_argb += src_stride_argb;
     dst_argb += dst_stride_argb;
   }
@@ -2244,7 +2325,7 @@ int ARGBGray(uint8_t* dst_argb,
 #endif
 
   for (y = 0; y < height; ++y) {
-    ARGBGrayRow(dst, dst, width);
+    PROFILE_ROW(ARGBGrayRow, width, dst, dst, width);
     dst += dst_stride_argb;
   }
   return 0;
@@ -2292,7 +2373,7 @@ int ARGBSepia(uint8_t* dst_argb,
 #endif
 
   for (y = 0; y < height; ++y) {
-    ARGBSepiaRow(dst, width);
+    PROFILE_ROW(ARGBSepiaRow, width, dst, width);
     dst += dst_stride_argb;
   }
   return 0;
@@ -2347,7 +2428,8 @@ int ARGBColorMatrix(const uint8_t* src_argb,
   }
 #endif
   for (y = 0; y < height; ++y) {
-    ARGBColorMatrixRow(src_argb, dst_argb, matrix_argb, width);
+    PROFILE_ROW(ARGBColorMatrixRow, width, src_argb, dst_argb, matrix_argb,
+                width);
     src_argb += src_stride_argb;
     dst_argb += dst_stride_argb;
   }
@@ -2421,7 +2503,7 @@ int ARGBColorTable(uint8_t* dst_argb,
   }
 #endif
   for (y = 0; y < height; ++y) {
-    ARGBColorTableRow(dst, table_argb, width);
+    PROFILE_ROW(ARGBColorTableRow, width, dst, table_argb, width);
     dst += dst_stride_argb;
   }
   return 0;
@@ -2457,7 +2539,7 @@ int RGBColorTable(uint8_t* dst_argb,
   }
 #endif
   for (y = 0; y < height; ++y) {
-    RGBColorTableRow(dst, table_argb, width);
+    PROFILE_ROW(RGBColorTableRow, width, dst, table_argb, width);
     dst += dst_stride_argb;
   }
   return 0;
@@ -2512,7 +2594,8 @@ int ARGBQuantize(uint8_t* dst_argb,
   }
 #endif
   for (y = 0; y < height; ++y) {
-    ARGBQuantizeRow(dst, scale, interval_size, interval_offset, width);
+    PROFILE_ROW(ARGBQuantizeRow, width, dst, scale, interval_size,
+                interval_offset, width);
     dst += dst_stride_argb;
   }
   return 0;
@@ -2548,7 +2631,8 @@ int ARGBComputeCumulativeSum(const uint8_t* src_argb,
 
   memset(dst_cumsum, 0, width * sizeof(dst_cumsum[0]) * 4);  // 4 int per pixel.
   for (y = 0; y < height; ++y) {
-    ComputeCumulativeSumRow(src_argb, dst_cumsum, previous_cumsum, width);
+    PROFILE_ROW(ComputeCumulativeSumRow, width, src_argb, dst_cumsum,
+                previous_cumsum, width);
     previous_cumsum = dst_cumsum;
     dst_cumsum += dst_stride32_cumsum;
     src_argb += src_stride_argb;
@@ -2643,31 +2727,32 @@ int ARGBBlur(const uint8_t* src_argb,
       if (cumsum_bot_row >= max_cumsum_bot_row) {
         cumsum_bot_row = dst_cumsum;
       }
-      ComputeCumulativeSumRow(src_argb, cumsum_bot_row, prev_cumsum_bot_row,
-                              width);
+      PROFILE_ROW(ComputeCumulativeSumRow, width, src_argb, cumsum_bot_row,
+                  prev_cumsum_bot_row, width);
       src_argb += src_stride_argb;
     }
 
     // Left clipped.
     for (x = 0; x < radius + 1; ++x) {
-      CumulativeSumToAverageRow(cumsum_top_row, cumsum_bot_row, boxwidth, area,
-                                &dst_argb[x * 4], 1);
+      PROFILE_ROW(CumulativeSumToAverageRow, boxwidth, cumsum_top_row,
+                  cumsum_bot_row, boxwidth, area, &dst_argb[x * 4], 1);
       area += (bot_y - top_y);
       boxwidth += 4;
     }
 
     // Middle unclipped.
     n = (width - 1) - radius - x + 1;
-    CumulativeSumToAverageRow(cumsum_top_row, cumsum_bot_row, boxwidth, area,
-                              &dst_argb[x * 4], n);
+    PROFILE_ROW(CumulativeSumToAverageRow, boxwidth, cumsum_top_row,
+                cumsum_bot_row, boxwidth, area, &dst_argb[x * 4], n);
 
     // Right clipped.
     for (x += n; x <= width - 1; ++x) {
       area -= (bot_y - top_y);
       boxwidth -= 4;
-      CumulativeSumToAverageRow(cumsum_top_row + (x - radius - 1) * 4,
-                                cumsum_bot_row + (x - radius - 1) * 4, boxwidth,
-                                area, &dst_argb[x * 4], 1);
+      PROFILE_ROW(CumulativeSumToAverageRow, boxwidth,
+                  cumsum_top_row + (x - radius - 1) * 4,
+                  cumsum_bot_row + (x - radius - 1) * 4, boxwidth, area,
+                  &dst_argb[x * 4], 1);
     }
     dst_argb += dst_stride_argb;
   }
@@ -2722,7 +2807,7 @@ int ARGBShade(const uint8_t* src_argb,
 #endif
 
   for (y = 0; y < height; ++y) {
-    ARGBShadeRow(src_argb, dst_argb, width, value);
+    PROFILE_ROW(ARGBShadeRow, width, src_argb, dst_argb, width, value);
     src_argb += src_stride_argb;
     dst_argb += dst_stride_argb;
   }
@@ -2801,7 +2886,8 @@ int InterpolatePlane(const uint8_t* src0,
 #endif
 
   for (y = 0; y < height; ++y) {
-    InterpolateRow(dst, src0, src1 - src0, width, interpolation);
+    PROFILE_ROW(InterpolateRow, width, dst, src0, src1 - src0, width,
+                interpolation);
     src0 += src_stride0;
     src1 += src_stride1;
     dst += dst_stride;
@@ -2932,7 +3018,7 @@ int ARGBShuffle(const uint8_t* src_bgra,
 #endif
 
   for (y = 0; y < height; ++y) {
-    ARGBShuffleRow(src_bgra, dst_argb, shuffler, width);
+    PROFILE_ROW(ARGBShuffleRow, width, src_bgra, dst_argb, shuffler, width);
     src_bgra += src_stride_bgra;
     dst_argb += dst_stride_argb;
   }
@@ -3062,10 +3148,10 @@ static int ARGBSobelize(const uint8_t* src_argb,
     uint8_t* row_y0 = row_y + kEdge;
     uint8_t* row_y1 = row_y0 + kRowSize;
     uint8_t* row_y2 = row_y1 + kRowSize;
-    ARGBToYJRow(src_argb, row_y0, width);
+    PROFILE_ROW(ARGBToYJRow, width, src_argb, row_y0, width);
     row_y0[-1] = row_y0[0];
     memset(row_y0 + width, row_y0[width - 1], 16);  // Extrude 16 for valgrind.
-    ARGBToYJRow(src_argb, row_y1, width);
+    PROFILE_ROW(ARGBToYJRow, width, src_argb, row_y1, width);
     row_y1[-1] = row_y1[0];
     memset(row_y1 + width, row_y1[width - 1], 16);
     memset(row_y2 + width, 0, 16);
@@ -3075,13 +3161,14 @@ static int ARGBSobelize(const uint8_t* src_argb,
       if (y < (height - 1)) {
         src_argb += src_stride_argb;
       }
-      ARGBToYJRow(src_argb, row_y2, width);
+      PROFILE_ROW(ARGBToYJRow, width, src_argb, row_y2, width);
       row_y2[-1] = row_y2[0];
       row_y2[width] = row_y2[width - 1];
 
-      SobelXRow(row_y0 - 1, row_y1 - 1, row_y2 - 1, row_sobelx, width);
-      SobelYRow(row_y0 - 1, row_y2 - 1, row_sobely, width);
-      SobelRow(row_sobelx, row_sobely, dst_argb, width);
+      PROFILE_ROW(SobelXRow, width, row_y0 - 1, row_y1 - 1, row_y2 - 1,
+                  row_sobelx, width);
+      PROFILE_ROW(SobelYRow, width, row_y0 - 1, row_y2 - 1, row_sobely, width);
+      PROFILE_ROW(SobelRow, width, row_sobelx, row_sobely, dst_argb, width);
 
       // Cycle thru circular queue of 3 row_y buffers.
       {
@@ -3277,7 +3364,7 @@ int ARGBPolynomial(const uint8_t* src_argb,
 #endif
 
   for (y = 0; y < height; ++y) {
-    ARGBPolynomialRow(src_argb, dst_argb, poly, width);
+    PROFILE_ROW(ARGBPolynomialRow, width, src_argb, dst_argb, poly, width);
     src_argb += src_stride_argb;
     dst_argb += dst_stride_argb;
   }
@@ -3358,7 +3445,7 @@ int HalfFloatPlane(const uint16_t* src_y,
 #endif
 
   for (y = 0; y < height; ++y) {
-    HalfFloatRow(src_y, dst_y, scale, width);
+    PROFILE_ROW(HalfFloatRow, width, src_y, dst_y, scale, width);
     src_y += src_stride_y;
     dst_y += dst_stride_y;
   }
@@ -3382,7 +3469,7 @@ int ByteToFloat(const uint8_t* src_y, float* dst_y, float scale, int width) {
   }
 #endif
 
-  ByteToFloatRow(src_y, dst_y, scale, width);
+  PROFILE_ROW(ByteToFloatRow, width, src_y, dst_y, scale, width);
   return 0;
 }
 
@@ -3421,7 +3508,8 @@ int ARGBLumaColorTable(const uint8_t* src_argb,
 #endif
 
   for (y = 0; y < height; ++y) {
-    ARGBLumaColorTableRow(src_argb, dst_argb, width, luma, 0x00264b0f);
+    PROFILE_ROW(ARGBLumaColorTableRow, width, src_argb, dst_argb, width, luma,
+                0x00264b0f);
     src_argb += src_stride_argb;
     dst_argb += dst_stride_argb;
   }
@@ -3480,7 +3568,7 @@ int ARGBCopyAlpha(const uint8_t* src_argb,
 #endif
 
   for (y = 0; y < height; ++y) {
-    ARGBCopyAlphaRow(src_argb, dst_argb, width);
+    PROFILE_ROW(ARGBCopyAlphaRow, width, src_argb, dst_argb, width);
     src_argb += src_stride_argb;
     dst_argb += dst_stride_argb;
   }
@@ -3544,7 +3632,7 @@ int ARGBExtractAlpha(const uint8_t* src_argb,
 #endif
 
   for (int y = 0; y < height; ++y) {
-    ARGBExtractAlphaRow(src_argb, dst_a, width);
+    PROFILE_ROW(ARGBExtractAlphaRow, width, src_argb, dst_a, width);
     src_argb += src_stride_argb;
     dst_a += dst_stride_a;
   }
@@ -3603,7 +3691,7 @@ int ARGBCopyYToAlpha(const uint8_t* src_y,
 #endif
 
   for (y = 0; y < height; ++y) {
-    ARGBCopyYToAlphaRow(src_y, dst_argb, width);
+    PROFILE_ROW(ARGBCopyYToAlphaRow, width, src_y, dst_argb, width);
     src_y += src_stride_y;
     dst_argb += dst_stride_argb;
   }
@@ -3726,19 +3814,21 @@ int YUY2ToNV12(const uint8_t* src_yuy2,
 
     for (y = 0; y < height - 1; y += 2) {
       // Split Y from UV.
-      SplitUVRow(src_yuy2, rows, rows + awidth, awidth);
-      memcpy(dst_y, rows, width);
-      SplitUVRow(src_yuy2 + src_stride_yuy2, rows, rows + awidth * 2, awidth);
-      memcpy(dst_y + dst_stride_y, rows, width);
-      InterpolateRow(dst_uv, rows + awidth, awidth, awidth, 128);
+      PROFILE_ROW(SplitUVRow, awidth, src_yuy2, rows, rows + awidth, awidth);
+      PROFILE_ROW(memcpy, width, dst_y, rows, width);
+      PROFILE_ROW(SplitUVRow, awidth, src_yuy2 + src_stride_yuy2, rows,
+                  rows + awidth * 2, awidth);
+      PROFILE_ROW(memcpy, width, dst_y + dst_stride_y, rows, width);
+      PROFILE_ROW(InterpolateRow, awidth, dst_uv, rows + awidth, awidth, awidth,
+                  128);
       src_yuy2 += src_stride_yuy2 * 2;
       dst_y += dst_stride_y * 2;
       dst_uv += dst_stride_uv;
     }
     if (height & 1) {
       // Split Y from UV.
-      SplitUVRow(src_yuy2, rows, dst_uv, awidth);
-      memcpy(dst_y, rows, width);
+      PROFILE_ROW(SplitUVRow, awidth, src_yuy2, rows, dst_uv, awidth);
+      PROFILE_ROW(memcpy, width, dst_y, rows, width);
     }
     free_aligned_buffer_64(rows);
   }
@@ -3858,19 +3948,21 @@ int UYVYToNV12(const uint8_t* src_uyvy,
 
     for (y = 0; y < height - 1; y += 2) {
       // Split Y from UV.
-      SplitUVRow(src_uyvy, rows + awidth, rows, awidth);
-      memcpy(dst_y, rows, width);
-      SplitUVRow(src_uyvy + src_stride_uyvy, rows + awidth * 2, rows, awidth);
-      memcpy(dst_y + dst_stride_y, rows, width);
-      InterpolateRow(dst_uv, rows + awidth, awidth, awidth, 128);
+      PROFILE_ROW(SplitUVRow, awidth, src_uyvy, rows + awidth, rows, awidth);
+      PROFILE_ROW(memcpy, width, dst_y, rows, width);
+      PROFILE_ROW(SplitUVRow, awidth, src_uyvy + src_stride_uyvy,
+                  rows + awidth * 2, rows, awidth);
+      PROFILE_ROW(memcpy, width, dst_y + dst_stride_y, rows, width);
+      PROFILE_ROW(InterpolateRow, awidth, dst_uv, rows + awidth, awidth, awidth,
+                  128);
       src_uyvy += src_stride_uyvy * 2;
       dst_y += dst_stride_y * 2;
       dst_uv += dst_stride_uv;
     }
     if (height & 1) {
       // Split Y from UV.
-      SplitUVRow(src_uyvy, dst_uv, rows, awidth);
-      memcpy(dst_y, rows, width);
+      PROFILE_ROW(SplitUVRow, awidth, src_uyvy, dst_uv, rows, awidth);
+      PROFILE_ROW(memcpy, width, dst_y, rows, width);
     }
     free_aligned_buffer_64(rows);
   }
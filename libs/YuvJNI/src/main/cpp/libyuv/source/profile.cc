@@ -0,0 +1,211 @@
+/*
+ *  Copyright 2020 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS. All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/profile.h"
+
+#ifdef LIBYUV_PROFILE
+#include <time.h>
+
+#include <atomic>
+#endif
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+#ifdef LIBYUV_PROFILE
+
+// Kernels per thread, a power of two.
+#define PROFILE_MAX_KERNELS 256
+// Threads with their own table. Threads beyond the limit share the last one.
+#define PROFILE_MAX_THREADS 64
+
+// Only the owning thread writes a slot, except in the shared table, so the
+// atomics are uncontended. They keep GetProfileKernels race free.
+struct ProfileSlot {
+  std::atomic<const void*> func;
+  std::atomic<const char*> name;
+  std::atomic<uint64_t> calls;
+  std::atomic<uint64_t> pixels;
+  std::atomic<uint64_t> cycles;
+};
+
+struct ProfileTable {
+  std::atomic<int> in_use;
+  ProfileSlot slots[PROFILE_MAX_KERNELS];
+};
+
+static ProfileTable profile_tables_[PROFILE_MAX_THREADS];
+static std::atomic<uint64_t> profile_cycles_per_second_(0);
+
+// Returns the table to the free list when the thread exits. A later thread
+// that takes it continues from the counts left behind.
+struct ProfileThread {
+  ProfileTable* table;
+  ~ProfileThread() {
+    if (table && table != &profile_tables_[PROFILE_MAX_THREADS - 1]) {
+      table->in_use.store(0, std::memory_order_release);
+    }
+  }
+};
+
+static thread_local ProfileThread profile_thread_ = {nullptr};
+
+static ProfileTable* GetThreadTable() {
+  ProfileTable* table = profile_thread_.table;
+  if (table) {
+    return table;
+  }
+  table = &profile_tables_[PROFILE_MAX_THREADS - 1];
+  for (int i = 0; i < PROFILE_MAX_THREADS - 1; ++i) {
+    int expected = 0;
+    if (profile_tables_[i].in_use.compare_exchange_strong(expected, 1)) {
+      table = &profile_tables_[i];
+      break;
+    }
+  }
+  profile_thread_.table = table;
+  return table;
+}
+
+LIBYUV_API
+int ProfileEnabled(void) {
+  return 1;
+}
+
+LIBYUV_API
+void ProfileRecord(const void* func,
+                   const char* name,
+                   int pixels,
+                   uint64_t cycles) {
+  ProfileTable* table = GetThreadTable();
+  uint32_t hash = (uint32_t)((uintptr_t)func >> 4) * 2654435761u;
+  for (int i = 0; i < PROFILE_MAX_KERNELS; ++i) {
+    ProfileSlot* slot = &table->slots[(hash + i) & (PROFILE_MAX_KERNELS - 1)];
+    const void* current = slot->func.load(std::memory_order_acquire);
+    if (!current) {
+      if (slot->func.compare_exchange_strong(current, func,
+                                             std::memory_order_acq_rel)) {
+        slot->name.store(name, std::memory_order_release);
+        current = func;
+      }
+    }
+    if (current == func) {
+      slot->calls.fetch_add(1, std::memory_order_relaxed);
+      slot->pixels.fetch_add(pixels, std::memory_order_relaxed);
+      slot->cycles.fetch_add(cycles, std::memory_order_relaxed);
+      return;
+    }
+  }
+  // Table full, the call is not counted.
+}
+
+LIBYUV_API
+int GetProfileKernels(ProfileKernel* kernels, int max_kernels) {
+  int count = 0;
+  for (int t = 0; t < PROFILE_MAX_THREADS; ++t) {
+    for (int i = 0; i < PROFILE_MAX_KERNELS; ++i) {
+      const ProfileSlot* slot = &profile_tables_[t].slots[i];
+      const void* func = slot->func.load(std::memory_order_acquire);
+      uint64_t calls = slot->calls.load(std::memory_order_relaxed);
+      if (!func || !calls) {
+        continue;
+      }
+      if (kernels && count < max_kernels) {
+        ProfileKernel* kernel = &kernels[count];
+        kernel->func = func;
+        kernel->name = slot->name.load(std::memory_order_acquire);
+        kernel->thread = t;
+        kernel->calls = calls;
+        kernel->pixels = slot->pixels.load(std::memory_order_relaxed);
+        kernel->cycles = slot->cycles.load(std::memory_order_relaxed);
+      }
+      ++count;
+    }
+  }
+  return count;
+}
+
+LIBYUV_API
+void ResetProfile(void) {
+  for (int t = 0; t < PROFILE_MAX_THREADS; ++t) {
+    for (int i = 0; i < PROFILE_MAX_KERNELS; ++i) {
+      ProfileSlot* slot = &profile_tables_[t].slots[i];
+      slot->calls.store(0, std::memory_order_relaxed);
+      slot->pixels.store(0, std::memory_order_relaxed);
+      slot->cycles.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+static uint64_t MonotonicNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+LIBYUV_API
+uint64_t GetProfileCyclesPerSecond(void) {
+  uint64_t rate = profile_cycles_per_second_.load(std::memory_order_relaxed);
+  if (rate) {
+    return rate;
+  }
+  // Count cycles over 20ms of wall time.
+  uint64_t start_ns = MonotonicNs();
+  uint64_t start = ProfileCycles();
+  uint64_t elapsed_ns;
+  do {
+    elapsed_ns = MonotonicNs() - start_ns;
+  } while (elapsed_ns < 20000000);
+  rate = (ProfileCycles() - start) * 1000000000 / elapsed_ns;
+  profile_cycles_per_second_.store(rate, std::memory_order_relaxed);
+  return rate;
+}
+
+#else  // LIBYUV_PROFILE
+
+LIBYUV_API
+int ProfileEnabled(void) {
+  return 0;
+}
+
+LIBYUV_API
+void ProfileRecord(const void* func,
+                   const char* name,
+                   int pixels,
+                   uint64_t cycles) {
+  (void)func;
+  (void)name;
+  (void)pixels;
+  (void)cycles;
+}
+
+LIBYUV_API
+int GetProfileKernels(ProfileKernel* kernels, int max_kernels) {
+  (void)kernels;
+  (void)max_kernels;
+  return 0;
+}
+
+LIBYUV_API
+void ResetProfile(void) {}
+
+LIBYUV_API
+uint64_t GetProfileCyclesPerSecond(void) {
+  return 0;
+}
+
+#endif  // LIBYUV_PROFILE
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
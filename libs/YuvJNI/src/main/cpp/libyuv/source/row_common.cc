@@ -2054,6 +2054,20 @@ void MirrorUVRow_C(const uint8_t* src_uv,
   }
 }
 
+// Swap U and V of an interleaved UV row, e.g. NV12 to NV21.
+// Safe to use in place.
+void SwapUVRow_C(const uint8_t* src_uv, uint8_t* dst_vu, int width) {
+  int x;
+  for (x = 0; x < width; ++x) {
+    uint8_t u = src_uv[0];
+    uint8_t v = src_uv[1];
+    dst_vu[0] = v;
+    dst_vu[1] = u;
+    src_uv += 2;
+    dst_vu += 2;
+  }
+}
+
 void ARGBMirrorRow_C(const uint8_t* src, uint8_t* dst, int width) {
   int x;
   const uint32_t* src32 = (const uint32_t*)(src);
@@ -725,6 +725,23 @@ void MirrorUVRow_NEON(const uint8_t* src_uv,
       : "cc", "memory", "r12", "q0");
 }
 
+// Convert UV row of NV12 to VU row of NV21. Safe to use in place.
+void SwapUVRow_NEON(const uint8_t* src_uv, uint8_t* dst_vu, int width) {
+  asm volatile(
+      "1:                                        \n"
+      "vld1.8     {q0, q1}, [%0]!                \n"  // load 16 UV pairs
+      "subs       %2, %2, #16                    \n"  // 16 pairs per loop
+      "vrev16.8   q0, q0                         \n"  // swap U and V
+      "vrev16.8   q1, q1                         \n"
+      "vst1.8     {q0, q1}, [%1]!                \n"  // store 16 VU pairs
+      "bgt        1b                             \n"
+      : "+r"(src_uv),  // %0
+        "+r"(dst_vu),  // %1
+        "+r"(width)    // %2
+      :
+      : "cc", "memory", "q0", "q1");
+}
+
 void ARGBMirrorRow_NEON(const uint8_t* src, uint8_t* dst, int width) {
   asm volatile(
       // Start at end of source row.
@@ -2086,6 +2103,38 @@ void InterpolateRow_NEON(uint8_t* dst_ptr,
       : "cc", "memory", "q0", "q1", "d4", "d5", "q13", "q14");
 }
 
+// Blend 16 pixels at a time.
+// dst = (src0 * alpha + src1 * (255 - alpha) + 255) / 256
+void BlendPlaneRow_NEON(const uint8_t* src0,
+                        const uint8_t* src1,
+                        const uint8_t* alpha,
+                        uint8_t* dst,
+                        int width) {
+  asm volatile(
+      "vmov.i16   q15, #255                      \n"  // rounding
+      "1:                                        \n"
+      "vld1.8     {q0}, [%0]!                    \n"  // load 16 src0
+      "vld1.8     {q1}, [%1]!                    \n"  // load 16 src1
+      "vld1.8     {q2}, [%2]!                    \n"  // load 16 alpha
+      "subs       %4, %4, #16                    \n"  // 16 processed per loop.
+      "vmvn       q3, q2                         \n"  // 255 - alpha
+      "vmull.u8   q8, d0, d4                     \n"  // src0 * alpha
+      "vmull.u8   q9, d1, d5                     \n"
+      "vmlal.u8   q8, d2, d6                     \n"  // + src1 * (255 - alpha)
+      "vmlal.u8   q9, d3, d7                     \n"
+      "vaddhn.i16 d0, q8, q15                    \n"  // (+ 255) >> 8
+      "vaddhn.i16 d1, q9, q15                    \n"
+      "vst1.8     {q0}, [%3]!                    \n"  // store 16 pixels
+      "bgt        1b                             \n"
+      : "+r"(src0),   // %0
+        "+r"(src1),   // %1
+        "+r"(alpha),  // %2
+        "+r"(dst),    // %3
+        "+r"(width)   // %4
+      :
+      : "cc", "memory", "q0", "q1", "q2", "q3", "q8", "q9", "q15");
+}
+
 // dr * (256 - sa) / 256 + sr = dr - dr * sa / 256 + sr
 void ARGBBlendRow_NEON(const uint8_t* src_argb0,
                        const uint8_t* src_argb1,
@@ -766,6 +766,23 @@ void MirrorUVRow_NEON(const uint8_t* src_uv,
       : "cc", "memory", "v0", "v1");
 }
 
+// Convert UV row of NV12 to VU row of NV21. Safe to use in place.
+void SwapUVRow_NEON(const uint8_t* src_uv, uint8_t* dst_vu, int width) {
+  asm volatile(
+      "1:                                        \n"
+      "ld1        {v0.16b, v1.16b}, [%0], #32    \n"  // load 16 UV pairs
+      "subs       %w2, %w2, #16                  \n"  // 16 pairs per loop
+      "rev16      v0.16b, v0.16b                 \n"  // swap U and V
+      "rev16      v1.16b, v1.16b                 \n"
+      "st1        {v0.16b, v1.16b}, [%1], #32    \n"  // store 16 VU pairs
+      "b.gt       1b                             \n"
+      : "+r"(src_uv),  // %0
+        "+r"(dst_vu),  // %1
+        "+r"(width)    // %2
+      :
+      : "cc", "memory", "v0", "v1");
+}
+
 void ARGBMirrorRow_NEON(const uint8_t* src, uint8_t* dst, int width) {
   asm volatile(
       // Start at end of source row.
@@ -2118,6 +2135,38 @@ void InterpolateRow_NEON(uint8_t* dst_ptr,
       : "cc", "memory", "v0", "v1", "v3", "v4", "v5");
 }
 
+// Blend 16 pixels at a time.
+// dst = (src0 * alpha + src1 * (255 - alpha) + 255) / 256
+void BlendPlaneRow_NEON(const uint8_t* src0,
+                        const uint8_t* src1,
+                        const uint8_t* alpha,
+                        uint8_t* dst,
+                        int width) {
+  asm volatile(
+      "movi       v31.8h, #255                   \n"  // rounding
+      "1:                                        \n"
+      "ld1        {v0.16b}, [%0], #16            \n"  // load 16 src0
+      "ld1        {v1.16b}, [%1], #16            \n"  // load 16 src1
+      "ld1        {v2.16b}, [%2], #16            \n"  // load 16 alpha
+      "subs       %w4, %w4, #16                  \n"  // 16 processed per loop.
+      "mvn        v3.16b, v2.16b                 \n"  // 255 - alpha
+      "umull      v4.8h, v0.8b, v2.8b            \n"  // src0 * alpha
+      "umull2     v5.8h, v0.16b, v2.16b          \n"
+      "umlal      v4.8h, v1.8b, v3.8b            \n"  // + src1 * (255 - alpha)
+      "umlal2     v5.8h, v1.16b, v3.16b          \n"
+      "addhn      v6.8b, v4.8h, v31.8h           \n"  // (+ 255) >> 8
+      "addhn2     v6.16b, v5.8h, v31.8h          \n"
+      "st1        {v6.16b}, [%3], #16            \n"  // store 16 pixels
+      "b.gt       1b                             \n"
+      : "+r"(src0),   // %0
+        "+r"(src1),   // %1
+        "+r"(alpha),  // %2
+        "+r"(dst),    // %3
+        "+r"(width)   // %4
+      :
+      : "cc", "memory", "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v31");
+}
+
 // dr * (256 - sa) / 256 + sr = dr - dr * sa / 256 + sr
 void ARGBBlendRow_NEON(const uint8_t* src_argb0,
                        const uint8_t* src_argb1,
@@ -15,6 +15,7 @@
 
 #include "libyuv/cpu_id.h"
 #include "libyuv/planar_functions.h"  // For CopyPlane
+#include "libyuv/profile.h"
 #include "libyuv/row.h"
 #include "libyuv/scale_row.h"
 
@@ -139,7 +140,8 @@ static void ScalePlaneDown2(int src_width,
   }
   // TODO(fbarchard): Loop through source height to allow odd height.
   for (y = 0; y < dst_height; ++y) {
-    ScaleRowDown2(src_ptr, src_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown2, dst_width, src_ptr, src_stride, dst_ptr,
+                dst_width);
     src_ptr += row_stride;
     dst_ptr += dst_stride;
   }
@@ -198,7 +200,8 @@ static void ScalePlaneDown2_16(int src_width,
   }
   // TODO(fbarchard): Loop through source height to allow odd height.
   for (y = 0; y < dst_height; ++y) {
-    ScaleRowDown2(src_ptr, src_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown2, dst_width, src_ptr, src_stride, dst_ptr,
+                dst_width);
     src_ptr += row_stride;
     dst_ptr += dst_stride;
   }
@@ -278,7 +281,8 @@ static void ScalePlaneDown4(int src_width,
     src_stride = 0;
   }
   for (y = 0; y < dst_height; ++y) {
-    ScaleRowDown4(src_ptr, src_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown4, dst_width, src_ptr, src_stride, dst_ptr,
+                dst_width);
     src_ptr += row_stride;
     dst_ptr += dst_stride;
   }
@@ -326,7 +330,8 @@ static void ScalePlaneDown4_16(int src_width,
     src_stride = 0;
   }
   for (y = 0; y < dst_height; ++y) {
-    ScaleRowDown4(src_ptr, src_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown4, dst_width, src_ptr, src_stride, dst_ptr,
+                dst_width);
     src_ptr += row_stride;
     dst_ptr += dst_stride;
   }
@@ -420,25 +425,29 @@ static void ScalePlaneDown34(int src_width,
 #endif
 
   for (y = 0; y < dst_height - 2; y += 3) {
-    ScaleRowDown34_0(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_0, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride;
     dst_ptr += dst_stride;
-    ScaleRowDown34_1(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_1, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride;
     dst_ptr += dst_stride;
-    ScaleRowDown34_0(src_ptr + src_stride, -filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_0, dst_width, src_ptr + src_stride,
+                -filter_stride, dst_ptr, dst_width);
     src_ptr += src_stride * 2;
     dst_ptr += dst_stride;
   }
 
   // Remainder 1 or 2 rows with last row vertically unfiltered
   if ((dst_height % 3) == 2) {
-    ScaleRowDown34_0(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_0, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride;
     dst_ptr += dst_stride;
-    ScaleRowDown34_1(src_ptr, 0, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_1, dst_width, src_ptr, 0, dst_ptr, dst_width);
   } else if ((dst_height % 3) == 1) {
-    ScaleRowDown34_0(src_ptr, 0, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_0, dst_width, src_ptr, 0, dst_ptr, dst_width);
   }
 }
 
@@ -491,25 +500,29 @@ static void ScalePlaneDown34_16(int src_width,
 #endif
 
   for (y = 0; y < dst_height - 2; y += 3) {
-    ScaleRowDown34_0(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_0, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride;
     dst_ptr += dst_stride;
-    ScaleRowDown34_1(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_1, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride;
     dst_ptr += dst_stride;
-    ScaleRowDown34_0(src_ptr + src_stride, -filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_0, dst_width, src_ptr + src_stride,
+                -filter_stride, dst_ptr, dst_width);
     src_ptr += src_stride * 2;
     dst_ptr += dst_stride;
   }
 
   // Remainder 1 or 2 rows with last row vertically unfiltered
   if ((dst_height % 3) == 2) {
-    ScaleRowDown34_0(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_0, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride;
     dst_ptr += dst_stride;
-    ScaleRowDown34_1(src_ptr, 0, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_1, dst_width, src_ptr, 0, dst_ptr, dst_width);
   } else if ((dst_height % 3) == 1) {
-    ScaleRowDown34_0(src_ptr, 0, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown34_0, dst_width, src_ptr, 0, dst_ptr, dst_width);
   }
 }
 
@@ -615,25 +628,29 @@ static void ScalePlaneDown38(int src_width,
 #endif
 
   for (y = 0; y < dst_height - 2; y += 3) {
-    ScaleRowDown38_3(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_3, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride * 3;
     dst_ptr += dst_stride;
-    ScaleRowDown38_3(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_3, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride * 3;
     dst_ptr += dst_stride;
-    ScaleRowDown38_2(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_2, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride * 2;
     dst_ptr += dst_stride;
   }
 
   // Remainder 1 or 2 rows with last row vertically unfiltered
   if ((dst_height % 3) == 2) {
-    ScaleRowDown38_3(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_3, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride * 3;
     dst_ptr += dst_stride;
-    ScaleRowDown38_3(src_ptr, 0, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_3, dst_width, src_ptr, 0, dst_ptr, dst_width);
   } else if ((dst_height % 3) == 1) {
-    ScaleRowDown38_3(src_ptr, 0, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_3, dst_width, src_ptr, 0, dst_ptr, dst_width);
   }
 }
 
@@ -686,25 +703,29 @@ static void ScalePlaneDown38_16(int src_width,
 #endif
 
   for (y = 0; y < dst_height - 2; y += 3) {
-    ScaleRowDown38_3(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_3, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride * 3;
     dst_ptr += dst_stride;
-    ScaleRowDown38_3(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_3, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride * 3;
     dst_ptr += dst_stride;
-    ScaleRowDown38_2(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_2, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride * 2;
     dst_ptr += dst_stride;
   }
 
   // Remainder 1 or 2 rows with last row vertically unfiltered
   if ((dst_height % 3) == 2) {
-    ScaleRowDown38_3(src_ptr, filter_stride, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_3, dst_width, src_ptr, filter_stride, dst_ptr,
+                dst_width);
     src_ptr += src_stride * 3;
     dst_ptr += dst_stride;
-    ScaleRowDown38_3(src_ptr, 0, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_3, dst_width, src_ptr, 0, dst_ptr, dst_width);
   } else if ((dst_height % 3) == 1) {
-    ScaleRowDown38_3(src_ptr, 0, dst_ptr, dst_width);
+    PROFILE_ROW(ScaleRowDown38_3, dst_width, src_ptr, 0, dst_ptr, dst_width);
   }
 }
 
@@ -906,10 +927,11 @@ static void ScalePlaneBox(int src_width,
       boxheight = MIN1((y >> 16) - iy);
       memset(row16, 0, src_width * 2);
       for (k = 0; k < boxheight; ++k) {
-        ScaleAddRow(src, (uint16_t*)(row16), src_width);
+        PROFILE_ROW(ScaleAddRow, src_width, src, (uint16_t*)(row16), src_width);
         src += src_stride;
       }
-      ScaleAddCols(dst_width, boxheight, x, dx, (uint16_t*)(row16), dst_ptr);
+      PROFILE_ROW(ScaleAddCols, dst_width, dst_width, boxheight, x, dx,
+                  (uint16_t*)(row16), dst_ptr);
       dst_ptr += dst_stride;
     }
     free_aligned_buffer_64(row16);
@@ -965,10 +987,11 @@ static void ScalePlaneBox_16(int src_width,
       boxheight = MIN1((y >> 16) - iy);
       memset(row32, 0, src_width * 4);
       for (k = 0; k < boxheight; ++k) {
-        ScaleAddRow(src, (uint32_t*)(row32), src_width);
+        PROFILE_ROW(ScaleAddRow, src_width, src, (uint32_t*)(row32), src_width);
         src += src_stride;
       }
-      ScaleAddCols(dst_width, boxheight, x, dx, (uint32_t*)(row32), dst_ptr);
+      PROFILE_ROW(ScaleAddCols, dst_width, dst_width, boxheight, x, dx,
+                  (uint32_t*)(row32), dst_ptr);
       dst_ptr += dst_stride;
     }
     free_aligned_buffer_64(row32);
@@ -1076,11 +1099,12 @@ void ScalePlaneBilinearDown(int src_width,
     int yi = y >> 16;
     const uint8_t* src = src_ptr + yi * src_stride;
     if (filtering == kFilterLinear) {
-      ScaleFilterCols(dst_ptr, src, dst_width, x, dx);
+      PROFILE_ROW(ScaleFilterCols, dst_width, dst_ptr, src, dst_width, x, dx);
     } else {
       int yf = (y >> 8) & 255;
-      InterpolateRow(row, src, src_stride, src_width, yf);
-      ScaleFilterCols(dst_ptr, row, dst_width, x, dx);
+      PROFILE_ROW(InterpolateRow, src_width, row, src, src_stride, src_width,
+                  yf);
+      PROFILE_ROW(ScaleFilterCols, dst_width, dst_ptr, row, dst_width, x, dx);
     }
     dst_ptr += dst_stride;
     y += dy;
@@ -1167,11 +1191,13 @@ void ScalePlaneBilinearDown_16(int src_width,
     int yi = y >> 16;
     const uint16_t* src = src_ptr + yi * src_stride;
     if (filtering == kFilterLinear) {
-      ScaleFilterCols(dst_ptr, src, dst_width, x, dx);
+      PROFILE_ROW(ScaleFilterCols, dst_width, dst_ptr, src, dst_width, x, dx);
     } else {
       int yf = (y >> 8) & 255;
-      InterpolateRow((uint16_t*)row, src, src_stride, src_width, yf);
-      ScaleFilterCols(dst_ptr, (uint16_t*)row, dst_width, x, dx);
+      PROFILE_ROW(InterpolateRow, src_width, (uint16_t*)row, src, src_stride,
+                  src_width, yf);
+      PROFILE_ROW(ScaleFilterCols, dst_width, dst_ptr, (uint16_t*)row,
+                  dst_width, x, dx);
     }
     dst_ptr += dst_stride;
     y += dy;
@@ -1287,11 +1313,12 @@ void ScalePlaneBilinearUp(int src_width,
     int rowstride = kRowSize;
     int lasty = yi;
 
-    ScaleFilterCols(rowptr, src, dst_width, x, dx);
+    PROFILE_ROW(ScaleFilterCols, dst_width, rowptr, src, dst_width, x, dx);
     if (src_height > 1) {
       src += src_stride;
     }
-    ScaleFilterCols(rowptr + rowstride, src, dst_width, x, dx);
+    PROFILE_ROW(ScaleFilterCols, dst_width, rowptr + rowstride, src, dst_width,
+                x, dx);
     src += src_stride;
 
     for (j = 0; j < dst_height; ++j) {
@@ -1303,7 +1330,8 @@ void ScalePlaneBilinearUp(int src_width,
           src = src_ptr + yi * src_stride;
         }
         if (yi != lasty) {
-          ScaleFilterCols(rowptr, src, dst_width, x, dx);
+          PROFILE_ROW(ScaleFilterCols, dst_width, rowptr, src, dst_width, x,
+                      dx);
           rowptr += rowstride;
           rowstride = -rowstride;
           lasty = yi;
@@ -1311,10 +1339,12 @@ void ScalePlaneBilinearUp(int src_width,
         }
       }
       if (filtering == kFilterLinear) {
-        InterpolateRow(dst_ptr, rowptr, 0, dst_width, 0);
+        PROFILE_ROW(InterpolateRow, dst_width, dst_ptr, rowptr, 0, dst_width,
+                    0);
       } else {
         int yf = (y >> 8) & 255;
-        InterpolateRow(dst_ptr, rowptr, rowstride, dst_width, yf);
+        PROFILE_ROW(InterpolateRow, dst_width, dst_ptr, rowptr, rowstride,
+                    dst_width, yf);
       }
       dst_ptr += dst_stride;
       y += dy;
@@ -1419,11 +1449,12 @@ void ScalePlaneBilinearUp_16(int src_width,
     int rowstride = kRowSize;
     int lasty = yi;
 
-    ScaleFilterCols(rowptr, src, dst_width, x, dx);
+    PROFILE_ROW(ScaleFilterCols, dst_width, rowptr, src, dst_width, x, dx);
     if (src_height > 1) {
       src += src_stride;
     }
-    ScaleFilterCols(rowptr + rowstride, src, dst_width, x, dx);
+    PROFILE_ROW(ScaleFilterCols, dst_width, rowptr + rowstride, src, dst_width,
+                x, dx);
     src += src_stride;
 
     for (j = 0; j < dst_height; ++j) {
@@ -1435,7 +1466,8 @@ void ScalePlaneBilinearUp_16(int src_width,
           src = src_ptr + yi * src_stride;
         }
         if (yi != lasty) {
-          ScaleFilterCols(rowptr, src, dst_width, x, dx);
+          PROFILE_ROW(ScaleFilterCols, dst_width, rowptr, src, dst_width, x,
+                      dx);
           rowptr += rowstride;
           rowstride = -rowstride;
           lasty = yi;
@@ -1443,10 +1475,12 @@ void ScalePlaneBilinearUp_16(int src_width,
         }
       }
       if (filtering == kFilterLinear) {
-        InterpolateRow(dst_ptr, rowptr, 0, dst_width, 0);
+        PROFILE_ROW(InterpolateRow, dst_width, dst_ptr, rowptr, 0, dst_width,
+                    0);
       } else {
         int yf = (y >> 8) & 255;
-        InterpolateRow(dst_ptr, rowptr, rowstride, dst_width, yf);
+        PROFILE_ROW(InterpolateRow, dst_width, dst_ptr, rowptr, rowstride,
+                    dst_width, yf);
       }
       dst_ptr += dst_stride;
       y += dy;
@@ -1495,7 +1529,8 @@ static void ScalePlaneSimple(int src_width,
   }
 
   for (i = 0; i < dst_height; ++i) {
-    ScaleCols(dst_ptr, src_ptr + (y >> 16) * src_stride, dst_width, x, dx);
+    PROFILE_ROW(ScaleCols, dst_width, dst_ptr, src_ptr + (y >> 16) * src_stride,
+                dst_width, x, dx);
     dst_ptr += dst_stride;
     y += dy;
   }
@@ -1536,7 +1571,8 @@ static void ScalePlaneSimple_16(int src_width,
   }
 
   for (i = 0; i < dst_height; ++i) {
-    ScaleCols(dst_ptr, src_ptr + (y >> 16) * src_stride, dst_width, x, dx);
+    PROFILE_ROW(ScaleCols, dst_width, dst_ptr, src_ptr + (y >> 16) * src_stride,
+                dst_width, x, dx);
     dst_ptr += dst_stride;
     y += dy;
   }
@@ -377,6 +377,22 @@ SDANY(ScaleARGBRowDown2Box_Any_SSE2,
       4,
       3)
 #endif
+#ifdef HAS_SCALEUVROWDOWN2BOX_SSSE3
+SDANY(ScaleUVRowDown2Box_Any_SSSE3,
+      ScaleUVRowDown2Box_SSSE3,
+      ScaleUVRowDown2Box_C,
+      2,
+      2,
+      3)
+#endif
+#ifdef HAS_SCALEUVROWDOWN2BOX_NEON
+SDANY(ScaleUVRowDown2Box_Any_NEON,
+      ScaleUVRowDown2Box_NEON,
+      ScaleUVRowDown2Box_C,
+      2,
+      2,
+      7)
+#endif
 #ifdef HAS_SCALEARGBROWDOWN2_NEON
 SDANY(ScaleARGBRowDown2_Any_NEON,
       ScaleARGBRowDown2_NEON,
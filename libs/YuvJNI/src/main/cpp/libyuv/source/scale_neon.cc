@@ -950,6 +950,36 @@ void ScaleARGBFilterCols_NEON(uint8_t* dst_argb,
 
 #undef LOAD2_DATA32_LANE
 
+// Reads 16 UV pairs from each of 2 rows, writes 8 averaged UV pairs.
+void ScaleUVRowDown2Box_NEON(const uint8_t* src_uv,
+                             ptrdiff_t src_stride,
+                             uint8_t* dst_uv,
+                             int dst_width) {
+  asm volatile(
+      // change the stride to row 2 pointer
+      "add        %1, %1, %0                     \n"
+      "1:                                        \n"
+      "vld2.8     {d0, d2}, [%0]!                \n"  // load 8 UV pixels.
+      "vld2.8     {d1, d3}, [%0]!                \n"  // load next 8 UV
+      "subs       %3, %3, #8                     \n"  // 8 processed per loop.
+      "vpaddl.u8  q0, q0                         \n"  // U 16 bytes -> 8 shorts.
+      "vpaddl.u8  q1, q1                         \n"  // V 16 bytes -> 8 shorts.
+      "vld2.8     {d16, d18}, [%1]!              \n"  // load 8 more UV
+      "vld2.8     {d17, d19}, [%1]!              \n"  // load last 8 UV
+      "vpadal.u8  q0, q8                         \n"  // U 16 bytes -> 8 shorts.
+      "vpadal.u8  q1, q9                         \n"  // V 16 bytes -> 8 shorts.
+      "vrshrn.u16 d0, q0, #2                     \n"  // round and pack to bytes
+      "vrshrn.u16 d1, q1, #2                     \n"
+      "vst2.8     {d0, d1}, [%2]!                \n"
+      "bgt        1b                             \n"
+      : "+r"(src_uv),      // %0
+        "+r"(src_stride),  // %1
+        "+r"(dst_uv),      // %2
+        "+r"(dst_width)    // %3
+      :
+      : "memory", "cc", "q0", "q1", "q8", "q9");
+}
+
 #endif  // defined(__ARM_NEON__) && !defined(__aarch64__)
 
 #ifdef __cplusplus
@@ -0,0 +1,76 @@
+/*
+ *  Copyright 2020 The LibYuv Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS. All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "libyuv/scratch.h"
+
+#include <stdlib.h>
+
+#include "libyuv/profile.h"
+
+#ifdef __cplusplus
+namespace libyuv {
+extern "C" {
+#endif
+
+static void* DefaultScratchAlloc(size_t size) {
+  return malloc(size);
+}
+
+static void DefaultScratchFree(void* ptr) {
+  free(ptr);
+}
+
+static ScratchAllocFunc scratch_alloc_ = DefaultScratchAlloc;
+static ScratchFreeFunc scratch_free_ = DefaultScratchFree;
+
+LIBYUV_API
+void SetScratchAllocator(ScratchAllocFunc alloc_func,
+                         ScratchFreeFunc free_func) {
+  if (alloc_func && free_func) {
+    scratch_alloc_ = alloc_func;
+    scratch_free_ = free_func;
+  } else {
+    scratch_alloc_ = DefaultScratchAlloc;
+    scratch_free_ = DefaultScratchFree;
+  }
+}
+
+LIBYUV_API
+void* ScratchAlloc(size_t size) {
+#ifdef LIBYUV_PROFILE
+  // Counted as a kernel so allocator time shows next to the row functions.
+  uint64_t start = ProfileCycles();
+  void* ptr = scratch_alloc_(size);
+  ProfileRecord((const void*)scratch_alloc_, "ScratchAlloc", (int)size,
+                ProfileCycles() - start);
+  return ptr;
+#else
+  return scratch_alloc_(size);
+#endif
+}
+
+LIBYUV_API
+void ScratchFree(void* ptr) {
+  if (ptr) {
+#ifdef LIBYUV_PROFILE
+    uint64_t start = ProfileCycles();
+    scratch_free_(ptr);
+    ProfileRecord((const void*)scratch_free_, "ScratchFree", 0,
+                  ProfileCycles() - start);
+#else
+    scratch_free_(ptr);
+#endif
+  }
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+}  // namespace libyuv
+#endif
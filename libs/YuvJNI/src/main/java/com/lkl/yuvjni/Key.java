@@ -37,6 +37,51 @@ public final class Key {
     public static final int ROTATE_180 = 1;
     public static final int ROTATE_270 = 2;
 
+    //YUV420数据格式
+    public static final int YUV_I420 = 0;
+    public static final int YUV_NV12 = 1;
+    public static final int YUV_NV21 = 2;
+
+    //时间水印格式，yyyy-MM-dd HH:mm:ss 及 yyyy-MM-dd HH:mm:ss.SSS
+    public static final int TIME_FORMAT_DATE_TIME = 0;
+    public static final int TIME_FORMAT_DATE_TIME_MS = 1;
+
+    //一次批量处理最多的帧数
+    public static final int BATCH_MAX_FRAMES = 64;
+
+    //异步任务的操作类型
+    public static final int JOB_NV21_TO_I420 = 0;
+    public static final int JOB_I420_TO_NV21 = 1;
+    public static final int JOB_NV21_TO_ARGB = 2;
+    public static final int JOB_NV21_SCALE = 3;
+    public static final int JOB_TRANSFORM_PLAN = 4;
+    public static final int JOB_DRAW_TIMESTAMP = 5;
+    public static final int JOB_GRAPH = 6;
+
+    //异步任务的状态，另外0成功，-1失败
+    public static final int JOB_PENDING = 1;
+    public static final int JOB_UNKNOWN = -2;
+
+    //CPU特性位，同 libyuv cpu_id.h 中的 kCpuHasXXX
+    public static final int CPU_HAS_ARM = 0x2;
+    public static final int CPU_HAS_NEON = 0x4;
+    public static final int CPU_HAS_X86 = 0x10;
+    public static final int CPU_HAS_SSE2 = 0x20;
+    public static final int CPU_HAS_SSSE3 = 0x40;
+    public static final int CPU_HAS_SSE41 = 0x80;
+    public static final int CPU_HAS_SSE42 = 0x100;
+    public static final int CPU_HAS_AVX = 0x200;
+    public static final int CPU_HAS_AVX2 = 0x400;
+    public static final int CPU_HAS_ERMS = 0x800;
+    public static final int CPU_HAS_AVX512BW = 0x8000;
+    public static final int CPU_HAS_MIPS = 0x200000;
+    public static final int CPU_HAS_MSA = 0x400000;
+    public static final int CPU_HAS_MMI = 0x800000;
+
+    //maskCpuFlags 的参数：恢复全部特性、只用C实现
+    public static final int CPU_FLAGS_ALL = -1;
+    public static final int CPU_FLAGS_C_ONLY = 1;
+
     //类型
     //低16位分别表示ABGR所在的位置
     //28-31表示类型分类
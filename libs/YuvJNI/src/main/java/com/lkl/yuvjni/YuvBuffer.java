@@ -0,0 +1,82 @@
+package com.lkl.yuvjni;
+
+import java.nio.ByteBuffer;
+
+/**
+ * native 帧缓冲池中的一块内存，64字节对齐，可直接传给 {@link YuvUtils} 的 ByteBuffer 及 long 地址版本的方法
+ * <p>
+ * 同尺寸的帧反复 obtain / close 时复用同一块内存，帧数据不占用 Java 堆，不再触发GC；
+ * 不会随 GC 自动回收，使用完必须调用 {@link #close()} 归还，非线程安全，同一时刻只应由一个线程持有
+ *
+ * @author likunlun
+ * @since 2026/10/19
+ */
+public final class YuvBuffer implements AutoCloseable {
+    private long handle;
+    private final long address;
+    private final int size;
+    private ByteBuffer buffer;
+
+    private YuvBuffer(long handle, int size) {
+        this.handle = handle;
+        this.address = YuvUtils.getBufferAddress(handle);
+        this.size = size;
+    }
+
+    /**
+     * 从缓冲池取一块至少 size 字节的内存，内容未初始化
+     *
+     * @throws OutOfMemoryError 分配失败
+     */
+    public static YuvBuffer obtain(int size) {
+        long handle = YuvUtils.acquireBuffer(size);
+        if (handle == 0) {
+            throw new OutOfMemoryError("acquire native buffer failed, size " + size);
+        }
+        return new YuvBuffer(handle, size);
+    }
+
+    /**
+     * 数据的 native 地址，用于 YuvUtils 中 native 内存地址版本的方法
+     */
+    public long address() {
+        checkValid();
+        return address;
+    }
+
+    /**
+     * 数据大小
+     */
+    public int size() {
+        return size;
+    }
+
+    /**
+     * 包装数据的 direct ByteBuffer，首次调用时创建，之后返回同一个对象（position / limit 由调用方维护）
+     */
+    public ByteBuffer buffer() {
+        checkValid();
+        if (buffer == null) {
+            buffer = YuvUtils.wrapBuffer(handle);
+        }
+        return buffer;
+    }
+
+    /**
+     * 归还到缓冲池，之后不能再访问 address() 及 buffer() 返回的数据，重复调用无影响
+     */
+    @Override
+    public void close() {
+        if (handle != 0) {
+            YuvUtils.releaseBuffer(handle);
+            handle = 0;
+            buffer = null;
+        }
+    }
+
+    private void checkValid() {
+        if (handle == 0) {
+            throw new IllegalStateException("YuvBuffer already closed");
+        }
+    }
+}
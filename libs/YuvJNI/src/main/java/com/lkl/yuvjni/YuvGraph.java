@@ -0,0 +1,136 @@
+package com.lkl.yuvjni;
+
+import java.nio.ByteBuffer;
+
+/**
+ * 声明式的YUV处理链，如 裁剪 → 缩放 → 叠加水印 → 输出为编码器需要的格式，创建时描述一次，之后每帧只传入数据：
+ * <pre>
+ * YuvGraph graph = new YuvGraph(width, height, Key.YUV_NV21)
+ *         .crop(x, y, cropWidth, cropHeight)
+ *         .scale(1280, 720, Key.SCALE_MODE_LINEAR)
+ *         .overlay(watermark, 32, 32)
+ *         .prepare(Key.YUV_NV12);
+ * graph.execute(nv21, dst);
+ * </pre>
+ * native按带流式执行所有节点，中间结果不经过内存；不会随 GC 自动回收，使用完必须调用 {@link #close()}，非线程安全
+ *
+ * @author likunlun
+ * @since 2026/10/19
+ */
+public final class YuvGraph implements AutoCloseable {
+    private long handle;
+    private int size = -1;
+
+    /**
+     * @param srcFormat {@link Key#YUV_I420}、{@link Key#YUV_NV12}、{@link Key#YUV_NV21}
+     */
+    public YuvGraph(int srcWidth, int srcHeight, int srcFormat) {
+        this(srcWidth, srcHeight, srcWidth, srcHeight, srcFormat);
+    }
+
+    /**
+     * @param srcStride      源数据Y分量每行的字节数
+     * @param srcSliceHeight 源数据Y分量的行数，色度紧跟其后
+     * @throws IllegalArgumentException 参数错误
+     */
+    public YuvGraph(int srcWidth, int srcHeight, int srcStride, int srcSliceHeight, int srcFormat) {
+        handle = YuvUtils.createGraph(srcWidth, srcHeight, srcStride, srcSliceHeight, srcFormat);
+        if (handle == 0) {
+            throw new IllegalArgumentException("invalid graph source " + srcWidth + "x" + srcHeight);
+        }
+    }
+
+    public YuvGraph crop(int x, int y, int width, int height) {
+        return check(YuvUtils.graphCrop(checkValid(), x, y, width, height), "crop");
+    }
+
+    public YuvGraph scale(int width, int height, int mode) {
+        return check(YuvUtils.graphScale(checkValid(), width, height, mode), "scale");
+    }
+
+    public YuvGraph rotate(int rotation) {
+        return check(YuvUtils.graphRotate(checkValid(), rotation), "rotate");
+    }
+
+    /**
+     * @param overlay {@link YuvUtils#createOverlay(byte[], int, int, int)} 创建的图层，追加后即可释放
+     */
+    public YuvGraph overlay(long overlay, int x, int y) {
+        return check(YuvUtils.graphOverlay(checkValid(), overlay, x, y), "overlay");
+    }
+
+    /**
+     * 输出紧凑排列的数据
+     */
+    public YuvGraph prepare(int dstFormat) {
+        return prepare(0, 0, dstFormat);
+    }
+
+    /**
+     * 指定输出格式，之后不能再追加节点
+     *
+     * @param dstStride      目标Y分量每行的字节数，0为输出宽度
+     * @param dstSliceHeight 目标Y分量的行数，0为输出高度
+     */
+    public YuvGraph prepare(int dstStride, int dstSliceHeight, int dstFormat) {
+        size = YuvUtils.prepareGraph(checkValid(), dstStride, dstSliceHeight, dstFormat);
+        if (size < 0) {
+            throw new IllegalArgumentException("prepare graph failed");
+        }
+        return this;
+    }
+
+    /**
+     * 目标数据的长度，prepare 之前为-1
+     */
+    public int size() {
+        return size;
+    }
+
+    public int execute(byte[] src, byte[] dst) {
+        return YuvUtils.executeGraph(checkValid(), src, dst);
+    }
+
+    public int execute(ByteBuffer src, int srcOffset, ByteBuffer dst, int dstOffset) {
+        return YuvUtils.executeGraph(checkValid(), src, srcOffset, dst, dstOffset);
+    }
+
+    public int execute(YuvBuffer src, YuvBuffer dst) {
+        return YuvUtils.executeGraph(checkValid(), src.address(), dst.address());
+    }
+
+    /**
+     * 释放处理图，重复调用无影响
+     */
+    @Override
+    public void close() {
+        if (handle != 0) {
+            YuvUtils.releaseGraph(handle);
+            handle = 0;
+        }
+    }
+
+    /**
+     * 已 prepare 的处理图句柄，用于提交异步任务
+     */
+    long preparedHandle() {
+        if (size < 0) {
+            throw new IllegalStateException("YuvGraph not prepared");
+        }
+        return checkValid();
+    }
+
+    private YuvGraph check(int ret, String node) {
+        if (ret != 0) {
+            throw new IllegalArgumentException("add " + node + " node failed");
+        }
+        return this;
+    }
+
+    private long checkValid() {
+        if (handle == 0) {
+            throw new IllegalStateException("YuvGraph already closed");
+        }
+        return handle;
+    }
+}
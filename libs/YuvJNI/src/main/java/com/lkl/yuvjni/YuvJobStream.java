@@ -0,0 +1,209 @@
+package com.lkl.yuvjni;
+
+import android.os.Build;
+import android.os.Looper;
+import android.os.MessageQueue;
+import android.os.ParcelFileDescriptor;
+import android.system.ErrnoException;
+import android.system.Os;
+
+import androidx.annotation.RequiresApi;
+
+import java.io.FileDescriptor;
+import java.io.IOException;
+
+/**
+ * 异步转换任务流，提交后立即返回任务ID，转换在native执行，调用线程可以同时等待编码器的缓冲区，转换与送帧流水线进行：
+ * <pre>
+ * long job = stream.nv21ToI420(nv21, i420, width, height, false);
+ * int index = codec.dequeueInputBuffer(timeout);
+ * if (stream.await(job, -1) == 0) { ... }
+ * </pre>
+ * 同一个任务流的任务按提交顺序执行，帧数据必须是 {@link YuvBuffer}，任务完成前不能归还或修改；
+ * 不会随 GC 自动回收，使用完必须调用 {@link #close()}，提交方法线程安全
+ *
+ * @author likunlun
+ * @since 2026/10/19
+ */
+public final class YuvJobStream implements AutoCloseable {
+    /**
+     * 任务完成回调，在注册时指定的 Looper 线程执行
+     */
+    public interface OnJobsCompleteListener {
+        /**
+         * @param completedJob 最近完成的任务ID，不大于该ID的任务都已完成
+         */
+        void onJobsComplete(long completedJob);
+    }
+
+    private long handle;
+    // 单帧任务复用的参数数组
+    private final long[] srcAddresses = new long[1];
+    private final long[] dstAddresses = new long[1];
+    private final long[] timestamps = new long[1];
+
+    private ParcelFileDescriptor eventFd;
+    private MessageQueue eventQueue;
+
+    /**
+     * @throws IllegalStateException 创建失败
+     */
+    public YuvJobStream() {
+        handle = YuvUtils.createJobStream();
+        if (handle == 0) {
+            throw new IllegalStateException("create job stream failed");
+        }
+    }
+
+    public synchronized long nv21ToI420(YuvBuffer nv21, YuvBuffer i420, int width, int height, boolean swapUV) {
+        return submit(Key.JOB_NV21_TO_I420, nv21, i420, width, height, 0, 0, 0, swapUV, 0);
+    }
+
+    public synchronized long i420ToNV21(YuvBuffer i420, YuvBuffer nv21, int width, int height, boolean swapUV) {
+        return submit(Key.JOB_I420_TO_NV21, i420, nv21, width, height, 0, 0, 0, swapUV, 0);
+    }
+
+    public synchronized long nv21ToArgb(YuvBuffer nv21, YuvBuffer argb, int width, int height) {
+        return submit(Key.JOB_NV21_TO_ARGB, nv21, argb, width, height, 0, 0, 0, false, 0);
+    }
+
+    public synchronized long nv21Scale(YuvBuffer src, int width, int height, YuvBuffer dst, int dstWidth,
+                                       int dstHeight, int mode) {
+        return submit(Key.JOB_NV21_SCALE, src, dst, width, height, dstWidth, dstHeight, mode, false, 0);
+    }
+
+    /**
+     * @param plan {@link YuvUtils#createTransformPlan} 创建的方案，任务完成前不能释放
+     */
+    public synchronized long transform(long plan, YuvBuffer src, YuvBuffer dst) {
+        return submit(Key.JOB_TRANSFORM_PLAN, src, dst, 0, 0, 0, 0, 0, false, plan);
+    }
+
+    /**
+     * @param graph 已 prepare 的处理图，任务完成前不能关闭，也不能在其他线程同时执行
+     */
+    public synchronized long execute(YuvGraph graph, YuvBuffer src, YuvBuffer dst) {
+        return submit(Key.JOB_GRAPH, src, dst, 0, 0, 0, 0, 0, false, graph.preparedHandle());
+    }
+
+    /**
+     * NV21数据上叠加时间水印
+     *
+     * @param atlas {@link YuvUtils#createGlyphAtlas()} 创建的字形表，任务完成前不能释放
+     */
+    public synchronized long drawTimestamp(YuvBuffer yuv, int width, int height, long atlas, long timestamp,
+                                           int format, int x, int y) {
+        srcAddresses[0] = yuv.address();
+        timestamps[0] = timestamp;
+        return YuvUtils.submitJob(checkValid(), Key.JOB_DRAW_TIMESTAMP, srcAddresses, null, 1, width, height, 0, 0, 0,
+                false, atlas, timestamps, format, x, y);
+    }
+
+    /**
+     * 查询任务结果，不等待
+     *
+     * @return {@link Key#JOB_PENDING} 未完成，0成功，-1失败，{@link Key#JOB_UNKNOWN} 任务不存在或结果已过期
+     */
+    public int poll(long job) {
+        return YuvUtils.pollJob(checkValid(), job);
+    }
+
+    /**
+     * 等待任务完成
+     *
+     * @param timeoutMs 最多等待的毫秒数，<0一直等待
+     * @return 同 {@link #poll(long)}，超时返回 {@link Key#JOB_PENDING}
+     */
+    public int await(long job, int timeoutMs) {
+        return YuvUtils.waitJob(checkValid(), job, timeoutMs);
+    }
+
+    /**
+     * 最近完成的任务ID
+     */
+    public long completedJob() {
+        return YuvUtils.getCompletedJob(checkValid());
+    }
+
+    /**
+     * 在 looper 线程上接收任务完成通知，多个任务接连完成时可能只回调一次；传null取消
+     */
+    @RequiresApi(Build.VERSION_CODES.M)
+    public synchronized void setOnJobsCompleteListener(Looper looper, OnJobsCompleteListener listener) {
+        removeEventListener();
+        if (listener == null) {
+            return;
+        }
+        int fd = YuvUtils.getJobStreamEventFd(checkValid());
+        if (fd < 0) {
+            throw new UnsupportedOperationException("job stream eventfd unavailable");
+        }
+        try {
+            // dup 一份，任务流释放时关闭自己的 fd，不影响 Looper 中的监听
+            eventFd = ParcelFileDescriptor.fromFd(fd);
+        } catch (IOException e) {
+            throw new IllegalStateException("dup job stream eventfd failed", e);
+        }
+        final byte[] counter = new byte[8];
+        eventQueue = looper.getQueue();
+        eventQueue.addOnFileDescriptorEventListener(eventFd.getFileDescriptor(),
+                MessageQueue.OnFileDescriptorEventListener.EVENT_INPUT, (FileDescriptor descriptor, int events) -> {
+                    try {
+                        // 读出计数，eventfd 恢复为不可读
+                        Os.read(descriptor, counter, 0, counter.length);
+                    } catch (ErrnoException | IOException ignored) {
+                    }
+                    long completedJob;
+                    synchronized (YuvJobStream.this) {
+                        if (handle == 0) {
+                            return 0;
+                        }
+                        completedJob = YuvUtils.getCompletedJob(handle);
+                    }
+                    listener.onJobsComplete(completedJob);
+                    return MessageQueue.OnFileDescriptorEventListener.EVENT_INPUT;
+                });
+    }
+
+    /**
+     * 等待已提交的任务全部完成后释放任务流，重复调用无影响
+     */
+    @Override
+    public synchronized void close() {
+        if (handle != 0) {
+            removeEventListener();
+            YuvUtils.releaseJobStream(handle);
+            handle = 0;
+        }
+    }
+
+    private long submit(int type, YuvBuffer srcBuffer, YuvBuffer dstBuffer, int width, int height, int dstWidth,
+                        int dstHeight, int mode, boolean swapUV, long target) {
+        srcAddresses[0] = srcBuffer.address();
+        dstAddresses[0] = dstBuffer.address();
+        return YuvUtils.submitJob(checkValid(), type, srcAddresses, dstAddresses, 1, width, height, dstWidth,
+                dstHeight, mode, swapUV, target, null, 0, 0, 0);
+    }
+
+    private void removeEventListener() {
+        if (eventFd == null) {
+            return;
+        }
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.M) {
+            eventQueue.removeOnFileDescriptorEventListener(eventFd.getFileDescriptor());
+        }
+        try {
+            eventFd.close();
+        } catch (IOException ignored) {
+        }
+        eventFd = null;
+        eventQueue = null;
+    }
+
+    private long checkValid() {
+        if (handle == 0) {
+            throw new IllegalStateException("YuvJobStream already closed");
+        }
+        return handle;
+    }
+}
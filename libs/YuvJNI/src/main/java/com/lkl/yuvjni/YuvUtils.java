@@ -1,5 +1,10 @@
 package com.lkl.yuvjni;
 
+import dalvik.annotation.optimization.CriticalNative;
+import dalvik.annotation.optimization.FastNative;
+
+import java.nio.ByteBuffer;
+
 /**
  * YUV 图片格式转换工具
  *
@@ -25,6 +30,7 @@ public class YuvUtils {
     // 1280 * 720 耗时 103 ms 左右
     public static native int NV21ToRgb24(byte[] yuv, byte[] rgb24, int width, int height);
 
+    // 按颜色键判断透明，文字边缘不自然，新代码使用 NV21BlendOverlays
     public static native void NV21AddWaterMark(int startX, int startY, byte[] waterMarkData, int waterMarkW, int waterMarkH, byte[] yuvData, int yuvW, int yuvH);
 
     public static native int I420ToRgba(int type, byte[] yuv, int y_stride, int u_stride, int v_stride,
@@ -49,6 +55,627 @@ public class YuvUtils {
 
     public static native void NV21CutData(byte[] tarYuv, byte[] srcYuv, int startW, int startH, int cutW, int cutH, int srcW, int srcH);
 
+    // ---------------- direct ByteBuffer 版本 ----------------
+    // 参数与 byte[] 版本一一对应，每个 buffer 后面跟一个字节偏移 offset；
+    // buffer 必须是 ByteBuffer.allocateDirect 或 MediaCodec/Image 等返回的 direct buffer，否则抛出 IllegalArgumentException
+
+    public static native int RgbaToI420(int type, ByteBuffer rgba, int rgbaOffset, int stride,
+                                        ByteBuffer yuv, int yuvOffset, int y_stride, int u_stride,
+                                        int v_stride, int width, int height);
+
+    public static native int RgbaToI420(int type, ByteBuffer rgba, int rgbaOffset, ByteBuffer yuv,
+                                        int yuvOffset, int width, int height);
+
+    public static native int ArgbToNV21(ByteBuffer rgba, int rgbaOffset, ByteBuffer yuv, int yuvOffset,
+                                        int width, int height);
+
+    public static native void NV12ToNV21(ByteBuffer yuv, int offset, int width, int height);
+
+    public static native int NV12ToArgb(ByteBuffer yuv, int yuvOffset, ByteBuffer argb, int argbOffset,
+                                        int width, int height);
+
+    public static native int NV21ToArgb(ByteBuffer yuv, int yuvOffset, ByteBuffer argb, int argbOffset,
+                                        int width, int height);
+
+    public static native int NV21ToRgb24(ByteBuffer yuv, int yuvOffset, ByteBuffer rgb24, int rgb24Offset,
+                                         int width, int height);
+
+    public static native void NV21AddWaterMark(int startX, int startY, ByteBuffer waterMarkData,
+                                               int waterMarkOffset, int waterMarkW, int waterMarkH,
+                                               ByteBuffer yuvData, int yuvOffset, int yuvW, int yuvH);
+
+    public static native int I420ToRgba(int type, ByteBuffer yuv, int yuvOffset, int y_stride,
+                                        int u_stride, int v_stride, ByteBuffer rgba, int rgbaOffset,
+                                        int stride, int width, int height);
+
+    public static native int I420ToRgba(int type, ByteBuffer yuv, int yuvOffset, ByteBuffer rgba,
+                                        int rgbaOffset, int width, int height);
+
+    public static native int I420ToNV21(ByteBuffer yuv420p, int srcOffset, ByteBuffer yuv420sp,
+                                        int dstOffset, int width, int height, boolean swapUV);
+
+    public static native int NV21ToI420(ByteBuffer yuv420sp, int srcOffset, ByteBuffer yuv420p,
+                                        int dstOffset, int width, int height, boolean swapUV);
+
+    public static native void NV21Scale(ByteBuffer src_data, int srcOffset, int width, int height,
+                                        ByteBuffer out, int dstOffset, int dst_width, int dst_height,
+                                        int type);
+
+    public static native void I420Scale(ByteBuffer src_data, int srcOffset, int width, int height,
+                                        ByteBuffer out, int dstOffset, int dst_width, int dst_height,
+                                        int type, boolean swapUV);
+
+    public static native void RgbaScale(ByteBuffer src_data, int srcOffset, int width, int height,
+                                        ByteBuffer out, int dstOffset, int dst_width, int dst_height,
+                                        int type);
+
+    public static native void NV21ToI420Rotate(ByteBuffer src, int srcOffset, int width, int height,
+                                               ByteBuffer dst, int dstOffset, int de, boolean swapUV);
+
+    public static native void NV21CutData(ByteBuffer tarYuv, int tarOffset, ByteBuffer srcYuv,
+                                          int srcOffset, int startW, int startH, int cutW, int cutH,
+                                          int srcW, int srcH);
+
+    /**
+     * NV21数据添加水印并转为YUV420，一次遍历直接写入 direct ByteBuffer（如 MediaCodec 的 InputBuffer），不修改源数据
+     *
+     * @param nv21           源NV21数据
+     * @param width          宽度
+     * @param height         高度
+     * @param waterMarkData  水印NV21数据，null 不添加水印
+     * @param waterMarkW     水印宽度
+     * @param waterMarkH     水印高度
+     * @param startX         水印左上角X坐标
+     * @param startY         水印左上角Y坐标
+     * @param dst            目标 direct ByteBuffer
+     * @param dstOffset      目标数据在 dst 中的偏移
+     * @param dstStride      目标Y分量每行的字节数
+     * @param dstSliceHeight 目标Y分量的行数
+     * @param dstFormat      目标格式 {@link Key#YUV_I420}、{@link Key#YUV_NV12}、{@link Key#YUV_NV21}
+     * @return 写入的数据长度，-1失败
+     */
+    public static native int NV21ToYuv420WithWaterMark(byte[] nv21, int width, int height,
+                                                       byte[] waterMarkData, int waterMarkW, int waterMarkH,
+                                                       int startX, int startY, ByteBuffer dst, int dstOffset,
+                                                       int dstStride, int dstSliceHeight, int dstFormat);
+
+    /**
+     * NV21、NV12数据一次完成裁剪、旋转、缩放并输出为I420、NV12或NV21，不产生整帧的中间数据拷贝
+     *
+     * @param src            源数据
+     * @param srcWidth       源数据宽度
+     * @param srcHeight      源数据高度
+     * @param srcStride      源数据Y、UV分量每行的字节数
+     * @param srcSliceHeight 源数据Y分量的行数，UV分量紧跟其后
+     * @param srcFormat      源数据格式 {@link Key#YUV_NV12}、{@link Key#YUV_NV21}
+     * @param cropX          裁剪区域左上角X坐标，按2对齐
+     * @param cropY          裁剪区域左上角Y坐标，按2对齐
+     * @param cropWidth      裁剪区域宽度，按2对齐
+     * @param cropHeight     裁剪区域高度，按2对齐
+     * @param rotation       顺时针旋转角度，0、90、180、270
+     * @param dst            目标数据
+     * @param dstWidth       旋转、缩放后的宽度，偶数
+     * @param dstHeight      旋转、缩放后的高度，偶数
+     * @param dstStride      目标Y分量每行的字节数，I420的U、V分量为其一半
+     * @param dstSliceHeight 目标Y分量的行数
+     * @param dstFormat      目标格式 {@link Key#YUV_I420}、{@link Key#YUV_NV12}、{@link Key#YUV_NV21}
+     * @param mode           缩放模式 Key.SCALE_MODE_XXX
+     * @return 目标数据的长度 dstStride * dstSliceHeight * 3 / 2，-1失败
+     */
+    public static native int YUV420SPTransform(byte[] src, int srcWidth, int srcHeight, int srcStride,
+                                               int srcSliceHeight, int srcFormat, int cropX, int cropY,
+                                               int cropWidth, int cropHeight, int rotation, byte[] dst,
+                                               int dstWidth, int dstHeight, int dstStride,
+                                               int dstSliceHeight, int dstFormat, int mode);
+
+    public static native int YUV420SPTransform(ByteBuffer src, int srcOffset, int srcWidth, int srcHeight,
+                                               int srcStride, int srcSliceHeight, int srcFormat, int cropX,
+                                               int cropY, int cropWidth, int cropHeight, int rotation,
+                                               ByteBuffer dst, int dstOffset, int dstWidth, int dstHeight,
+                                               int dstStride, int dstSliceHeight, int dstFormat, int mode);
+
+    /**
+     * 创建固定参数的裁剪、旋转、缩放方案，参数校验、偏移、处理路径只计算一次并预留临时内存，
+     * 之后每帧调用 executeTransformPlan 只需传入数据，适合录制期间尺寸不变的场景
+     * <p>
+     * 参数含义同 YUV420SPTransform，srcFormat 额外支持 {@link Key#YUV_I420}（U、V分量的stride为 srcStride 的一半）
+     *
+     * @return 方案句柄，0参数错误，不再使用时调用 {@link #releaseTransformPlan(long)} 释放
+     */
+    @CriticalNative
+    public static native long createTransformPlan(int srcWidth, int srcHeight, int srcStride, int srcSliceHeight,
+                                                  int srcFormat, int cropX, int cropY, int cropWidth,
+                                                  int cropHeight, int rotation, int dstWidth, int dstHeight,
+                                                  int dstStride, int dstSliceHeight, int dstFormat, int mode);
+
+    /**
+     * 按方案处理一帧，结果与同样参数的 YUV420SPTransform 一致；同一个方案不能同时在多个线程执行
+     *
+     * @return 目标数据的长度 dstStride * dstSliceHeight * 3 / 2，-1失败
+     */
+    public static native int executeTransformPlan(long plan, byte[] src, byte[] dst);
+
+    public static native int executeTransformPlan(long plan, ByteBuffer src, int srcOffset, ByteBuffer dst,
+                                                  int dstOffset);
+
+    @CriticalNative
+    public static native void releaseTransformPlan(long plan);
+
+    /**
+     * 创建处理图：依次追加裁剪、缩放、旋转、叠加图层节点描述整条处理链，{@link #prepareGraph(long, int, int, int)} 后每帧执行；
+     * 执行时按带（几十行）流式经过所有节点，中间结果留在缓存中，多步处理的内存带宽接近单次遍历，一般使用封装好的 {@link YuvGraph}
+     *
+     * @param srcFormat 源数据格式 {@link Key#YUV_I420}、{@link Key#YUV_NV12}、{@link Key#YUV_NV21}，其它参数含义同 createTransformPlan
+     * @return 处理图句柄，0参数错误，不再使用时调用 {@link #releaseGraph(long)} 释放
+     */
+    @CriticalNative
+    public static native long createGraph(int srcWidth, int srcHeight, int srcStride, int srcSliceHeight,
+                                          int srcFormat);
+
+    /**
+     * 追加裁剪节点，区域按2对齐
+     *
+     * @return 0成功，-1参数错误、节点已满（最多16个）或已经 prepareGraph
+     */
+    @CriticalNative
+    public static native int graphCrop(long graph, int x, int y, int width, int height);
+
+    /**
+     * 追加缩放节点，宽高为偶数，mode 为 Key.SCALE_MODE_XXX
+     */
+    @CriticalNative
+    public static native int graphScale(long graph, int width, int height, int mode);
+
+    /**
+     * 追加顺时针旋转节点，0、90、180、270
+     */
+    @CriticalNative
+    public static native int graphRotate(long graph, int rotation);
+
+    /**
+     * 追加叠加图层节点，图层数据在追加时拷贝，之后可以释放图层
+     *
+     * @param overlay {@link #createOverlay(byte[], int, int, int)} 创建的图层
+     */
+    @CriticalNative
+    public static native int graphOverlay(long graph, long overlay, int x, int y);
+
+    /**
+     * 指定输出格式并预留临时内存，之后不能再追加节点
+     *
+     * @param dstStride      目标Y分量每行的字节数，<=0为输出宽度
+     * @param dstSliceHeight 目标Y分量的行数，<=0为输出高度
+     * @param dstFormat 目标格式 {@link Key#YUV_I420}、{@link Key#YUV_NV12}、{@link Key#YUV_NV21}
+     * @return 目标数据的长度 dstStride * dstSliceHeight * 3 / 2，-1失败
+     */
+    @CriticalNative
+    public static native int prepareGraph(long graph, int dstStride, int dstSliceHeight, int dstFormat);
+
+    /**
+     * 按处理图处理一帧，结果与逐步调用各处理方法一致；同一个处理图不能同时在多个线程执行
+     *
+     * @return 目标数据的长度，-1失败
+     */
+    public static native int executeGraph(long graph, byte[] src, byte[] dst);
+
+    public static native int executeGraph(long graph, ByteBuffer src, int srcOffset, ByteBuffer dst, int dstOffset);
+
+    @CriticalNative
+    public static native void releaseGraph(long graph);
+
+    /**
+     * android.media.Image（YUV_420_888）的三个平面按 rowStride、pixelStride 打包为I420、NV12或NV21
+     *
+     * @param y             Y平面的 direct ByteBuffer，即 Image.Plane.getBuffer()
+     * @param yOffset       裁剪区域左上角在Y平面中的偏移
+     * @param yRowStride    Y平面每行的字节数
+     * @param u             U平面的 direct ByteBuffer
+     * @param uOffset       裁剪区域左上角在U平面中的偏移
+     * @param uRowStride    U平面每行的字节数
+     * @param v             V平面的 direct ByteBuffer
+     * @param vOffset       裁剪区域左上角在V平面中的偏移
+     * @param vRowStride    V平面每行的字节数
+     * @param uvPixelStride U、V平面相邻像素的间隔字节数
+     * @param dst           目标数据，紧凑排列，长度至少 width * height + ((width + 1) / 2) * ((height + 1) / 2) * 2
+     * @param width         宽度
+     * @param height        高度
+     * @param dstFormat     目标格式 {@link Key#YUV_I420}、{@link Key#YUV_NV12}、{@link Key#YUV_NV21}
+     * @return 写入的数据长度，-1失败
+     */
+    public static native int Android420ToYuv(ByteBuffer y, int yOffset, int yRowStride, ByteBuffer u, int uOffset,
+                                             int uRowStride, ByteBuffer v, int vOffset, int vRowStride,
+                                             int uvPixelStride, byte[] dst, int width, int height, int dstFormat);
+
+    public static native int Android420ToYuv(ByteBuffer y, int yOffset, int yRowStride, ByteBuffer u, int uOffset,
+                                             int uRowStride, ByteBuffer v, int vOffset, int vRowStride,
+                                             int uvPixelStride, ByteBuffer dst, int dstOffset, int width,
+                                             int height, int dstFormat);
+
+    /**
+     * 创建叠加图层（水印、点击提示、光标等），转为YUV和alpha平面后常驻内存，每帧叠加时直接使用
+     *
+     * @param rgba   预乘alpha的RGBA数据，即 Bitmap(ARGB_8888).copyPixelsToBuffer 的结果
+     * @param stride 每行的字节数，不小于 width * 4
+     * @param width  宽度
+     * @param height 高度
+     * @return 图层句柄，0失败，不再使用时调用 {@link #releaseOverlay(long)} 释放
+     * @throws IllegalArgumentException rgba 长度小于 stride * height 或 stride 不足一行
+     */
+    public static native long createOverlay(byte[] rgba, int stride, int width, int height);
+
+    @CriticalNative
+    public static native void releaseOverlay(long overlay);
+
+    /**
+     * NV21数据上按alpha混合叠加多个图层，超出图片范围的部分被裁剪
+     *
+     * @param yuv       NV21数据
+     * @param width     宽度
+     * @param height    高度
+     * @param overlays  {@link #createOverlay(byte[], int, int, int)} 创建的图层
+     * @param positions 每个图层左上角的坐标，x、y交替存放，按2对齐
+     * @param count     图层个数
+     */
+    public static native void NV21BlendOverlays(byte[] yuv, int width, int height, long[] overlays,
+                                                int[] positions, int count);
+
+    public static native void NV21BlendOverlays(ByteBuffer yuv, int offset, int width, int height,
+                                                long[] overlays, int[] positions, int count);
+
+    /**
+     * 创建空的字形表，通过 {@link #addGlyph(long, char, byte[], int, int, int)} 添加字形，
+     * 之后每帧用 {@link #NV21DrawTimestamp(byte[], int, int, long, long, int, int, int)} 逐字叠加时间水印
+     *
+     * @return 字形表句柄，0失败，不再使用时调用 {@link #releaseGlyphAtlas(long)} 释放
+     */
+    @FastNative
+    public static native long createGlyphAtlas();
+
+    /**
+     * 向字形表添加一个字形，字符渲染结果只转换一次YUV和alpha
+     *
+     * @param atlas  字形表
+     * @param glyph  字符，仅支持ASCII
+     * @param rgba   字符渲染结果，预乘alpha的RGBA数据
+     * @param stride 每行的字节数，不小于 width * 4
+     * @param width  宽度
+     * @param height 高度
+     * @return 0成功，-1失败
+     * @throws IllegalArgumentException rgba 长度小于 stride * height 或 stride 不足一行
+     */
+    public static native int addGlyph(long atlas, char glyph, byte[] rgba, int stride, int width, int height);
+
+    @CriticalNative
+    public static native void releaseGlyphAtlas(long atlas);
+
+    /**
+     * NV21数据上叠加时间水印，时间在native按本地时区格式化，每帧不生成Bitmap、不分配Java对象
+     *
+     * @param yuv       NV21数据
+     * @param width     宽度
+     * @param height    高度
+     * @param atlas     字形表
+     * @param timestamp 时间戳 ms
+     * @param format    {@link Key#TIME_FORMAT_DATE_TIME} 或 {@link Key#TIME_FORMAT_DATE_TIME_MS}
+     * @param x         左上角X坐标，按2对齐
+     * @param y         左上角Y坐标，按2对齐
+     * @return 绘制的宽度，-1失败
+     */
+    public static native int NV21DrawTimestamp(byte[] yuv, int width, int height, long atlas,
+                                               long timestamp, int format, int x, int y);
+
+    /**
+     * 计算时间水印的宽度
+     */
+    @CriticalNative
+    public static native int measureTimestamp(long atlas, long timestamp, int format);
+
+    /**
+     * 字形表中字形的最大高度
+     */
+    @CriticalNative
+    public static native int getGlyphAtlasHeight(long atlas);
+
+    /**
+     * 获取 direct ByteBuffer 的 native 内存地址，供下面 long 地址版本的方法使用，调用方需保证 buffer 在使用期间不被回收
+     */
+    @FastNative
+    public static native long getDirectBufferAddress(ByteBuffer buffer);
+
+    // ---------------- native 内存地址版本 ----------------
+    // 参数只有基本类型，省去 buffer 的查找和数组的锁定，适用于每秒调用次数很多的小帧；地址可带偏移，如 getDirectBufferAddress(buffer) + offset。
+    // 整帧处理耗时较长，大图还会在线程池上并行并等待，因此不使用 @CriticalNative（执行期间不能被GC挂起）
+
+    public static native int I420ToNV21(long yuv420p, long yuv420sp, int width, int height, boolean swapUV);
+
+    public static native int NV21ToI420(long yuv420sp, long yuv420p, int width, int height, boolean swapUV);
+
+    public static native int ArgbToNV21(long rgba, long yuv, int width, int height);
+
+    public static native void NV12ToNV21(long yuv, int width, int height);
+
+    public static native void NV21Scale(long src_data, int width, int height, long out,
+                                        int dst_width, int dst_height, int type);
+
+    public static native void I420Scale(long src_data, int width, int height, long out,
+                                        int dst_width, int dst_height, int type, boolean swapUV);
+
+    public static native void NV21ToI420Rotate(long src, int width, int height, long dst, int de, boolean swapUV);
+
+    public static native void NV21AddWaterMark(int startX, int startY, long waterMarkData, int waterMarkW,
+                                               int waterMarkH, long yuvData, int yuvW, int yuvH);
+
+    public static native void NV21BlendOverlay(long yuv, int width, int height, long overlay, int x, int y);
+
+    public static native int NV21DrawTimestamp(long yuv, int width, int height, long atlas,
+                                               long timestamp, int format, int x, int y);
+
+    public static native int executeTransformPlan(long plan, long src, long dst);
+
+    public static native int executeGraph(long graph, long src, long dst);
+
+    public static native int YUV420SPTransform(long src, int srcWidth, int srcHeight, int srcStride,
+                                               int srcSliceHeight, int srcFormat, int cropX, int cropY,
+                                               int cropWidth, int cropHeight, int rotation, long dst,
+                                               int dstWidth, int dstHeight, int dstStride,
+                                               int dstSliceHeight, int dstFormat, int mode);
+
+    /**
+     * 设置大图转换、缩放、旋转按行分带并行使用的线程数（含调用线程），小图始终在调用线程执行
+     *
+     * @param count 1关闭并行，<=0按CPU核数（默认）
+     */
+    @CriticalNative
+    public static native void setThreadCount(int count);
+
+    @CriticalNative
+    public static native int getThreadCount();
+
+    // ---------------- 批量处理 ----------------
+    // 一次JNI调用处理同尺寸的多帧（最多 Key.BATCH_MAX_FRAMES 帧），帧之间在线程池上并行，适合离线加水印、批量生成缩略图等吞吐优先的场景；
+    // 各帧可以是 native 地址（long[]，如 YuvBuffer.address()），也可以打包在一个 byte[] 中按偏移表取用，byte[] 每批只取一次（数组可移动时会拷贝一次）。
+    // 每帧结果和单帧方法一致，0成功，-1任意一帧失败
+
+    /**
+     * 批量 NV21 转 I420
+     *
+     * @param src    每帧NV21数据的 native 地址
+     * @param dst    每帧I420数据的 native 地址
+     * @param count  帧数
+     * @param width  宽度
+     * @param height 高度
+     * @param swapUV 同 {@link #NV21ToI420(byte[], byte[], int, int, boolean)}
+     */
+    public static native int NV21ToI420Batch(long[] src, long[] dst, int count, int width, int height,
+                                             boolean swapUV);
+
+    /**
+     * @param srcOffsets 每帧在 src 中的偏移
+     * @param dstOffsets 每帧在 dst 中的偏移
+     */
+    public static native int NV21ToI420Batch(byte[] src, int[] srcOffsets, byte[] dst, int[] dstOffsets,
+                                             int count, int width, int height, boolean swapUV);
+
+    public static native int I420ToNV21Batch(long[] src, long[] dst, int count, int width, int height,
+                                             boolean swapUV);
+
+    public static native int I420ToNV21Batch(byte[] src, int[] srcOffsets, byte[] dst, int[] dstOffsets,
+                                             int count, int width, int height, boolean swapUV);
+
+    public static native int NV21ToArgbBatch(long[] src, long[] dst, int count, int width, int height);
+
+    public static native int NV21ToArgbBatch(byte[] src, int[] srcOffsets, byte[] dst, int[] dstOffsets,
+                                             int count, int width, int height);
+
+    public static native int NV21ScaleBatch(long[] src, long[] dst, int count, int width, int height,
+                                            int dstWidth, int dstHeight, int mode);
+
+    public static native int NV21ScaleBatch(byte[] src, int[] srcOffsets, byte[] dst, int[] dstOffsets,
+                                            int count, int width, int height, int dstWidth, int dstHeight,
+                                            int mode);
+
+    /**
+     * 按同一个方案批量处理，各带使用各自的临时内存，不占用方案本身的临时内存
+     */
+    public static native int executeTransformPlanBatch(long plan, long[] src, long[] dst, int count);
+
+    public static native int executeTransformPlanBatch(long plan, byte[] src, int[] srcOffsets, byte[] dst,
+                                                       int[] dstOffsets, int count);
+
+    /**
+     * 批量叠加时间水印，直接在各帧NV21数据上绘制
+     *
+     * @param timestamps 每帧的时间戳 ms
+     */
+    public static native int NV21DrawTimestampBatch(long[] yuv, int count, int width, int height, long atlas,
+                                                    long[] timestamps, int format, int x, int y);
+
+    public static native int NV21DrawTimestampBatch(byte[] yuv, int[] offsets, int count, int width, int height,
+                                                    long atlas, long[] timestamps, int format, int x, int y);
+
+    // ---------------- 异步任务 ----------------
+    // 转换提交到任务流后立即返回，调用线程可以继续等待编码器的输入、输出缓冲区，之后按任务ID查询、等待结果，
+    // 或监听任务流的 eventfd；同一个任务流的任务按提交顺序执行。帧数据只能是 native 地址，任务完成前必须保持有效，
+    // 一般使用封装好的 {@link YuvJobStream}
+
+    /**
+     * 创建任务流，使用完调用 {@link #releaseJobStream(long)} 释放
+     *
+     * @return 任务流句柄，0失败
+     */
+    public static native long createJobStream();
+
+    /**
+     * 提交一个批量处理任务，未完成的任务已有16个时等待最早的任务完成
+     *
+     * @param stream     任务流
+     * @param type       {@link Key#JOB_NV21_TO_I420} 等
+     * @param src        每帧源数据的 native 地址
+     * @param dst        每帧目标数据的 native 地址，{@link Key#JOB_DRAW_TIMESTAMP} 传null
+     * @param count      帧数，不超过 {@link Key#BATCH_MAX_FRAMES}
+     * @param handle     变换方案、处理图或字形表，其他操作传0
+     * @param timestamps 每帧的时间戳 ms，只用于 {@link Key#JOB_DRAW_TIMESTAMP}
+     * @return 任务ID，-1失败；其余参数含义同对应的批量方法，不用的传0
+     */
+    public static native long submitJob(long stream, int type, long[] src, long[] dst, int count, int width,
+                                        int height, int dstWidth, int dstHeight, int mode, boolean swapUV,
+                                        long handle, long[] timestamps, int format, int x, int y);
+
+    /**
+     * 查询任务结果，不等待
+     *
+     * @return {@link Key#JOB_PENDING} 未完成，0成功，-1失败，{@link Key#JOB_UNKNOWN} 任务不存在或结果已过期（保留最近64个）
+     */
+    @CriticalNative
+    public static native int pollJob(long stream, long job);
+
+    /**
+     * 等待任务完成
+     *
+     * @param timeoutMs 最多等待的毫秒数，<0一直等待
+     * @return 同 {@link #pollJob(long, long)}，超时返回 {@link Key#JOB_PENDING}
+     */
+    public static native int waitJob(long stream, long job, int timeoutMs);
+
+    /**
+     * 最近完成的任务ID，不大于该ID的任务都已完成
+     */
+    @CriticalNative
+    public static native long getCompletedJob(long stream);
+
+    /**
+     * 任务完成通知的 eventfd，每完成一个任务可读一次，由任务流持有，不能关闭；-1不支持
+     */
+    @CriticalNative
+    public static native int getJobStreamEventFd(long stream);
+
+    /**
+     * 等待已提交的任务全部完成后释放任务流
+     */
+    public static native void releaseJobStream(long stream);
+
+    // ---------------- CPU 特性 ----------------
+    // libyuv按检测到的CPU特性选择各行函数的SIMD实现，特性位为全进程共享，屏蔽后所有转换都改用较低的实现
+
+    /**
+     * 当前生效的CPU特性位，{@link Key#CPU_HAS_NEON} 等的组合
+     */
+    @CriticalNative
+    public static native int getCpuFlags();
+
+    /**
+     * 屏蔽CPU特性，用于对比、排查某个SIMD实现，对之后开始的转换生效
+     *
+     * @param mask 允许使用的特性位，{@link Key#CPU_FLAGS_ALL} 恢复全部特性，{@link Key#CPU_FLAGS_C_ONLY} 只用C实现
+     * @return 生效的特性位
+     */
+    @CriticalNative
+    public static native int maskCpuFlags(int mask);
+
+    /**
+     * 按指令集档位（如 AVX2、SSSE3、SSE2、C）依次测试常用操作的耗时，选用总耗时最短的档位；
+     * 耗时较长，且测试期间其他线程的转换也会受影响，应在后台线程、开始处理前调用
+     *
+     * @param width      测试图片的宽度，一般为实际处理的分辨率
+     * @param height     测试图片的高度
+     * @param iterations 每个操作重复的次数
+     * @return 选用的特性位，-1失败
+     */
+    public static native int autoSelectCpuFlags(int width, int height, int iterations);
+
+    /**
+     * CPU特性报告：检测到及生效的特性位、各操作当前使用的行函数实现，以及最近一次 {@link #autoSelectCpuFlags} 的耗时；
+     * 与 autoSelectCpuFlags 共用一把锁，测速期间会等待测速结束，不要在主线程调用
+     */
+    public static native String getCpuReport();
+
+    /**
+     * 行函数统计：libyuv convert、scale、planar_functions 中每个行函数（含 _Any_ 尾部处理、C实现）及 scratch 分配
+     * 的调用次数、像素数、耗时，按耗时从高到低排列；只有以 -PyuvProfile=ON 编译的调试包才有统计
+     */
+    public static native String getKernelProfile();
+
+    /**
+     * 清零行函数统计，如在测试某个操作前调用
+     */
+    @CriticalNative
+    public static native void resetKernelProfile();
+
+    // ---------------- trace ----------------
+    // 每个 native 入口及内部阶段（convert、scale、blend、copy、分带执行及等待、异步任务）记录为一个事件，
+    // 关闭时每个入口只多一次原子变量读取
+
+    /**
+     * 开始或停止记录 trace 事件，开始时清空之前记录的事件；开启期间事件同时输出为 ATrace section（Android 6.0 及以上），
+     * 抓取 systrace / Perfetto 时与 MediaCodec 等系统事件显示在同一时间轴上
+     */
+    @CriticalNative
+    public static native void setTraceEnabled(boolean enabled);
+
+    /**
+     * 将记录的事件（每个线程最近约 4096 个）按 Chrome trace JSON 格式写入文件，可用 Perfetto UI 或 chrome://tracing 打开
+     *
+     * @param path 文件路径
+     * @return 写入的事件数，-1打开文件失败
+     */
+    public static native int dumpTrace(String path);
+
+    // ---------------- native 帧缓冲池 ----------------
+    // 64字节对齐、按规格复用的 native 内存，可通过 wrapBuffer 或 getBufferAddress 传给上面所有 ByteBuffer / long 地址版本的方法，
+    // 一般使用封装好的 {@link YuvBuffer}
+
+    /**
+     * 从缓冲池取一块至少 size 字节的 native 内存，内容未初始化，线程安全
+     *
+     * @return 缓冲区句柄，0失败，不再使用时调用 {@link #releaseBuffer(long)} 归还
+     */
+    @CriticalNative
+    public static native long acquireBuffer(int size);
+
+    /**
+     * 归还缓冲区，之后不能再使用该句柄及由它得到的地址、ByteBuffer
+     */
+    @CriticalNative
+    public static native void releaseBuffer(long buffer);
+
+    /**
+     * 缓冲区数据的 native 地址，按64字节对齐
+     */
+    @CriticalNative
+    public static native long getBufferAddress(long buffer);
+
+    /**
+     * 把缓冲区包装为 direct ByteBuffer，capacity 为申请的大小，归还缓冲区后不能再访问
+     */
+    @FastNative
+    public static native ByteBuffer wrapBuffer(long buffer);
+
+    /**
+     * 释放缓冲池中所有空闲的内存，如录制结束后
+     */
+    @CriticalNative
+    public static native void trimBufferPool();
+
+    /**
+     * 设置缓冲池最多缓存的空闲内存字节数，默认64M
+     *
+     * @param bytes 0不缓存，<0恢复默认值
+     */
+    @CriticalNative
+    public static native void setBufferPoolLimit(long bytes);
+
+    /**
+     * 缓冲池累计分配内存的次数，稳定运行时不再增长
+     */
+    @CriticalNative
+    public static native long getBufferPoolAllocCount();
+
+    /**
+     * libyuv内部行缓冲（每个线程一块 scratch arena）累计分配内存的次数，稳定运行时不再增长
+     */
+    @CriticalNative
+    public static native long getScratchAllocCount();
+
     static {
         System.loadLibrary("yuv-jni");
     }